@@ -6,8 +6,15 @@ VERSION='0.8'
 from distutils.core import setup, Extension
 
 sources=[ 'src/llist.c',
+          'src/adllist.c',
+          'src/arena.c',
+          'src/deferred.c',
           'src/dllist.c',
           'src/sllist.c',
+          'src/typeddllist.c',
+          'src/typedsllist.c',
+          'src/typedvalue.c',
+          'src/ullist.c',
           'src/utils.c',
           ]
 
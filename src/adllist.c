@@ -0,0 +1,1563 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+#include <structmember.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "lock.h"
+#include "py23macros.h"
+#include "utils.h"
+
+#ifndef PyVarObject_HEAD_INIT
+    #define PyVarObject_HEAD_INIT(type, size) \
+        PyObject_HEAD_INIT(type) size,
+#endif
+
+/* Number of slots allocated for a list on first insertion. */
+#define ADLLIST_MIN_CAPACITY 8
+
+/* Largest number of slots addressable by 32-bit links. */
+#define ADLLIST_MAX_CAPACITY INT32_MAX
+
+/* Link value marking absence of a slot. */
+#define ADLLIST_NO_SLOT ((int32_t)-1)
+
+
+static PyTypeObject ADLListType;
+static PyTypeObject ADLListIteratorType;
+
+
+/* ADLListSlot */
+
+/* Slots are stored in a single contiguous array owned by the list.
+ * Unused slots have value set to NULL and are chained through
+ * the next field into a list of free slots. */
+typedef struct
+{
+    PyObject* value;
+    int32_t prev;
+    int32_t next;
+} ADLListSlot;
+
+
+/* ADLList */
+
+typedef struct
+{
+    PyObject_HEAD
+    ADLListSlot* slots;
+    Py_ssize_t capacity;
+    int32_t first;
+    int32_t last;
+    int32_t free_head;
+    Py_ssize_t size;
+    /* incremented whenever slots are released or moved,
+     * invalidates iterators */
+    Py_ssize_t state;
+    PyObject* weakref_list;
+} ADLListObject;
+
+static PyObject* adllist_slot_to_object(int32_t slot)
+{
+    if (slot == ADLLIST_NO_SLOT)
+        Py_RETURN_NONE;
+
+    return PyLong_FromLong(slot);
+}
+
+/* Convert Python object to an index of a slot used by the list.
+ * Returns ADLLIST_NO_SLOT and sets an exception on failure. */
+static int32_t adllist_validate_slot(ADLListObject* self, PyObject* arg)
+{
+    Py_ssize_t slot;
+
+    if (!Py23Int_Check(arg))
+    {
+        PyErr_SetString(PyExc_TypeError, "Slot must be an integer");
+        return ADLLIST_NO_SLOT;
+    }
+
+    slot = Py23Int_AsSsize_t(arg);
+    if (slot == -1 && PyErr_Occurred())
+        return ADLLIST_NO_SLOT;
+
+    if (slot < 0 || slot >= self->capacity || self->slots[slot].value == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "Slot is not used by the list");
+        return ADLLIST_NO_SLOT;
+    }
+
+    return (int32_t)slot;
+}
+
+/* Grow slot array, so that at least one free slot is available. */
+static int adllist_grow(ADLListObject* self)
+{
+    Py_ssize_t new_capacity;
+    ADLListSlot* new_slots;
+    Py_ssize_t i;
+
+    if (self->capacity >= ADLLIST_MAX_CAPACITY)
+    {
+        PyErr_SetString(PyExc_OverflowError, "List is full");
+        return 0;
+    }
+
+    if (self->capacity == 0)
+        new_capacity = ADLLIST_MIN_CAPACITY;
+    else if (self->capacity > ADLLIST_MAX_CAPACITY / 2)
+        new_capacity = ADLLIST_MAX_CAPACITY;
+    else
+        new_capacity = self->capacity * 2;
+
+    new_slots = PyMem_Resize(self->slots, ADLListSlot, new_capacity);
+    if (new_slots == NULL)
+    {
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    /* chain new slots into the free list, preserving their order */
+    for (i = self->capacity; i < new_capacity; ++i)
+    {
+        new_slots[i].value = NULL;
+        new_slots[i].prev = ADLLIST_NO_SLOT;
+        new_slots[i].next = (i + 1 < new_capacity) ?
+            (int32_t)(i + 1) : self->free_head;
+    }
+
+    self->free_head = (int32_t)self->capacity;
+    self->slots = new_slots;
+    self->capacity = new_capacity;
+
+    return 1;
+}
+
+/* Store value in a free slot and link it between prev and next.
+ * Returns index of the slot or ADLLIST_NO_SLOT on failure. */
+static int32_t adllist_link_new(ADLListObject* self,
+                                int32_t prev,
+                                int32_t next,
+                                PyObject* value)
+{
+    ADLListSlot* slot;
+    int32_t index;
+
+    if (self->free_head == ADLLIST_NO_SLOT && !adllist_grow(self))
+        return ADLLIST_NO_SLOT;
+
+    index = self->free_head;
+    slot = &self->slots[index];
+    self->free_head = slot->next;
+
+    Py_INCREF(value);
+    slot->value = value;
+    slot->prev = prev;
+    slot->next = next;
+
+    if (prev != ADLLIST_NO_SLOT)
+        self->slots[prev].next = index;
+    else
+        self->first = index;
+
+    if (next != ADLLIST_NO_SLOT)
+        self->slots[next].prev = index;
+    else
+        self->last = index;
+
+    ++self->size;
+
+    return index;
+}
+
+/* Unlink slot from the list and put it on the free list.
+ * Returns value stored in the slot, ownership of the reference is passed
+ * to the caller. */
+static PyObject* adllist_unlink(ADLListObject* self, int32_t index)
+{
+    ADLListSlot* slot = &self->slots[index];
+    PyObject* value = slot->value;
+
+    if (slot->prev != ADLLIST_NO_SLOT)
+        self->slots[slot->prev].next = slot->next;
+    else
+        self->first = slot->next;
+
+    if (slot->next != ADLLIST_NO_SLOT)
+        self->slots[slot->next].prev = slot->prev;
+    else
+        self->last = slot->prev;
+
+    slot->value = NULL;
+    slot->prev = ADLLIST_NO_SLOT;
+    slot->next = self->free_head;
+    self->free_head = index;
+
+    --self->size;
+    ++self->state;
+
+    return value;
+}
+
+/* Convenience function for locating slots using index. */
+static int32_t adllist_get_slot_internal(ADLListObject* self,
+                                         Py_ssize_t index)
+{
+    int32_t slot;
+    Py_ssize_t i;
+
+    if (index >= self->size || index < 0)
+    {
+        PyErr_SetString(PyExc_IndexError, "Index out of range");
+        return ADLLIST_NO_SLOT;
+    }
+
+    if (index <= self->size / 2)
+    {
+        /* forward scan */
+        slot = self->first;
+        for (i = 0; i < index; ++i)
+            slot = self->slots[slot].next;
+    }
+    else
+    {
+        /* backward scan */
+        slot = self->last;
+        for (i = self->size - 1; i > index; --i)
+            slot = self->slots[slot].prev;
+    }
+
+    return slot;
+}
+
+/* Detach all slots from the list and release them. */
+static void adllist_clear_internal(ADLListObject* self)
+{
+    ADLListSlot* slots = self->slots;
+    Py_ssize_t capacity = self->capacity;
+    Py_ssize_t i;
+
+    self->slots = NULL;
+    self->capacity = 0;
+    self->first = ADLLIST_NO_SLOT;
+    self->last = ADLLIST_NO_SLOT;
+    self->free_head = ADLLIST_NO_SLOT;
+    self->size = 0;
+    ++self->state;
+
+    /* Values are released after the list is detached from slots,
+     * because destructors of values may access the list. */
+    for (i = 0; i < capacity; ++i)
+        Py_XDECREF(slots[i].value);
+
+    PyMem_Free(slots);
+}
+
+/* Convenience function for extending the list with elements
+ * from an iterable. Elements are added at the right side if
+ * left is 0, or at the left side otherwise. */
+static int adllist_extend_internal(ADLListObject* self,
+                                   PyObject* iterable,
+                                   int left)
+{
+    PyObject* iterator;
+    PyObject* item;
+
+    if (PyObject_TypeCheck(iterable, &ADLListType))
+    {
+        /* Special path for extending with an ADLList.
+         * Number of copied values is fixed in advance to terminate
+         * loop if self == iterable. Slot array may be reallocated,
+         * so slots are addressed by index. */
+        ADLListObject* other = (ADLListObject*)iterable;
+        int32_t slot = other->first;
+        Py_ssize_t remaining = other->size;
+
+        for (; remaining > 0; --remaining)
+        {
+            int32_t new_slot = left ?
+                adllist_link_new(self, ADLLIST_NO_SLOT, self->first,
+                                 other->slots[slot].value) :
+                adllist_link_new(self, self->last, ADLLIST_NO_SLOT,
+                                 other->slots[slot].value);
+
+            if (new_slot == ADLLIST_NO_SLOT)
+                return 0;
+
+            slot = other->slots[slot].next;
+        }
+
+        return 1;
+    }
+
+    iterator = PyObject_GetIter(iterable);
+    if (iterator == NULL)
+        return 0;
+
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        int32_t new_slot = left ?
+            adllist_link_new(self, ADLLIST_NO_SLOT, self->first, item) :
+            adllist_link_new(self, self->last, ADLLIST_NO_SLOT, item);
+
+        Py_DECREF(item);
+
+        if (new_slot == ADLLIST_NO_SLOT)
+        {
+            Py_DECREF(iterator);
+            return 0;
+        }
+    }
+
+    Py_DECREF(iterator);
+
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+/* Find first slot holding a value equal to value.
+ * Returns 1 if found, 0 if not found or -1 on error. */
+static int adllist_find(ADLListObject* self,
+                        PyObject* value,
+                        int32_t* found_slot)
+{
+    Py_ssize_t state = self->state;
+    int32_t slot = self->first;
+
+    while (slot != ADLLIST_NO_SLOT)
+    {
+        PyObject* item = self->slots[slot].value;
+        int equal;
+
+        Py_INCREF(item);
+        equal = PyObject_RichCompareBool(item, value, Py_EQ);
+        Py_DECREF(item);
+
+        if (equal < 0)
+            return -1;
+
+        if (equal)
+        {
+            *found_slot = slot;
+            return 1;
+        }
+
+        if (state != self->state)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                "List changed during comparison");
+            return -1;
+        }
+
+        slot = self->slots[slot].next;
+    }
+
+    return 0;
+}
+
+/* Convenience function for formatting list to a string.
+ * Pass PyObject_Repr or PyObject_Str in the fmt_func argument. */
+static PyObject* adllist_to_string(ADLListObject* self,
+                                   reprfunc fmt_func)
+{
+    PyObject* str = NULL;
+    PyObject* comma_str = NULL;
+    PyObject* tmp_str;
+    Py_ssize_t state = self->state;
+    int32_t slot;
+
+    assert(fmt_func != NULL);
+
+    if (Py_ReprEnter((PyObject*)self) > 0)
+        return Py23String_FromString("adllist(<...>)");
+
+    if (self->first == ADLLIST_NO_SLOT)
+    {
+        Py_ReprLeave((PyObject*)self);
+
+        str = Py23String_FromString("adllist()");
+        if (str == NULL)
+            goto str_alloc_error;
+        return str;
+    }
+
+    str = Py23String_FromString("adllist([");
+    if (str == NULL)
+        goto str_alloc_error;
+
+    comma_str = Py23String_FromString(", ");
+    if (comma_str == NULL)
+        goto str_alloc_error;
+
+    for (slot = self->first; slot != ADLLIST_NO_SLOT;
+         slot = self->slots[slot].next)
+    {
+        PyObject* item = self->slots[slot].value;
+
+        if (slot != self->first)
+            Py23String_Concat(&str, comma_str);
+
+        Py_INCREF(item);
+        tmp_str = fmt_func(item);
+        Py_DECREF(item);
+
+        if (tmp_str == NULL)
+            goto str_alloc_error;
+        Py23String_ConcatAndDel(&str, tmp_str);
+
+        if (state != self->state)
+        {
+            Py_DECREF(str);
+            Py_DECREF(comma_str);
+            Py_ReprLeave((PyObject*)self);
+            PyErr_SetString(PyExc_RuntimeError,
+                "List changed during formatting");
+            return NULL;
+        }
+    }
+
+    Py_DECREF(comma_str);
+    comma_str = NULL;
+
+    tmp_str = Py23String_FromString("])");
+    if (tmp_str == NULL)
+        goto str_alloc_error;
+    Py23String_ConcatAndDel(&str, tmp_str);
+
+    Py_ReprLeave((PyObject*)self);
+
+    return str;
+
+str_alloc_error:
+    Py_XDECREF(str);
+    Py_XDECREF(comma_str);
+    PyErr_SetString(PyExc_RuntimeError, "Failed to create string");
+
+    Py_ReprLeave((PyObject*)self);
+
+    return NULL;
+}
+
+static int adllist_traverse(ADLListObject* self, visitproc visit, void* arg)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < self->capacity; ++i)
+        Py_VISIT(self->slots[i].value);
+
+    return 0;
+}
+
+static int adllist_clear_refs(ADLListObject* self)
+{
+    adllist_clear_internal(self);
+
+    return 0;
+}
+
+static void adllist_dealloc(ADLListObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    if (self->weakref_list != NULL)
+        PyObject_ClearWeakRefs(obj_self);
+
+    adllist_clear_internal(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* adllist_new(PyTypeObject* type,
+                             PyObject* args,
+                             PyObject* kwds)
+{
+    ADLListObject* self;
+
+    self = (ADLListObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->slots = NULL;
+    self->capacity = 0;
+    self->first = ADLLIST_NO_SLOT;
+    self->last = ADLLIST_NO_SLOT;
+    self->free_head = ADLLIST_NO_SLOT;
+    self->size = 0;
+    self->state = 0;
+    self->weakref_list = NULL;
+
+    return (PyObject*)self;
+}
+
+static int adllist_init(ADLListObject* self, PyObject* args, PyObject* kwds)
+{
+    PyObject* iterable = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &iterable))
+        return -1;
+
+    if (iterable == NULL)
+        return 0;
+
+    return adllist_extend_internal(self, iterable, 0) ? 0 : -1;
+}
+
+static PyObject* adllist_repr(ADLListObject* self)
+{
+    return adllist_to_string(self, PyObject_Repr);
+}
+
+static PyObject* adllist_str(ADLListObject* self)
+{
+    return adllist_to_string(self, PyObject_Str);
+}
+
+static long adllist_hash(ADLListObject* self)
+{
+    long hash = 0;
+    Py_ssize_t state = self->state;
+    int32_t slot;
+
+    for (slot = self->first; slot != ADLLIST_NO_SLOT;
+         slot = self->slots[slot].next)
+    {
+        PyObject* item = self->slots[slot].value;
+        long obj_hash;
+
+        Py_INCREF(item);
+        obj_hash = PyObject_Hash(item);
+        Py_DECREF(item);
+
+        if (obj_hash == -1)
+            return -1;
+
+        if (state != self->state)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                "List changed during hashing");
+            return -1;
+        }
+
+        hash = hash_combine(hash, obj_hash);
+    }
+
+    /* -1 is reserved for signalling errors */
+    return (hash != -1) ? hash : -2;
+}
+
+static PyObject* adllist_richcompare(ADLListObject* self,
+                                     ADLListObject* other,
+                                     int op)
+{
+    Py_ssize_t self_state;
+    Py_ssize_t other_state;
+    int32_t self_slot;
+    int32_t other_slot;
+    int satisfied;
+
+    if (!PyObject_TypeCheck(other, &ADLListType))
+    {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    self_state = self->state;
+    other_state = other->state;
+
+    if (self == other &&
+        (op == Py_EQ || op == Py_LE || op == Py_GE))
+        Py_RETURN_TRUE;
+
+    if (self->size != other->size)
+    {
+        if (op == Py_EQ)
+            Py_RETURN_FALSE;
+        else if (op == Py_NE)
+            Py_RETURN_TRUE;
+    }
+
+    /* Scan through sequences' items as long as they are equal. */
+    self_slot = self->first;
+    other_slot = other->first;
+
+    while (self_slot != ADLLIST_NO_SLOT && other_slot != ADLLIST_NO_SLOT)
+    {
+        PyObject* self_item = self->slots[self_slot].value;
+        PyObject* other_item = other->slots[other_slot].value;
+
+        Py_INCREF(self_item);
+        Py_INCREF(other_item);
+
+        satisfied = PyObject_RichCompareBool(self_item, other_item, Py_EQ);
+
+        if (satisfied == 0 && op != Py_EQ && op != Py_NE)
+        {
+            /* Both items are valid, but not equal */
+            satisfied = PyObject_RichCompareBool(self_item, other_item, op);
+
+            Py_DECREF(self_item);
+            Py_DECREF(other_item);
+
+            if (satisfied == -1)
+                return NULL;
+            else if (satisfied)
+                Py_RETURN_TRUE;
+            else
+                Py_RETURN_FALSE;
+        }
+
+        Py_DECREF(self_item);
+        Py_DECREF(other_item);
+
+        if (satisfied == -1)
+            return NULL;
+
+        if (satisfied == 0)
+        {
+            if (op == Py_EQ)
+                Py_RETURN_FALSE;
+            else
+                Py_RETURN_TRUE;
+        }
+
+        if (self_state != self->state || other_state != other->state)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                "List changed during comparison");
+            return NULL;
+        }
+
+        self_slot = self->slots[self_slot].next;
+        other_slot = other->slots[other_slot].next;
+    }
+
+    /* At least one of operands has been fully traversed. */
+    switch (op)
+    {
+    case Py_EQ:
+        satisfied = (self_slot == other_slot);
+        break;
+    case Py_NE:
+        satisfied = (self_slot != other_slot);
+        break;
+    case Py_LT:
+        satisfied = (other_slot != ADLLIST_NO_SLOT);
+        break;
+    case Py_GT:
+        satisfied = (self_slot != ADLLIST_NO_SLOT);
+        break;
+    case Py_LE:
+        satisfied = (self_slot == ADLLIST_NO_SLOT);
+        break;
+    case Py_GE:
+        satisfied = (other_slot == ADLLIST_NO_SLOT);
+        break;
+    default:
+        assert(0 && "Invalid rich compare operator");
+        PyErr_SetString(PyExc_ValueError, "Invalid rich compare operator");
+        return NULL;
+    }
+
+    if (satisfied)
+        Py_RETURN_TRUE;
+    else
+        Py_RETURN_FALSE;
+}
+
+static PyObject* adllist_appendleft(ADLListObject* self, PyObject* arg)
+{
+    int32_t slot;
+
+    slot = adllist_link_new(self, ADLLIST_NO_SLOT, self->first, arg);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(slot);
+}
+
+static PyObject* adllist_appendright(ADLListObject* self, PyObject* arg)
+{
+    int32_t slot;
+
+    slot = adllist_link_new(self, self->last, ADLLIST_NO_SLOT, arg);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(slot);
+}
+
+static PyObject* adllist_insert(ADLListObject* self, PyObject* args)
+{
+    PyObject* value = NULL;
+    PyObject* ref = NULL;
+    int32_t ref_slot;
+    int32_t slot;
+
+    if (!PyArg_UnpackTuple(args, "insert", 1, 2, &value, &ref))
+        return NULL;
+
+    if (ref == NULL || ref == Py_None)
+        return adllist_appendright(self, value);
+
+    ref_slot = adllist_validate_slot(self, ref);
+    if (ref_slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    slot = adllist_link_new(
+        self, self->slots[ref_slot].prev, ref_slot, value);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(slot);
+}
+
+static PyObject* adllist_insertbefore(ADLListObject* self, PyObject* args)
+{
+    PyObject* value = NULL;
+    PyObject* ref = NULL;
+    int32_t ref_slot;
+    int32_t slot;
+
+    if (!PyArg_UnpackTuple(args, "insertbefore", 2, 2, &value, &ref))
+        return NULL;
+
+    ref_slot = adllist_validate_slot(self, ref);
+    if (ref_slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    slot = adllist_link_new(
+        self, self->slots[ref_slot].prev, ref_slot, value);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(slot);
+}
+
+static PyObject* adllist_insertafter(ADLListObject* self, PyObject* args)
+{
+    PyObject* value = NULL;
+    PyObject* ref = NULL;
+    int32_t ref_slot;
+    int32_t slot;
+
+    if (!PyArg_UnpackTuple(args, "insertafter", 2, 2, &value, &ref))
+        return NULL;
+
+    ref_slot = adllist_validate_slot(self, ref);
+    if (ref_slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    slot = adllist_link_new(
+        self, ref_slot, self->slots[ref_slot].next, value);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(slot);
+}
+
+static PyObject* adllist_extendleft(ADLListObject* self, PyObject* arg)
+{
+    if (!adllist_extend_internal(self, arg, 1))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* adllist_extendright(ADLListObject* self, PyObject* arg)
+{
+    if (!adllist_extend_internal(self, arg, 0))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* adllist_clear(ADLListObject* self)
+{
+    adllist_clear_internal(self);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* adllist_popleft(ADLListObject* self)
+{
+    if (self->first == ADLLIST_NO_SLOT)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    return adllist_unlink(self, self->first);
+}
+
+static PyObject* adllist_popright(ADLListObject* self)
+{
+    if (self->last == ADLLIST_NO_SLOT)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    return adllist_unlink(self, self->last);
+}
+
+static PyObject* adllist_remove(ADLListObject* self, PyObject* arg)
+{
+    int32_t slot;
+
+    slot = adllist_validate_slot(self, arg);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_unlink(self, slot);
+}
+
+static PyObject* adllist_slot_at(ADLListObject* self, PyObject* indexObject)
+{
+    Py_ssize_t index;
+    int32_t slot;
+
+    if (!Py23Int_Check(indexObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "Index must be an integer");
+        return NULL;
+    }
+
+    index = Py23Int_AsSsize_t(indexObject);
+
+    if (index < 0)
+        index = self->size + index;
+
+    slot = adllist_get_slot_internal(self, index);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(slot);
+}
+
+static PyObject* adllist_slot_value(ADLListObject* self, PyObject* arg)
+{
+    int32_t slot;
+    PyObject* value;
+
+    slot = adllist_validate_slot(self, arg);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    value = self->slots[slot].value;
+    Py_INCREF(value);
+
+    return value;
+}
+
+static PyObject* adllist_set_slot_value(ADLListObject* self, PyObject* args)
+{
+    PyObject* ref = NULL;
+    PyObject* value = NULL;
+    PyObject* oldval;
+    int32_t slot;
+
+    if (!PyArg_UnpackTuple(args, "setslotvalue", 2, 2, &ref, &value))
+        return NULL;
+
+    slot = adllist_validate_slot(self, ref);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    oldval = self->slots[slot].value;
+
+    Py_INCREF(value);
+    self->slots[slot].value = value;
+    Py_DECREF(oldval);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* adllist_next_slot(ADLListObject* self, PyObject* arg)
+{
+    int32_t slot;
+
+    slot = adllist_validate_slot(self, arg);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(self->slots[slot].next);
+}
+
+static PyObject* adllist_prev_slot(ADLListObject* self, PyObject* arg)
+{
+    int32_t slot;
+
+    slot = adllist_validate_slot(self, arg);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    return adllist_slot_to_object(self->slots[slot].prev);
+}
+
+static PyObject* adllist_compact(ADLListObject* self)
+{
+    ADLListSlot* new_slots = NULL;
+    Py_ssize_t new_capacity;
+    Py_ssize_t i;
+    int32_t slot;
+
+    if (self->size == 0)
+    {
+        adllist_clear_internal(self);
+        Py_RETURN_NONE;
+    }
+
+    /* Shrink slot array, keeping some spare room for insertions. */
+    new_capacity = self->size + self->size / 8;
+    if (new_capacity < ADLLIST_MIN_CAPACITY)
+        new_capacity = ADLLIST_MIN_CAPACITY;
+    if (new_capacity > self->capacity)
+        new_capacity = self->capacity;
+
+    new_slots = PyMem_New(ADLListSlot, new_capacity);
+    if (new_slots == NULL)
+        return PyErr_NoMemory();
+
+    /* copy values in list order, references are moved */
+    slot = self->first;
+    for (i = 0; i < self->size; ++i)
+    {
+        new_slots[i].value = self->slots[slot].value;
+        new_slots[i].prev = (int32_t)(i - 1);
+        new_slots[i].next = (int32_t)(i + 1);
+        slot = self->slots[slot].next;
+    }
+
+    new_slots[self->size - 1].next = ADLLIST_NO_SLOT;
+
+    for (i = self->size; i < new_capacity; ++i)
+    {
+        new_slots[i].value = NULL;
+        new_slots[i].prev = ADLLIST_NO_SLOT;
+        new_slots[i].next = (i + 1 < new_capacity) ?
+            (int32_t)(i + 1) : ADLLIST_NO_SLOT;
+    }
+
+    PyMem_Free(self->slots);
+
+    self->slots = new_slots;
+    self->capacity = new_capacity;
+    self->first = 0;
+    self->last = (int32_t)(self->size - 1);
+    self->free_head = (self->size < new_capacity) ?
+        (int32_t)self->size : ADLLIST_NO_SLOT;
+    ++self->state;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* adllist_create_iterator(PyObject* self, int slots);
+
+static PyObject* adllist_iterslots(PyObject* self)
+{
+    return adllist_create_iterator(self, 1);
+}
+
+static PyObject* adllist_itervalues(PyObject* self)
+{
+    return adllist_create_iterator(self, 0);
+}
+
+static Py_ssize_t adllist_len(PyObject* self)
+{
+    return ((ADLListObject*)self)->size;
+}
+
+static PyObject* adllist_concat(PyObject* self, PyObject* other)
+{
+    ADLListObject* new_list;
+
+    new_list = (ADLListObject*)PyObject_CallObject(
+        (PyObject*)&ADLListType, NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    if (!adllist_extend_internal(new_list, self, 0) ||
+        !adllist_extend_internal(new_list, other, 0))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* adllist_inplace_concat(PyObject* self, PyObject* other)
+{
+    if (!adllist_extend_internal((ADLListObject*)self, other, 0))
+        return NULL;
+
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject* adllist_repeat(PyObject* self, Py_ssize_t count)
+{
+    ADLListObject* new_list;
+    Py_ssize_t i;
+
+    new_list = (ADLListObject*)PyObject_CallObject(
+        (PyObject*)&ADLListType, NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (!adllist_extend_internal(new_list, self, 0))
+        {
+            Py_DECREF(new_list);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* adllist_get_item(PyObject* self, Py_ssize_t index)
+{
+    ADLListObject* list = (ADLListObject*)self;
+    PyObject* value;
+    int32_t slot;
+
+    slot = adllist_get_slot_internal(list, index);
+    if (slot == ADLLIST_NO_SLOT)
+        return NULL;
+
+    value = list->slots[slot].value;
+    Py_INCREF(value);
+
+    return value;
+}
+
+static int adllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
+{
+    ADLListObject* list = (ADLListObject*)self;
+    PyObject* oldval;
+    int32_t slot;
+
+    slot = adllist_get_slot_internal(list, index);
+    if (slot == ADLLIST_NO_SLOT)
+        return -1;
+
+    /* del list[index] */
+    if (val == NULL)
+    {
+        /* Py_DECREF may evaluate its argument more than once on Python 2 */
+        oldval = adllist_unlink(list, slot);
+        Py_DECREF(oldval);
+        return 0;
+    }
+
+    /* list[index] = item */
+    oldval = list->slots[slot].value;
+
+    Py_INCREF(val);
+    list->slots[slot].value = val;
+    Py_DECREF(oldval);
+
+    return 0;
+}
+
+static int adllist_contains(PyObject* self, PyObject* value)
+{
+    int32_t slot;
+
+    return adllist_find((ADLListObject*)self, value, &slot);
+}
+
+static PyObject* adllist_get_first(ADLListObject* self, void* closure)
+{
+    return adllist_slot_to_object(self->first);
+}
+
+static PyObject* adllist_get_last(ADLListObject* self, void* closure)
+{
+    return adllist_slot_to_object(self->last);
+}
+
+/* Size of the list including its slot array. Values are not included. */
+static PyObject* adllist_sizeof(ADLListObject* self)
+{
+    return PyLong_FromSsize_t(Py_TYPE(self)->tp_basicsize +
+                              self->capacity * sizeof(ADLListSlot));
+}
+
+/* Convenience function for copying lists. Values are copied with
+ * copy.deepcopy() if memo is not NULL. Values of the new list occupy
+ * consecutive slots, as after compact(). */
+static PyObject* adllist_copy_internal(ADLListObject* self, PyObject* memo)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    ADLListObject* new_list;
+    PyObject* args;
+    PyObject* values = NULL;
+    int32_t slot;
+    Py_ssize_t i;
+
+    /* __init__ of subclasses is not called, like in copy.copy() */
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+
+    new_list = (ADLListObject*)type->tp_new(type, args, NULL);
+    Py_DECREF(args);
+    if (new_list == NULL)
+        return NULL;
+
+    if (memo == NULL)
+    {
+        if (!adllist_extend_internal(new_list, (PyObject*)self, 0))
+            goto copy_error;
+    }
+    else
+    {
+        if (!llist_memo_store(memo, (PyObject*)self, (PyObject*)new_list))
+            goto copy_error;
+
+        /* deepcopy may run arbitrary code modifying the list,
+         * so values are copied from a snapshot */
+        values = PyList_New(self->size);
+        if (values == NULL)
+            goto copy_error;
+
+        for (slot = self->first, i = 0; slot != ADLLIST_NO_SLOT;
+             slot = self->slots[slot].next, ++i)
+        {
+            Py_INCREF(self->slots[slot].value);
+            PyList_SET_ITEM(values, i, self->slots[slot].value);
+        }
+
+        for (i = 0; i < PyList_GET_SIZE(values); ++i)
+        {
+            PyObject* value;
+            int32_t new_slot;
+
+            value = llist_deepcopy(PyList_GET_ITEM(values, i), memo);
+            if (value == NULL)
+                goto copy_error;
+
+            new_slot = adllist_link_new(
+                new_list, new_list->last, ADLLIST_NO_SLOT, value);
+            Py_DECREF(value);
+            if (new_slot == ADLLIST_NO_SLOT)
+                goto copy_error;
+        }
+
+        Py_CLEAR(values);
+    }
+
+    if (!llist_copy_state((PyObject*)self, (PyObject*)new_list, memo))
+        goto copy_error;
+
+    return (PyObject*)new_list;
+
+copy_error:
+    Py_XDECREF(values);
+    Py_DECREF(new_list);
+    return NULL;
+}
+
+static PyObject* adllist_copy(ADLListObject* self)
+{
+    return adllist_copy_internal(self, NULL);
+}
+
+static PyObject* adllist_deepcopy(ADLListObject* self, PyObject* memo)
+{
+    return adllist_copy_internal(self, memo);
+}
+
+/* Values are passed as an iterator, like for dllist, so pickle creates
+ * (and memoizes) an empty list first and appends values to it, which
+ * handles lists containing themselves. */
+static PyObject* adllist_reduce(ADLListObject* self)
+{
+    PyObject* state;
+    PyObject* items;
+
+    items = PyObject_GetIter((PyObject*)self);
+    if (items == NULL)
+        return NULL;
+
+    state = llist_get_state((PyObject*)self);
+    if (state == NULL)
+    {
+        Py_DECREF(items);
+        return NULL;
+    }
+
+    return Py_BuildValue("O()NN", (PyObject*)Py_TYPE(self), state, items);
+}
+
+/* wrappers holding the list lock, see lock.h */
+LLIST_LOCKED_ARG(adllist_appendleft_locked, adllist_appendleft)
+LLIST_LOCKED_ARG(adllist_appendright_locked, adllist_appendright)
+LLIST_LOCKED_NOARGS(adllist_clear_locked, adllist_clear)
+LLIST_LOCKED_NOARGS(adllist_compact_locked, adllist_compact)
+LLIST_LOCKED_NOARGS(adllist_copy_locked, adllist_copy)
+LLIST_LOCKED_ARG(adllist_deepcopy_locked, adllist_deepcopy)
+LLIST_LOCKED_ARG2(adllist_extendright_locked, adllist_extendright)
+LLIST_LOCKED_ARG2(adllist_extendleft_locked, adllist_extendleft)
+LLIST_LOCKED_ARG(adllist_insert_locked, adllist_insert)
+LLIST_LOCKED_ARG(adllist_insertbefore_locked, adllist_insertbefore)
+LLIST_LOCKED_ARG(adllist_insertafter_locked, adllist_insertafter)
+LLIST_LOCKED_NOARGS(adllist_iterslots_locked, adllist_iterslots)
+LLIST_LOCKED_NOARGS(adllist_itervalues_locked, adllist_itervalues)
+LLIST_LOCKED_ARG(adllist_next_slot_locked, adllist_next_slot)
+LLIST_LOCKED_NOARGS(adllist_popleft_locked, adllist_popleft)
+LLIST_LOCKED_NOARGS(adllist_popright_locked, adllist_popright)
+LLIST_LOCKED_ARG(adllist_prev_slot_locked, adllist_prev_slot)
+LLIST_LOCKED_NOARGS(adllist_reduce_locked, adllist_reduce)
+LLIST_LOCKED_ARG(adllist_remove_locked, adllist_remove)
+LLIST_LOCKED_NOARGS(adllist_sizeof_locked, adllist_sizeof)
+LLIST_LOCKED_ARG(adllist_set_slot_value_locked, adllist_set_slot_value)
+LLIST_LOCKED_ARG(adllist_slot_at_locked, adllist_slot_at)
+LLIST_LOCKED_ARG(adllist_slot_value_locked, adllist_slot_value)
+LLIST_LOCKED_LEN(adllist_len_locked, adllist_len)
+LLIST_LOCKED_CONCAT(adllist_concat_locked, adllist_concat)
+LLIST_LOCKED_INDEX(adllist_repeat_locked, adllist_repeat)
+LLIST_LOCKED_INDEX(adllist_get_item_locked, adllist_get_item)
+LLIST_LOCKED_ASS_ITEM(adllist_set_item_locked, adllist_set_item)
+LLIST_LOCKED_CONTAINS(adllist_contains_locked, adllist_contains)
+LLIST_LOCKED_CONCAT(adllist_inplace_concat_locked, adllist_inplace_concat)
+LLIST_LOCKED_UNARY(adllist_repr_locked, adllist_repr)
+LLIST_LOCKED_UNARY(adllist_str_locked, adllist_str)
+LLIST_LOCKED_HASH(adllist_hash_locked, adllist_hash)
+LLIST_LOCKED_RICHCOMPARE(adllist_richcompare_locked, adllist_richcompare)
+LLIST_LOCKED_INIT(adllist_init_locked, adllist_init)
+
+static PyMethodDef ADLListMethods[] =
+{
+    { "appendleft", (PyCFunction)adllist_appendleft_locked, METH_O,
+      "Append element at the beginning of the list" },
+    { "append", (PyCFunction)adllist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "appendright", (PyCFunction)adllist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "clear", (PyCFunction)adllist_clear_locked, METH_NOARGS,
+      "Remove all elements from the list" },
+    { "compact", (PyCFunction)adllist_compact_locked, METH_NOARGS,
+      "Reorder slots to match order of elements in the list" },
+    { "extend", (PyCFunction)adllist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "extendleft", (PyCFunction)adllist_extendleft_locked, METH_O,
+      "Append elements from iterable at the left side of the list" },
+    { "extendright", (PyCFunction)adllist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "insert", (PyCFunction)adllist_insert_locked, METH_VARARGS,
+      "Inserts element before slot" },
+    { "insertbefore", (PyCFunction)adllist_insertbefore_locked, METH_VARARGS,
+      "Inserts element before slot" },
+    { "insertafter", (PyCFunction)adllist_insertafter_locked, METH_VARARGS,
+      "Inserts element after slot" },
+    { "iterslots", (PyCFunction)adllist_iterslots_locked, METH_NOARGS,
+      "Return iterator over slots used by the list" },
+    { "itervalues", (PyCFunction)adllist_itervalues_locked, METH_NOARGS,
+      "Return iterator over list values" },
+    { "nextslot", (PyCFunction)adllist_next_slot_locked, METH_O,
+      "Return slot following the given slot" },
+    { "popleft", (PyCFunction)adllist_popleft_locked, METH_NOARGS,
+      "Remove first element from the list and return it" },
+    { "pop", (PyCFunction)adllist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "popright", (PyCFunction)adllist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "prevslot", (PyCFunction)adllist_prev_slot_locked, METH_O,
+      "Return slot preceding the given slot" },
+    { "remove", (PyCFunction)adllist_remove_locked, METH_O,
+      "Remove element stored in slot from the list" },
+    { "__copy__", (PyCFunction)adllist_copy_locked, METH_NOARGS,
+      "Return shallow copy of the list" },
+    { "__deepcopy__", (PyCFunction)adllist_deepcopy_locked, METH_O,
+      "Return deep copy of the list" },
+    { "__reduce__", (PyCFunction)adllist_reduce_locked, METH_NOARGS,
+      "Return state information for pickling" },
+    { "__sizeof__", (PyCFunction)adllist_sizeof_locked, METH_NOARGS,
+      "Return size of the list and its slots in memory, in bytes" },
+    { "setslotvalue", (PyCFunction)adllist_set_slot_value_locked, METH_VARARGS,
+      "Replace value stored in slot" },
+    { "slotat", (PyCFunction)adllist_slot_at_locked, METH_O,
+      "Return slot at index" },
+    { "slotvalue", (PyCFunction)adllist_slot_value_locked, METH_O,
+      "Return value stored in slot" },
+    { NULL },   /* sentinel */
+};
+
+static PyMemberDef ADLListMembers[] =
+{
+    { "size", T_PYSSIZET, offsetof(ADLListObject, size), READONLY,
+      "Number of elements in the list" },
+    { "capacity", T_PYSSIZET, offsetof(ADLListObject, capacity), READONLY,
+      "Number of allocated slots" },
+    { NULL },   /* sentinel */
+};
+
+static PyGetSetDef ADLListGetSetters[] =
+{
+    { "first", (getter)adllist_get_first, NULL,
+      "First slot", NULL },
+    { "last", (getter)adllist_get_last, NULL,
+      "Last slot", NULL },
+    { NULL },   /* sentinel */
+};
+
+static PySequenceMethods ADLListSequenceMethods =
+{
+    adllist_len_locked,         /* sq_length */
+    adllist_concat_locked,      /* sq_concat */
+    adllist_repeat_locked,      /* sq_repeat */
+    adllist_get_item_locked,    /* sq_item */
+    0,                          /* sq_slice */
+    adllist_set_item_locked,    /* sq_ass_item */
+    0,                          /* sq_ass_slice */
+    adllist_contains_locked,    /* sq_contains */
+    adllist_inplace_concat_locked, /* sq_inplace_concat */
+    0,                          /* sq_inplace_repeat */
+};
+
+static PyTypeObject ADLListType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.adllist",            /* tp_name */
+    sizeof(ADLListObject),      /* tp_basicsize */
+    0,                          /* tp_itemsize */
+    (destructor)adllist_dealloc,/* tp_dealloc */
+    0,                          /* tp_print */
+    0,                          /* tp_getattr */
+    0,                          /* tp_setattr */
+    0,                          /* tp_compare */
+    (reprfunc)adllist_repr_locked, /* tp_repr */
+    0,                          /* tp_as_number */
+    &ADLListSequenceMethods,    /* tp_as_sequence */
+    0,                          /* tp_as_mapping */
+    (hashfunc)adllist_hash_locked, /* tp_hash */
+    0,                          /* tp_call */
+    (reprfunc)adllist_str_locked, /* tp_str */
+    0,                          /* tp_getattro */
+    0,                          /* tp_setattro */
+    0,                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+                                /* tp_flags */
+    "Array-backed doubly linked list",
+                                /* tp_doc */
+    (traverseproc)adllist_traverse,
+                                /* tp_traverse */
+    (inquiry)adllist_clear_refs,/* tp_clear */
+    (richcmpfunc)adllist_richcompare_locked,
+                                /* tp_richcompare */
+    offsetof(ADLListObject, weakref_list),
+                                /* tp_weaklistoffset */
+    adllist_itervalues,         /* tp_iter */
+    0,                          /* tp_iternext */
+    ADLListMethods,             /* tp_methods */
+    ADLListMembers,             /* tp_members */
+    ADLListGetSetters,          /* tp_getset */
+    0,                          /* tp_base */
+    0,                          /* tp_dict */
+    0,                          /* tp_descr_get */
+    0,                          /* tp_descr_set */
+    0,                          /* tp_dictoffset */
+    (initproc)adllist_init_locked, /* tp_init */
+    0,                          /* tp_alloc */
+    adllist_new,                /* tp_new */
+};
+
+
+/* ADLListIterator */
+
+typedef struct
+{
+    PyObject_HEAD
+    ADLListObject* list;
+    /* slot returned by the last call to next() */
+    int32_t current_slot;
+    Py_ssize_t state;
+    /* yield slot indices instead of values */
+    int slots;
+} ADLListIteratorObject;
+
+static int adllistiterator_traverse(ADLListIteratorObject* self,
+                                    visitproc visit,
+                                    void* arg)
+{
+    Py_VISIT(self->list);
+
+    return 0;
+}
+
+static int adllistiterator_clear_refs(ADLListIteratorObject* self)
+{
+    Py_CLEAR(self->list);
+
+    return 0;
+}
+
+static void adllistiterator_dealloc(ADLListIteratorObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    adllistiterator_clear_refs(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* adllistiterator_new(PyTypeObject* type,
+                                     PyObject* args,
+                                     PyObject* kwds)
+{
+    ADLListIteratorObject* self;
+    PyObject* owner_list = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__new__", 1, 1, &owner_list))
+        return NULL;
+
+    if (!PyObject_TypeCheck(owner_list, &ADLListType))
+    {
+        PyErr_SetString(PyExc_TypeError, "adllist argument expected");
+        return NULL;
+    }
+
+    self = (ADLListIteratorObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->list = (ADLListObject*)owner_list;
+    self->current_slot = ADLLIST_NO_SLOT;
+    self->state = self->list->state;
+    self->slots = 0;
+
+    Py_INCREF(self->list);
+
+    return (PyObject*)self;
+}
+
+static PyObject* adllistiterator_iternext(PyObject* self)
+{
+    ADLListIteratorObject* iter_self = (ADLListIteratorObject*)self;
+    ADLListObject* list = iter_self->list;
+    int32_t next_slot;
+
+    if (list == NULL)
+        return NULL;
+
+    if (iter_self->state != list->state)
+    {
+        Py_CLEAR(iter_self->list);
+        PyErr_SetString(PyExc_RuntimeError,
+            "List changed size during iteration");
+        return NULL;
+    }
+
+    if (iter_self->current_slot == ADLLIST_NO_SLOT)
+        next_slot = list->first;
+    else
+        next_slot = list->slots[iter_self->current_slot].next;
+
+    if (next_slot == ADLLIST_NO_SLOT)
+    {
+        /* release the list, so that the iterator stays exhausted */
+        Py_CLEAR(iter_self->list);
+        return NULL;
+    }
+
+    iter_self->current_slot = next_slot;
+
+    if (iter_self->slots)
+        return adllist_slot_to_object(next_slot);
+
+    Py_INCREF(list->slots[next_slot].value);
+    return list->slots[next_slot].value;
+}
+
+LLIST_LOCKED_ITERNEXT(adllistiterator_iternext_locked,
+    adllistiterator_iternext, ADLListIteratorObject)
+
+static PyTypeObject ADLListIteratorType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.adllistiterator",                /* tp_name */
+    sizeof(ADLListIteratorObject),          /* tp_basicsize */
+    0,                                      /* tp_itemsize */
+    (destructor)adllistiterator_dealloc,    /* tp_dealloc */
+    0,                                      /* tp_print */
+    0,                                      /* tp_getattr */
+    0,                                      /* tp_setattr */
+    0,                                      /* tp_compare */
+    0,                                      /* tp_repr */
+    0,                                      /* tp_as_number */
+    0,                                      /* tp_as_sequence */
+    0,                                      /* tp_as_mapping */
+    0,                                      /* tp_hash */
+    0,                                      /* tp_call */
+    0,                                      /* tp_str */
+    0,                                      /* tp_getattro */
+    0,                                      /* tp_setattro */
+    0,                                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+                                            /* tp_flags */
+    "Array-backed doubly linked list iterator",
+                                            /* tp_doc */
+    (traverseproc)adllistiterator_traverse, /* tp_traverse */
+    (inquiry)adllistiterator_clear_refs,    /* tp_clear */
+    0,                                      /* tp_richcompare */
+    0,                                      /* tp_weaklistoffset */
+    PyObject_SelfIter,                      /* tp_iter */
+    adllistiterator_iternext_locked,        /* tp_iternext */
+    0,                                      /* tp_methods */
+    0,                                      /* tp_members */
+    0,                                      /* tp_getset */
+    0,                                      /* tp_base */
+    0,                                      /* tp_dict */
+    0,                                      /* tp_descr_get */
+    0,                                      /* tp_descr_set */
+    0,                                      /* tp_dictoffset */
+    0,                                      /* tp_init */
+    0,                                      /* tp_alloc */
+    adllistiterator_new,                    /* tp_new */
+};
+
+static PyObject* adllist_create_iterator(PyObject* self, int slots)
+{
+    PyObject* args;
+    PyObject* result;
+
+    args = PyTuple_Pack(1, self);
+    if (args == NULL)
+        return NULL;
+
+    result = PyObject_CallObject((PyObject*)&ADLListIteratorType, args);
+
+    Py_DECREF(args);
+
+    if (result != NULL)
+        ((ADLListIteratorObject*)result)->slots = slots;
+
+    return result;
+}
+
+LLIST_INTERNAL int adllist_init_type(void)
+{
+    return
+        ((PyType_Ready(&ADLListType) == 0) &&
+         (PyType_Ready(&ADLListIteratorType) == 0))
+        ? 1 : 0;
+}
+
+LLIST_INTERNAL void adllist_register(PyObject* module)
+{
+    Py_INCREF(&ADLListType);
+    Py_INCREF(&ADLListIteratorType);
+
+    PyModule_AddObject(module, "adllist", (PyObject*)&ADLListType);
+    PyModule_AddObject(
+        module, "adllistiterator", (PyObject*)&ADLListIteratorType);
+}
@@ -0,0 +1,13 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef ADLLIST_H
+#define ADLLIST_H
+
+#include "config.h"
+
+LLIST_INTERNAL int  adllist_init_type(void);
+LLIST_INTERNAL void adllist_register(PyObject* module);
+
+#endif /* ADLLIST_H */
@@ -0,0 +1,419 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+
+#include "config.h"
+#include "arena.h"
+#include "utils.h"
+
+#ifdef LLIST_ARENA_SUPPORTED
+
+/* Sizes of blocks grow geometrically, so that large lists use
+ * few blocks. */
+#define ARENA_MIN_BLOCK_SIZE    ((Py_ssize_t)16 * 1024)
+#define ARENA_MAX_BLOCK_SIZE    ((Py_ssize_t)1024 * 1024)
+
+/* Garbage collector header preceding tracked objects, as declared by
+ * PyGC_Head in Python 3.8 to 3.13 (in internal/pycore_gc.h since 3.9).
+ * An object is not tracked while _gc_next is zero. Arenas are enabled
+ * only for these versions (see arena.h), and only if the header size
+ * measured at runtime matches. */
+typedef struct
+{
+    uintptr_t _gc_next;
+    uintptr_t _gc_prev;
+} ArenaGCHead;
+
+#define ARENA_GC_HEAD_SIZE      ((Py_ssize_t)sizeof(ArenaGCHead))
+
+/* Nodes hold only pointers and the garbage collector uses two lowest
+ * bits of pointers in its header, so pointer alignment is sufficient. */
+#define ARENA_ALIGN             ((Py_ssize_t)sizeof(void*))
+#define ARENA_ROUND_UP(n)       (((n) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+typedef struct
+{
+    LListArena* arena;
+    char* end;
+    Py_ssize_t size;
+    /* number of objects allocated from the block and not released yet,
+     * plus one if the arena still allocates from the block */
+    Py_ssize_t live;
+    /* set by llist_arena_pinned() for blocks holding nodes of the list */
+    int marked;
+} ArenaBlock;
+
+#define ARENA_BLOCK_HEADER_SIZE ARENA_ROUND_UP((Py_ssize_t)sizeof(ArenaBlock))
+
+/* Types of objects allocated from arenas, with the number of their blocks
+ * which are not freed yet. Objects of other types, or of types without
+ * blocks, are freed without searching for their block. */
+#define ARENA_MAX_TYPES 2
+
+typedef struct
+{
+    PyTypeObject* type;
+    Py_ssize_t block_count;
+} ArenaType;
+
+static ArenaType arena_types[ARENA_MAX_TYPES];
+
+struct LListArena
+{
+    PyTypeObject* type;
+    ArenaType* type_info;
+    Py_ssize_t slot_size;
+    ArenaBlock* current;
+    char* next_slot;
+    Py_ssize_t next_block_size;
+    Py_ssize_t reserved;
+    /* number of objects allocated from the arena and not released yet */
+    Py_ssize_t nodes;
+    /* one reference held by the list and one by each block */
+    Py_ssize_t refs;
+};
+
+/* All blocks which are not freed yet, sorted by address. Used to find
+ * the block containing an object being freed. */
+static ArenaBlock** blocks = NULL;
+static Py_ssize_t block_count = 0;
+static Py_ssize_t block_capacity = 0;
+
+/* Return index of the last block starting at or before ptr, or -1. */
+static Py_ssize_t blocks_search(const void* ptr)
+{
+    Py_ssize_t lo = 0;
+    Py_ssize_t hi = block_count;
+
+    while (lo < hi)
+    {
+        Py_ssize_t mid = lo + (hi - lo) / 2;
+
+        if ((const char*)blocks[mid] <= (const char*)ptr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo - 1;
+}
+
+static int blocks_insert(ArenaBlock* block)
+{
+    Py_ssize_t index;
+
+    if (block_count == block_capacity)
+    {
+        Py_ssize_t new_capacity =
+            (block_capacity > 0) ? block_capacity * 2 : 16;
+        ArenaBlock** new_blocks = (ArenaBlock**)PyMem_Realloc(
+            blocks, new_capacity * sizeof(ArenaBlock*));
+
+        if (new_blocks == NULL)
+            return 0;
+
+        blocks = new_blocks;
+        block_capacity = new_capacity;
+    }
+
+    index = blocks_search(block) + 1;
+    memmove(&blocks[index + 1], &blocks[index],
+            (block_count - index) * sizeof(ArenaBlock*));
+    blocks[index] = block;
+    ++block_count;
+
+    return 1;
+}
+
+static void blocks_remove(ArenaBlock* block)
+{
+    Py_ssize_t index = blocks_search(block);
+
+    assert(index >= 0 && blocks[index] == block);
+
+    memmove(&blocks[index], &blocks[index + 1],
+            (block_count - index - 1) * sizeof(ArenaBlock*));
+    --block_count;
+}
+
+static void arena_decref(LListArena* arena)
+{
+    if (--arena->refs == 0)
+        PyMem_Free(arena);
+}
+
+static void block_decref(ArenaBlock* block)
+{
+    LListArena* arena = block->arena;
+
+    if (--block->live > 0)
+        return;
+
+    blocks_remove(block);
+    --arena->type_info->block_count;
+    arena->reserved -= block->size;
+    PyMem_Free(block);
+    arena_decref(arena);
+}
+
+/* Allocate a new block for a list holding list_size nodes. */
+static ArenaBlock* block_new(LListArena* arena, Py_ssize_t list_size)
+{
+    /* Nodes outside the list (detached, or moved to other lists) keep
+     * their blocks alive, so blocks are not enlarged while such nodes
+     * exist. Nodes adopted by the list from elsewhere may hide some of
+     * them, since only counts are compared. */
+    int grow = (arena->nodes <= list_size);
+    Py_ssize_t size = grow ? arena->next_block_size : ARENA_MIN_BLOCK_SIZE;
+    ArenaBlock* block = (ArenaBlock*)PyMem_Malloc(size);
+
+    if (block == NULL)
+        return NULL;
+
+    if (!blocks_insert(block))
+    {
+        PyMem_Free(block);
+        return NULL;
+    }
+
+    block->arena = arena;
+    block->end = (char*)block + size;
+    block->size = size;
+    block->live = 1;
+    block->marked = 0;
+
+    ++arena->type_info->block_count;
+    arena->reserved += size;
+    ++arena->refs;
+
+    if (!grow)
+        arena->next_block_size = ARENA_MIN_BLOCK_SIZE;
+    else if (size < ARENA_MAX_BLOCK_SIZE)
+        arena->next_block_size = size * 2;
+
+    return block;
+}
+
+LLIST_INTERNAL int llist_arena_enable(LListArena** arena,
+                                      PyTypeObject* type,
+                                      int enable)
+{
+    LListArena* new_arena;
+    ArenaType* type_info = NULL;
+    int i;
+
+#if PY_VERSION_HEX < 0x03090000
+    Py_BUILD_ASSERT(sizeof(PyGC_Head) == sizeof(ArenaGCHead));
+#endif
+
+    if (!enable)
+    {
+        if (*arena != NULL)
+        {
+            llist_arena_reset(*arena);
+            arena_decref(*arena);
+            *arena = NULL;
+        }
+        return 1;
+    }
+
+    if (*arena != NULL)
+        return 1;
+
+    assert(type->tp_free == llist_arena_free);
+
+    if (llist_gc_head_size() != ARENA_GC_HEAD_SIZE)
+        return 1;
+
+    for (i = 0; i < ARENA_MAX_TYPES && type_info == NULL; ++i)
+    {
+        if (arena_types[i].type == NULL)
+            arena_types[i].type = type;
+        if (arena_types[i].type == type)
+            type_info = &arena_types[i];
+    }
+
+    if (type_info == NULL)
+    {
+        PyErr_SetString(PyExc_SystemError, "Too many node types in arenas");
+        return 0;
+    }
+
+    new_arena = (LListArena*)PyMem_Malloc(sizeof(LListArena));
+    if (new_arena == NULL)
+    {
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    new_arena->type = type;
+    new_arena->type_info = type_info;
+    new_arena->slot_size =
+        ARENA_ROUND_UP(ARENA_GC_HEAD_SIZE + type->tp_basicsize);
+    new_arena->current = NULL;
+    new_arena->next_slot = NULL;
+    new_arena->next_block_size = ARENA_MIN_BLOCK_SIZE;
+    new_arena->reserved = 0;
+    new_arena->nodes = 0;
+    new_arena->refs = 1;
+
+    *arena = new_arena;
+
+    return 1;
+}
+
+LLIST_INTERNAL PyObject* llist_arena_alloc(LListArena* arena,
+                                           Py_ssize_t list_size)
+{
+    char* slot;
+    PyObject* obj;
+
+    if (arena->current == NULL ||
+        arena->next_slot + arena->slot_size > arena->current->end)
+    {
+        ArenaBlock* block = block_new(arena, list_size);
+
+        if (block == NULL)
+            return PyErr_NoMemory();
+
+        llist_arena_reset(arena);
+        arena->current = block;
+        arena->next_slot = (char*)block + ARENA_BLOCK_HEADER_SIZE;
+    }
+
+    slot = arena->next_slot;
+    arena->next_slot += arena->slot_size;
+    ++arena->current->live;
+    ++arena->nodes;
+
+    /* zeroed garbage collector header marks the object as untracked */
+    memset(slot, 0, arena->slot_size);
+    obj = (PyObject*)(slot + ARENA_GC_HEAD_SIZE);
+    PyObject_Init(obj, arena->type);
+#if PY_VERSION_HEX >= 0x03090000
+    assert(!PyObject_GC_IsTracked(obj));
+#endif
+    PyObject_GC_Track(obj);
+
+    return obj;
+}
+
+LLIST_INTERNAL void llist_arena_reset(LListArena* arena)
+{
+    ArenaBlock* block = arena->current;
+
+    if (block == NULL)
+        return;
+
+    arena->current = NULL;
+    arena->next_slot = NULL;
+    block_decref(block);
+}
+
+LLIST_INTERNAL Py_ssize_t llist_arena_reserved(LListArena* arena)
+{
+    return (arena != NULL) ? arena->reserved : 0;
+}
+
+LLIST_INTERNAL Py_ssize_t llist_arena_pinned(LListArena* arena,
+                                             PyObject* first,
+                                             Py_ssize_t next_offset)
+{
+    PyObject* node = first;
+    Py_ssize_t pinned = 0;
+    Py_ssize_t i;
+
+    if (arena == NULL)
+        return 0;
+
+    for (i = 0; i < block_count; ++i)
+        blocks[i]->marked = 0;
+
+    while (node != NULL)
+    {
+        Py_ssize_t index = blocks_search(node);
+
+        if (index >= 0 && (char*)node < blocks[index]->end)
+            blocks[index]->marked = 1;
+        node = *(PyObject**)((char*)node + next_offset);
+    }
+
+    for (i = 0; i < block_count; ++i)
+    {
+        ArenaBlock* block = blocks[i];
+
+        if (block->arena == arena && !block->marked &&
+            block != arena->current)
+            pinned += block->size;
+    }
+
+    return pinned;
+}
+
+LLIST_INTERNAL void llist_arena_free(void* obj)
+{
+    PyTypeObject* type = Py_TYPE((PyObject*)obj);
+    int i;
+
+    for (i = 0; i < ARENA_MAX_TYPES; ++i)
+    {
+        if (arena_types[i].type == type)
+        {
+            if (arena_types[i].block_count > 0)
+            {
+                Py_ssize_t index = blocks_search(obj);
+
+                if (index >= 0 && (char*)obj < blocks[index]->end)
+                {
+                    --blocks[index]->arena->nodes;
+                    block_decref(blocks[index]);
+                    return;
+                }
+            }
+            break;
+        }
+    }
+
+    PyObject_GC_Del(obj);
+}
+
+#else /* !LLIST_ARENA_SUPPORTED */
+
+LLIST_INTERNAL int llist_arena_enable(LListArena** arena,
+                                      PyTypeObject* type,
+                                      int enable)
+{
+    return 1;
+}
+
+LLIST_INTERNAL PyObject* llist_arena_alloc(LListArena* arena,
+                                           Py_ssize_t list_size)
+{
+    PyErr_SetString(PyExc_SystemError, "Node arenas are not supported");
+    return NULL;
+}
+
+LLIST_INTERNAL void llist_arena_reset(LListArena* arena)
+{
+}
+
+LLIST_INTERNAL Py_ssize_t llist_arena_reserved(LListArena* arena)
+{
+    return 0;
+}
+
+LLIST_INTERNAL Py_ssize_t llist_arena_pinned(LListArena* arena,
+                                             PyObject* first,
+                                             Py_ssize_t next_offset)
+{
+    return 0;
+}
+
+LLIST_INTERNAL void llist_arena_free(void* obj)
+{
+    PyObject_GC_Del(obj);
+}
+
+#endif /* LLIST_ARENA_SUPPORTED */
@@ -0,0 +1,84 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <Python.h>
+
+#include "config.h"
+
+/* Arenas allocate list nodes from large blocks, in which nodes are laid
+ * out in allocation order. A block is freed at once, when the last node
+ * allocated from it is released.
+ *
+ * Nodes are ordinary Python objects, so they cannot be moved out of
+ * a block. A node which outlives its list (or is removed from it) keeps
+ * its block alive until the node itself is released.
+ *
+ * Objects allocated from arenas bypass the object allocator, so they
+ * must be laid out like objects created by PyType_GenericAlloc().
+ * PyType_GenericAlloc() itself cannot be used per node, because the
+ * object allocator decides where objects are placed, and contiguous
+ * placement is the purpose of arenas. The generation 0 count of the
+ * garbage collector is only updated by the interpreter's allocation
+ * functions, so arena nodes do not count toward collection thresholds
+ * (nor is the count decreased when they are freed, as they are not
+ * released with PyObject_GC_Del()). They are tracked as usual, so cycles
+ * through them are still collected. Blocks are allocated with
+ * PyMem_Malloc(), so tracemalloc reports whole blocks, not nodes.
+ *
+ * The garbage collector header is laid out by hand, so arenas are only
+ * available on Python versions whose header layout is known (3.8 to
+ * 3.13, see arena.c), and not on free-threaded builds, where the garbage
+ * collector finds objects by walking allocator heaps.
+ *
+ * Once nodes allocated from an arena exist outside its list, new blocks
+ * are no longer enlarged, so that each further block kept alive by
+ * detached nodes has the minimum size. */
+#if PY_VERSION_HEX >= 0x03080000 && PY_VERSION_HEX < 0x030E0000 && \
+    !defined(Py_GIL_DISABLED)
+#define LLIST_ARENA_SUPPORTED
+#endif
+
+typedef struct LListArena LListArena;
+
+/* Create an arena in *arena if enable is nonzero and it does not exist
+ * yet, or release an existing arena if enable is zero. Nodes of type
+ * (which must use llist_arena_free() as tp_free) are allocated from
+ * the arena. Does nothing if arenas are not supported, or if the size
+ * of the garbage collector header measured at runtime differs from
+ * the expected one. Returns 0 and sets an exception on failure. */
+LLIST_INTERNAL int llist_arena_enable(LListArena** arena,
+                                      PyTypeObject* type,
+                                      int enable);
+
+/* Allocate a zeroed and tracked object, like tp_alloc, for a list
+ * holding list_size nodes. Returns NULL and sets an exception on
+ * failure. */
+LLIST_INTERNAL PyObject* llist_arena_alloc(LListArena* arena,
+                                           Py_ssize_t list_size);
+
+/* Start a new block for subsequent allocations, so that the current
+ * block is freed as soon as nodes allocated from it are released.
+ * Called when all nodes are removed from a list. */
+LLIST_INTERNAL void llist_arena_reset(LListArena* arena);
+
+/* Number of bytes in blocks of the arena which are not freed yet. */
+LLIST_INTERNAL Py_ssize_t llist_arena_reserved(LListArena* arena);
+
+/* Number of bytes in blocks of the arena which are kept alive only by
+ * nodes outside the list starting at first, that is blocks holding none
+ * of its nodes (other than the block used for new allocations).
+ * next_offset is the offset of the link to the next node in nodes.
+ * Has O(n log(b)) complexity, where b is the number of blocks. */
+LLIST_INTERNAL Py_ssize_t llist_arena_pinned(LListArena* arena,
+                                             PyObject* first,
+                                             Py_ssize_t next_offset);
+
+/* Free function (tp_free) for types allocated from arenas. Objects which
+ * were not allocated from an arena are freed with PyObject_GC_Del(). */
+LLIST_INTERNAL void llist_arena_free(void* obj);
+
+#endif /* ARENA_H */
@@ -0,0 +1,126 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+
+#include "config.h"
+#include "deferred.h"
+
+/* Chains of nodes detached from lists in deferred release mode.
+ * Nodes are released in slices by llist_release_pending(). */
+
+typedef struct
+{
+    PyObject* head;
+    Py_ssize_t size;
+    llist_release_func release;
+} PendingChain;
+
+static PendingChain* pending_chains = NULL;
+static Py_ssize_t pending_chain_count = 0;
+static Py_ssize_t pending_chain_capacity = 0;
+static Py_ssize_t pending_node_count = 0;
+
+/* Releasing nodes may run arbitrary code, so the queue is never locked
+ * while chains are being released. Chains are taken out of the queue
+ * and put back if they were not released completely. */
+#ifdef Py_GIL_DISABLED
+static PyMutex pending_mutex;
+#define PENDING_LOCK()      PyMutex_Lock(&pending_mutex)
+#define PENDING_UNLOCK()    PyMutex_Unlock(&pending_mutex)
+#else
+#define PENDING_LOCK()
+#define PENDING_UNLOCK()
+#endif
+
+static int pending_push(PendingChain* chain)
+{
+    if (pending_chain_count == pending_chain_capacity)
+    {
+        Py_ssize_t new_capacity =
+            (pending_chain_capacity > 0) ? pending_chain_capacity * 2 : 8;
+        PendingChain* new_chains = (PendingChain*)PyMem_Realloc(
+            pending_chains, new_capacity * sizeof(PendingChain));
+
+        if (new_chains == NULL)
+            return 0;
+
+        pending_chains = new_chains;
+        pending_chain_capacity = new_capacity;
+    }
+
+    pending_chains[pending_chain_count++] = *chain;
+    pending_node_count += chain->size;
+
+    return 1;
+}
+
+LLIST_INTERNAL int llist_defer_release(PyObject* head,
+                                       Py_ssize_t size,
+                                       llist_release_func release)
+{
+    PendingChain chain;
+    int result;
+
+    assert(head != NULL);
+    assert(size > 0);
+
+    chain.head = head;
+    chain.size = size;
+    chain.release = release;
+
+    PENDING_LOCK();
+    result = pending_push(&chain);
+    PENDING_UNLOCK();
+
+    return result;
+}
+
+LLIST_INTERNAL Py_ssize_t llist_release_pending(Py_ssize_t budget)
+{
+    Py_ssize_t remaining;
+
+    while (budget != 0)
+    {
+        PendingChain chain;
+        Py_ssize_t released;
+
+        PENDING_LOCK();
+        if (pending_chain_count == 0)
+        {
+            PENDING_UNLOCK();
+            break;
+        }
+        chain = pending_chains[--pending_chain_count];
+        pending_node_count -= chain.size;
+        PENDING_UNLOCK();
+
+        released = chain.release(&chain.head,
+            (budget < 0 || budget > chain.size) ? chain.size : budget);
+        chain.size -= released;
+        if (budget > 0)
+            budget -= released;
+
+        if (chain.head != NULL)
+        {
+            PENDING_LOCK();
+            /* the queue had room for this chain a moment ago,
+             * unless it was extended by code run during release */
+            if (!pending_push(&chain))
+            {
+                PENDING_UNLOCK();
+                chain.release(&chain.head, chain.size);
+                assert(chain.head == NULL);
+                continue;
+            }
+            PENDING_UNLOCK();
+        }
+    }
+
+    PENDING_LOCK();
+    remaining = pending_node_count;
+    PENDING_UNLOCK();
+
+    return remaining;
+}
@@ -0,0 +1,32 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <Python.h>
+
+#include "config.h"
+
+/* Number of pending nodes released by each insertion into a list
+ * in deferred release mode. */
+#define LLIST_RELEASE_STEP 8
+
+/* Release at most budget nodes from the chain starting at *head.
+ * Updates *head to the first remaining node (NULL if the whole chain
+ * was released) and returns the number of released nodes. */
+typedef Py_ssize_t (*llist_release_func)(PyObject** head, Py_ssize_t budget);
+
+/* Queue a detached chain of size nodes for incremental release.
+ * Returns 0 if the chain could not be queued (no exception is set),
+ * in which case the caller must release it immediately. */
+LLIST_INTERNAL int llist_defer_release(PyObject* head,
+                                       Py_ssize_t size,
+                                       llist_release_func release);
+
+/* Release at most budget pending nodes (all of them if budget is
+ * negative). Returns the number of nodes which are still pending. */
+LLIST_INTERNAL Py_ssize_t llist_release_pending(Py_ssize_t budget);
+
+#endif /* DEFERRED_H */
@@ -3,10 +3,21 @@
  */
 
 #include <Python.h>
+#include <pythread.h>
 #include <structmember.h>
+#if PY_VERSION_HEX < 0x03050000
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
 
 #include "config.h"
+#include "arena.h"
+#include "deferred.h"
 #include "flags.h"
+#include "lock.h"
 #include "py23macros.h"
 #include "utils.h"
 
@@ -21,6 +32,16 @@ static PyTypeObject DLListNodeType;
 static PyTypeObject DLListIteratorType;
 static PyTypeObject DLListNodeIteratorType;
 
+static PyObject* dllistnode_new(PyTypeObject* type,
+                                PyObject* args,
+                                PyObject* kwds);
+static PyObject* dllist_get_node_ref(PyObject* list);
+static LListArena* dllist_get_arena(PyObject* list);
+static Py_ssize_t dllist_get_size(PyObject* list);
+static PyObject* dllist_get_first(PyObject* list);
+static PyObject* dllist_get_last(PyObject* list);
+static void dllistiterator_set_cycle(PyObject* iterator);
+
 
 /* DLListNode */
 
@@ -30,10 +51,28 @@ typedef struct
     PyObject* value;
     PyObject* prev;
     PyObject* next;
+    /* NULL if the node does not belong to a list */
     PyObject* list_weakref;
-    unsigned char flags;
 } DLListNodeObject;
 
+/* Nodes storing atomic values (see llist_is_atomic) cannot be part of
+ * reference cycles, so they are not tracked by the garbage collector.
+ * This function must be called whenever value of a node changes.
+ * Instances of node subclasses are always tracked. */
+static void dllistnode_update_gc(DLListNodeObject* node)
+{
+    if (Py_TYPE(node) != &DLListNodeType)
+        return;
+
+    if (llist_is_atomic(node->value))
+    {
+        if (PyObject_GC_IsTracked((PyObject*)node))
+            PyObject_GC_UnTrack(node);
+    }
+    else if (!PyObject_GC_IsTracked((PyObject*)node))
+        PyObject_GC_Track(node);
+}
+
 /* Convenience function for linking list nodes.
  * Automatically updates pointers in inserted node and its neighbours.
  */
@@ -43,27 +82,25 @@ static void dllistnode_link(PyObject* prev,
                             PyObject* owner_list)
 {
     assert(inserted != NULL);
-    assert(inserted->prev == Py_None);
-    assert(inserted->next == Py_None);
+    assert(inserted->prev == NULL);
+    assert(inserted->next == NULL);
+    assert(inserted->list_weakref == NULL);
     assert(owner_list != NULL);
-    assert(owner_list != Py_None);
 
-    /* prev is initialized to Py_None by default (by dllistnode_new) */
-    if (prev != NULL && prev != Py_None)
+    if (prev != NULL)
     {
         inserted->prev = prev;
         ((DLListNodeObject*)prev)->next = (PyObject*)inserted;
     }
 
-    /* next is initialized to Py_None by default (by dllistnode_new) */
-    if (next != NULL && next != Py_None)
+    if (next != NULL)
     {
         inserted->next = next;
         ((DLListNodeObject*)next)->prev = (PyObject*)inserted;
     }
 
-    Py_DECREF(inserted->list_weakref);
-    inserted->list_weakref = PyWeakref_NewRef(owner_list, NULL);
+    inserted->list_weakref = dllist_get_node_ref(owner_list);
+    Py_INCREF(inserted->list_weakref);
 }
 
 /* Convenience function for creating list nodes.
@@ -75,33 +112,23 @@ static DLListNodeObject* dllistnode_create(PyObject* prev,
                                            PyObject* owner_list)
 {
     DLListNodeObject *node;
-    PyObject* args = NULL;
+    LListArena* arena = dllist_get_arena(owner_list);
 
     assert(value != NULL);
 
-    if (value != Py_None)
-    {
-        args = PyTuple_New(1);
-        if (args == NULL)
-        {
-            PyErr_SetString(PyExc_RuntimeError,
-                "Failed to create argument tuple");
-            return NULL;
-        }
-
-        Py_INCREF(value);
-        if (PyTuple_SetItem(args, 0, value) != 0)
-        {
-            PyErr_SetString(PyExc_RuntimeError,
-                "Failed to initialize argument tuple");
-            return NULL;
-        }
-    }
-
-    node = (DLListNodeObject*)PyObject_CallObject(
-        (PyObject*)&DLListNodeType, args);
+    /* Nodes are allocated directly, without going through
+     * the node type constructor. Links are zeroed by tp_alloc. */
+    if (arena != NULL)
+        node = (DLListNodeObject*)llist_arena_alloc(
+            arena, dllist_get_size(owner_list));
+    else
+        node = (DLListNodeObject*)DLListNodeType.tp_alloc(&DLListNodeType, 0);
+    if (node == NULL)
+        return NULL;
 
-    Py_XDECREF(args);
+    Py_INCREF(value);
+    node->value = value;
+    dllistnode_update_gc(node);
 
     dllistnode_link(prev, next, node, owner_list);
 
@@ -113,24 +140,25 @@ static DLListNodeObject* dllistnode_create(PyObject* prev,
  */
 static void dllistnode_delete(DLListNodeObject* node)
 {
-    if (node->prev != Py_None)
+    if (node->prev != NULL)
     {
         DLListNodeObject* prev = (DLListNodeObject*)node->prev;
         prev->next = node->next;
     }
 
-    if (node->next != Py_None)
+    if (node->next != NULL)
     {
         DLListNodeObject* next = (DLListNodeObject*)node->next;
         next->prev = node->prev;
     }
 
-    node->prev = Py_None;
-    node->next = Py_None;
+    node->prev = NULL;
+    node->next = NULL;
 
-    Py_XDECREF(node->list_weakref);
-    Py_INCREF(Py_None);
-    node->list_weakref = Py_None;
+    /* see dllistnode_access */
+    Py_BEGIN_CRITICAL_SECTION(node);
+    Py_CLEAR(node->list_weakref);
+    Py_END_CRITICAL_SECTION();
 
     Py_DECREF((PyObject*)node);
 }
@@ -138,6 +166,7 @@ static void dllistnode_delete(DLListNodeObject* node)
 /* Convenience function for formatting list node to a string.
  * Pass PyObject_Repr or PyObject_Str in the fmt_func argument. */
 static PyObject* dllistnode_to_string(DLListNodeObject* self,
+                                      PyObject* value,
                                       reprfunc fmt_func,
                                       const char* prefix,
                                       const char* suffix)
@@ -154,7 +183,7 @@ static PyObject* dllistnode_to_string(DLListNodeObject* self,
     if (str == NULL)
         goto str_alloc_error;
 
-    tmp_str = fmt_func(self->value);
+    tmp_str = fmt_func(value);
     if (tmp_str == NULL)
         goto str_alloc_error;
     Py23String_ConcatAndDel(&str, tmp_str);
@@ -192,12 +221,6 @@ static int dllistnode_clear_refs(DLListNodeObject* self)
     Py_CLEAR(self->value);
     Py_CLEAR(self->list_weakref);
 
-    if ((self->flags & LLIST_HAS_PY_NONE_REF) != 0)
-    {
-        self->flags &= ~LLIST_HAS_PY_NONE_REF;
-        Py_DECREF(Py_None);
-    }
-
     return 0;
 }
 
@@ -221,22 +244,235 @@ static PyObject* dllistnode_new(PyTypeObject* type,
     if (self == NULL)
         return NULL;
 
-    /* A single reference to Py_None is held for the whole
-     * lifetime of a node. */
+    /* links and owner reference are zeroed by tp_alloc */
     Py_INCREF(Py_None);
-
     self->value = Py_None;
-    self->prev = Py_None;
-    self->next = Py_None;
-    self->list_weakref = Py_None;
-    self->flags = LLIST_HAS_PY_NONE_REF;
-
-    Py_INCREF(self->value);
-    Py_INCREF(self->list_weakref);
 
     return (PyObject*)self;
 }
 
+/* Signature of functions called by dllistnode_access. list is the list
+ * referred to by owner reference of the node, or NULL if the node does
+ * not refer to a live list. */
+typedef PyObject* (*dllistnode_accessor)(DLListNodeObject* node,
+                                         PyObject* list,
+                                         PyObject* arg);
+
+/* Return 1 if the node belongs to list passed to a dllistnode_accessor.
+ * Nodes detached by clear() in deferred mode refer to an old owner
+ * reference of the list. */
+static int dllistnode_in_list(DLListNodeObject* node, PyObject* list)
+{
+    return list != NULL && dllist_get_node_ref(list) == node->list_weakref;
+}
+
+/* Call func with the lock guarding value, links and owner reference of
+ * the node held. Nodes referring to a live list are guarded by critical
+ * section of that list, which list methods hold while modifying their
+ * nodes. Other nodes are guarded by their own critical section, which
+ * is also held while a free node is adopted by a list and while owner
+ * reference of a node is cleared.
+ * On free-threaded builds owner reference is read with the node locked,
+ * then the list and the node are locked together. This is retried if
+ * the node was moved to another list in the meantime. */
+static PyObject* dllistnode_access(DLListNodeObject* node,
+                                   dllistnode_accessor func,
+                                   PyObject* arg)
+{
+#ifdef Py_GIL_DISABLED
+    PyObject* result = NULL;
+    int done = 0;
+
+    while (!done)
+    {
+        PyObject* owner_ref = NULL;
+        PyObject* list = NULL;
+
+        Py_BEGIN_CRITICAL_SECTION(node);
+        if (node->list_weakref == NULL ||
+            PyWeakref_GetRef(node->list_weakref, &list) <= 0)
+        {
+            result = func(node, NULL, arg);
+            done = 1;
+        }
+        else
+        {
+            owner_ref = node->list_weakref;
+            Py_INCREF(owner_ref);
+        }
+        Py_END_CRITICAL_SECTION();
+
+        if (done)
+            break;
+
+        Py_BEGIN_CRITICAL_SECTION2(list, node);
+        if (node->list_weakref == owner_ref)
+        {
+            result = func(node, list, arg);
+            done = 1;
+        }
+        Py_END_CRITICAL_SECTION2();
+
+        Py_DECREF(owner_ref);
+        Py_DECREF(list);
+    }
+
+    return result;
+#else
+    PyObject* list = NULL;
+
+    if (node->list_weakref != NULL)
+    {
+        list = PyWeakref_GetObject(node->list_weakref);
+        if (list == Py_None)
+            list = NULL;
+    }
+
+    return func(node, list, arg);
+#endif
+}
+
+static PyObject* dllistnode_value_locked(DLListNodeObject* node,
+                                         PyObject* list,
+                                         PyObject* unused)
+{
+    Py_INCREF(node->value);
+    return node->value;
+}
+
+/* Returns the replaced value, which should be released after the node
+ * is unlocked. */
+static PyObject* dllistnode_swap_value_locked(DLListNodeObject* node,
+                                              PyObject* list,
+                                              PyObject* value)
+{
+    PyObject* oldval = node->value;
+
+    Py_INCREF(value);
+    node->value = value;
+    dllistnode_update_gc(node);
+
+    return oldval;
+}
+
+static PyObject* dllistnode_owner_locked(DLListNodeObject* node,
+                                         PyObject* list,
+                                         PyObject* unused)
+{
+    PyObject* owner = node->list_weakref;
+
+    /* nodes detached by clear() or deletion of a list in deferred mode
+     * are not owned */
+    if (!dllistnode_in_list(node, list))
+        Py_RETURN_NONE;
+
+    Py_INCREF(owner);
+    return owner;
+}
+
+/* Check whether node can be adopted by a list. Nodes detached by clear()
+ * or deletion of a list in deferred mode are not owned, but stay chained
+ * until they are released, so all pending nodes are released before such
+ * a node is adopted. Returns 0 and sets ValueError with message if the
+ * node belongs to a list. */
+static int dllistnode_check_free(DLListNodeObject* node, const char* message)
+{
+    if (node->list_weakref != NULL)
+    {
+        PyObject* owner = dllistnode_access(node, dllistnode_owner_locked, NULL);
+
+        if (owner == Py_None)
+            llist_release_pending(-1);
+        Py_DECREF(owner);
+    }
+
+    if (node->list_weakref != NULL
+        || node->prev != NULL
+        || node->next != NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, message);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* Links are exposed only for nodes in a list, nodes detached by clear()
+ * in deferred mode are chained only until they are released.
+ * If wrap is not NULL, the last node is followed by the first one. */
+static PyObject* dllistnode_next_locked(DLListNodeObject* node,
+                                        PyObject* list,
+                                        PyObject* wrap)
+{
+    PyObject* next = NULL;
+
+    if (dllistnode_in_list(node, list))
+    {
+        next = node->next;
+        if (next == NULL && wrap != NULL)
+            next = dllist_get_first(list);
+    }
+
+    if (next == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(next);
+    return next;
+}
+
+static PyObject* dllistnode_prev_locked(DLListNodeObject* node,
+                                        PyObject* list,
+                                        PyObject* wrap)
+{
+    PyObject* prev = NULL;
+
+    if (dllistnode_in_list(node, list))
+    {
+        prev = node->prev;
+        if (prev == NULL && wrap != NULL)
+            prev = dllist_get_last(list);
+    }
+
+    if (prev == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(prev);
+    return prev;
+}
+
+static PyObject* dllistnode_get_value(DLListNodeObject* self, void* closure)
+{
+    return dllistnode_access(self, dllistnode_value_locked, NULL);
+}
+
+static int dllistnode_set_value(DLListNodeObject* self, PyObject* value, void* closure)
+{
+    PyObject* oldval;
+
+    if (value == NULL)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete node value");
+        return -1;
+    }
+
+    /* Py_DECREF may evaluate its argument more than once on Python 2 */
+    oldval = dllistnode_access(self, dllistnode_swap_value_locked, value);
+    Py_DECREF(oldval);
+
+    return 0;
+}
+
+/* Methods inserting a node as an item insert its value instead.
+ * Returns a new reference to the inserted value. */
+static PyObject* dllistnode_unwrap_value(PyObject* item)
+{
+    if (PyObject_TypeCheck(item, &DLListNodeType))
+        return dllistnode_get_value((DLListNodeObject*)item, NULL);
+
+    Py_INCREF(item);
+    return item;
+}
+
 static int dllistnode_init(DLListNodeObject* self,
                            PyObject* args,
                            PyObject* kwds)
@@ -250,41 +486,76 @@ static int dllistnode_init(DLListNodeObject* self,
         return 0;
 
     /* initialize node using passed value */
-    Py_DECREF(self->value);
-    Py_INCREF(value);
-    self->value = value;
-
-    return 0;
+    return dllistnode_set_value(self, value, NULL);
 }
 
 static PyObject* dllistnode_call(DLListNodeObject* self,
                                  PyObject* args,
                                  PyObject* kw)
 {
-    Py_INCREF(self->value);
-    return self->value;
+    return dllistnode_get_value(self, NULL);
 }
 
 static PyObject* dllistnode_repr(DLListNodeObject* self)
 {
-    return dllistnode_to_string(self, PyObject_Repr, "<dllistnode(", ")>");
+    PyObject* value = dllistnode_get_value(self, NULL);
+    PyObject* str = dllistnode_to_string(
+        self, value, PyObject_Repr, "<dllistnode(", ")>");
+
+    Py_DECREF(value);
+    return str;
 }
 
 static PyObject* dllistnode_str(DLListNodeObject* self)
 {
-    return dllistnode_to_string(self, PyObject_Str, "dllistnode(", ")");
+    PyObject* value = dllistnode_get_value(self, NULL);
+    PyObject* str = dllistnode_to_string(
+        self, value, PyObject_Str, "dllistnode(", ")");
+
+    Py_DECREF(value);
+    return str;
 }
 
-static PyMemberDef DLListNodeMembers[] =
+static PyObject* dllistnode_get_owner(DLListNodeObject* self, void* closure)
 {
-    { "value", T_OBJECT_EX, offsetof(DLListNodeObject, value), 0,
-      "Value stored in node" },
-    { "prev", T_OBJECT_EX, offsetof(DLListNodeObject, prev), READONLY,
-      "Previous node" },
-    { "next", T_OBJECT_EX, offsetof(DLListNodeObject, next), READONLY,
-      "Next node" },
-    { "owner", T_OBJECT_EX, offsetof(DLListNodeObject, list_weakref), READONLY,
-      "List that this node belongs to" },
+    return dllistnode_access(self, dllistnode_owner_locked, NULL);
+}
+
+static PyObject* dllistnode_get_next(DLListNodeObject* self, void* closure)
+{
+    return dllistnode_access(self, dllistnode_next_locked, NULL);
+}
+
+static PyObject* dllistnode_get_prev(DLListNodeObject* self, void* closure)
+{
+    return dllistnode_access(self, dllistnode_prev_locked, NULL);
+}
+
+static PyObject* dllistnode_get_nextwrap(DLListNodeObject* self, void* closure)
+{
+    return dllistnode_access(self, dllistnode_next_locked, Py_True);
+}
+
+static PyObject* dllistnode_get_prevwrap(DLListNodeObject* self, void* closure)
+{
+    return dllistnode_access(self, dllistnode_prev_locked, Py_True);
+}
+
+static PyGetSetDef DLListNodeGetSetters[] =
+{
+    { "value", (getter)dllistnode_get_value, (setter)dllistnode_set_value,
+      "Value stored in node", NULL },
+    { "prev", (getter)dllistnode_get_prev, llist_readonly_setter,
+      "Previous node", NULL },
+    { "next", (getter)dllistnode_get_next, llist_readonly_setter,
+      "Next node", NULL },
+    { "owner", (getter)dllistnode_get_owner, llist_readonly_setter,
+      "List that this node belongs to", NULL },
+    { "nextwrap", (getter)dllistnode_get_nextwrap, NULL,
+      "Next node, or the first node of the list after the last one", NULL },
+    { "prevwrap", (getter)dllistnode_get_prevwrap, NULL,
+      "Previous node, or the last node of the list before the first one",
+      NULL },
     { NULL },   /* sentinel */
 };
 
@@ -320,8 +591,8 @@ static PyTypeObject DLListNodeType =
     0,                              /* tp_iter */
     0,                              /* tp_iternext */
     0,                              /* tp_methods */
-    DLListNodeMembers,              /* tp_members */
-    0,                              /* tp_getset */
+    0,                              /* tp_members */
+    DLListNodeGetSetters,           /* tp_getset */
     0,                              /* tp_base */
     0,                              /* tp_dict */
     0,                              /* tp_descr_get */
@@ -330,11 +601,14 @@ static PyTypeObject DLListNodeType =
     (initproc)dllistnode_init,      /* tp_init */
     0,                              /* tp_alloc */
     dllistnode_new,                 /* tp_new */
+    llist_arena_free,               /* tp_free */
 };
 
 
 /* DLList */
 
+/* Links between nodes, first, last and last_accessed_node are NULL
+ * at the ends of the list. They are exposed to Python as None. */
 typedef struct
 {
     PyObject_HEAD
@@ -344,9 +618,39 @@ typedef struct
     Py_ssize_t last_accessed_idx;
     Py_ssize_t size;
     PyObject* weakref_list;
+    /* weak reference to the list shared by all nodes in the list,
+     * replaced when nodes are detached by deferred clear() */
+    PyObject* node_ref;
+    /* NULL unless nodes are allocated from an arena */
+    LListArena* arena;
     unsigned char flags;
 } DLListObject;
 
+static PyObject* dllist_get_node_ref(PyObject* list)
+{
+    return ((DLListObject*)list)->node_ref;
+}
+
+static LListArena* dllist_get_arena(PyObject* list)
+{
+    return ((DLListObject*)list)->arena;
+}
+
+static Py_ssize_t dllist_get_size(PyObject* list)
+{
+    return ((DLListObject*)list)->size;
+}
+
+static PyObject* dllist_get_first(PyObject* list)
+{
+    return ((DLListObject*)list)->first;
+}
+
+static PyObject* dllist_get_last(PyObject* list)
+{
+    return ((DLListObject*)list)->last;
+}
+
 static Py_ssize_t py_ssize_t_abs(Py_ssize_t x)
 {
     return (x >= 0) ? x : -x;
@@ -383,7 +687,7 @@ static DLListNodeObject* dllist_get_node_internal(DLListObject* self,
     }
 
     /* check if last accessed index is closer */
-    if (self->last_accessed_node != Py_None &&
+    if (self->last_accessed_node != NULL &&
         self->last_accessed_idx >= 0 &&
         py_ssize_t_abs(index - self->last_accessed_idx) < middle)
     {
@@ -392,7 +696,7 @@ static DLListNodeObject* dllist_get_node_internal(DLListObject* self,
         reverse_dir = (index < self->last_accessed_idx) ? 1 : 0;
     }
 
-    assert((PyObject*)node != Py_None);
+    assert(node != NULL);
 
     if (!reverse_dir)
     {
@@ -411,8 +715,11 @@ static DLListNodeObject* dllist_get_node_internal(DLListObject* self,
 }
 
 /* Convenience function for extending (concatenating in-place)
- * the list with elements from a sequence. */
-static int dllist_extend_internal(DLListObject* self, PyObject* sequence)
+ * the list with elements from a sequence. If nodes is not NULL,
+ * created nodes are appended to it. */
+static int dllist_extend_internal(DLListObject* self,
+                                  PyObject* sequence,
+                                  PyObject* nodes)
 {
     Py_ssize_t i;
     Py_ssize_t sequence_len;
@@ -425,18 +732,25 @@ static int dllist_extend_internal(DLListObject* self, PyObject* sequence)
         PyObject* iter_node_obj = ((DLListObject*)sequence)->first;
         PyObject* last_node_obj = self->last;
 
-        while (iter_node_obj != Py_None)
+        while (iter_node_obj != NULL)
         {
             DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
             PyObject* new_node;
 
             new_node = (PyObject*)dllistnode_create(
                 self->last, NULL, iter_node->value, (PyObject*)self);
+            if (new_node == NULL)
+                return 0;
 
-            if (self->first == Py_None)
+            if (self->first == NULL)
                 self->first = new_node;
             self->last = new_node;
 
+            ++self->size;
+
+            if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+                return 0;
+
             if (iter_node_obj == last_node_obj)
             {
                 /* This is needed to terminate loop if self == sequence. */
@@ -446,8 +760,6 @@ static int dllist_extend_internal(DLListObject* self, PyObject* sequence)
             iter_node_obj = iter_node->next;
         }
 
-        self->size += ((DLListObject*)sequence)->size;
-
         return 1;
     }
 
@@ -473,14 +785,18 @@ static int dllist_extend_internal(DLListObject* self, PyObject* sequence)
 
         new_node = (PyObject*)dllistnode_create(
             self->last, NULL, item, (PyObject*)self);
+        Py_DECREF(item);
+        if (new_node == NULL)
+            return 0;
 
-        if (self->first == Py_None)
+        if (self->first == NULL)
             self->first = new_node;
         self->last = new_node;
 
         ++self->size;
 
-        Py_DECREF(item);
+        if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+            return 0;
     }
 
     return 1;
@@ -501,7 +817,7 @@ static PyObject* dllist_to_string(DLListObject* self,
     if (Py_ReprEnter((PyObject*)self) > 0)
         return Py23String_FromString("dllist(<...>)");
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
     {
         str = Py23String_FromString("dllist()");
         if (str == NULL)
@@ -517,7 +833,7 @@ static PyObject* dllist_to_string(DLListObject* self,
     if (comma_str == NULL)
         goto str_alloc_error;
 
-    while ((PyObject*)node != Py_None)
+    while (node != NULL)
     {
         if (node != (DLListNodeObject*)self->first)
             Py23String_Concat(&str, comma_str);
@@ -556,25 +872,69 @@ static int dllist_traverse(DLListObject* self, visitproc visit, void* arg)
 {
     PyObject* node = self->first;
 
-    if (node != NULL)
+    while (node != NULL)
     {
-        while (node != Py_None)
-        {
-            PyObject* next_node = ((DLListNodeObject*)node)->next;
-            Py_VISIT(node);
-            node = next_node;
-        }
+        PyObject* next_node = ((DLListNodeObject*)node)->next;
+        Py_VISIT(node);
+        node = next_node;
     }
 
+    Py_VISIT(self->node_ref);
+
     return 0;
 }
 
 static void dllist_invalidate_last_access_cache(DLListObject* self)
 {
-    self->last_accessed_node = Py_None;
+    self->last_accessed_node = NULL;
     self->last_accessed_idx = -1;
 }
 
+/* Release function for chains of nodes detached in deferred mode
+ * (see deferred.h). */
+static Py_ssize_t dllist_release_nodes(PyObject** head, Py_ssize_t budget)
+{
+    PyObject* node = *head;
+    Py_ssize_t released = 0;
+
+    while (node != NULL && released < budget)
+    {
+        PyObject* next_node = ((DLListNodeObject*)node)->next;
+        dllistnode_delete((DLListNodeObject*)node);
+        node = next_node;
+        ++released;
+    }
+
+    *head = node;
+
+    return released;
+}
+
+/* Move all nodes of the list to the queue of pending nodes, which are
+ * released incrementally. Returns 0 if nodes could not be queued. */
+static int dllist_detach_nodes(DLListObject* self)
+{
+    if (self->size == 0)
+        return 1;
+
+    if (!llist_defer_release(self->first, self->size, dllist_release_nodes))
+        return 0;
+
+    self->first = NULL;
+    self->last = NULL;
+    self->size = 0;
+
+    return 1;
+}
+
+/* Release a slice of pending nodes if the list is in deferred mode.
+ * Called at the start of operations which insert nodes. */
+static void dllist_release_step(DLListObject* self)
+{
+    if ((self->flags & LLIST_DEFERRED_RELEASE) != 0)
+        llist_release_pending(LLIST_RELEASE_STEP);
+}
+
 static int dllist_clear_refs(DLListObject* self)
 {
     PyObject* node = self->first;
@@ -584,23 +944,19 @@ static int dllist_clear_refs(DLListObject* self)
 
     self->first = NULL;
     self->last = NULL;
+    self->last_accessed_node = NULL;
+    self->last_accessed_idx = -1;
+    self->size = 0;
     self->weakref_list = NULL;
 
-    if (node != NULL)
+    while (node != NULL)
     {
-        while (node != Py_None)
-        {
-            PyObject* next_node = ((DLListNodeObject*)node)->next;
-            dllistnode_delete((DLListNodeObject*)node);
-            node = next_node;
-        }
+        PyObject* next_node = ((DLListNodeObject*)node)->next;
+        dllistnode_delete((DLListNodeObject*)node);
+        node = next_node;
     }
 
-    if ((self->flags & LLIST_HAS_PY_NONE_REF) != 0)
-    {
-        self->flags &= ~LLIST_HAS_PY_NONE_REF;
-        Py_DECREF(Py_None);
-    }
+    Py_CLEAR(self->node_ref);
 
     return 0;
 }
@@ -610,7 +966,12 @@ static void dllist_dealloc(DLListObject* self)
     PyObject_GC_UnTrack(self);
     PyObject* obj_self = (PyObject*)self;
 
+    /* nodes which cannot be queued are released by dllist_clear_refs */
+    if ((self->flags & LLIST_DEFERRED_RELEASE) != 0 && self->first != NULL)
+        dllist_detach_nodes(self);
+
     dllist_clear_refs(self);
+    llist_arena_enable(&self->arena, &DLListNodeType, 0);
 
     obj_self->ob_type->tp_free(obj_self);
 }
@@ -625,28 +986,46 @@ static PyObject* dllist_new(PyTypeObject* type,
     if (self == NULL)
         return NULL;
 
-    /* A single reference to Py_None is held for the whole
-     * lifetime of a list. */
-    Py_INCREF(Py_None);
-
-    self->first = Py_None;
-    self->last = Py_None;
-    self->last_accessed_node = Py_None;
+    self->first = NULL;
+    self->last = NULL;
+    self->last_accessed_node = NULL;
     self->last_accessed_idx = -1;
     self->size = 0;
     self->weakref_list = NULL;
-    self->flags = LLIST_HAS_PY_NONE_REF;
+    self->node_ref = NULL;
+    self->arena = NULL;
+    self->flags = 0;
+
+    self->node_ref = llist_new_owner_ref((PyObject*)self);
+    if (self->node_ref == NULL)
+    {
+        Py_DECREF(self);
+        return NULL;
+    }
 
     return (PyObject*)self;
 }
 
 static int dllist_init(DLListObject* self, PyObject* args, PyObject* kwds)
 {
+    static char* kwlist[] = { "iterable", "deferred", "arena", NULL };
+
     PyObject* sequence = NULL;
+    int deferred = 0;
+    int arena = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oii:dllist", kwlist,
+                                     &sequence, &deferred, &arena))
+        return -1;
 
-    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &sequence))
+    if (!llist_arena_enable(&self->arena, &DLListNodeType, arena))
         return -1;
 
+    if (deferred)
+        self->flags |= LLIST_DEFERRED_RELEASE;
+    else
+        self->flags &= ~LLIST_DEFERRED_RELEASE;
+
     if (sequence == NULL)
         return 0;
 
@@ -657,7 +1036,7 @@ static int dllist_init(DLListObject* self, PyObject* args, PyObject* kwds)
         return -1;
     }
 
-    return dllist_extend_internal(self, sequence) ? 0 : -1;
+    return dllist_extend_internal(self, sequence, NULL) ? 0 : -1;
 }
 
 static PyObject* dllist_node_at(PyObject* self, PyObject* indexObject)
@@ -704,7 +1083,7 @@ static long dllist_hash(DLListObject* self)
     long hash = 0;
     PyObject* iter_node_obj = self->first;
 
-    while (iter_node_obj != Py_None)
+    while (iter_node_obj != NULL)
     {
         long obj_hash;
         DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
@@ -750,8 +1129,7 @@ static PyObject* dllist_richcompare(DLListObject* self,
     self_node = (DLListNodeObject*)self->first;
     other_node = (DLListNodeObject*)other->first;
 
-    while ((PyObject*)self_node != Py_None &&
-            (PyObject*)other_node != Py_None)
+    while (self_node != NULL && other_node != NULL)
     {
         satisfied = PyObject_RichCompareBool(
             self_node->value, other_node->value, Py_EQ);
@@ -770,7 +1148,7 @@ static PyObject* dllist_richcompare(DLListObject* self,
     if (satisfied)
     {
         /* At least one of operands has been fully traversed.
-         * Either self_node or other_node is equal to Py_None. */
+         * Either self_node or other_node is NULL. */
         switch (op)
         {
         case Py_EQ:
@@ -780,16 +1158,16 @@ static PyObject* dllist_richcompare(DLListObject* self,
             satisfied = (self_node != other_node);
             break;
         case Py_LT:
-            satisfied = ((PyObject*)other_node != Py_None);
+            satisfied = (other_node != NULL);
             break;
         case Py_GT:
-            satisfied = ((PyObject*)self_node != Py_None);
+            satisfied = (self_node != NULL);
             break;
         case Py_LE:
-            satisfied = ((PyObject*)self_node == Py_None);
+            satisfied = (self_node == NULL);
             break;
         case Py_GE:
-            satisfied = ((PyObject*)other_node == Py_None);
+            satisfied = (other_node == NULL);
             break;
         default:
             assert(0 && "Invalid rich compare operator");
@@ -813,15 +1191,20 @@ static PyObject* dllist_richcompare(DLListObject* self,
 static PyObject* dllist_appendleft(DLListObject* self, PyObject* arg)
 {
     DLListNodeObject* new_node;
+    PyObject* value;
 
-    if (PyObject_TypeCheck(arg, &DLListNodeType))
-        arg = ((DLListNodeObject*)arg)->value;
+    dllist_release_step(self);
 
-    new_node = dllistnode_create(NULL, self->first, arg, (PyObject*)self);
+    value = dllistnode_unwrap_value(arg);
+
+    new_node = dllistnode_create(NULL, self->first, value, (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     self->first = (PyObject*)new_node;
 
-    if (self->last == Py_None)
+    if (self->last == NULL)
         self->last = (PyObject*)new_node;
 
     if (self->last_accessed_idx >= 0)
@@ -836,15 +1219,20 @@ static PyObject* dllist_appendleft(DLListObject* self, PyObject* arg)
 static PyObject* dllist_appendright(DLListObject* self, PyObject* arg)
 {
     DLListNodeObject* new_node;
+    PyObject* value;
+
+    dllist_release_step(self);
 
-    if (PyObject_TypeCheck(arg, &DLListNodeType))
-        arg = ((DLListNodeObject*)arg)->value;
+    value = dllistnode_unwrap_value(arg);
 
-    new_node = dllistnode_create(self->last, NULL, arg, (PyObject*)self);
+    new_node = dllistnode_create(self->last, NULL, value, (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     self->last = (PyObject*)new_node;
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
         self->first = (PyObject*)new_node;
 
     ++self->size;
@@ -855,6 +1243,8 @@ static PyObject* dllist_appendright(DLListObject* self, PyObject* arg)
 
 static PyObject* dllist_appendnode(DLListObject* self, PyObject* arg)
 {
+    dllist_release_step(self);
+
     if (!PyObject_TypeCheck(arg, &DLListNodeType))
     {
         PyErr_SetString(PyExc_TypeError, "Argument must be a dllistnode");
@@ -863,17 +1253,12 @@ static PyObject* dllist_appendnode(DLListObject* self, PyObject* arg)
 
     DLListNodeObject* node = (DLListNodeObject*) arg;
 
-    if (node->list_weakref != Py_None
-        || node->prev != Py_None
-        || node->next != Py_None)
-    {
-        PyErr_SetString(PyExc_ValueError,
-            "Argument node must not belong to a list");
+    if (!dllistnode_check_free(node,
+            "Argument node must not belong to a list"))
         return NULL;
-    }
 
     /* appending to empty list */
-    if(self->first == Py_None)
+    if(self->first == NULL)
         self->first = (PyObject*)node;
     /* setting next of last element as new node */
     else
@@ -885,8 +1270,8 @@ static PyObject* dllist_appendnode(DLListObject* self, PyObject* arg)
     /* allways set last node to new node */
     self->last = (PyObject*)node;
 
-    Py_DECREF(node->list_weakref);
-    node->list_weakref = PyWeakref_NewRef((PyObject*) self, NULL);
+    node->list_weakref = self->node_ref;
+    Py_INCREF(node->list_weakref);
 
     Py_INCREF((PyObject*)node);
     ++self->size;
@@ -906,16 +1291,14 @@ static int dllist_validate_ref_node(DLListObject* self, PyObject* ref_node)
 
     PyObject* list_weakref = ((DLListNodeObject*)ref_node)->list_weakref;
 
-    if (list_weakref == Py_None)
+    if (list_weakref == NULL)
     {
         PyErr_SetString(PyExc_ValueError,
             "dllistnode does not belong to a list");
         return 0;
     }
 
-    PyObject* list_ref = PyWeakref_GetObject(list_weakref);
-
-    if (list_ref != (PyObject*)self)
+    if (list_weakref != self->node_ref)
     {
         PyErr_SetString(PyExc_ValueError,
             "dllistnode belongs to another list");
@@ -931,36 +1314,48 @@ static PyObject* dllist_insert(DLListObject* self, PyObject* args)
     PyObject* ref_node = NULL;
     DLListNodeObject* new_node;
 
+    dllist_release_step(self);
+
     if (!PyArg_UnpackTuple(args, "insert", 1, 2, &val, &ref_node))
         return NULL;
 
-    if (PyObject_TypeCheck(val, &DLListNodeType))
-        val = ((DLListNodeObject*)val)->value;
+    /* the value is read before ref_node is validated, as reading it may
+     * release the list lock for a while on free-threaded builds */
+    val = dllistnode_unwrap_value(val);
 
     if (ref_node == NULL || ref_node == Py_None)
     {
         /* append item at the end of the list */
         new_node = dllistnode_create(self->last, NULL, val, (PyObject*)self);
+        Py_DECREF(val);
+        if (new_node == NULL)
+            return NULL;
 
         self->last = (PyObject*)new_node;
 
-        if (self->first == Py_None)
+        if (self->first == NULL)
             self->first = (PyObject*)new_node;
     }
     else
     {
         if (!dllist_validate_ref_node(self, ref_node))
+        {
+            Py_DECREF(val);
             return NULL;
+        }
 
         /* insert item before ref_node */
         new_node = dllistnode_create(
             ((DLListNodeObject*)ref_node)->prev,
             ref_node, val, (PyObject*)self);
+        Py_DECREF(val);
+        if (new_node == NULL)
+            return NULL;
 
         if (ref_node == self->first)
             self->first = (PyObject*)new_node;
 
-        if (self->last == Py_None)
+        if (self->last == NULL)
             self->last = (PyObject*)new_node;
 
         dllist_invalidate_last_access_cache(self);
@@ -977,20 +1372,27 @@ static PyObject* dllist_insertbefore(DLListObject* self, PyObject* args)
     PyObject* value = NULL;
     PyObject* ref = NULL;
 
+    dllist_release_step(self);
+
     if (!PyArg_UnpackTuple(args, "insertbefore", 2, 2, &value, &ref))
         return NULL;
 
+    /* if inserted item is a node, extract and insert its value instead */
+    value = dllistnode_unwrap_value(value);
+
     if (!dllist_validate_ref_node(self, ref))
+    {
+        Py_DECREF(value);
         return NULL;
-
-    /* if inserted item is a node, extract and insert its value instead */
-    if (PyObject_TypeCheck(value, &DLListNodeType))
-        value = ((DLListNodeObject*)value)->value;
+    }
 
     DLListNodeObject* ref_node = (DLListNodeObject*)ref;
 
     DLListNodeObject* new_node = dllistnode_create(
         ref_node->prev, ref, value, (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     if (ref == self->first)
         self->first = (PyObject*)new_node;
@@ -1008,20 +1410,27 @@ static PyObject* dllist_insertafter(DLListObject* self, PyObject* args)
     PyObject* value = NULL;
     PyObject* ref = NULL;
 
+    dllist_release_step(self);
+
     if (!PyArg_UnpackTuple(args, "insertafter", 2, 2, &value, &ref))
         return NULL;
 
+    /* if inserted item is a node, extract and insert its value instead */
+    value = dllistnode_unwrap_value(value);
+
     if (!dllist_validate_ref_node(self, ref))
+    {
+        Py_DECREF(value);
         return NULL;
-
-    /* if inserted item is a node, extract and insert its value instead */
-    if (PyObject_TypeCheck(value, &DLListNodeType))
-        value = ((DLListNodeObject*)value)->value;
+    }
 
     DLListNodeObject* ref_node = (DLListNodeObject*)ref;
 
     DLListNodeObject* new_node = dllistnode_create(
         ref, ref_node->next, value, (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     if (ref == self->last)
         self->last = (PyObject*)new_node;
@@ -1045,16 +1454,8 @@ static int dllist_validate_inserted_node(DLListObject* self, PyObject* inserted)
 
     DLListNodeObject* inserted_node = (DLListNodeObject*)inserted;
 
-    if (inserted_node->list_weakref != Py_None
-        || inserted_node->prev != Py_None
-        || inserted_node->next != Py_None)
-    {
-        PyErr_SetString(PyExc_ValueError,
-            "Inserted node must not belong to a list");
-        return 0;
-    }
-
-    return 1;
+    return dllistnode_check_free(inserted_node,
+        "Inserted node must not belong to a list");
 }
 
 static PyObject* dllist_insertnode(DLListObject* self, PyObject* args)
@@ -1062,6 +1463,8 @@ static PyObject* dllist_insertnode(DLListObject* self, PyObject* args)
     PyObject* inserted = NULL;
     PyObject* ref = NULL;
 
+    dllist_release_step(self);
+
     if (!PyArg_UnpackTuple(args, "insertnode", 1, 2, &inserted, &ref))
         return NULL;
 
@@ -1077,7 +1480,7 @@ static PyObject* dllist_insertnode(DLListObject* self, PyObject* args)
 
         self->last = inserted;
 
-        if (self->first == Py_None)
+        if (self->first == NULL)
             self->first = inserted;
     }
     else
@@ -1093,7 +1496,7 @@ static PyObject* dllist_insertnode(DLListObject* self, PyObject* args)
         if (ref == self->first)
             self->first = inserted;
 
-        if (self->last == Py_None)
+        if (self->last == NULL)
             self->last = inserted;
 
         dllist_invalidate_last_access_cache(self);
@@ -1111,6 +1514,8 @@ static PyObject* dllist_insertnodebefore(DLListObject* self, PyObject* args)
     PyObject* inserted = NULL;
     PyObject* ref = NULL;
 
+    dllist_release_step(self);
+
     if (!PyArg_UnpackTuple(args, "insertnodebefore", 2, 2, &inserted, &ref))
         return NULL;
 
@@ -1142,6 +1547,8 @@ static PyObject* dllist_insertnodeafter(DLListObject* self, PyObject* args)
     PyObject* inserted = NULL;
     PyObject* ref = NULL;
 
+    dllist_release_step(self);
+
     if (!PyArg_UnpackTuple(args, "insertnodeafter", 2, 2, &inserted, &ref))
         return NULL;
 
@@ -1168,7 +1575,11 @@ static PyObject* dllist_insertnodeafter(DLListObject* self, PyObject* args)
     return inserted;
 }
 
-static PyObject* dllist_extendleft(DLListObject* self, PyObject* sequence)
+/* Prepend elements of a sequence to the list, in reverse order.
+ * If nodes is not NULL, created nodes are appended to it. */
+static int dllist_extendleft_internal(DLListObject* self,
+                                      PyObject* sequence,
+                                      PyObject* nodes)
 {
     Py_ssize_t i;
     Py_ssize_t sequence_len;
@@ -1181,18 +1592,29 @@ static PyObject* dllist_extendleft(DLListObject* self, PyObject* sequence)
         PyObject* iter_node_obj = ((DLListObject*)sequence)->first;
         PyObject* last_node_obj = ((DLListObject*)sequence)->last;
 
-        while (iter_node_obj != Py_None)
+        while (iter_node_obj != NULL)
         {
             DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
             PyObject* new_node;
 
             new_node = (PyObject*)dllistnode_create(
                 NULL, self->first, iter_node->value, (PyObject*)self);
+            if (new_node == NULL)
+                return 0;
 
             self->first = new_node;
-            if (self->last == Py_None)
+            if (self->last == NULL)
                 self->last = new_node;
 
+            ++self->size;
+
+            /* update index of last accessed item */
+            if (self->last_accessed_idx >= 0)
+                ++self->last_accessed_idx;
+
+            if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+                return 0;
+
             if (iter_node_obj == last_node_obj)
             {
                 /* This is needed to terminate loop if self == sequence. */
@@ -1202,20 +1624,14 @@ static PyObject* dllist_extendleft(DLListObject* self, PyObject* sequence)
             iter_node_obj = iter_node->next;
         }
 
-        self->size += ((DLListObject*)sequence)->size;
-
-        /* update index of last accessed item */
-        if (self->last_accessed_idx >= 0)
-            self->last_accessed_idx += ((DLListObject*)sequence)->size;
-
-        Py_RETURN_NONE;
+        return 1;
     }
 
     sequence_len = PySequence_Length(sequence);
     if (sequence_len == -1)
     {
         PyErr_SetString(PyExc_ValueError, "Invalid sequence");
-        return NULL;
+        return 0;
     }
 
     for (i = 0; i < sequence_len; ++i)
@@ -1228,14 +1644,17 @@ static PyObject* dllist_extendleft(DLListObject* self, PyObject* sequence)
         {
             PyErr_SetString(PyExc_ValueError,
                 "Failed to get element from sequence");
-            return NULL;
+            return 0;
         }
 
         new_node = (PyObject*)dllistnode_create(
             NULL, self->first, item, (PyObject*)self);
+        Py_DECREF(item);
+        if (new_node == NULL)
+            return 0;
 
         self->first = new_node;
-        if (self->last == Py_None)
+        if (self->last == NULL)
             self->last = new_node;
 
         ++self->size;
@@ -1244,38 +1663,121 @@ static PyObject* dllist_extendleft(DLListObject* self, PyObject* sequence)
         if (self->last_accessed_idx >= 0)
             ++self->last_accessed_idx;
 
-        Py_DECREF(item);
+        if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+            return 0;
     }
 
+    return 1;
+}
+
+static PyObject* dllist_extendleft(DLListObject* self, PyObject* sequence)
+{
+    dllist_release_step(self);
+
+    if (!dllist_extendleft_internal(self, sequence, NULL))
+        return NULL;
+
     Py_RETURN_NONE;
 }
 
+static PyObject* dllist_extendleftnodes(DLListObject* self,
+                                        PyObject* sequence)
+{
+    PyObject* nodes;
+
+    dllist_release_step(self);
+
+    nodes = PyList_New(0);
+    if (nodes == NULL)
+        return NULL;
+
+    if (!dllist_extendleft_internal(self, sequence, nodes))
+    {
+        Py_DECREF(nodes);
+        return NULL;
+    }
+
+    return nodes;
+}
+
 static PyObject* dllist_extendright(DLListObject* self, PyObject* arg)
 {
-    if (!dllist_extend_internal(self, arg))
+    dllist_release_step(self);
+
+    if (!dllist_extend_internal(self, arg, NULL))
         return NULL;
 
     Py_RETURN_NONE;
 }
 
+static PyObject* dllist_extendnodes(DLListObject* self, PyObject* arg)
+{
+    PyObject* nodes;
+
+    dllist_release_step(self);
+
+    nodes = PyList_New(0);
+    if (nodes == NULL)
+        return NULL;
+
+    if (!dllist_extend_internal(self, arg, nodes))
+    {
+        Py_DECREF(nodes);
+        return NULL;
+    }
+
+    return nodes;
+}
+
 static PyObject* dllist_clear(DLListObject* self)
 {
-    PyObject* iter_node_obj = self->first;
+    PyObject* iter_node_obj;
 
-    while (iter_node_obj != Py_None)
+    dllist_release_step(self);
+
+    /* blocks of the arena are freed along with the last of their nodes */
+    if (self->arena != NULL)
+        llist_arena_reset(self->arena);
+
+    if ((self->flags & LLIST_DEFERRED_RELEASE) != 0 && self->size > 0)
     {
-        DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
+        /* Detached nodes still refer to the old node_ref, so they are
+         * no longer recognized as members of the list. */
+        PyObject* old_node_ref = self->node_ref;
+        PyObject* new_node_ref = llist_new_owner_ref((PyObject*)self);
 
-        iter_node_obj = iter_node->next;
-        dllistnode_delete(iter_node);
+        if (new_node_ref == NULL)
+            return NULL;
+
+        if (dllist_detach_nodes(self))
+        {
+            self->node_ref = new_node_ref;
+            Py_DECREF(old_node_ref);
+            dllist_invalidate_last_access_cache(self);
+            Py_RETURN_NONE;
+        }
+
+        Py_DECREF(new_node_ref);
     }
 
+    iter_node_obj = self->first;
+
+    /* the list is emptied first, as deleting nodes may run finalizers
+     * of their values */
     dllist_invalidate_last_access_cache(self);
 
-    self->first = Py_None;
-    self->last = Py_None;
+    self->first = NULL;
+    self->last = NULL;
     self->size = 0;
 
+    while (iter_node_obj != NULL)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
+
+        iter_node_obj = iter_node->next;
+        dllistnode_delete(iter_node);
+    }
+
     Py_RETURN_NONE;
 }
 
@@ -1284,7 +1786,7 @@ static PyObject* dllist_popleft(DLListObject* self)
     DLListNodeObject* del_node;
     PyObject* value;
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
     {
         PyErr_SetString(PyExc_ValueError, "List is empty");
         return NULL;
@@ -1294,7 +1796,7 @@ static PyObject* dllist_popleft(DLListObject* self)
 
     self->first = del_node->next;
     if (self->last == (PyObject*)del_node)
-        self->last = Py_None;
+        self->last = NULL;
 
     if (self->last_accessed_node != (PyObject*)del_node)
     {
@@ -1319,7 +1821,7 @@ static PyObject* dllist_popright(DLListObject* self)
     DLListNodeObject* del_node;
     PyObject* value;
 
-    if (self->last == Py_None)
+    if (self->last == NULL)
     {
         PyErr_SetString(PyExc_ValueError, "List is empty");
         return NULL;
@@ -1329,7 +1831,7 @@ static PyObject* dllist_popright(DLListObject* self)
 
     self->last = del_node->prev;
     if (self->first == (PyObject*)del_node)
-        self->first = Py_None;
+        self->first = NULL;
 
     if (self->last_accessed_node == (PyObject*)del_node)
       dllist_invalidate_last_access_cache(self);
@@ -1344,10 +1846,128 @@ static PyObject* dllist_popright(DLListObject* self)
     return value;
 }
 
+/* Parse count of elements to pop. Returns -1 on failure. */
+static Py_ssize_t dllist_parse_pop_count(DLListObject* self, PyObject* arg)
+{
+    Py_ssize_t n;
+
+    if (!Py23Int_Check(arg))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return -1;
+    }
+
+    n = Py23Int_AsSsize_t(arg);
+    if (n == -1 && PyErr_Occurred())
+        return -1;
+
+    if (n < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return -1;
+    }
+
+    return (n < self->size) ? n : self->size;
+}
+
+static PyObject* dllist_popleftn(DLListObject* self, PyObject* arg)
+{
+    Py_ssize_t n = dllist_parse_pop_count(self, arg);
+    PyObject* values;
+    PyObject* head;
+    PyObject* node;
+    Py_ssize_t i;
+
+    if (n < 0)
+        return NULL;
+
+    values = PyList_New(n);
+    if (values == NULL || n == 0)
+        return values;
+
+    /* detach the first n nodes as a single chain */
+    head = self->first;
+    node = head;
+    for (i = 0; i < n; ++i)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)node;
+
+        Py_INCREF(iter_node->value);
+        PyList_SET_ITEM(values, i, iter_node->value);
+
+        if (node == self->last_accessed_node)
+            dllist_invalidate_last_access_cache(self);
+
+        if (i == n - 1)
+        {
+            self->first = iter_node->next;
+            iter_node->next = NULL;
+        }
+        node = iter_node->next;
+    }
+
+    if (self->first != NULL)
+        ((DLListNodeObject*)self->first)->prev = NULL;
+    else
+        self->last = NULL;
+
+    self->size -= n;
+    if (self->last_accessed_idx >= 0)
+        self->last_accessed_idx -= n;
+
+    dllist_release_nodes(&head, n);
+
+    return values;
+}
+
+static PyObject* dllist_poprightn(DLListObject* self, PyObject* arg)
+{
+    Py_ssize_t n = dllist_parse_pop_count(self, arg);
+    PyObject* values;
+    PyObject* head;
+    Py_ssize_t i;
+
+    if (n < 0)
+        return NULL;
+
+    values = PyList_New(n);
+    if (values == NULL || n == 0)
+        return values;
+
+    /* detach the last n nodes as a single chain */
+    head = self->last;
+    for (i = 0; i < n; ++i)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)head;
+
+        Py_INCREF(iter_node->value);
+        PyList_SET_ITEM(values, i, iter_node->value);
+
+        if (head == self->last_accessed_node)
+            dllist_invalidate_last_access_cache(self);
+
+        if (i < n - 1)
+            head = iter_node->prev;
+    }
+
+    self->last = ((DLListNodeObject*)head)->prev;
+    ((DLListNodeObject*)head)->prev = NULL;
+
+    if (self->last != NULL)
+        ((DLListNodeObject*)self->last)->next = NULL;
+    else
+        self->first = NULL;
+
+    self->size -= n;
+
+    dllist_release_nodes(&head, n);
+
+    return values;
+}
+
 static PyObject* dllist_remove(DLListObject* self, PyObject* arg)
 {
     DLListNodeObject* del_node;
-    PyObject* list_ref;
     PyObject* value;
 
     if (!PyObject_TypeCheck(arg, &DLListNodeType))
@@ -1356,7 +1976,7 @@ static PyObject* dllist_remove(DLListObject* self, PyObject* arg)
         return NULL;
     }
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
     {
         PyErr_SetString(PyExc_ValueError, "List is empty");
         return NULL;
@@ -1364,15 +1984,14 @@ static PyObject* dllist_remove(DLListObject* self, PyObject* arg)
 
     del_node = (DLListNodeObject*)arg;
 
-    if (del_node->list_weakref == Py_None)
+    if (del_node->list_weakref == NULL)
     {
         PyErr_SetString(PyExc_ValueError,
             "dllistnode does not belong to a list");
         return NULL;
     }
 
-    list_ref = PyWeakref_GetObject(del_node->list_weakref);
-    if (list_ref != (PyObject*)self)
+    if (del_node->list_weakref != self->node_ref)
     {
         PyErr_SetString(PyExc_ValueError,
             "dllistnode belongs to another list");
@@ -1398,141 +2017,1533 @@ static PyObject* dllist_remove(DLListObject* self, PyObject* arg)
     return value;
 }
 
-static PyObject* dllist_rotate(DLListObject* self, PyObject* nObject)
+/* Return a new list of nodes of the list. */
+static PyObject* dllist_collect_nodes(DLListObject* self)
 {
-    Py_ssize_t n;
-    Py_ssize_t split_idx;
-    Py_ssize_t n_mod;
-    DLListNodeObject* new_first;
-    DLListNodeObject* new_last;
+    PyObject* nodes;
+    PyObject* iter_node_obj = self->first;
+    Py_ssize_t i;
 
-    if (self->size <= 1)
-        Py_RETURN_NONE;
+    nodes = PyList_New(self->size);
+    if (nodes == NULL)
+        return NULL;
 
-    if (!Py23Int_Check(nObject))
+    for (i = 0; i < self->size; ++i)
     {
-        PyErr_SetString(PyExc_TypeError, "n must be an integer");
-        return NULL;
+        Py_INCREF(iter_node_obj);
+        PyList_SET_ITEM(nodes, i, iter_node_obj);
+        iter_node_obj = ((DLListNodeObject*)iter_node_obj)->next;
     }
 
-    n = Py23Int_AsSsize_t(nObject);
-    n_mod = py_ssize_t_abs(n) % self->size;
+    return nodes;
+}
 
-    if (n_mod == 0)
-        Py_RETURN_NONE; /* no-op */
+/* Return a new list of keys of values of nodes in list nodes. */
+static PyObject* dllist_collect_keys(PyObject* nodes, PyObject* key)
+{
+    PyObject* keys;
+    Py_ssize_t i;
 
-    if (n > 0)
-        split_idx = self->size - n_mod; /* rotate right */
-    else
-        split_idx = n_mod;  /* rotate left */
+    keys = PyList_New(0);
+    if (keys == NULL)
+        return NULL;
 
-    new_last = dllist_get_node_internal(self, split_idx - 1);
-    assert(new_last != NULL);
-    new_first = (DLListNodeObject*)new_last->next;
+    /* nodes are kept alive by the list of nodes, even if the key
+     * function removes them from their list */
+    for (i = 0; i < PyList_GET_SIZE(nodes); ++i)
+    {
+        DLListNodeObject* node = (DLListNodeObject*)PyList_GET_ITEM(nodes, i);
+        PyObject* node_key;
+        int result;
 
-    ((DLListNodeObject*)self->first)->prev = self->last;
-    ((DLListNodeObject*)self->last)->next = self->first;
+        node_key = llist_apply_key(key, node->value);
+        if (node_key == NULL)
+        {
+            Py_DECREF(keys);
+            return NULL;
+        }
 
-    new_first->prev = Py_None;
-    new_last->next = Py_None;
+        result = PyList_Append(keys, node_key);
+        Py_DECREF(node_key);
+        if (result != 0)
+        {
+            Py_DECREF(keys);
+            return NULL;
+        }
+    }
 
-    self->first = (PyObject*)new_first;
-    self->last = (PyObject*)new_last;
+    return keys;
+}
 
-    if (self->last_accessed_idx >= 0)
+/* Check whether list consists of nodes in list nodes, in that order. */
+static int dllist_has_nodes(DLListObject* self, PyObject* nodes)
+{
+    PyObject* iter_node_obj = self->first;
+    Py_ssize_t i;
+
+    if (self->size != PyList_GET_SIZE(nodes))
+        return 0;
+
+    for (i = 0; i < self->size; ++i)
     {
-        self->last_accessed_idx =
-            (self->last_accessed_idx + self->size - split_idx) % self->size;
+        if (iter_node_obj != PyList_GET_ITEM(nodes, i))
+            return 0;
+        iter_node_obj = ((DLListNodeObject*)iter_node_obj)->next;
     }
 
-    Py_RETURN_NONE;
+    return 1;
 }
 
-static PyObject* dllist_create_iterator(PyObject* self, PyObject* iterator_type)
+/* Merge nodes of sorted list other into sorted list self. Keys of all
+ * values are computed and compared before any node is relinked, like
+ * in sorted(), so if the key function or a comparison fails, or modifies
+ * either list, both lists are left unchanged. */
+static PyObject* dllist_merge_nodes(DLListObject* self,
+                                    DLListObject* other,
+                                    PyObject* key)
 {
-    PyObject* args;
-    PyObject* result;
+    PyObject* self_ref;
+    PyObject* a_nodes = NULL;
+    PyObject* b_nodes = NULL;
+    PyObject* a_keys = NULL;
+    PyObject* b_keys = NULL;
+    PyObject* tail = NULL;
+    PyObject* result = NULL;
+    Py_ssize_t a_size;
+    Py_ssize_t b_size;
+    Py_ssize_t i = 0;
+    Py_ssize_t j = 0;
+    Py_ssize_t k;
+    char* take_b = NULL;
+
+    if (other->size == 0)
+        Py_RETURN_NONE;
 
-    args = PyTuple_New(1);
-    if (args == NULL)
+    /* nodes are collected before the key function can modify lists */
+    a_nodes = dllist_collect_nodes(self);
+    if (a_nodes == NULL)
+        goto merge_done;
+    b_nodes = dllist_collect_nodes(other);
+    if (b_nodes == NULL)
+        goto merge_done;
+
+    a_keys = dllist_collect_keys(a_nodes, key);
+    if (a_keys == NULL)
+        goto merge_done;
+    b_keys = dllist_collect_keys(b_nodes, key);
+    if (b_keys == NULL)
+        goto merge_done;
+
+    a_size = PyList_GET_SIZE(a_nodes);
+    b_size = PyList_GET_SIZE(b_nodes);
+
+    /* take_b[k] tells whether k-th merged node comes from other, while
+     * neither list is exhausted */
+    take_b = (char*)PyMem_Malloc(a_size + b_size);
+    if (take_b == NULL)
     {
-        PyErr_SetString(PyExc_RuntimeError,
-            "Failed to create argument tuple");
-        return NULL;
+        PyErr_NoMemory();
+        goto merge_done;
     }
 
-    Py_INCREF(self);
-    if (PyTuple_SetItem(args, 0, self) != 0)
+    for (k = 0; i < a_size && j < b_size; ++k)
     {
-        PyErr_SetString(PyExc_RuntimeError,
-            "Failed to initialize argument tuple");
-        return NULL;
+        /* nodes of self come first among equal elements */
+        int less = PyObject_RichCompareBool(PyList_GET_ITEM(b_keys, j),
+                                            PyList_GET_ITEM(a_keys, i),
+                                            Py_LT);
+        if (less < 0)
+            goto merge_done;
+
+        take_b[k] = (char)less;
+        if (less)
+            ++j;
+        else
+            ++i;
     }
 
-    result = PyObject_CallObject(iterator_type, args);
+    if (!dllist_has_nodes(self, a_nodes) || !dllist_has_nodes(other, b_nodes))
+    {
+        PyErr_SetString(PyExc_ValueError, "List modified during merge");
+        goto merge_done;
+    }
 
-    Py_DECREF(args);
+    /* no code can run from here on, until the lists are relinked */
+    self_ref = self->node_ref;
+    i = 0;
+    j = 0;
+    for (k = 0; k < a_size + b_size; ++k)
+    {
+        DLListNodeObject* node;
 
-    return result;
-}
+        if (j < b_size && (i == a_size || take_b[k]))
+        {
+            node = (DLListNodeObject*)PyList_GET_ITEM(b_nodes, j++);
 
-static PyObject* dllist_iternodes(PyObject* self)
-{
-    return dllist_create_iterator(self, (PyObject*)&DLListNodeIteratorType);
-}
+            /* the old reference is still held by other */
+            Py_DECREF(node->list_weakref);
+            Py_INCREF(self_ref);
+            node->list_weakref = self_ref;
+        }
+        else
+            node = (DLListNodeObject*)PyList_GET_ITEM(a_nodes, i++);
+
+        node->prev = tail;
+        if (tail != NULL)
+            ((DLListNodeObject*)tail)->next = (PyObject*)node;
+        else
+            self->first = (PyObject*)node;
+        tail = (PyObject*)node;
+    }
+    ((DLListNodeObject*)tail)->next = NULL;
 
-static PyObject* dllist_itervalues(PyObject* self)
-{
-    return dllist_create_iterator(self, (PyObject*)&DLListIteratorType);
-}
+    self->last = tail;
+    self->size = a_size + b_size;
+    dllist_invalidate_last_access_cache(self);
 
-static Py_ssize_t dllist_len(PyObject* self)
-{
-    DLListObject* list = (DLListObject*)self;
-    return list->size;
+    other->first = NULL;
+    other->last = NULL;
+    other->size = 0;
+    dllist_invalidate_last_access_cache(other);
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+merge_done:
+    PyMem_Free(take_b);
+    Py_XDECREF(a_nodes);
+    Py_XDECREF(b_nodes);
+    Py_XDECREF(a_keys);
+    Py_XDECREF(b_keys);
+
+    return result;
 }
 
-static PyObject* dllist_concat(PyObject* self, PyObject* other)
+static PyObject* dllist_merge(PyObject* self, PyObject* args, PyObject* kwds)
 {
-    DLListObject* new_list;
+    static char* kwlist[] = { "other", "key", NULL };
 
-    new_list = (DLListObject*)PyObject_CallObject(
-        (PyObject*)&DLListType, NULL);
+    PyObject* other = NULL;
+    PyObject* key = Py_None;
+    PyObject* result;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:merge", kwlist,
+                                     &other, &key))
+        return NULL;
 
-    if (!dllist_extend_internal(new_list, self) ||
-        !dllist_extend_internal(new_list, other))
+    if (!PyObject_TypeCheck(other, &DLListType))
     {
-        Py_DECREF(new_list);
+        PyErr_SetString(PyExc_TypeError, "Argument must be a dllist");
         return NULL;
     }
 
-    return (PyObject*)new_list;
-}
-
-static PyObject* dllist_inplace_concat(PyObject* self, PyObject* other)
-{
-    if (!dllist_extend_internal((DLListObject*)self, other))
+    if (other == self)
+    {
+        PyErr_SetString(PyExc_ValueError, "Cannot merge list with itself");
         return NULL;
+    }
 
-    Py_INCREF(self);
-    return self;
+    /* both lists are locked here, so the method is not wrapped */
+    Py_BEGIN_CRITICAL_SECTION2(self, other);
+    result = dllist_merge_nodes((DLListObject*)self,
+                                (DLListObject*)other,
+                                key);
+    Py_END_CRITICAL_SECTION2();
+
+    return result;
 }
 
-static PyObject* dllist_repeat(PyObject* self, Py_ssize_t count)
+/* Check whether node precedes position of x in a sorted list, that is
+ * whether key(node.value) is less than x (or less than or equal to x
+ * if op is Py_LE). Fails if the comparison removes node from the list.
+ * Returns -1 on failure. */
+static int dllist_node_precedes(DLListObject* self,
+                                PyObject* node,
+                                PyObject* x,
+                                PyObject* key,
+                                int op)
 {
-    DLListObject* new_list;
-    Py_ssize_t i;
+    PyObject* node_key;
+    int result;
 
-    new_list = (DLListObject*)PyObject_CallObject(
-        (PyObject*)&DLListType, NULL);
+    Py_INCREF(node);
 
-    for (i = 0; i < count; ++i)
+    node_key = llist_apply_key(key, ((DLListNodeObject*)node)->value);
+    if (node_key == NULL)
     {
-        if (!dllist_extend_internal(new_list, self))
-        {
-            Py_DECREF(new_list);
-            return NULL;
-        }
+        Py_DECREF(node);
+        return -1;
+    }
+
+    result = PyObject_RichCompareBool(node_key, x, op);
+    Py_DECREF(node_key);
+
+    if (result >= 0 &&
+        ((DLListNodeObject*)node)->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError, "List modified during search");
+        result = -1;
+    }
+
+    Py_DECREF(node);
+
+    return result;
+}
+
+/* Find position of x in a sorted list, walking from start (or from the
+ * last accessed node or the end of the list if start is NULL) towards
+ * it. Stores the first node which does not precede x in *result, or NULL
+ * if x belongs at the end of the list. Elements equal to x precede it
+ * unless left is nonzero. Returns 0 on failure. */
+static int dllist_bisect_internal(DLListObject* self,
+                                  PyObject* x,
+                                  PyObject* key,
+                                  PyObject* start,
+                                  int left,
+                                  PyObject** result)
+{
+    int op = left ? Py_LT : Py_LE;
+    PyObject* node = start;
+    int precedes;
+
+    if (node == NULL)
+        node = self->last_accessed_node;
+    if (node == NULL)
+        node = self->last;
+    if (node == NULL)
+    {
+        *result = NULL;
+        return 1;
+    }
+
+    precedes = dllist_node_precedes(self, node, x, key, op);
+    if (precedes < 0)
+        return 0;
+
+    if (precedes)
+    {
+        /* walk forward to the first node which does not precede x */
+        node = ((DLListNodeObject*)node)->next;
+        while (node != NULL)
+        {
+            precedes = dllist_node_precedes(self, node, x, key, op);
+            if (precedes < 0)
+                return 0;
+            if (!precedes)
+                break;
+            node = ((DLListNodeObject*)node)->next;
+        }
+
+        *result = node;
+        return 1;
+    }
+
+    /* walk backward while the preceding node does not precede x */
+    while (((DLListNodeObject*)node)->prev != NULL)
+    {
+        PyObject* prev = ((DLListNodeObject*)node)->prev;
+
+        precedes = dllist_node_precedes(self, prev, x, key, op);
+        if (precedes < 0)
+            return 0;
+        if (precedes)
+            break;
+        node = prev;
+    }
+
+    /* node might have been removed by the comparison of its predecessor */
+    if (((DLListNodeObject*)node)->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError, "List modified during search");
+        return 0;
+    }
+
+    *result = node;
+    return 1;
+}
+
+static int dllist_parse_bisect_args(DLListObject* self,
+                                    PyObject* args,
+                                    PyObject* kwds,
+                                    const char* format,
+                                    PyObject** x,
+                                    PyObject** key,
+                                    PyObject** hint)
+{
+    static char* kwlist[] = { "x", "key", "hint", NULL };
+
+    *key = Py_None;
+    *hint = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, format, kwlist,
+                                     x, key, hint))
+        return 0;
+
+    if (*hint == Py_None)
+        *hint = NULL;
+    else if (!dllist_validate_ref_node(self, *hint))
+        return 0;
+
+    return 1;
+}
+
+static PyObject* dllist_bisect(DLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds,
+                               const char* format,
+                               int left)
+{
+    PyObject* x;
+    PyObject* key;
+    PyObject* hint;
+    PyObject* node;
+
+    if (!dllist_parse_bisect_args(self, args, kwds, format, &x, &key, &hint))
+        return NULL;
+
+    if (!dllist_bisect_internal(self, x, key, hint, left, &node))
+        return NULL;
+
+    if (node == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(node);
+    return node;
+}
+
+static PyObject* dllist_bisectleft(DLListObject* self,
+                                   PyObject* args,
+                                   PyObject* kwds)
+{
+    return dllist_bisect(self, args, kwds, "O|OO:bisectleft", 1);
+}
+
+static PyObject* dllist_bisectright(DLListObject* self,
+                                    PyObject* args,
+                                    PyObject* kwds)
+{
+    return dllist_bisect(self, args, kwds, "O|OO:bisectright", 0);
+}
+
+static PyObject* dllist_insort(DLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds)
+{
+    PyObject* value;
+    PyObject* key;
+    PyObject* hint;
+    PyObject* value_key;
+    PyObject* next;
+    PyObject* prev;
+    DLListNodeObject* new_node;
+
+    dllist_release_step(self);
+
+    if (!dllist_parse_bisect_args(self, args, kwds, "O|OO:insort",
+                                  &value, &key, &hint))
+        return NULL;
+
+    value = dllistnode_unwrap_value(value);
+
+    value_key = llist_apply_key(key, value);
+    if (value_key == NULL)
+    {
+        Py_DECREF(value);
+        return NULL;
+    }
+
+    /* hint might have been removed by the key function */
+    if (hint != NULL &&
+        ((DLListNodeObject*)hint)->list_weakref != self->node_ref)
+        hint = NULL;
+
+    if (!dllist_bisect_internal(self, value_key, key, hint, 0, &next))
+    {
+        Py_DECREF(value_key);
+        Py_DECREF(value);
+        return NULL;
+    }
+
+    Py_DECREF(value_key);
+
+    prev = (next != NULL) ? ((DLListNodeObject*)next)->prev : self->last;
+
+    new_node = dllistnode_create(prev, next, value, (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
+
+    if (prev == NULL)
+        self->first = (PyObject*)new_node;
+    if (next == NULL)
+        self->last = (PyObject*)new_node;
+    ++self->size;
+
+    /* The new node is the starting point of the next search. Its index
+     * is not known, so it cannot be used by indexing. */
+    self->last_accessed_node = (PyObject*)new_node;
+    self->last_accessed_idx = -1;
+
+    Py_INCREF(new_node);
+    return (PyObject*)new_node;
+}
+
+/* Remove nodes for which predicate returns a true value (or a false
+ * value if remove_matching is zero) in a single pass. Returns the number
+ * of removed nodes, or a list of removed values if values is nonzero. */
+static PyObject* dllist_filter(DLListObject* self,
+                               PyObject* predicate,
+                               int remove_matching,
+                               int values)
+{
+    PyObject* removed = NULL;
+    PyObject* node;
+    Py_ssize_t count = 0;
+
+    if (!PyCallable_Check(predicate))
+    {
+        PyErr_SetString(PyExc_TypeError, "Predicate must be callable");
+        return NULL;
+    }
+
+    if (values)
+    {
+        removed = PyList_New(0);
+        if (removed == NULL)
+            return NULL;
+    }
+
+    /* References to the current and next node are held, because the
+     * predicate (and values released with removed nodes) may run code
+     * modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)node;
+        PyObject* next;
+        PyObject* result;
+        int matches;
+
+        result = PyObject_CallFunctionObjArgs(
+            predicate, iter_node->value, NULL);
+        if (result == NULL)
+            goto filter_error;
+
+        matches = PyObject_IsTrue(result);
+        Py_DECREF(result);
+        if (matches < 0)
+            goto filter_error;
+
+        if (iter_node->list_weakref != self->node_ref)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "List modified during filtering");
+            goto filter_error;
+        }
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+
+        if (matches == remove_matching)
+        {
+            if (removed != NULL &&
+                PyList_Append(removed, iter_node->value) != 0)
+            {
+                Py_XDECREF(next);
+                goto filter_error;
+            }
+
+            if (self->first == node)
+                self->first = iter_node->next;
+            if (self->last == node)
+                self->last = iter_node->prev;
+            if (self->last_accessed_node != NULL)
+                dllist_invalidate_last_access_cache(self);
+
+            --self->size;
+            ++count;
+
+            dllistnode_delete(iter_node);
+        }
+
+        Py_DECREF(node);
+        node = next;
+    }
+
+    if (removed != NULL)
+        return removed;
+
+    return PyLong_FromSsize_t(count);
+
+filter_error:
+    Py_DECREF(node);
+    Py_XDECREF(removed);
+    return NULL;
+}
+
+/* Check that all items are distinct nodes of the list. Nodes are marked by clearing their
+ * owner references (which are restored by dllist_unmark_nodes()), so
+ * no code may run until marks are removed. Returns the number of marked
+ * nodes, which is smaller than count on failure. */
+static Py_ssize_t dllist_mark_nodes(DLListObject* self,
+                                    PyObject** items,
+                                    Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < count; ++i)
+    {
+        DLListNodeObject* node = (DLListNodeObject*)items[i];
+        Py_ssize_t j;
+
+        if (!PyObject_TypeCheck(items[i], &DLListNodeType))
+        {
+            PyErr_SetString(PyExc_TypeError,
+                "Iterable must contain only dllistnode objects");
+            return i;
+        }
+
+        if (node->list_weakref == self->node_ref)
+        {
+            node->list_weakref = NULL;
+            continue;
+        }
+
+        if (node->list_weakref != NULL)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "dllistnode belongs to another list");
+            return i;
+        }
+
+        for (j = 0; j < i; ++j)
+        {
+            if (items[j] == items[i])
+            {
+                PyErr_SetString(PyExc_ValueError,
+                    "dllistnode occurs more than once");
+                return i;
+            }
+        }
+
+        PyErr_SetString(PyExc_ValueError,
+            "dllistnode does not belong to a list");
+        return i;
+    }
+
+    return count;
+}
+
+static void dllist_unmark_nodes(DLListObject* self,
+                                PyObject** items,
+                                Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < count; ++i)
+        ((DLListNodeObject*)items[i])->list_weakref = self->node_ref;
+}
+
+static PyObject* dllist_removenodes(DLListObject* self, PyObject* arg)
+{
+    PyObject* sequence;
+    PyObject* values;
+    PyObject** items;
+    Py_ssize_t count;
+    Py_ssize_t i;
+
+    /* a private copy of nodes cannot be modified by other code */
+    sequence = PySequence_List(arg);
+    if (sequence == NULL)
+        return NULL;
+
+    count = PyList_GET_SIZE(sequence);
+    items = PySequence_Fast_ITEMS(sequence);
+
+    /* allocated before nodes are marked, as it may run the collector */
+    values = PyList_New(count);
+    if (values == NULL)
+    {
+        Py_DECREF(sequence);
+        return NULL;
+    }
+
+    i = dllist_mark_nodes(self, items, count);
+    if (i < count)
+    {
+        dllist_unmark_nodes(self, items, i);
+        Py_DECREF(values);
+        Py_DECREF(sequence);
+        return NULL;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        DLListNodeObject* node = (DLListNodeObject*)items[i];
+
+        if (self->first == items[i])
+            self->first = node->next;
+        if (self->last == items[i])
+            self->last = node->prev;
+
+        if (node->prev != NULL)
+            ((DLListNodeObject*)node->prev)->next = node->next;
+        if (node->next != NULL)
+            ((DLListNodeObject*)node->next)->prev = node->prev;
+
+        node->prev = NULL;
+        node->next = NULL;
+
+        Py_INCREF(node->value);
+        PyList_SET_ITEM(values, i, node->value);
+
+        /* reference to node_ref held by the node is dropped here */
+        Py_DECREF(self->node_ref);
+    }
+
+    self->size -= count;
+    if (count > 0)
+        dllist_invalidate_last_access_cache(self);
+
+    /* Release references held by the list only after all nodes are
+     * unlinked, because releasing nodes may run arbitrary code. */
+    for (i = 0; i < count; ++i)
+        Py_DECREF(items[i]);
+
+    Py_DECREF(sequence);
+
+    return values;
+}
+
+static PyObject* dllist_removeif(DLListObject* self,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    static char* kwlist[] = { "predicate", "values", NULL };
+
+    PyObject* predicate = NULL;
+    int values = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:removeif", kwlist,
+                                     &predicate, &values))
+        return NULL;
+
+    return dllist_filter(self, predicate, 1, values);
+}
+
+static PyObject* dllist_retain(DLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds)
+{
+    static char* kwlist[] = { "predicate", "values", NULL };
+
+    PyObject* predicate = NULL;
+    int values = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:retain", kwlist,
+                                     &predicate, &values))
+        return NULL;
+
+    return dllist_filter(self, predicate, 0, values);
+}
+
+/* Remove elements whose keys are equal to the key of any earlier element
+ * or, if adjacent is nonzero, to the key of the preceding kept element.
+ * Returns the number of removed elements. */
+static PyObject* dllist_dedupe_internal(DLListObject* self,
+                                        PyObject* key,
+                                        int adjacent)
+{
+    PyObject* seen = NULL;
+    PyObject* last_key = NULL;
+    PyObject* node;
+    Py_ssize_t count = 0;
+
+    if (!adjacent)
+    {
+        seen = PySet_New(NULL);
+        if (seen == NULL)
+            return NULL;
+    }
+
+    /* References to the current and next node are held, because the key
+     * function and comparisons (and values released with removed nodes)
+     * may run code modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)node;
+        PyObject* next;
+        PyObject* node_key;
+        int duplicate;
+
+        node_key = llist_apply_key(key, iter_node->value);
+        if (node_key == NULL)
+            goto dedupe_error;
+
+        if (adjacent)
+        {
+            duplicate = (last_key != NULL) ?
+                PyObject_RichCompareBool(last_key, node_key, Py_EQ) : 0;
+
+            if (duplicate == 0)
+            {
+                Py_XDECREF(last_key);
+                last_key = node_key;
+            }
+            else
+                Py_DECREF(node_key);
+        }
+        else
+        {
+            duplicate = PySet_Contains(seen, node_key);
+            if (duplicate == 0 && PySet_Add(seen, node_key) != 0)
+                duplicate = -1;
+            Py_DECREF(node_key);
+        }
+
+        if (duplicate < 0)
+            goto dedupe_error;
+
+        if (iter_node->list_weakref != self->node_ref)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "List modified during deduplication");
+            goto dedupe_error;
+        }
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+
+        if (duplicate)
+        {
+            if (self->first == node)
+                self->first = iter_node->next;
+            if (self->last == node)
+                self->last = iter_node->prev;
+            if (self->last_accessed_node != NULL)
+                dllist_invalidate_last_access_cache(self);
+
+            --self->size;
+            ++count;
+
+            dllistnode_delete(iter_node);
+        }
+
+        Py_DECREF(node);
+        node = next;
+    }
+
+    Py_XDECREF(seen);
+    Py_XDECREF(last_key);
+
+    return PyLong_FromSsize_t(count);
+
+dedupe_error:
+    Py_DECREF(node);
+    Py_XDECREF(seen);
+    Py_XDECREF(last_key);
+    return NULL;
+}
+
+static PyObject* dllist_dedupe(DLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds)
+{
+    static char* kwlist[] = { "key", NULL };
+
+    PyObject* key = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:dedupe", kwlist, &key))
+        return NULL;
+
+    return dllist_dedupe_internal(self, key, 0);
+}
+
+static PyObject* dllist_dedupeadjacent(DLListObject* self,
+                                       PyObject* args,
+                                       PyObject* kwds)
+{
+    static char* kwlist[] = { "key", NULL };
+
+    PyObject* key = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:dedupeadjacent", kwlist,
+                                     &key))
+        return NULL;
+
+    return dllist_dedupe_internal(self, key, 1);
+}
+
+static PyObject* dllist_rotate(DLListObject* self, PyObject* nObject)
+{
+    Py_ssize_t n;
+    Py_ssize_t split_idx;
+    Py_ssize_t n_mod;
+    DLListNodeObject* new_first;
+    DLListNodeObject* new_last;
+
+    if (self->size <= 1)
+        Py_RETURN_NONE;
+
+    if (!Py23Int_Check(nObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return NULL;
+    }
+
+    n = Py23Int_AsSsize_t(nObject);
+    n_mod = py_ssize_t_abs(n) % self->size;
+
+    if (n_mod == 0)
+        Py_RETURN_NONE; /* no-op */
+
+    if (n > 0)
+        split_idx = self->size - n_mod; /* rotate right */
+    else
+        split_idx = n_mod;  /* rotate left */
+
+    new_last = dllist_get_node_internal(self, split_idx - 1);
+    assert(new_last != NULL);
+    new_first = (DLListNodeObject*)new_last->next;
+
+    ((DLListNodeObject*)self->first)->prev = self->last;
+    ((DLListNodeObject*)self->last)->next = self->first;
+
+    new_first->prev = NULL;
+    new_last->next = NULL;
+
+    self->first = (PyObject*)new_first;
+    self->last = (PyObject*)new_last;
+
+    if (self->last_accessed_idx >= 0)
+    {
+        self->last_accessed_idx =
+            (self->last_accessed_idx + self->size - split_idx) % self->size;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/* Create an empty list of the same type and with the same release
+ * and allocation options as self. */
+static DLListObject* dllist_new_similar(DLListObject* self)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    DLListObject* new_list;
+    PyObject* args;
+
+    /* __init__ of subclasses is not called, like in copy.copy() */
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+
+    new_list = (DLListObject*)type->tp_new(type, args, NULL);
+    Py_DECREF(args);
+    if (new_list == NULL)
+        return NULL;
+
+    new_list->flags |= self->flags & LLIST_DEFERRED_RELEASE;
+
+    if (!llist_arena_enable(&new_list->arena, &DLListNodeType,
+                            self->arena != NULL))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return new_list;
+}
+
+/* Convenience function for copying lists. New nodes are created in
+ * a single pass over the source list. Values are copied with
+ * copy.deepcopy() if memo is not NULL. */
+static PyObject* dllist_copy_internal(DLListObject* self, PyObject* memo)
+{
+    DLListObject* new_list;
+    PyObject* iter_node_obj;
+
+    new_list = dllist_new_similar(self);
+    if (new_list == NULL)
+        return NULL;
+
+    if (memo != NULL &&
+        !llist_memo_store(memo, (PyObject*)self, (PyObject*)new_list))
+        goto copy_error;
+
+    iter_node_obj = self->first;
+
+    while (iter_node_obj != NULL)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
+        DLListNodeObject* new_node;
+        PyObject* value;
+
+        if (memo != NULL)
+        {
+            /* deepcopy may run arbitrary code, keep the node alive */
+            Py_INCREF(iter_node);
+            value = llist_deepcopy(iter_node->value, memo);
+            iter_node_obj = iter_node->next;
+            Py_DECREF(iter_node);
+
+            if (value == NULL)
+                goto copy_error;
+        }
+        else
+        {
+            value = iter_node->value;
+            Py_INCREF(value);
+            iter_node_obj = iter_node->next;
+        }
+
+        new_node = dllistnode_create(
+            new_list->last, NULL, value, (PyObject*)new_list);
+        Py_DECREF(value);
+
+        if (new_node == NULL)
+            goto copy_error;
+
+        if (new_list->first == NULL)
+            new_list->first = (PyObject*)new_node;
+        new_list->last = (PyObject*)new_node;
+        ++new_list->size;
+    }
+
+    if (!llist_copy_state((PyObject*)self, (PyObject*)new_list, memo))
+        goto copy_error;
+
+    return (PyObject*)new_list;
+
+copy_error:
+    Py_DECREF(new_list);
+    return NULL;
+}
+
+static PyObject* dllist_copy(DLListObject* self)
+{
+    return dllist_copy_internal(self, NULL);
+}
+
+static PyObject* dllist_deepcopy(DLListObject* self, PyObject* memo)
+{
+    return dllist_copy_internal(self, memo);
+}
+
+/* Move node and all nodes following it to a new list, which is returned.
+ * Nodes are relinked, not copied, but their owner references must be
+ * updated, so this is linear in the number of moved nodes. The new list
+ * is empty if node is NULL. */
+static PyObject* dllist_split_internal(DLListObject* self, PyObject* node)
+{
+    DLListObject* new_list;
+    PyObject* prev;
+    PyObject* iter_node_obj;
+    Py_ssize_t count = 0;
+
+    new_list = dllist_new_similar(self);
+    if (new_list == NULL)
+        return NULL;
+
+    if (node == NULL)
+        return (PyObject*)new_list;
+
+    for (iter_node_obj = node; iter_node_obj != NULL;
+         iter_node_obj = ((DLListNodeObject*)iter_node_obj)->next)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)iter_node_obj;
+
+        /* the list still holds its own reference to node_ref */
+        Py_DECREF(iter_node->list_weakref);
+        iter_node->list_weakref = new_list->node_ref;
+        Py_INCREF(iter_node->list_weakref);
+
+        if (iter_node_obj == self->last_accessed_node)
+            dllist_invalidate_last_access_cache(self);
+
+        ++count;
+    }
+
+    prev = ((DLListNodeObject*)node)->prev;
+    ((DLListNodeObject*)node)->prev = NULL;
+
+    new_list->first = node;
+    new_list->last = self->last;
+    new_list->size = count;
+
+    if (prev != NULL)
+        ((DLListNodeObject*)prev)->next = NULL;
+    else
+        self->first = NULL;
+    self->last = prev;
+    self->size -= count;
+
+    return (PyObject*)new_list;
+}
+
+/* Check that arg is a node of the list. */
+static int dllist_validate_node(DLListObject* self, PyObject* arg)
+{
+    if (!PyObject_TypeCheck(arg, &DLListNodeType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument must be a dllistnode");
+        return 0;
+    }
+
+    if (((DLListNodeObject*)arg)->list_weakref == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "dllistnode does not belong to a list");
+        return 0;
+    }
+
+    if (((DLListNodeObject*)arg)->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "dllistnode belongs to another list");
+        return 0;
+    }
+
+    return 1;
+}
+
+static PyObject* dllist_splitafter(DLListObject* self, PyObject* arg)
+{
+    if (!dllist_validate_node(self, arg))
+        return NULL;
+
+    return dllist_split_internal(self, ((DLListNodeObject*)arg)->next);
+}
+
+static PyObject* dllist_splitbefore(DLListObject* self, PyObject* arg)
+{
+    if (!dllist_validate_node(self, arg))
+        return NULL;
+
+    return dllist_split_internal(self, arg);
+}
+
+/* Rotate the list so that it starts at new_first, which must be a node
+ * of the list. Only the ends of the list are relinked. */
+static void dllist_rotate_to_node(DLListObject* self, PyObject* new_first)
+{
+    PyObject* new_last = ((DLListNodeObject*)new_first)->prev;
+
+    if (new_last == NULL)
+        return; /* no-op */
+
+    ((DLListNodeObject*)self->first)->prev = self->last;
+    ((DLListNodeObject*)self->last)->next = self->first;
+
+    ((DLListNodeObject*)new_first)->prev = NULL;
+    ((DLListNodeObject*)new_last)->next = NULL;
+
+    self->first = new_first;
+    self->last = new_last;
+
+    /* index of the last accessed node is not known anymore, unless it is
+     * at one of the new ends, but the node is still useful as a finger */
+    if (self->last_accessed_node == self->first)
+        self->last_accessed_idx = 0;
+    else if (self->last_accessed_node == self->last)
+        self->last_accessed_idx = self->size - 1;
+    else
+        self->last_accessed_idx = -1;
+}
+
+static PyObject* dllist_rotateto(DLListObject* self, PyObject* arg)
+{
+    if (!dllist_validate_node(self, arg))
+        return NULL;
+
+    dllist_rotate_to_node(self, arg);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* dllist_rotateafter(DLListObject* self, PyObject* arg)
+{
+    PyObject* next;
+
+    if (!dllist_validate_node(self, arg))
+        return NULL;
+
+    next = ((DLListNodeObject*)arg)->next;
+    if (next != NULL)
+        dllist_rotate_to_node(self, next);
+
+    Py_RETURN_NONE;
+}
+
+/* Move nodes for whose values predicate is true to a new list, which is
+ * returned. Predicate is called for all nodes before any of them is
+ * moved, so the list is left unchanged if it fails. */
+static PyObject* dllist_partition(DLListObject* self, PyObject* predicate)
+{
+    DLListObject* matching;
+    PyObject* nodes;
+    PyObject* node;
+    Py_ssize_t i;
+
+    if (!PyCallable_Check(predicate))
+    {
+        PyErr_SetString(PyExc_TypeError, "Predicate must be callable");
+        return NULL;
+    }
+
+    nodes = PyList_New(0);
+    if (nodes == NULL)
+        return NULL;
+
+    /* References to the current and next node are held, because the
+     * predicate may run code modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)node;
+        PyObject* next;
+        PyObject* result;
+        int matches;
+
+        result = PyObject_CallFunctionObjArgs(
+            predicate, iter_node->value, NULL);
+        if (result == NULL)
+            goto partition_error;
+
+        matches = PyObject_IsTrue(result);
+        Py_DECREF(result);
+        if (matches < 0)
+            goto partition_error;
+
+        if (iter_node->list_weakref != self->node_ref)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "List modified during partitioning");
+            goto partition_error;
+        }
+
+        if (matches && PyList_Append(nodes, node) != 0)
+            goto partition_error;
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+        Py_DECREF(node);
+        node = next;
+    }
+
+    matching = dllist_new_similar(self);
+    if (matching == NULL)
+    {
+        Py_DECREF(nodes);
+        return NULL;
+    }
+
+    /* no code can run from here, nodes are relinked in their order */
+    for (i = 0; i < PyList_GET_SIZE(nodes); ++i)
+    {
+        DLListNodeObject* moved = (DLListNodeObject*)PyList_GET_ITEM(nodes, i);
+
+        /* skip nodes visited twice */
+        if (moved->list_weakref != self->node_ref)
+            continue;
+
+        if (moved->prev != NULL)
+            ((DLListNodeObject*)moved->prev)->next = moved->next;
+        else
+            self->first = moved->next;
+
+        if (moved->next != NULL)
+            ((DLListNodeObject*)moved->next)->prev = moved->prev;
+        else
+            self->last = moved->prev;
+
+        moved->prev = NULL;
+        moved->next = NULL;
+        Py_CLEAR(moved->list_weakref);
+        --self->size;
+
+        dllistnode_link(matching->last, NULL, moved, (PyObject*)matching);
+        if (matching->first == NULL)
+            matching->first = (PyObject*)moved;
+        matching->last = (PyObject*)moved;
+        ++matching->size;
+    }
+
+    if (matching->size > 0 && self->last_accessed_node != NULL)
+        dllist_invalidate_last_access_cache(self);
+
+    Py_DECREF(nodes);
+
+    return (PyObject*)matching;
+
+partition_error:
+    Py_DECREF(node);
+    Py_DECREF(nodes);
+    return NULL;
+}
+
+/* Replace each value of the list with the result of calling func on it. */
+static PyObject* dllist_apply(DLListObject* self, PyObject* func)
+{
+    PyObject* node;
+
+    if (!PyCallable_Check(func))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument must be callable");
+        return NULL;
+    }
+
+    /* References to the current and next node are held, because func
+     * (and replaced values when they are released) may run code
+     * modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        DLListNodeObject* iter_node = (DLListNodeObject*)node;
+        PyObject* old_value = NULL;
+        PyObject* next;
+
+        if (!llist_is_identity_call(func, iter_node->value))
+        {
+            PyObject* value = Py23Object_CallOneArg(func, iter_node->value);
+
+            if (value == NULL)
+                goto apply_error;
+
+            if (iter_node->list_weakref != self->node_ref)
+            {
+                Py_DECREF(value);
+                PyErr_SetString(PyExc_ValueError,
+                    "List modified during apply");
+                goto apply_error;
+            }
+
+            old_value = iter_node->value;
+            iter_node->value = value;
+            dllistnode_update_gc(iter_node);
+        }
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+
+        Py_XDECREF(old_value);
+        Py_DECREF(node);
+        node = next;
+    }
+
+    Py_RETURN_NONE;
+
+apply_error:
+    Py_DECREF(node);
+    return NULL;
+}
+
+static PyObject* dllist_reduce(DLListObject* self)
+{
+    PyObject* args;
+    PyObject* state;
+    PyObject* items;
+    PyObject* result;
+
+    /* values are passed as an iterator over the list, so pickle creates
+     * (and memoizes) an empty list first and appends values to it, which
+     * handles lists containing themselves and avoids copying values */
+    items = PyObject_GetIter((PyObject*)self);
+    if (items == NULL)
+        return NULL;
+
+    state = llist_get_state((PyObject*)self);
+    if (state == NULL)
+    {
+        Py_DECREF(items);
+        return NULL;
+    }
+
+    /* options are passed to the constructor only when set, so pickles
+     * of other lists stay loadable by subclasses overriding __init__ */
+    if (self->arena != NULL)
+        args = Py_BuildValue("(()ii)",
+            (self->flags & LLIST_DEFERRED_RELEASE) != 0, 1);
+    else if ((self->flags & LLIST_DEFERRED_RELEASE) != 0)
+        args = Py_BuildValue("(()i)", 1);
+    else
+        args = PyTuple_New(0);
+    if (args == NULL)
+    {
+        Py_DECREF(state);
+        Py_DECREF(items);
+        return NULL;
+    }
+
+    result = Py_BuildValue("ONON", (PyObject*)Py_TYPE(self), args,
+                           state, items);
+
+    Py_DECREF(state);
+
+    return result;
+}
+
+/* Compute memory used by nodes owned by the list and by the weak
+ * reference shared by them. Values stored in nodes are not included. */
+static void dllist_memory_usage(DLListObject* self,
+                               Py_ssize_t* node_bytes,
+                               Py_ssize_t* ref_bytes)
+{
+    PyObject* iter_node_obj = self->first;
+
+    *node_bytes = 0;
+    while (iter_node_obj != NULL)
+    {
+        *node_bytes += llist_object_size(iter_node_obj);
+        iter_node_obj = ((DLListNodeObject*)iter_node_obj)->next;
+    }
+
+    *ref_bytes = llist_object_size(self->node_ref);
+}
+
+static PyObject* dllist_sizeof(DLListObject* self)
+{
+    Py_ssize_t node_bytes;
+    Py_ssize_t ref_bytes;
+
+    dllist_memory_usage(self, &node_bytes, &ref_bytes);
+
+    return PyLong_FromSsize_t(
+        Py_TYPE(self)->tp_basicsize + node_bytes + ref_bytes);
+}
+
+static PyObject* dllist_memory_stats(DLListObject* self)
+{
+    Py_ssize_t node_bytes;
+    Py_ssize_t ref_bytes;
+
+    dllist_memory_usage(self, &node_bytes, &ref_bytes);
+
+    return Py_BuildValue("{s:n,s:n,s:n,s:n,s:n}",
+                         "nodes", self->size,
+                         "node_bytes", node_bytes,
+                         "ref_bytes", ref_bytes,
+                         "pool_bytes", llist_arena_reserved(self->arena),
+                         "pinned_bytes", llist_arena_pinned(
+                             self->arena, self->first,
+                             offsetof(DLListNodeObject, next)));
+}
+
+static PyObject* dllist_create_iterator(PyObject* self, PyObject* iterator_type)
+{
+    PyObject* args;
+    PyObject* result;
+
+    args = PyTuple_New(1);
+    if (args == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError,
+            "Failed to create argument tuple");
+        return NULL;
+    }
+
+    Py_INCREF(self);
+    if (PyTuple_SetItem(args, 0, self) != 0)
+    {
+        PyErr_SetString(PyExc_RuntimeError,
+            "Failed to initialize argument tuple");
+        return NULL;
+    }
+
+    result = PyObject_CallObject(iterator_type, args);
+
+    Py_DECREF(args);
+
+    return result;
+}
+
+static PyObject* dllist_iternodes(PyObject* self)
+{
+    return dllist_create_iterator(self, (PyObject*)&DLListNodeIteratorType);
+}
+
+static PyObject* dllist_itervalues(PyObject* self)
+{
+    return dllist_create_iterator(self, (PyObject*)&DLListIteratorType);
+}
+
+static PyObject* dllist_create_cycle_iterator(PyObject* self,
+                                            PyObject* iterator_type)
+{
+    PyObject* iterator = dllist_create_iterator(self, iterator_type);
+
+    if (iterator != NULL)
+        dllistiterator_set_cycle(iterator);
+
+    return iterator;
+}
+
+static PyObject* dllist_itercycle(PyObject* self)
+{
+    return dllist_create_cycle_iterator(self, (PyObject*)&DLListIteratorType);
+}
+
+static PyObject* dllist_itercyclenodes(PyObject* self)
+{
+    return dllist_create_cycle_iterator(self,
+                                      (PyObject*)&DLListNodeIteratorType);
+}
+
+static Py_ssize_t dllist_len(PyObject* self)
+{
+    DLListObject* list = (DLListObject*)self;
+    return list->size;
+}
+
+static PyObject* dllist_concat(PyObject* self, PyObject* other)
+{
+    DLListObject* new_list;
+
+    new_list = (DLListObject*)PyObject_CallObject(
+        (PyObject*)&DLListType, NULL);
+
+    if (!dllist_extend_internal(new_list, self, NULL) ||
+        !dllist_extend_internal(new_list, other, NULL))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* dllist_inplace_concat(PyObject* self, PyObject* other)
+{
+    if (!dllist_extend_internal((DLListObject*)self, other, NULL))
+        return NULL;
+
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject* dllist_repeat(PyObject* self, Py_ssize_t count)
+{
+    DLListObject* new_list;
+    Py_ssize_t i;
+
+    new_list = (DLListObject*)PyObject_CallObject(
+        (PyObject*)&DLListType, NULL);
+
+    for (i = 0; i < count; ++i)
+    {
+        if (!dllist_extend_internal(new_list, self, NULL))
+        {
+            Py_DECREF(new_list);
+            return NULL;
+        }
     }
 
     return (PyObject*)new_list;
@@ -1565,9 +3576,17 @@ static int dllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
     DLListNodeObject* node;
     PyObject* oldval;
 
+    /* if assigned item is a node, its value is read before looking up
+     * the item (see dllist_insert) */
+    if (val != NULL)
+        val = dllistnode_unwrap_value(val);
+
     node = dllist_get_node_internal(list, index);
     if (node == NULL)
+    {
+        Py_XDECREF(val);
         return -1;
+    }
 
     /* Here is a tricky (and undocumented) part of sequence protocol.
      * Python will pass NULL as item value when item is deleted with:
@@ -1579,7 +3598,7 @@ static int dllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
 
         result = dllist_remove(list, (PyObject*)node);
 
-        if (prev != Py_None && index > 0)
+        if (prev != NULL && index > 0)
         {
             /* Last accessed item was invalidated by dllist_remove.
              * We restore it here as the preceding node. */
@@ -1594,13 +3613,10 @@ static int dllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
 
     /* The rest of this function handles normal assignment:
      * list[index] = item */
-    if (PyObject_TypeCheck(val, &DLListNodeType))
-        val = ((DLListNodeObject*)val)->value;
-
     oldval = node->value;
 
-    Py_INCREF(val);
     node->value = val;
+    dllistnode_update_gc(node);
     Py_DECREF(oldval);
 
     /* update last accessed node */
@@ -1610,77 +3626,239 @@ static int dllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
     return 0;
 }
 
+/* wrappers holding the list lock, see lock.h */
+LLIST_LOCKED_ARG(dllist_appendleft_locked, dllist_appendleft)
+LLIST_LOCKED_ARG(dllist_appendright_locked, dllist_appendright)
+LLIST_LOCKED_ARG2(dllist_appendnode_locked, dllist_appendnode)
+LLIST_LOCKED_ARG(dllist_apply_locked, dllist_apply)
+LLIST_LOCKED_KWARGS(dllist_bisectleft_locked, dllist_bisectleft)
+LLIST_LOCKED_KWARGS(dllist_bisectright_locked, dllist_bisectright)
+LLIST_LOCKED_NOARGS(dllist_clear_locked, dllist_clear)
+LLIST_LOCKED_NOARGS(dllist_copy_locked, dllist_copy)
+LLIST_LOCKED_ARG(dllist_deepcopy_locked, dllist_deepcopy)
+LLIST_LOCKED_ARG(dllist_partition_locked, dllist_partition)
+LLIST_LOCKED_ARG(dllist_splitafter_locked, dllist_splitafter)
+LLIST_LOCKED_ARG(dllist_splitbefore_locked, dllist_splitbefore)
+LLIST_LOCKED_ARG2(dllist_extendright_locked, dllist_extendright)
+LLIST_LOCKED_ARG2(dllist_extendleft_locked, dllist_extendleft)
+LLIST_LOCKED_ARG2(dllist_extendnodes_locked, dllist_extendnodes)
+LLIST_LOCKED_ARG2(dllist_extendleftnodes_locked, dllist_extendleftnodes)
+LLIST_LOCKED_ARG(dllist_insert_locked, dllist_insert)
+LLIST_LOCKED_ARG(dllist_insertbefore_locked, dllist_insertbefore)
+LLIST_LOCKED_ARG(dllist_insertafter_locked, dllist_insertafter)
+LLIST_LOCKED_ARGS2(dllist_insertnode_locked, dllist_insertnode)
+LLIST_LOCKED_ARGS2(dllist_insertnodebefore_locked, dllist_insertnodebefore)
+LLIST_LOCKED_ARGS2(dllist_insertnodeafter_locked, dllist_insertnodeafter)
+LLIST_LOCKED_KWARGS(dllist_insort_locked, dllist_insort)
+LLIST_LOCKED_NOARGS(dllist_itercycle_locked, dllist_itercycle)
+LLIST_LOCKED_NOARGS(dllist_itercyclenodes_locked, dllist_itercyclenodes)
+LLIST_LOCKED_NOARGS(dllist_iternodes_locked, dllist_iternodes)
+LLIST_LOCKED_NOARGS(dllist_itervalues_locked, dllist_itervalues)
+LLIST_LOCKED_NOARGS(dllist_memory_stats_locked, dllist_memory_stats)
+LLIST_LOCKED_ARG(dllist_node_at_locked, dllist_node_at)
+LLIST_LOCKED_NOARGS(dllist_popleft_locked, dllist_popleft)
+LLIST_LOCKED_ARG(dllist_popleftn_locked, dllist_popleftn)
+LLIST_LOCKED_NOARGS(dllist_popright_locked, dllist_popright)
+LLIST_LOCKED_ARG(dllist_poprightn_locked, dllist_poprightn)
+LLIST_LOCKED_NOARGS(dllist_reduce_locked, dllist_reduce)
+LLIST_LOCKED_ARG(dllist_remove_locked, dllist_remove)
+LLIST_LOCKED_KWARGS(dllist_removeif_locked, dllist_removeif)
+LLIST_LOCKED_ARG(dllist_removenodes_locked, dllist_removenodes)
+LLIST_LOCKED_KWARGS(dllist_retain_locked, dllist_retain)
+LLIST_LOCKED_KWARGS(dllist_dedupe_locked, dllist_dedupe)
+LLIST_LOCKED_KWARGS(dllist_dedupeadjacent_locked, dllist_dedupeadjacent)
+LLIST_LOCKED_ARG(dllist_rotate_locked, dllist_rotate)
+LLIST_LOCKED_ARG(dllist_rotateafter_locked, dllist_rotateafter)
+LLIST_LOCKED_ARG(dllist_rotateto_locked, dllist_rotateto)
+LLIST_LOCKED_NOARGS(dllist_sizeof_locked, dllist_sizeof)
+LLIST_LOCKED_LEN(dllist_len_locked, dllist_len)
+LLIST_LOCKED_CONCAT(dllist_concat_locked, dllist_concat)
+LLIST_LOCKED_INDEX(dllist_repeat_locked, dllist_repeat)
+LLIST_LOCKED_INDEX(dllist_get_item_locked, dllist_get_item)
+LLIST_LOCKED_ASS_ITEM(dllist_set_item_locked, dllist_set_item)
+LLIST_LOCKED_CONCAT(dllist_inplace_concat_locked, dllist_inplace_concat)
+LLIST_LOCKED_UNARY(dllist_repr_locked, dllist_repr)
+LLIST_LOCKED_UNARY(dllist_str_locked, dllist_str)
+LLIST_LOCKED_HASH(dllist_hash_locked, dllist_hash)
+LLIST_LOCKED_RICHCOMPARE(dllist_richcompare_locked, dllist_richcompare)
+LLIST_LOCKED_INIT(dllist_init_locked, dllist_init)
+
 static PyMethodDef DLListMethods[] =
 {
-    { "appendleft", (PyCFunction)dllist_appendleft, METH_O,
+    { "appendleft", (PyCFunction)dllist_appendleft_locked, METH_O,
       "Append element at the beginning of the list" },
-    { "append", (PyCFunction)dllist_appendright, METH_O,
+    { "append", (PyCFunction)dllist_appendright_locked, METH_O,
       "Append element at the end of the list" },
-    { "appendright", (PyCFunction)dllist_appendright, METH_O,
+    { "appendright", (PyCFunction)dllist_appendright_locked, METH_O,
       "Append element at the end of the list" },
-    { "appendnode", (PyCFunction)dllist_appendnode, METH_O,
+    { "appendnode", (PyCFunction)dllist_appendnode_locked, METH_O,
       "Append raw dllistnode at the end of the list" },
-    { "clear", (PyCFunction)dllist_clear, METH_NOARGS,
+    { "apply", (PyCFunction)dllist_apply_locked, METH_O,
+      "Replace each element with the result of calling func on it" },
+    { "bisectleft", (PyCFunction)dllist_bisectleft_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Return first node whose value is not less than x in a sorted list" },
+    { "bisectright", (PyCFunction)dllist_bisectright_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Return first node whose value is greater than x in a sorted list" },
+    { "clear", (PyCFunction)dllist_clear_locked, METH_NOARGS,
       "Remove all elements from the list" },
-    { "extend", (PyCFunction)dllist_extendright, METH_O,
+    { "__copy__", (PyCFunction)dllist_copy_locked, METH_NOARGS,
+      "Return shallow copy of the list" },
+    { "__deepcopy__", (PyCFunction)dllist_deepcopy_locked, METH_O,
+      "Return deep copy of the list" },
+    { "dedupe", (PyCFunction)dllist_dedupe_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Remove elements equal to an earlier element" },
+    { "dedupeadjacent", (PyCFunction)dllist_dedupeadjacent_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Collapse runs of equal elements into their first element" },
+    { "extend", (PyCFunction)dllist_extendright_locked, METH_O,
       "Append elements from iterable at the right side of the list" },
-    { "extendleft", (PyCFunction)dllist_extendleft, METH_O,
+    { "extendleft", (PyCFunction)dllist_extendleft_locked, METH_O,
       "Append elements from iterable at the left side of the list" },
-    { "extendright", (PyCFunction)dllist_extendright, METH_O,
+    { "extendleftnodes", (PyCFunction)dllist_extendleftnodes_locked, METH_O,
+      "Append elements from iterable at the left side of the list and "
+      "return created nodes" },
+    { "extendnodes", (PyCFunction)dllist_extendnodes_locked, METH_O,
+      "Append elements from iterable at the right side of the list and "
+      "return created nodes" },
+    { "extendright", (PyCFunction)dllist_extendright_locked, METH_O,
       "Append elements from iterable at the right side of the list" },
-    { "insert", (PyCFunction)dllist_insert, METH_VARARGS,
+    { "insert", (PyCFunction)dllist_insert_locked, METH_VARARGS,
       "Inserts element before node" },
-    { "insertbefore", (PyCFunction)dllist_insertbefore, METH_VARARGS,
+    { "insertbefore", (PyCFunction)dllist_insertbefore_locked, METH_VARARGS,
       "Inserts element before node" },
-    { "insertafter", (PyCFunction)dllist_insertafter, METH_VARARGS,
+    { "insertafter", (PyCFunction)dllist_insertafter_locked, METH_VARARGS,
       "Inserts element after node" },
-    { "insertnode", (PyCFunction)dllist_insertnode, METH_VARARGS,
+    { "insertnode", (PyCFunction)dllist_insertnode_locked, METH_VARARGS,
       "Inserts element before node" },
-    { "insertnodebefore", (PyCFunction)dllist_insertnodebefore, METH_VARARGS,
+    { "insertnodebefore", (PyCFunction)dllist_insertnodebefore_locked, METH_VARARGS,
       "Inserts element before node" },
-    { "insertnodeafter", (PyCFunction)dllist_insertnodeafter, METH_VARARGS,
+    { "insertnodeafter", (PyCFunction)dllist_insertnodeafter_locked, METH_VARARGS,
       "Inserts element before node" },
-    { "iternodes", (PyCFunction)dllist_iternodes, METH_NOARGS,
+    { "insort", (PyCFunction)dllist_insort_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Insert element into a sorted list, keeping it sorted" },
+    { "itercycle", (PyCFunction)dllist_itercycle_locked, METH_NOARGS,
+      "Return iterator cycling over list values" },
+    { "itercyclenodes", (PyCFunction)dllist_itercyclenodes_locked, METH_NOARGS,
+      "Return iterator cycling over list nodes" },
+    { "iternodes", (PyCFunction)dllist_iternodes_locked, METH_NOARGS,
       "Return iterator over list nodes" },
-    { "itervalues", (PyCFunction)dllist_itervalues, METH_NOARGS,
+    { "itervalues", (PyCFunction)dllist_itervalues_locked, METH_NOARGS,
       "Return iterator over list values" },
-    { "nodeat", (PyCFunction)dllist_node_at, METH_O,
+    { "memory_stats", (PyCFunction)dllist_memory_stats_locked, METH_NOARGS,
+      "Return statistics of memory used by the list" },
+    { "merge", (PyCFunction)dllist_merge, METH_VARARGS | METH_KEYWORDS,
+      "Merge nodes of another sorted list into the sorted list" },
+    { "nodeat", (PyCFunction)dllist_node_at_locked, METH_O,
       "Return node at index" },
-    { "popleft", (PyCFunction)dllist_popleft, METH_NOARGS,
+    { "partition", (PyCFunction)dllist_partition_locked, METH_O,
+      "Move elements for which predicate is true to a new list" },
+    { "popleft", (PyCFunction)dllist_popleft_locked, METH_NOARGS,
       "Remove first element from the list and return it" },
-    { "pop", (PyCFunction)dllist_popright, METH_NOARGS,
+    { "popleftn", (PyCFunction)dllist_popleftn_locked, METH_O,
+      "Remove up to n first elements from the list and return them" },
+    { "pop", (PyCFunction)dllist_popright_locked, METH_NOARGS,
       "Remove last element from the list and return it" },
-    { "popright", (PyCFunction)dllist_popright, METH_NOARGS,
+    { "popright", (PyCFunction)dllist_popright_locked, METH_NOARGS,
       "Remove last element from the list and return it" },
-    { "remove", (PyCFunction)dllist_remove, METH_O,
+    { "poprightn", (PyCFunction)dllist_poprightn_locked, METH_O,
+      "Remove up to n last elements from the list and return them" },
+    { "__reduce__", (PyCFunction)dllist_reduce_locked, METH_NOARGS,
+      "Return state information for pickling" },
+    { "remove", (PyCFunction)dllist_remove_locked, METH_O,
       "Remove element from the list" },
-    { "rotate", (PyCFunction)dllist_rotate, METH_O,
+    { "removeif", (PyCFunction)dllist_removeif_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Remove all elements for which predicate is true" },
+    { "removenodes", (PyCFunction)dllist_removenodes_locked, METH_O,
+      "Remove nodes from the list and return their values" },
+    { "retain", (PyCFunction)dllist_retain_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Keep only elements for which predicate is true" },
+    { "rotate", (PyCFunction)dllist_rotate_locked, METH_O,
       "Rotate the list n steps to the right" },
+    { "rotateafter", (PyCFunction)dllist_rotateafter_locked, METH_O,
+      "Rotate the list so that it ends at node" },
+    { "rotateto", (PyCFunction)dllist_rotateto_locked, METH_O,
+      "Rotate the list so that it starts at node" },
+    { "splitafter", (PyCFunction)dllist_splitafter_locked, METH_O,
+      "Move nodes following node to a new list and return it" },
+    { "splitbefore", (PyCFunction)dllist_splitbefore_locked, METH_O,
+      "Move node and nodes following it to a new list and return it" },
+    { "__sizeof__", (PyCFunction)dllist_sizeof_locked, METH_NOARGS,
+      "Return size of the list and its nodes in memory, in bytes" },
     { NULL },   /* sentinel */
 };
 
 static PyMemberDef DLListMembers[] =
 {
-    { "first", T_OBJECT_EX, offsetof(DLListObject, first), READONLY,
+    { "first", T_OBJECT, offsetof(DLListObject, first), READONLY,
       "First node" },
-    { "last", T_OBJECT_EX, offsetof(DLListObject, last), READONLY,
+    { "last", T_OBJECT, offsetof(DLListObject, last), READONLY,
       "Next node" },
     { "size", T_INT, offsetof(DLListObject, size), READONLY,
       "Number of elements in the list" },
     { NULL },   /* sentinel */
 };
 
+static PyObject* dllist_get_deferred(DLListObject* self, void* closure)
+{
+    return PyBool_FromLong((self->flags & LLIST_DEFERRED_RELEASE) != 0);
+}
+
+static int dllist_set_deferred(DLListObject* self,
+                               PyObject* value,
+                               void* closure)
+{
+    int deferred;
+
+    if (value == NULL)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete deferred attribute");
+        return -1;
+    }
+
+    deferred = PyObject_IsTrue(value);
+    if (deferred < 0)
+        return -1;
+
+    if (deferred)
+        self->flags |= LLIST_DEFERRED_RELEASE;
+    else
+        self->flags &= ~LLIST_DEFERRED_RELEASE;
+
+    return 0;
+}
+
+static PyObject* dllist_get_arena_attr(DLListObject* self, void* closure)
+{
+    return PyBool_FromLong(self->arena != NULL);
+}
+
+static PyGetSetDef DLListGetSetters[] =
+{
+    { "arena", (getter)dllist_get_arena_attr, NULL,
+      "Whether nodes are allocated from a per-list arena", NULL },
+    { "deferred", (getter)dllist_get_deferred, (setter)dllist_set_deferred,
+      "Release nodes incrementally when the list is cleared or deleted",
+      NULL },
+    { NULL },   /* sentinel */
+};
+
 static PySequenceMethods DLListSequenceMethods =
 {
-    dllist_len,                 /* sq_length */
-    dllist_concat,              /* sq_concat */
-    dllist_repeat,              /* sq_repeat */
-    dllist_get_item,            /* sq_item */
+    dllist_len_locked,          /* sq_length */
+    dllist_concat_locked,       /* sq_concat */
+    dllist_repeat_locked,       /* sq_repeat */
+    dllist_get_item_locked,     /* sq_item */
     0,                          /* sq_slice */
-    dllist_set_item,            /* sq_ass_item */
+    dllist_set_item_locked,     /* sq_ass_item */
     0,                          /* sq_ass_slice */
     0,                          /* sq_contains */
-    dllist_inplace_concat,      /* sq_inplace_concat */
+    dllist_inplace_concat_locked, /* sq_inplace_concat */
     0,                          /* sq_inplace_repeat */
 };
 
@@ -1695,13 +3873,13 @@ static PyTypeObject DLListType =
     0,                          /* tp_getattr */
     0,                          /* tp_setattr */
     0,                          /* tp_compare */
-    (reprfunc)dllist_repr,      /* tp_repr */
+    (reprfunc)dllist_repr_locked, /* tp_repr */
     0,                          /* tp_as_number */
     &DLListSequenceMethods,     /* tp_as_sequence */
     0,                          /* tp_as_mapping */
-    (hashfunc)dllist_hash,      /* tp_hash */
+    (hashfunc)dllist_hash_locked, /* tp_hash */
     0,                          /* tp_call */
-    (reprfunc)dllist_str,       /* tp_str */
+    (reprfunc)dllist_str_locked, /* tp_str */
     0,                          /* tp_getattro */
     0,                          /* tp_setattro */
     0,                          /* tp_as_buffer */
@@ -1711,7 +3889,7 @@ static PyTypeObject DLListType =
     (traverseproc)dllist_traverse,
                                 /* tp_traverse */
     (inquiry)dllist_clear_refs, /* tp_clear */
-    (richcmpfunc)dllist_richcompare,
+    (richcmpfunc)dllist_richcompare_locked,
                                 /* tp_richcompare */
     offsetof(DLListObject, weakref_list),
                                 /* tp_weaklistoffset */
@@ -1719,190 +3897,752 @@ static PyTypeObject DLListType =
     0,                          /* tp_iternext */
     DLListMethods,              /* tp_methods */
     DLListMembers,              /* tp_members */
-    0,                          /* tp_getset */
+    DLListGetSetters,           /* tp_getset */
     0,                          /* tp_base */
     0,                          /* tp_dict */
     0,                          /* tp_descr_get */
     0,                          /* tp_descr_set */
     0,                          /* tp_dictoffset */
-    (initproc)dllist_init,      /* tp_init */
+    (initproc)dllist_init_locked, /* tp_init */
     0,                          /* tp_alloc */
     dllist_new,                 /* tp_new */
 };
 
 
-/* DLListIterator */
+/* DLListIterator */
+
+typedef struct
+{
+    PyObject_HEAD
+    DLListObject* list;
+    /* node returned by the last call to next(), NULL before first call */
+    PyObject* current_node;
+    int exhausted;
+    /* restart from the first node after the last one */
+    int cycle;
+} DLListIteratorObject;
+
+static int dllistiterator_traverse(DLListIteratorObject* self,
+                                    visitproc visit,
+                                    void* arg)
+{
+    Py_VISIT(self->list);
+    Py_VISIT(self->current_node);
+
+    return 0;
+}
+
+static int dllistiterator_clear_refs(DLListIteratorObject* self)
+{
+    Py_CLEAR(self->list);
+    Py_CLEAR(self->current_node);
+
+    return 0;
+}
+
+static void dllistiterator_dealloc(DLListIteratorObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    dllistiterator_clear_refs(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* dllistiterator_new(PyTypeObject* type,
+                                    PyObject* args,
+                                    PyObject* kwds)
+{
+    DLListIteratorObject* self;
+    PyObject* owner_list = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__new__", 1, 1, &owner_list))
+        return NULL;
+
+    if (!PyObject_TypeCheck(owner_list, &DLListType))
+    {
+        PyErr_SetString(PyExc_TypeError, "dllist argument expected");
+        return NULL;
+    }
+
+    self = (DLListIteratorObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->list = (DLListObject*)owner_list;
+    self->current_node = NULL;
+    self->exhausted = 0;
+    self->cycle = 0;
+
+    Py_INCREF(self->list);
+
+    return (PyObject*)self;
+}
+
+static void dllistiterator_set_cycle(PyObject* iterator)
+{
+    ((DLListIteratorObject*)iterator)->cycle = 1;
+}
+
+static DLListNodeObject* dllistiterator_advance(PyObject* self)
+{
+    DLListIteratorObject* iter_self = (DLListIteratorObject*)self;
+    PyObject* next_node;
+
+    if (iter_self->exhausted)
+    {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+
+    if (iter_self->current_node == NULL)
+    {
+        // first iteration
+        next_node = iter_self->list->first;
+    }
+    else
+        next_node = ((DLListNodeObject*)iter_self->current_node)->next;
+
+    /* cycling iterators stop only when the list is empty */
+    if (next_node == NULL && iter_self->cycle)
+        next_node = iter_self->list->first;
+
+    Py_XINCREF(next_node);
+    Py_XDECREF(iter_self->current_node);
+    iter_self->current_node = next_node;
+
+    if (next_node == NULL)
+    {
+        iter_self->exhausted = 1;
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+
+    return (DLListNodeObject*)next_node;
+}
+
+static PyObject* dllistvalueiterator_iternext(PyObject* self)
+{
+    DLListNodeObject* current_node = dllistiterator_advance(self);
+
+    if (current_node == NULL)
+        return NULL;
+
+    PyObject* value = current_node->value;
+    Py_INCREF(value);
+
+    return value;
+}
+
+static PyObject* dllistnodeiterator_iternext(PyObject* self)
+{
+    DLListNodeObject* current_node = dllistiterator_advance(self);
+    Py_XINCREF(current_node);
+    return (PyObject*)current_node;
+}
+
+LLIST_LOCKED_ITERNEXT(dllistvalueiterator_iternext_locked,
+    dllistvalueiterator_iternext, DLListIteratorObject)
+LLIST_LOCKED_ITERNEXT(dllistnodeiterator_iternext_locked,
+    dllistnodeiterator_iternext, DLListIteratorObject)
+
+static PyTypeObject DLListIteratorType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.dllistiterator",             /* tp_name */
+    sizeof(DLListIteratorObject),       /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)dllistiterator_dealloc, /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_compare */
+    0,                                  /* tp_repr */
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash */
+    0,                                  /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+                                        /* tp_flags */
+    "Doubly linked list iterator",      /* tp_doc */
+    (traverseproc)dllistiterator_traverse,
+                                        /* tp_traverse */
+    (inquiry)dllistiterator_clear_refs, /* tp_clear */
+    0,                                  /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    PyObject_SelfIter,                  /* tp_iter */
+    dllistvalueiterator_iternext_locked, /* tp_iternext */
+    0,                                  /* tp_methods */
+    0,                                  /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    dllistiterator_new,                 /* tp_new */
+};
+
+static PyTypeObject DLListNodeIteratorType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.dllistnodeiterator",         /* tp_name */
+    sizeof(DLListIteratorObject),       /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)dllistiterator_dealloc, /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_compare */
+    0,                                  /* tp_repr */
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash */
+    0,                                  /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+                                        /* tp_flags */
+    "Doubly linked list node iterator", /* tp_doc */
+    (traverseproc)dllistiterator_traverse,
+                                        /* tp_traverse */
+    (inquiry)dllistiterator_clear_refs, /* tp_clear */
+    0,                                  /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    PyObject_SelfIter,                  /* tp_iter */
+    dllistnodeiterator_iternext_locked, /* tp_iternext */
+    0,                                  /* tp_methods */
+    0,                                  /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    dllistiterator_new,                 /* tp_new */
+};
+
+/* DLListQueue */
+
+/* Unbounded FIFO queue storing values in nodes of a private dllist.
+ * put() returns the node holding the value, so that it can be removed
+ * from the queue in constant time with cancel().
+ *
+ * The list is protected by the GIL (or by a critical section on the
+ * list on free-threaded builds). The lock is used only to wake up
+ * consumers: it is held by a consumer while the queue is empty and
+ * released by put(), or by a consumer which took a value while other
+ * consumers may be waiting. The locked field tells whether the lock
+ * is held. */
+typedef struct
+{
+    PyObject_HEAD
+    DLListObject* list;
+    PyThread_type_lock lock;
+    int locked;
+    PyObject* weakref_list;
+} DLListQueueObject;
+
+#if PY_VERSION_HEX < 0x03020000
+/* Python 2 locks support only blocking and non-blocking acquisition,
+ * so waits with a timeout poll the lock every millisecond. Waits are
+ * never interrupted by signals. */
+typedef long long PY_TIMEOUT_T;
+#define PY_TIMEOUT_MAX 0x7fffffffffffffffLL
+
+typedef enum
+{
+    PY_LOCK_FAILURE = 0,
+    PY_LOCK_ACQUIRED = 1,
+    PY_LOCK_INTR
+} PyLockStatus;
+
+static PyLockStatus PyThread_acquire_lock_timed(PyThread_type_lock lock,
+                                                PY_TIMEOUT_T microseconds,
+                                                int intr_flag)
+{
+    if (microseconds < 0)
+        return PyThread_acquire_lock(lock, 1) ? PY_LOCK_ACQUIRED
+                                              : PY_LOCK_FAILURE;
+
+    for (;;)
+    {
+        if (PyThread_acquire_lock(lock, 0))
+            return PY_LOCK_ACQUIRED;
+
+        if (microseconds <= 0)
+            return PY_LOCK_FAILURE;
+
+#ifdef _WIN32
+        Sleep(1);
+#else
+        {
+            struct timespec delay = { 0, 1000000 };
+            nanosleep(&delay, NULL);
+        }
+#endif
+        microseconds -= 1000;
+    }
+}
+#endif
+
+/* Raise queue.Empty, importing it on first use. */
+static void dllistqueue_set_empty_error(void)
+{
+    static PyObject* empty_error = NULL;
+
+    if (empty_error == NULL)
+    {
+#if PY_MAJOR_VERSION >= 3
+        PyObject* module = PyImport_ImportModule("queue");
+#else
+        PyObject* module = PyImport_ImportModule("Queue");
+#endif
+        if (module == NULL)
+            return;
 
-typedef struct
+        empty_error = PyObject_GetAttrString(module, "Empty");
+        Py_DECREF(module);
+        if (empty_error == NULL)
+            return;
+    }
+
+    PyErr_SetNone(empty_error);
+}
+
+/* Return current time of the monotonic clock in seconds, or -1.0 with
+ * an exception set on failure. The clock is read in C, without calling
+ * time.monotonic(). */
+static double dllistqueue_monotonic(void)
 {
-    PyObject_HEAD
-    DLListObject* list;
-    PyObject* current_node;
-} DLListIteratorObject;
+#if PY_VERSION_HEX >= 0x030D0000
+    PyTime_t now;
+
+    if (PyTime_Monotonic(&now) < 0)
+        return -1.0;
+
+    return PyTime_AsSecondsDouble(now);
+#elif PY_VERSION_HEX >= 0x03050000
+    /* reports errors only during interpreter startup */
+    return _PyTime_AsSecondsDouble(_PyTime_GetMonotonicClock());
+#elif defined(_WIN32)
+    return GetTickCount64() / 1e3;
+#else
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+    {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1.0;
+    }
 
-static int dllistiterator_traverse(DLListIteratorObject* self,
-                                    visitproc visit,
-                                    void* arg)
+    return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+/* Convert timeout in seconds to microseconds. None means no timeout,
+ * which is stored as -1. Returns 0 and sets an exception on failure. */
+static int dllistqueue_parse_timeout(PyObject* arg, PY_TIMEOUT_T* timeout)
+{
+    double seconds;
+
+    if (arg == NULL || arg == Py_None)
+    {
+        *timeout = -1;
+        return 1;
+    }
+
+    seconds = PyFloat_AsDouble(arg);
+    if (seconds == -1.0 && PyErr_Occurred())
+        return 0;
+
+    if (!(seconds >= 0.0))
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "timeout must be a non-negative number");
+        return 0;
+    }
+
+    if (seconds * 1e6 > (double)PY_TIMEOUT_MAX)
+    {
+        PyErr_SetString(PyExc_OverflowError, "timeout value is too large");
+        return 0;
+    }
+
+    *timeout = (PY_TIMEOUT_T)(seconds * 1e6);
+    return 1;
+}
+
+/* Release the lock if a consumer holds it. Must be called with
+ * the list locked. */
+static void dllistqueue_wake_up(DLListQueueObject* self)
+{
+    if (self->locked)
+    {
+        PyThread_release_lock(self->lock);
+        self->locked = 0;
+    }
+}
+
+static int dllistqueue_traverse(DLListQueueObject* self,
+                                visitproc visit,
+                                void* arg)
 {
     Py_VISIT(self->list);
-    Py_VISIT(self->current_node);
 
     return 0;
 }
 
-static int dllistiterator_clear_refs(DLListIteratorObject* self)
+static int dllistqueue_clear_refs(DLListQueueObject* self)
 {
     Py_CLEAR(self->list);
-    Py_CLEAR(self->current_node);
 
     return 0;
 }
 
-static void dllistiterator_dealloc(DLListIteratorObject* self)
+static void dllistqueue_dealloc(DLListQueueObject* self)
 {
-    PyObject_GC_UnTrack(self);
     PyObject* obj_self = (PyObject*)self;
 
-    dllistiterator_clear_refs(self);
+    PyObject_GC_UnTrack(self);
+
+    if (self->weakref_list != NULL)
+        PyObject_ClearWeakRefs(obj_self);
+
+    dllistqueue_clear_refs(self);
+
+    if (self->lock != NULL)
+    {
+        if (self->locked)
+            PyThread_release_lock(self->lock);
+        PyThread_free_lock(self->lock);
+    }
 
     obj_self->ob_type->tp_free(obj_self);
 }
 
-static PyObject* dllistiterator_new(PyTypeObject* type,
-                                    PyObject* args,
-                                    PyObject* kwds)
+static PyObject* dllistqueue_new(PyTypeObject* type,
+                                 PyObject* args,
+                                 PyObject* kwds)
 {
-    DLListIteratorObject* self;
-    PyObject* owner_list = NULL;
+    DLListQueueObject* self;
 
-    if (!PyArg_UnpackTuple(args, "__new__", 1, 1, &owner_list))
+    self = (DLListQueueObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
         return NULL;
 
-    if (!PyObject_TypeCheck(owner_list, &DLListType))
+    self->list = NULL;
+    self->lock = NULL;
+    self->locked = 0;
+    self->weakref_list = NULL;
+
+    self->list = (DLListObject*)dllist_new(&DLListType, NULL, NULL);
+    if (self->list == NULL)
     {
-        PyErr_SetString(PyExc_TypeError, "dllist argument expected");
+        Py_DECREF(self);
         return NULL;
     }
 
-    self = (DLListIteratorObject*)type->tp_alloc(type, 0);
-    if (self == NULL)
+    self->lock = PyThread_allocate_lock();
+    if (self->lock == NULL)
+    {
+        Py_DECREF(self);
+        PyErr_SetString(PyExc_MemoryError, "Cannot allocate lock");
         return NULL;
+    }
 
-    self->list = (DLListObject*)owner_list;
-    self->current_node = NULL;
+    return (PyObject*)self;
+}
 
-    Py_INCREF(self->list);
+static int dllistqueue_init(DLListQueueObject* self,
+                            PyObject* args,
+                            PyObject* kwds)
+{
+    static char* kwlist[] = { NULL };
 
-    return (PyObject*)self;
+    return PyArg_ParseTupleAndKeywords(args, kwds, ":dllistqueue", kwlist)
+        ? 0 : -1;
 }
 
-static DLListNodeObject* dllistiterator_advance(PyObject* self)
+static PyObject* dllistqueue_put_internal(DLListQueueObject* self,
+                                          PyObject* item)
 {
-    DLListIteratorObject* iter_self = (DLListIteratorObject*)self;
+    DLListObject* list = self->list;
+    DLListNodeObject* new_node;
 
-    if (iter_self->current_node == NULL)
+    Py_BEGIN_CRITICAL_SECTION(list);
+
+    new_node = dllistnode_create(list->last, NULL, item, (PyObject*)list);
+    if (new_node != NULL)
     {
-        // first iteration
-        iter_self->current_node = iter_self->list->first;
-        Py_INCREF(iter_self->current_node);
+        list->last = (PyObject*)new_node;
+        if (list->first == NULL)
+            list->first = (PyObject*)new_node;
+
+        ++list->size;
+
+        Py_INCREF((PyObject*)new_node);
+
+        dllistqueue_wake_up(self);
     }
-    else if (iter_self->current_node != Py_None)
+
+    Py_END_CRITICAL_SECTION();
+
+    return (PyObject*)new_node;
+}
+
+/* Remove the first value from the queue, waiting at most timeout
+ * microseconds (or indefinitely if timeout is negative) for a value
+ * to be put if block is nonzero. */
+static PyObject* dllistqueue_get_internal(DLListQueueObject* self,
+                                          int block,
+                                          PY_TIMEOUT_T timeout)
+{
+    DLListObject* list = self->list;
+    double deadline = 0.0;
+
+    if (block && timeout > 0)
     {
-        PyObject* next_node;
+        deadline = dllistqueue_monotonic();
+        if (deadline == -1.0 && PyErr_Occurred())
+            return NULL;
 
-        next_node = ((DLListNodeObject*)iter_self->current_node)->next;
-        Py_INCREF(next_node);
-        Py_DECREF(iter_self->current_node);
-        iter_self->current_node = next_node;
+        deadline += timeout / 1e6;
     }
 
-    if (iter_self->current_node == Py_None)
+    for (;;)
     {
-        PyErr_SetNone(PyExc_StopIteration);
-        return NULL;
+        PyObject* value = NULL;
+        PyLockStatus status;
+
+        Py_BEGIN_CRITICAL_SECTION(list);
+
+        if (list->first != NULL)
+        {
+            value = dllist_popleft(list);
+
+            /* other consumers may be waiting for the remaining values */
+            dllistqueue_wake_up(self);
+        }
+
+        Py_END_CRITICAL_SECTION();
+
+        if (value != NULL)
+            return value;
+
+        if (!block)
+        {
+            dllistqueue_set_empty_error();
+            return NULL;
+        }
+
+        /* try without releasing the GIL first */
+        status = PyThread_acquire_lock_timed(self->lock, 0, 0);
+        if (status == PY_LOCK_FAILURE && timeout != 0)
+        {
+            Py_BEGIN_ALLOW_THREADS
+            status = PyThread_acquire_lock_timed(self->lock, timeout, 1);
+            Py_END_ALLOW_THREADS
+        }
+
+        if (status == PY_LOCK_FAILURE)
+        {
+            dllistqueue_set_empty_error();
+            return NULL;
+        }
+
+        if (status == PY_LOCK_INTR)
+        {
+            if (Py_MakePendingCalls() < 0)
+                return NULL;
+        }
+        else
+        {
+            Py_BEGIN_CRITICAL_SECTION(list);
+            self->locked = 1;
+            Py_END_CRITICAL_SECTION();
+        }
+
+        if (deadline > 0.0)
+        {
+            double now = dllistqueue_monotonic();
+            if (now == -1.0 && PyErr_Occurred())
+                return NULL;
+
+            /* after the deadline check the queue once more, without
+             * waiting */
+            timeout = (now < deadline)
+                ? (PY_TIMEOUT_T)((deadline - now) * 1e6) : 0;
+        }
     }
+}
+
+static PyObject* dllistqueue_put(DLListQueueObject* self,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    static char* kwlist[] = { "item", "block", "timeout", NULL };
 
-    return (DLListNodeObject*)iter_self->current_node;
+    PyObject* item = NULL;
+    PyObject* block = NULL;
+    PyObject* timeout = NULL;
+
+    /* the queue is never full, so block and timeout are accepted only
+     * for compatibility with queue.Queue */
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:put", kwlist,
+                                     &item, &block, &timeout))
+        return NULL;
+
+    return dllistqueue_put_internal(self, item);
 }
 
-static PyObject* dllistvalueiterator_iternext(PyObject* self)
+static PyObject* dllistqueue_put_nowait(DLListQueueObject* self,
+                                        PyObject* arg)
 {
-    DLListNodeObject* current_node = dllistiterator_advance(self);
+    return dllistqueue_put_internal(self, arg);
+}
 
-    if (current_node == NULL)
+static PyObject* dllistqueue_get(DLListQueueObject* self,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    static char* kwlist[] = { "block", "timeout", NULL };
+
+    int block = 1;
+    PyObject* timeout_obj = NULL;
+    PY_TIMEOUT_T timeout;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iO:get", kwlist,
+                                     &block, &timeout_obj))
         return NULL;
 
-    PyObject* value = current_node->value;
-    Py_INCREF(value);
+    if (!dllistqueue_parse_timeout(timeout_obj, &timeout))
+        return NULL;
 
-    return value;
+    return dllistqueue_get_internal(self, block, timeout);
 }
 
-static PyObject* dllistnodeiterator_iternext(PyObject* self)
+static PyObject* dllistqueue_get_nowait(DLListQueueObject* self)
 {
-    DLListNodeObject* current_node = dllistiterator_advance(self);
-    Py_XINCREF(current_node);
-    return (PyObject*)current_node;
+    return dllistqueue_get_internal(self, 0, 0);
 }
 
-static PyTypeObject DLListIteratorType =
+static PyObject* dllistqueue_cancel(DLListQueueObject* self, PyObject* arg)
 {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    "llist.dllistiterator",             /* tp_name */
-    sizeof(DLListIteratorObject),       /* tp_basicsize */
-    0,                                  /* tp_itemsize */
-    (destructor)dllistiterator_dealloc, /* tp_dealloc */
-    0,                                  /* tp_print */
-    0,                                  /* tp_getattr */
-    0,                                  /* tp_setattr */
-    0,                                  /* tp_compare */
-    0,                                  /* tp_repr */
-    0,                                  /* tp_as_number */
-    0,                                  /* tp_as_sequence */
-    0,                                  /* tp_as_mapping */
-    0,                                  /* tp_hash */
-    0,                                  /* tp_call */
-    0,                                  /* tp_str */
-    0,                                  /* tp_getattro */
-    0,                                  /* tp_setattro */
-    0,                                  /* tp_as_buffer */
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
-                                        /* tp_flags */
-    "Doubly linked list iterator",      /* tp_doc */
-    (traverseproc)dllistiterator_traverse,
-                                        /* tp_traverse */
-    (inquiry)dllistiterator_clear_refs, /* tp_clear */
-    0,                                  /* tp_richcompare */
-    0,                                  /* tp_weaklistoffset */
-    PyObject_SelfIter,                  /* tp_iter */
-    dllistvalueiterator_iternext,       /* tp_iternext */
-    0,                                  /* tp_methods */
-    0,                                  /* tp_members */
-    0,                                  /* tp_getset */
-    0,                                  /* tp_base */
-    0,                                  /* tp_dict */
-    0,                                  /* tp_descr_get */
-    0,                                  /* tp_descr_set */
-    0,                                  /* tp_dictoffset */
-    0,                                  /* tp_init */
-    0,                                  /* tp_alloc */
-    dllistiterator_new,                 /* tp_new */
+    DLListObject* list = self->list;
+    DLListNodeObject* node;
+    PyObject* result = NULL;
+
+    if (!PyObject_TypeCheck(arg, &DLListNodeType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument must be a dllistnode");
+        return NULL;
+    }
+
+    node = (DLListNodeObject*)arg;
+
+    Py_BEGIN_CRITICAL_SECTION(list);
+
+    if (node->list_weakref == NULL)
+    {
+        /* the value was already taken from the queue or cancelled */
+        result = Py_False;
+        Py_INCREF(result);
+    }
+    else if (node->list_weakref != list->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "dllistnode belongs to another list");
+    }
+    else
+    {
+        PyObject* value = dllist_remove(list, arg);
+        if (value != NULL)
+        {
+            Py_DECREF(value);
+            result = Py_True;
+            Py_INCREF(result);
+        }
+    }
+
+    Py_END_CRITICAL_SECTION();
+
+    return result;
+}
+
+static Py_ssize_t dllistqueue_len(PyObject* self)
+{
+    DLListObject* list = ((DLListQueueObject*)self)->list;
+    Py_ssize_t size;
+
+    Py_BEGIN_CRITICAL_SECTION(list);
+    size = list->size;
+    Py_END_CRITICAL_SECTION();
+
+    return size;
+}
+
+static PyObject* dllistqueue_qsize(DLListQueueObject* self)
+{
+    return PyLong_FromSsize_t(dllistqueue_len((PyObject*)self));
+}
+
+static PyObject* dllistqueue_empty(DLListQueueObject* self)
+{
+    return PyBool_FromLong(dllistqueue_len((PyObject*)self) == 0);
+}
+
+static PyMethodDef DLListQueueMethods[] =
+{
+    { "cancel", (PyCFunction)dllistqueue_cancel, METH_O,
+      "Remove node returned by put() from the queue, if it is still queued" },
+    { "empty", (PyCFunction)dllistqueue_empty, METH_NOARGS,
+      "Return True if the queue is empty" },
+    { "get", (PyCFunction)dllistqueue_get, METH_VARARGS | METH_KEYWORDS,
+      "Remove and return the first value, waiting for one if necessary" },
+    { "get_nowait", (PyCFunction)dllistqueue_get_nowait, METH_NOARGS,
+      "Remove and return the first value without waiting" },
+    { "put", (PyCFunction)dllistqueue_put, METH_VARARGS | METH_KEYWORDS,
+      "Append value to the queue and return its node" },
+    { "put_nowait", (PyCFunction)dllistqueue_put_nowait, METH_O,
+      "Append value to the queue and return its node" },
+    { "qsize", (PyCFunction)dllistqueue_qsize, METH_NOARGS,
+      "Return number of values in the queue" },
+    { NULL },   /* sentinel */
 };
 
-static PyTypeObject DLListNodeIteratorType =
+static PySequenceMethods DLListQueueSequenceMethods =
+{
+    dllistqueue_len,            /* sq_length */
+};
+
+static PyTypeObject DLListQueueType =
 {
     PyVarObject_HEAD_INIT(NULL, 0)
-    "llist.dllistnodeiterator",         /* tp_name */
-    sizeof(DLListIteratorObject),       /* tp_basicsize */
+    "llist.dllistqueue",                /* tp_name */
+    sizeof(DLListQueueObject),          /* tp_basicsize */
     0,                                  /* tp_itemsize */
-    (destructor)dllistiterator_dealloc, /* tp_dealloc */
+    (destructor)dllistqueue_dealloc,    /* tp_dealloc */
     0,                                  /* tp_print */
     0,                                  /* tp_getattr */
     0,                                  /* tp_setattr */
     0,                                  /* tp_compare */
     0,                                  /* tp_repr */
     0,                                  /* tp_as_number */
-    0,                                  /* tp_as_sequence */
+    &DLListQueueSequenceMethods,        /* tp_as_sequence */
     0,                                  /* tp_as_mapping */
     0,                                  /* tp_hash */
     0,                                  /* tp_call */
@@ -1912,15 +4652,16 @@ static PyTypeObject DLListNodeIteratorType =
     0,                                  /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
                                         /* tp_flags */
-    "Doubly linked list node iterator", /* tp_doc */
-    (traverseproc)dllistiterator_traverse,
-                                        /* tp_traverse */
-    (inquiry)dllistiterator_clear_refs, /* tp_clear */
+    "Thread-safe FIFO queue built on doubly linked list nodes",
+                                        /* tp_doc */
+    (traverseproc)dllistqueue_traverse, /* tp_traverse */
+    (inquiry)dllistqueue_clear_refs,    /* tp_clear */
     0,                                  /* tp_richcompare */
-    0,                                  /* tp_weaklistoffset */
-    PyObject_SelfIter,                  /* tp_iter */
-    dllistnodeiterator_iternext,        /* tp_iternext */
-    0,                                  /* tp_methods */
+    offsetof(DLListQueueObject, weakref_list),
+                                        /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    DLListQueueMethods,                 /* tp_methods */
     0,                                  /* tp_members */
     0,                                  /* tp_getset */
     0,                                  /* tp_base */
@@ -1928,9 +4669,9 @@ static PyTypeObject DLListNodeIteratorType =
     0,                                  /* tp_descr_get */
     0,                                  /* tp_descr_set */
     0,                                  /* tp_dictoffset */
-    0,                                  /* tp_init */
+    (initproc)dllistqueue_init,         /* tp_init */
     0,                                  /* tp_alloc */
-    dllistiterator_new,                 /* tp_new */
+    dllistqueue_new,                    /* tp_new */
 };
 
 LLIST_INTERNAL int dllist_init_type(void)
@@ -1939,7 +4680,8 @@ LLIST_INTERNAL int dllist_init_type(void)
         ((PyType_Ready(&DLListType) == 0) &&
          (PyType_Ready(&DLListNodeType) == 0) &&
          (PyType_Ready(&DLListIteratorType) == 0) &&
-         (PyType_Ready(&DLListNodeIteratorType) == 0))
+         (PyType_Ready(&DLListNodeIteratorType) == 0) &&
+         (PyType_Ready(&DLListQueueType) == 0))
         ? 1 : 0;
 }
 
@@ -1949,6 +4691,7 @@ LLIST_INTERNAL void dllist_register(PyObject* module)
     Py_INCREF(&DLListNodeType);
     Py_INCREF(&DLListIteratorType);
     Py_INCREF(&DLListNodeIteratorType);
+    Py_INCREF(&DLListQueueType);
 
     PyModule_AddObject(module, "dllist", (PyObject*)&DLListType);
     PyModule_AddObject(module, "dllistnode", (PyObject*)&DLListNodeType);
@@ -1956,4 +4699,5 @@ LLIST_INTERNAL void dllist_register(PyObject* module)
         module, "dllistiterator", (PyObject*)&DLListIteratorType);
     PyModule_AddObject(
         module, "dllistnodeiterator", (PyObject*)&DLListNodeIteratorType);
+    PyModule_AddObject(module, "dllistqueue", (PyObject*)&DLListQueueType);
 }
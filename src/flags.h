@@ -5,6 +5,6 @@
 #ifndef FLAGS_H
 #define FLAGS_H
 
-#define LLIST_HAS_PY_NONE_REF (0x01)
+#define LLIST_DEFERRED_RELEASE (0x02)
 
 #endif /* FLAGS_H */
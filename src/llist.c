@@ -6,9 +6,27 @@
 
 #include "sllist.h"
 #include "dllist.h"
+#include "typedsllist.h"
+#include "typeddllist.h"
+#include "ullist.h"
+#include "adllist.h"
+#include "deferred.h"
+#include "utils.h"
+
+static PyObject* llist_drain(PyObject* self, PyObject* args)
+{
+    Py_ssize_t budget = -1;
+
+    if (!PyArg_ParseTuple(args, "|n:drain", &budget))
+        return NULL;
+
+    return PyLong_FromSsize_t(llist_release_pending(budget));
+}
 
 static PyMethodDef llist_methods[] =
 {
+    { "drain", (PyCFunction)llist_drain, METH_VARARGS,
+      "Release nodes pending after deferred clear or deletion of lists" },
     { NULL }    /* sentinel */
 };
 
@@ -35,15 +53,35 @@ PyInit__llist(void)
 {
     PyObject* m;
 
+    if (!llist_utils_init())
+        return NULL;
     if (!sllist_init_type())
         return NULL;
     if (!dllist_init_type())
         return NULL;
+    if (!typedsllist_init_type())
+        return NULL;
+    if (!typeddllist_init_type())
+        return NULL;
+    if (!ullist_init_type())
+        return NULL;
+    if (!adllist_init_type())
+        return NULL;
 
     m = PyModule_Create(&llist_moduledef);
+    if (m == NULL)
+        return NULL;
+
+    /* List operations hold per-list critical sections (see lock.h), but
+     * the module does not declare Py_MOD_GIL_NOT_USED yet, so free-threaded
+     * builds enable the GIL on import until the module is tested on them. */
 
     sllist_register(m);
     dllist_register(m);
+    typedsllist_register(m);
+    typeddllist_register(m);
+    ullist_register(m);
+    adllist_register(m);
 
     return m;
 }
@@ -55,16 +93,30 @@ init_llist(void)
 {
     PyObject* m;
 
+    if (!llist_utils_init())
+        return;
     if (!sllist_init_type())
         return;
     if (!dllist_init_type())
         return;
+    if (!typedsllist_init_type())
+        return;
+    if (!typeddllist_init_type())
+        return;
+    if (!ullist_init_type())
+        return;
+    if (!adllist_init_type())
+        return;
 
     m = Py_InitModule3("_llist", llist_methods,
                        "Singly and doubly linked lists.");
 
     sllist_register(m);
     dllist_register(m);
+    typedsllist_register(m);
+    typeddllist_register(m);
+    ullist_register(m);
+    adllist_register(m);
 }
 
 #endif /* PY_MAJOR_VERSION >= 3 */
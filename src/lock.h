@@ -0,0 +1,213 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef LOCK_H
+#define LOCK_H
+
+#include <Python.h>
+
+/* On free-threaded builds lists are protected by per-object critical
+ * sections. Builds with the GIL do not need them, so the macros expand
+ * to plain blocks there (Python older than 3.13 does not define them). */
+#ifndef Py_BEGIN_CRITICAL_SECTION
+#define Py_BEGIN_CRITICAL_SECTION(op) {
+#define Py_END_CRITICAL_SECTION() }
+#define Py_BEGIN_CRITICAL_SECTION2(a, b) {
+#define Py_END_CRITICAL_SECTION2() }
+#endif
+
+/* The following macros define wrappers, which call the wrapped function
+ * with a critical section held on the list (and on the other operand for
+ * binary operations). Wrappers are used only in method tables and type
+ * slots, internal calls go directly to the wrapped functions. The first
+ * argument is passed through void*, so the wrapped function may declare
+ * it either as PyObject* or as a pointer to the list object. */
+
+#define LLIST_LOCKED_NOARGS(name, func)                                 \
+    static PyObject* name(PyObject* self, PyObject* unused)             \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func((void*)self);                                     \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+/* for METH_O and METH_VARARGS methods */
+#define LLIST_LOCKED_ARG(name, func)                                    \
+    static PyObject* name(PyObject* self, PyObject* arg)                \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func((void*)self, arg);                                \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+/* for METH_VARARGS | METH_KEYWORDS methods */
+#define LLIST_LOCKED_KWARGS(name, func)                                 \
+    static PyObject* name(PyObject* self, PyObject* args, PyObject* kwds) \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func((void*)self, args, kwds);                         \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+/* for methods reading from another object, e.g. extend() */
+#define LLIST_LOCKED_ARG2(name, func)                                   \
+    static PyObject* name(PyObject* self, PyObject* arg)                \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION2(self, arg);                          \
+        result = func((void*)self, arg);                                \
+        Py_END_CRITICAL_SECTION2();                                     \
+        return result;                                                  \
+    }
+
+/* for METH_VARARGS methods adopting a node passed as the first argument,
+ * e.g. insertnode() */
+#define LLIST_LOCKED_ARGS2(name, func)                                  \
+    static PyObject* name(PyObject* self, PyObject* args)               \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION2(self, PyTuple_GET_SIZE(args) > 0 ?   \
+            PyTuple_GET_ITEM(args, 0) : self);                          \
+        result = func((void*)self, args);                               \
+        Py_END_CRITICAL_SECTION2();                                     \
+        return result;                                                  \
+    }
+
+#define LLIST_LOCKED_INIT(name, func)                                   \
+    static int name(PyObject* self, PyObject* args, PyObject* kwds)     \
+    {                                                                   \
+        int result;                                                     \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func((void*)self, args, kwds);                         \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+/* for tp_repr and tp_str */
+#define LLIST_LOCKED_UNARY(name, func)                                  \
+    static PyObject* name(PyObject* self)                               \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func((void*)self);                                     \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+#define LLIST_LOCKED_HASH(name, func)                                   \
+    static long name(PyObject* self)                                    \
+    {                                                                   \
+        long result;                                                    \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func((void*)self);                                     \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+#define LLIST_LOCKED_RICHCOMPARE(name, func)                            \
+    static PyObject* name(PyObject* self, PyObject* other, int op)      \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION2(self, other);                        \
+        result = func((void*)self, (void*)other, op);                   \
+        Py_END_CRITICAL_SECTION2();                                     \
+        return result;                                                  \
+    }
+
+#define LLIST_LOCKED_LEN(name, func)                                    \
+    static Py_ssize_t name(PyObject* self)                              \
+    {                                                                   \
+        Py_ssize_t result;                                              \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func(self);                                            \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+/* for sq_concat and sq_inplace_concat */
+#define LLIST_LOCKED_CONCAT(name, func)                                 \
+    static PyObject* name(PyObject* self, PyObject* other)              \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION2(self, other);                        \
+        result = func(self, other);                                     \
+        Py_END_CRITICAL_SECTION2();                                     \
+        return result;                                                  \
+    }
+
+/* for sq_repeat and sq_item */
+#define LLIST_LOCKED_INDEX(name, func)                                  \
+    static PyObject* name(PyObject* self, Py_ssize_t index)             \
+    {                                                                   \
+        PyObject* result;                                               \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func(self, index);                                     \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+#define LLIST_LOCKED_ASS_ITEM(name, func)                               \
+    static int name(PyObject* self, Py_ssize_t index, PyObject* value)  \
+    {                                                                   \
+        int result;                                                     \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func(self, index, value);                              \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+#define LLIST_LOCKED_CONTAINS(name, func)                               \
+    static int name(PyObject* self, PyObject* value)                    \
+    {                                                                   \
+        int result;                                                     \
+        Py_BEGIN_CRITICAL_SECTION(self);                                \
+        result = func(self, value);                                     \
+        Py_END_CRITICAL_SECTION();                                      \
+        return result;                                                  \
+    }
+
+/* For tp_iternext of list iterators. Both the iterator and the iterated
+ * list (stored in the list field) are locked. The list field is read with
+ * the iterator locked, and checked again once both locks are held, since
+ * another thread may exhaust the iterator (releasing the list) while no
+ * lock is held. The list is kept alive until the critical section ends,
+ * because the iterator may release it. */
+#define LLIST_LOCKED_ITERNEXT(name, func, iter_type)                    \
+    static PyObject* name(PyObject* self)                               \
+    {                                                                   \
+        PyObject* list;                                                 \
+        PyObject* result = NULL;                                        \
+        int done = 0;                                                   \
+        while (!done)                                                   \
+        {                                                               \
+            Py_BEGIN_CRITICAL_SECTION(self);                            \
+            list = (PyObject*)((iter_type*)self)->list;                 \
+            Py_XINCREF(list);                                           \
+            if (list == NULL)                                           \
+            {                                                           \
+                result = func(self);                                    \
+                done = 1;                                               \
+            }                                                           \
+            Py_END_CRITICAL_SECTION();                                  \
+            if (list == NULL)                                           \
+                break;                                                  \
+            Py_BEGIN_CRITICAL_SECTION2(self, list);                     \
+            if ((PyObject*)((iter_type*)self)->list == list)            \
+            {                                                           \
+                result = func(self);                                    \
+                done = 1;                                               \
+            }                                                           \
+            Py_END_CRITICAL_SECTION2();                                 \
+            Py_DECREF(list);                                            \
+        }                                                               \
+        return result;                                                  \
+    }
+
+#endif /* LOCK_H */
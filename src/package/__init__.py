@@ -1,10 +1,27 @@
+import atexit
+
 from llist._llist import (
+    adllist,
+    adllistiterator,
     dllist,
-    dllistnode,
+    dllist_f64,
+    dllist_i64,
     dllistiterator,
+    dllistnode,
     dllistnodeiterator,
+    dllistqueue,
+    drain,
     sllist,
-    sllistnode,
+    sllist_f64,
+    sllist_i64,
     sllistiterator,
-    sllistnodeiterator
+    sllistnode,
+    sllistnodeiterator,
+    typeddllistiterator,
+    typedsllistiterator,
+    ullist,
+    ullistiterator
 )
+
+# release nodes of lists which were cleared or deleted in deferred mode
+atexit.register(drain)
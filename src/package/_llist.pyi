@@ -1,21 +1,27 @@
 import typing
-from collections.abc import Sequence
-from typing import Any, Generic, Optional, TypeVar
+from collections.abc import Callable, Iterable, Sequence
+from typing import Any, Generic, Optional, TypeVar, Union
 from _typeshed import Incomplete as Incomplete
 
 
 T = TypeVar('T')
 
 
+def drain(budget: int = ...) -> int: ...
+
+
 class dllist:
     first: Optional[dllistnode[Any]]
     last: Optional[dllistnode[Any]]
     size: int
+    deferred: bool
+    arena: bool
 
     @typing.overload
-    def __init__(self) -> None: ...
+    def __init__(self, *, deferred: bool = ..., arena: bool = ...) -> None: ...
     @typing.overload
-    def __init__(self, items: Sequence[Any]) -> None: ...
+    def __init__(self, items: Sequence[Any], deferred: bool = ...,
+                 arena: bool = ...) -> None: ...
 
     @typing.overload
     def append(self, value: T) -> dllistnode[T]: ...
@@ -34,12 +40,31 @@ class dllist:
 
     def appendnode(self, node: dllistnode[T]) -> dllistnode[T]: ...
 
+    def apply(self, func: Callable[[T], Any]) -> None: ...
+
+    def bisectleft(self, x: Any,
+                   key: Optional[Callable[[Any], Any]] = ...,
+                   hint: Optional[dllistnode[Any]] = ...) -> Optional[dllistnode[Any]]: ...
+
+    def bisectright(self, x: Any,
+                    key: Optional[Callable[[Any], Any]] = ...,
+                    hint: Optional[dllistnode[Any]] = ...) -> Optional[dllistnode[Any]]: ...
+
     def clear(self) -> None: ...
 
+    def dedupe(self, key: Optional[Callable[[T], Any]] = ...) -> int: ...
+
+    def dedupeadjacent(self,
+                       key: Optional[Callable[[T], Any]] = ...) -> int: ...
+
     def extend(self, items: Sequence[Any]) -> None: ...
 
     def extendleft(self, items: Sequence[Any]) -> None: ...
 
+    def extendleftnodes(self, items: Sequence[T]) -> list[dllistnode[T]]: ...
+
+    def extendnodes(self, items: Sequence[T]) -> list[dllistnode[T]]: ...
+
     def extendright(self, items: Sequence[Any]) -> None: ...
 
     @typing.overload
@@ -63,22 +88,57 @@ class dllist:
 
     def insertnodebefore(self, node: dllistnode[T], before_ref: dllistnode[Any]) -> dllistnode[T]: ...
 
+    def insort(self, value: T,
+               key: Optional[Callable[[Any], Any]] = ...,
+               hint: Optional[dllistnode[Any]] = ...) -> dllistnode[T]: ...
+
+    def itercycle(self) -> dllistiterator: ...
+
+    def itercyclenodes(self) -> dllistnodeiterator: ...
+
     def iternodes(self) -> dllistnodeiterator: ...
 
     def itervalues(self) -> dllistiterator: ...
 
+    def memory_stats(self) -> dict[str, int]: ...
+
+    def merge(self, other: dllist,
+              key: Optional[Callable[[Any], Any]] = ...) -> None: ...
+
     def nodeat(self, index: int) -> dllistnode[Any]: ...
 
+    def partition(self, predicate: Callable[[T], Any]) -> dllist: ...
+
     def pop(self) -> Any: ...
 
     def popleft(self) -> Any: ...
 
+    def popleftn(self, n: int) -> list[T]: ...
+
     def popright(self) -> Any: ...
 
+    def poprightn(self, n: int) -> list[T]: ...
+
     def remove(self, node: dllistnode[T]) -> T: ...
 
+    def removeif(self, predicate: Callable[[T], Any],
+                 values: bool = ...) -> Union[int, list[T]]: ...
+
+    def removenodes(self, nodes: Iterable[dllistnode[T]]) -> list[T]: ...
+
+    def retain(self, predicate: Callable[[T], Any],
+               values: bool = ...) -> Union[int, list[T]]: ...
+
     def rotate(self, n: int) -> None: ...
 
+    def rotateafter(self, node: dllistnode[Any]) -> None: ...
+
+    def rotateto(self, node: dllistnode[Any]) -> None: ...
+
+    def splitafter(self, node: dllistnode[Any]) -> dllist: ...
+
+    def splitbefore(self, node: dllistnode[Any]) -> dllist: ...
+
     def __add__(self, other: Any) -> None: ...
     def __delitem__(self, other: Any) -> None: ...
     def __eq__(self, other: Any) -> bool: ...
@@ -101,6 +161,8 @@ class dllistnode(Generic[T]):
     value: Optional[T]
     prev: Optional[dllistnode[Any]]
     next: Optional[dllistnode[Any]]
+    nextwrap: Optional[dllistnode[Any]]
+    prevwrap: Optional[dllistnode[Any]]
     owner: Optional[dllist]
 
     def __init__(self, *args, **kwargs) -> None: ...
@@ -121,15 +183,30 @@ class dllistnodeiterator:
     def __next__(self) -> dllistnode[Any]: ...
 
 
+class dllistqueue:
+    def __init__(self) -> None: ...
+    def cancel(self, node: dllistnode[Any]) -> bool: ...
+    def empty(self) -> bool: ...
+    def get(self, block: bool = ..., timeout: Optional[float] = ...) -> Any: ...
+    def get_nowait(self) -> Any: ...
+    def put(self, item: Any, block: bool = ..., timeout: Optional[float] = ...) -> dllistnode[Any]: ...
+    def put_nowait(self, item: Any) -> dllistnode[Any]: ...
+    def qsize(self) -> int: ...
+    def __len__(self) -> int: ...
+
+
 class sllist:
     first: Optional[sllistnode[Any]]
     last: Optional[sllistnode[Any]]
     size: int
+    deferred: bool
+    arena: bool
 
     @typing.overload
-    def __init__(self) -> None: ...
+    def __init__(self, *, deferred: bool = ..., arena: bool = ...) -> None: ...
     @typing.overload
-    def __init__(self, items: Sequence[Any]) -> None: ...
+    def __init__(self, items: Sequence[Any], deferred: bool = ...,
+                 arena: bool = ...) -> None: ...
 
     @typing.overload
     def append(self, value: T) -> sllistnode[T]: ...
@@ -148,12 +225,23 @@ class sllist:
 
     def appendnode(self, node: sllistnode[T]) -> sllistnode[T]: ...
 
+    def apply(self, func: Callable[[T], Any]) -> None: ...
+
     def clear(self) -> None: ...
 
+    def dedupe(self, key: Optional[Callable[[T], Any]] = ...) -> int: ...
+
+    def dedupeadjacent(self,
+                       key: Optional[Callable[[T], Any]] = ...) -> int: ...
+
     def extend(self, items: Sequence[Any]) -> None: ...
 
     def extendleft(self, items: Sequence[Any]) -> None: ...
 
+    def extendleftnodes(self, items: Sequence[T]) -> list[sllistnode[T]]: ...
+
+    def extendnodes(self, items: Sequence[T]) -> list[sllistnode[T]]: ...
+
     def extendright(self, items: Sequence[Any]) -> None: ...
 
     @typing.overload
@@ -162,30 +250,67 @@ class sllist:
     def insertafter(self, node: sllistnode[T], after_ref: sllistnode[Any]) -> sllistnode[T]: ...
 
     @typing.overload
-    def insertbefore(self, value: T, before_ref: sllistnode[Any]) -> sllistnode[T]: ...
+    def insertbefore(self, value: T, before_ref: sllistnode[Any], prev: Optional[sllistnode[Any]] = None) -> sllistnode[T]: ...
     @typing.overload
-    def insertbefore(self, node: sllistnode[T], before_ref: sllistnode[Any]) -> sllistnode[T]: ...
+    def insertbefore(self, node: sllistnode[T], before_ref: sllistnode[Any], prev: Optional[sllistnode[Any]] = None) -> sllistnode[T]: ...
 
     def insertnodeafter(self, node: sllistnode[T], after_ref: sllistnode[Any]) -> sllistnode[T]: ...
 
     def insertnodebefore(self, node: sllistnode[T], before_ref: sllistnode[Any]) -> sllistnode[T]: ...
 
+    def itercycle(self) -> sllistiterator: ...
+
+    def itercyclenodes(self) -> sllistnodeiterator: ...
+
     def iternodes(self) -> sllistnodeiterator: ...
 
     def itervalues(self) -> sllistiterator: ...
 
+    def memory_stats(self) -> dict[str, int]: ...
+
+    def merge(self, other: sllist,
+              key: Optional[Callable[[Any], Any]] = ...) -> None: ...
+
     def nodeat(self, index: int) -> sllistnode[Any]: ...
 
+    def partition(self, predicate: Callable[[T], Any]) -> sllist: ...
+
     def pop(self) -> Any: ...
 
+    def popafter(self, node: sllistnode[Any]) -> Any: ...
+
     def popleft(self) -> Any: ...
 
+    def popleftn(self, n: int) -> list[T]: ...
+
     def popright(self) -> Any: ...
 
-    def remove(self, node: sllistnode[T]) -> T: ...
+    def poprightn(self, n: int) -> list[T]: ...
+
+    def remove(self, node: sllistnode[T], prev: Optional[sllistnode[Any]] = None) -> T: ...
+
+    def removeafter(self, node: sllistnode[Any]) -> Optional[sllistnode[T]]: ...
+
+    def removeif(self, predicate: Callable[[T], Any],
+                 values: bool = ...) -> Union[int, list[T]]: ...
+
+    def removenodes(self, nodes: Iterable[sllistnode[T]]) -> list[T]: ...
+
+    def retain(self, predicate: Callable[[T], Any],
+               values: bool = ...) -> Union[int, list[T]]: ...
 
     def rotate(self, n: int) -> None: ...
 
+    def rotateafter(self, node: sllistnode[Any]) -> None: ...
+
+    def rotateto(self, node: sllistnode[Any],
+                 prev: Optional[sllistnode[Any]] = None) -> None: ...
+
+    def splitafter(self, node: sllistnode[Any]) -> sllist: ...
+
+    def splitbefore(self, node: sllistnode[Any],
+                    prev: Optional[sllistnode[Any]] = None) -> sllist: ...
+
     def __add__(self, other: Any) -> None: ...
     def __delitem__(self, other: Any) -> None: ...
     def __eq__(self, other: Any) -> bool: ...
@@ -207,6 +332,7 @@ class sllist:
 class sllistnode(Generic[T]):
     value: Optional[T]
     next: Optional[sllistnode[Any]]
+    nextwrap: Optional[sllistnode[Any]]
     owner: Optional[sllist]
 
     def __init__(self, *args, **kwargs) -> None: ...
@@ -225,3 +351,364 @@ class sllistnodeiterator:
     def __init__(cls, *args, **kwargs) -> None: ...
     def __iter__(self) -> sllistnodeiterator: ...
     def __next__(self) -> sllistnode[Any]: ...
+
+
+class dllist_i64:
+    size: int
+
+    @typing.overload
+    def __init__(self) -> None: ...
+    @typing.overload
+    def __init__(self, items: Iterable[int]) -> None: ...
+
+    def append(self, value: int) -> None: ...
+
+    def appendleft(self, value: int) -> None: ...
+
+    def appendright(self, value: int) -> None: ...
+
+    def clear(self) -> None: ...
+
+    def extend(self, items: Iterable[int]) -> None: ...
+
+    def extendleft(self, items: Iterable[int]) -> None: ...
+
+    def extendright(self, items: Iterable[int]) -> None: ...
+
+    def pop(self) -> int: ...
+
+    def popleft(self) -> int: ...
+
+    def popright(self) -> int: ...
+
+    def remove(self, value: int) -> None: ...
+
+    def rotate(self, n: int) -> None: ...
+
+    def __add__(self, other: Iterable[int]) -> dllist_i64: ...
+    def __contains__(self, value: Any) -> bool: ...
+    def __delitem__(self, index: int) -> None: ...
+    def __eq__(self, other: Any) -> bool: ...
+    def __ge__(self, other: Any) -> bool: ...
+    def __getitem__(self, index: int) -> int: ...
+    def __gt__(self, other: Any) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __iadd__(self, other: Iterable[int]) -> dllist_i64: ...
+    def __iter__(self) -> typeddllistiterator: ...
+    def __le__(self, other: Any) -> bool: ...
+    def __len__(self) -> int: ...
+    def __lt__(self, other: Any) -> bool: ...
+    def __mul__(self, other: int) -> dllist_i64: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __rmul__(self, other: int) -> dllist_i64: ...
+    def __setitem__(self, index: int, value: int) -> None: ...
+
+
+class dllist_f64:
+    size: int
+
+    @typing.overload
+    def __init__(self) -> None: ...
+    @typing.overload
+    def __init__(self, items: Iterable[float]) -> None: ...
+
+    def append(self, value: float) -> None: ...
+
+    def appendleft(self, value: float) -> None: ...
+
+    def appendright(self, value: float) -> None: ...
+
+    def clear(self) -> None: ...
+
+    def extend(self, items: Iterable[float]) -> None: ...
+
+    def extendleft(self, items: Iterable[float]) -> None: ...
+
+    def extendright(self, items: Iterable[float]) -> None: ...
+
+    def pop(self) -> float: ...
+
+    def popleft(self) -> float: ...
+
+    def popright(self) -> float: ...
+
+    def remove(self, value: float) -> None: ...
+
+    def rotate(self, n: int) -> None: ...
+
+    def __add__(self, other: Iterable[float]) -> dllist_f64: ...
+    def __contains__(self, value: Any) -> bool: ...
+    def __delitem__(self, index: int) -> None: ...
+    def __eq__(self, other: Any) -> bool: ...
+    def __ge__(self, other: Any) -> bool: ...
+    def __getitem__(self, index: int) -> float: ...
+    def __gt__(self, other: Any) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __iadd__(self, other: Iterable[float]) -> dllist_f64: ...
+    def __iter__(self) -> typeddllistiterator: ...
+    def __le__(self, other: Any) -> bool: ...
+    def __len__(self) -> int: ...
+    def __lt__(self, other: Any) -> bool: ...
+    def __mul__(self, other: int) -> dllist_f64: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __rmul__(self, other: int) -> dllist_f64: ...
+    def __setitem__(self, index: int, value: float) -> None: ...
+
+
+class typeddllistiterator:
+    @classmethod
+    def __init__(cls, *args, **kwargs) -> None: ...
+    def __iter__(self) -> typeddllistiterator: ...
+    def __next__(self) -> Any: ...
+
+
+class sllist_i64:
+    size: int
+
+    @typing.overload
+    def __init__(self) -> None: ...
+    @typing.overload
+    def __init__(self, items: Iterable[int]) -> None: ...
+
+    def append(self, value: int) -> None: ...
+
+    def appendleft(self, value: int) -> None: ...
+
+    def appendright(self, value: int) -> None: ...
+
+    def clear(self) -> None: ...
+
+    def extend(self, items: Iterable[int]) -> None: ...
+
+    def extendleft(self, items: Iterable[int]) -> None: ...
+
+    def extendright(self, items: Iterable[int]) -> None: ...
+
+    def pop(self) -> int: ...
+
+    def popleft(self) -> int: ...
+
+    def popright(self) -> int: ...
+
+    def remove(self, value: int) -> None: ...
+
+    def rotate(self, n: int) -> None: ...
+
+    def __add__(self, other: Iterable[int]) -> sllist_i64: ...
+    def __contains__(self, value: Any) -> bool: ...
+    def __delitem__(self, index: int) -> None: ...
+    def __eq__(self, other: Any) -> bool: ...
+    def __ge__(self, other: Any) -> bool: ...
+    def __getitem__(self, index: int) -> int: ...
+    def __gt__(self, other: Any) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __iadd__(self, other: Iterable[int]) -> sllist_i64: ...
+    def __iter__(self) -> typedsllistiterator: ...
+    def __le__(self, other: Any) -> bool: ...
+    def __len__(self) -> int: ...
+    def __lt__(self, other: Any) -> bool: ...
+    def __mul__(self, other: int) -> sllist_i64: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __rmul__(self, other: int) -> sllist_i64: ...
+    def __setitem__(self, index: int, value: int) -> None: ...
+
+
+class sllist_f64:
+    size: int
+
+    @typing.overload
+    def __init__(self) -> None: ...
+    @typing.overload
+    def __init__(self, items: Iterable[float]) -> None: ...
+
+    def append(self, value: float) -> None: ...
+
+    def appendleft(self, value: float) -> None: ...
+
+    def appendright(self, value: float) -> None: ...
+
+    def clear(self) -> None: ...
+
+    def extend(self, items: Iterable[float]) -> None: ...
+
+    def extendleft(self, items: Iterable[float]) -> None: ...
+
+    def extendright(self, items: Iterable[float]) -> None: ...
+
+    def pop(self) -> float: ...
+
+    def popleft(self) -> float: ...
+
+    def popright(self) -> float: ...
+
+    def remove(self, value: float) -> None: ...
+
+    def rotate(self, n: int) -> None: ...
+
+    def __add__(self, other: Iterable[float]) -> sllist_f64: ...
+    def __contains__(self, value: Any) -> bool: ...
+    def __delitem__(self, index: int) -> None: ...
+    def __eq__(self, other: Any) -> bool: ...
+    def __ge__(self, other: Any) -> bool: ...
+    def __getitem__(self, index: int) -> float: ...
+    def __gt__(self, other: Any) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __iadd__(self, other: Iterable[float]) -> sllist_f64: ...
+    def __iter__(self) -> typedsllistiterator: ...
+    def __le__(self, other: Any) -> bool: ...
+    def __len__(self) -> int: ...
+    def __lt__(self, other: Any) -> bool: ...
+    def __mul__(self, other: int) -> sllist_f64: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __rmul__(self, other: int) -> sllist_f64: ...
+    def __setitem__(self, index: int, value: float) -> None: ...
+
+
+class typedsllistiterator:
+    @classmethod
+    def __init__(cls, *args, **kwargs) -> None: ...
+    def __iter__(self) -> typedsllistiterator: ...
+    def __next__(self) -> Any: ...
+
+
+class ullist:
+    size: int
+
+    @typing.overload
+    def __init__(self) -> None: ...
+    @typing.overload
+    def __init__(self, items: Iterable[Any]) -> None: ...
+
+    def append(self, value: Any) -> None: ...
+
+    def appendleft(self, value: Any) -> None: ...
+
+    def appendright(self, value: Any) -> None: ...
+
+    def clear(self) -> None: ...
+
+    def extend(self, items: Iterable[Any]) -> None: ...
+
+    def extendleft(self, items: Iterable[Any]) -> None: ...
+
+    def extendright(self, items: Iterable[Any]) -> None: ...
+
+    def index(self, value: Any) -> int: ...
+
+    def insert(self, value: Any, index: Optional[int] = None) -> None: ...
+
+    def pop(self) -> Any: ...
+
+    def popleft(self) -> Any: ...
+
+    def popright(self) -> Any: ...
+
+    def remove(self, value: Any) -> None: ...
+
+    def rotate(self, n: int) -> None: ...
+
+    def __add__(self, other: Iterable[Any]) -> ullist: ...
+    def __contains__(self, value: Any) -> bool: ...
+    def __delitem__(self, index: int) -> None: ...
+    def __eq__(self, other: Any) -> bool: ...
+    def __ge__(self, other: Any) -> bool: ...
+    def __getitem__(self, index: int) -> Any: ...
+    def __gt__(self, other: Any) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __iadd__(self, other: Iterable[Any]) -> ullist: ...
+    def __iter__(self) -> ullistiterator: ...
+    def __le__(self, other: Any) -> bool: ...
+    def __len__(self) -> int: ...
+    def __lt__(self, other: Any) -> bool: ...
+    def __mul__(self, other: int) -> ullist: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __rmul__(self, other: int) -> ullist: ...
+    def __setitem__(self, index: int, value: Any) -> None: ...
+
+
+class ullistiterator:
+    @classmethod
+    def __init__(cls, *args, **kwargs) -> None: ...
+    def __iter__(self) -> ullistiterator: ...
+    def __next__(self) -> Any: ...
+
+
+class adllist:
+    first: Optional[int]
+    last: Optional[int]
+    size: int
+    capacity: int
+
+    @typing.overload
+    def __init__(self) -> None: ...
+    @typing.overload
+    def __init__(self, items: Iterable[Any]) -> None: ...
+
+    def append(self, value: Any) -> int: ...
+
+    def appendleft(self, value: Any) -> int: ...
+
+    def appendright(self, value: Any) -> int: ...
+
+    def clear(self) -> None: ...
+
+    def compact(self) -> None: ...
+
+    def extend(self, items: Iterable[Any]) -> None: ...
+
+    def extendleft(self, items: Iterable[Any]) -> None: ...
+
+    def extendright(self, items: Iterable[Any]) -> None: ...
+
+    def insert(self, value: Any, before: Optional[int] = None) -> int: ...
+
+    def insertafter(self, value: Any, after: int) -> int: ...
+
+    def insertbefore(self, value: Any, before: int) -> int: ...
+
+    def iterslots(self) -> adllistiterator: ...
+
+    def itervalues(self) -> adllistiterator: ...
+
+    def nextslot(self, slot: int) -> Optional[int]: ...
+
+    def pop(self) -> Any: ...
+
+    def popleft(self) -> Any: ...
+
+    def popright(self) -> Any: ...
+
+    def prevslot(self, slot: int) -> Optional[int]: ...
+
+    def remove(self, slot: int) -> Any: ...
+
+    def setslotvalue(self, slot: int, value: Any) -> None: ...
+
+    def slotat(self, index: int) -> int: ...
+
+    def slotvalue(self, slot: int) -> Any: ...
+
+    def __add__(self, other: Iterable[Any]) -> adllist: ...
+    def __contains__(self, value: Any) -> bool: ...
+    def __delitem__(self, index: int) -> None: ...
+    def __eq__(self, other: Any) -> bool: ...
+    def __ge__(self, other: Any) -> bool: ...
+    def __getitem__(self, index: int) -> Any: ...
+    def __gt__(self, other: Any) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __iadd__(self, other: Iterable[Any]) -> adllist: ...
+    def __iter__(self) -> adllistiterator: ...
+    def __le__(self, other: Any) -> bool: ...
+    def __len__(self) -> int: ...
+    def __lt__(self, other: Any) -> bool: ...
+    def __mul__(self, other: int) -> adllist: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __rmul__(self, other: int) -> adllist: ...
+    def __setitem__(self, index: int, value: Any) -> None: ...
+
+
+class adllistiterator:
+    @classmethod
+    def __init__(cls, *args, **kwargs) -> None: ...
+    def __iter__(self) -> adllistiterator: ...
+    def __next__(self) -> Any: ...
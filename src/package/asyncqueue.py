@@ -0,0 +1,159 @@
+"""Queue for asyncio tasks, built on dllist nodes.
+
+Queued items and futures of waiting tasks are kept in dllists, so that
+both a cancelled waiter and an item withdrawn with asyncqueue.cancel()
+are removed in O(1) time, instead of the O(n) removal from deques done
+by asyncio.Queue.
+"""
+import asyncio
+
+from llist._llist import dllist, dllistnode
+
+
+class asyncqueue(object):
+    """FIFO queue for asyncio tasks, compatible with asyncio.Queue.
+
+    put() and put_nowait() return the node holding the item, which can
+    be passed to cancel() to withdraw the item while it is queued.
+    """
+
+    def __init__(self, maxsize=0):
+        self._maxsize = maxsize
+        self._items = dllist()
+        self._getters = dllist()
+        self._putters = dllist()
+        self._joiners = dllist()
+        self._unfinished_tasks = 0
+
+    def __repr__(self):
+        return '<%s maxsize=%r qsize=%r>' % (
+            type(self).__name__, self._maxsize, len(self._items))
+
+    def __len__(self):
+        return len(self._items)
+
+    @property
+    def maxsize(self):
+        """Number of items allowed in the queue, 0 if unbounded."""
+        return self._maxsize
+
+    def qsize(self):
+        """Number of items in the queue."""
+        return len(self._items)
+
+    def empty(self):
+        """Return True if the queue is empty."""
+        return not self._items
+
+    def full(self):
+        """Return True if there are maxsize items in the queue."""
+        if self._maxsize <= 0:
+            return False
+        return len(self._items) >= self._maxsize
+
+    @staticmethod
+    def _wakeup_next(waiters):
+        # wake up the first waiter which is not cancelled
+        while waiters:
+            waiter = waiters.popleft()
+            if not waiter.done():
+                waiter.set_result(None)
+                break
+
+    @staticmethod
+    def _discard_waiter(waiters, node):
+        # a waiter is no longer linked if it was woken up already
+        if node.owner is not None:
+            waiters.remove(node)
+
+    async def _wait(self, waiters, is_blocked):
+        waiter = asyncio.get_running_loop().create_future()
+        node = waiters.append(waiter)
+        try:
+            await waiter
+        except:
+            waiter.cancel()  # in case the waiter is not done yet
+            self._discard_waiter(waiters, node)
+            if not is_blocked() and not waiter.cancelled():
+                # woken up, but cannot take the turn, pass it on
+                self._wakeup_next(waiters)
+            raise
+
+    async def put(self, item):
+        """Put item into the queue, waiting for a free slot if the queue
+        is full. Returns the node holding the item."""
+        while self.full():
+            await self._wait(self._putters, self.full)
+        return self.put_nowait(item)
+
+    def put_nowait(self, item):
+        """Put item into the queue without waiting. Returns the node
+        holding the item.
+
+        Raises asyncio.QueueFull if the queue is full.
+        """
+        if self.full():
+            raise asyncio.QueueFull
+        node = self._items.append(item)
+        self._unfinished_tasks += 1
+        self._wakeup_next(self._getters)
+        return node
+
+    async def get(self):
+        """Remove and return the first item, waiting for one if the queue
+        is empty."""
+        while self.empty():
+            await self._wait(self._getters, self.empty)
+        return self.get_nowait()
+
+    def get_nowait(self):
+        """Remove and return the first item without waiting.
+
+        Raises asyncio.QueueEmpty if the queue is empty.
+        """
+        if self.empty():
+            raise asyncio.QueueEmpty
+        item = self._items.popleft()
+        self._wakeup_next(self._putters)
+        return item
+
+    def cancel(self, node):
+        """Withdraw the item held by node, returned by put(), from the
+        queue. Returns True if the item was removed, or False if it was
+        already taken from the queue or cancelled. The item is treated
+        as finished by join().
+
+        Raises TypeError if node is not a dllistnode, or ValueError if it
+        belongs to another list.
+        """
+        if not isinstance(node, dllistnode):
+            raise TypeError('Argument must be a dllistnode')
+        owner = node.owner
+        if owner is None:
+            return False
+        if owner() is not self._items:
+            raise ValueError('dllistnode belongs to another list')
+        self._items.remove(node)
+        self._wakeup_next(self._putters)
+        self.task_done()
+        return True
+
+    def task_done(self):
+        """Indicate that processing of an item taken from the queue is
+        complete.
+
+        Raises ValueError if called more times than there were items.
+        """
+        if self._unfinished_tasks <= 0:
+            raise ValueError('task_done() called too many times')
+        self._unfinished_tasks -= 1
+        if self._unfinished_tasks == 0:
+            while self._joiners:
+                joiner = self._joiners.popleft()
+                if not joiner.done():
+                    joiner.set_result(None)
+
+    async def join(self):
+        """Wait until all items put into the queue are processed."""
+        if self._unfinished_tasks > 0:
+            await self._wait(self._joiners, lambda: True)
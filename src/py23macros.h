@@ -38,9 +38,22 @@
 #define Py23String_Concat           PyString_Concat
 #define Py23String_ConcatAndDel     PyString_ConcatAndDel
 
-#define Py23Int_Check       PyInt_Check
+#define Py23Int_Check(o)    (PyInt_Check(o) || PyLong_Check(o))
 #define Py23Int_AsSsize_t   PyInt_AsSsize_t
 
 #endif /* PY_MAJOR_VERSION >= 3 */
 
+#if PY_VERSION_HEX < 0x03090000
+#define PyObject_GC_IsTracked(o)    _PyObject_GC_IS_TRACKED(o)
+#endif
+
+/* PyObject_CallOneArg() uses the vectorcall protocol, which avoids
+ * creating an argument tuple for each call. */
+#if PY_VERSION_HEX >= 0x03090000
+#define Py23Object_CallOneArg(func, arg)    PyObject_CallOneArg(func, arg)
+#else
+#define Py23Object_CallOneArg(func, arg)    \
+    PyObject_CallFunctionObjArgs(func, arg, NULL)
+#endif
+
 #endif /* MACROS_H */
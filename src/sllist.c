@@ -6,7 +6,10 @@
 #include <structmember.h>
 
 #include "config.h"
+#include "arena.h"
+#include "deferred.h"
 #include "flags.h"
+#include "lock.h"
 #include "py23macros.h"
 #include "utils.h"
 
@@ -21,6 +24,15 @@ static PyTypeObject SLListNodeType;
 static PyTypeObject SLListIteratorType;
 static PyTypeObject SLListNodeIteratorType;
 
+static PyObject* sllistnode_new(PyTypeObject* type,
+                                PyObject* args,
+                                PyObject* kwds);
+static PyObject* sllist_get_node_ref(PyObject* list);
+static LListArena* sllist_get_arena(PyObject* list);
+static Py_ssize_t sllist_get_size(PyObject* list);
+static PyObject* sllist_get_first(PyObject* list);
+static void sllistiterator_set_cycle(PyObject* iterator);
+
 
 /* SLListNode */
 
@@ -29,25 +41,42 @@ typedef struct
     PyObject_HEAD
     PyObject* value;
     PyObject* next;
+    /* NULL if the node does not belong to a list */
     PyObject* list_weakref;
-    unsigned char flags;
 } SLListNodeObject;
 
+/* Nodes storing atomic values (see llist_is_atomic) cannot be part of
+ * reference cycles, so they are not tracked by the garbage collector.
+ * This function must be called whenever value of a node changes.
+ * Instances of node subclasses are always tracked. */
+static void sllistnode_update_gc(SLListNodeObject* node)
+{
+    if (Py_TYPE(node) != &SLListNodeType)
+        return;
+
+    if (llist_is_atomic(node->value))
+    {
+        if (PyObject_GC_IsTracked((PyObject*)node))
+            PyObject_GC_UnTrack(node);
+    }
+    else if (!PyObject_GC_IsTracked((PyObject*)node))
+        PyObject_GC_Track(node);
+}
+
 
 static void sllistnode_link(PyObject* next,
                             SLListNodeObject* inserted,
                             PyObject* owner_list)
 {
     assert(inserted != NULL);
-    assert(inserted->next == Py_None);
+    assert(inserted->next == NULL);
+    assert(inserted->list_weakref == NULL);
     assert(owner_list != NULL);
-    assert(owner_list != Py_None);
 
-    if (next != NULL)
-        inserted->next = next;
+    inserted->next = next;
 
-    Py_DECREF(inserted->list_weakref);
-    inserted->list_weakref = PyWeakref_NewRef(owner_list, NULL);
+    inserted->list_weakref = sllist_get_node_ref(owner_list);
+    Py_INCREF(inserted->list_weakref);
 }
 
 static SLListNodeObject* sllistnode_create(PyObject* next,
@@ -55,35 +84,24 @@ static SLListNodeObject* sllistnode_create(PyObject* next,
                                            PyObject* owner_list)
 {
     SLListNodeObject *node;
-    PyObject* args = NULL;
+    LListArena* arena = sllist_get_arena(owner_list);
 
     assert(value != NULL);
     assert(owner_list != NULL);
-    assert(owner_list != Py_None);
-
-    if (value != Py_None)
-    {
-        args = PyTuple_New(1);
-        if (args == NULL)
-        {
-            PyErr_SetString(PyExc_RuntimeError,
-                "Failed to create argument tuple");
-            return NULL;
-        }
-
-        Py_INCREF(value);
-        if (PyTuple_SetItem(args, 0, value) != 0)
-        {
-            PyErr_SetString(PyExc_RuntimeError,
-                "Failed to initialize argument tuple");
-            return NULL;
-        }
-    }
 
-    node = (SLListNodeObject*)PyObject_CallObject(
-        (PyObject*)&SLListNodeType, args);
+    /* Nodes are allocated directly, without going through
+     * the node type constructor. Links are zeroed by tp_alloc. */
+    if (arena != NULL)
+        node = (SLListNodeObject*)llist_arena_alloc(
+            arena, sllist_get_size(owner_list));
+    else
+        node = (SLListNodeObject*)SLListNodeType.tp_alloc(&SLListNodeType, 0);
+    if (node == NULL)
+        return NULL;
 
-    Py_XDECREF(args);
+    Py_INCREF(value);
+    node->value = value;
+    sllistnode_update_gc(node);
 
     sllistnode_link(next, node, owner_list);
 
@@ -95,12 +113,12 @@ static SLListNodeObject* sllistnode_create(PyObject* next,
  */
 static void sllistnode_delete(SLListNodeObject* node)
 {
-  /* unlink from parent list */
-  Py_DECREF(node->list_weakref);
-  Py_INCREF(Py_None);
-  node->list_weakref = Py_None;
+  /* unlink from parent list, see sllistnode_access */
+  Py_BEGIN_CRITICAL_SECTION(node);
+  Py_CLEAR(node->list_weakref);
+  Py_END_CRITICAL_SECTION();
 
-  node->next = Py_None;
+  node->next = NULL;
 
   Py_DECREF((PyObject*)node);
 }
@@ -120,12 +138,6 @@ static int sllistnode_clear_refs(SLListNodeObject* self)
     Py_CLEAR(self->value);
     Py_CLEAR(self->list_weakref);
 
-    if ((self->flags & LLIST_HAS_PY_NONE_REF) != 0)
-    {
-        self->flags &= ~LLIST_HAS_PY_NONE_REF;
-        Py_DECREF(Py_None);
-    }
-
     return 0;
 }
 
@@ -139,28 +151,6 @@ static void sllistnode_dealloc(SLListNodeObject* self)
     obj_self->ob_type->tp_free(obj_self);
 }
 
-static int sllistnode_init(SLListNodeObject* self,
-                           PyObject* args,
-                           PyObject* kwds)
-{
-    PyObject* value = NULL;
-
-    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &value))
-        return -1;
-
-    if (value == NULL)
-        return 0;
-
-    /* initialize node using passed value */
-    Py_DECREF(self->value);
-    Py_INCREF(value);
-    self->value = value;
-
-    return 0;
-}
-
-
-
 static PyObject* sllistnode_new(PyTypeObject* type,
                                 PyObject* args,
                                 PyObject* kwds)
@@ -171,17 +161,9 @@ static PyObject* sllistnode_new(PyTypeObject* type,
     if (self == NULL)
         return NULL;
 
-    /* A single reference to Py_None is held for the whole
-     * lifetime of a node. */
+    /* link and owner reference are zeroed by tp_alloc */
     Py_INCREF(Py_None);
-
-    self->next = Py_None;
     self->value = Py_None;
-    self->list_weakref = Py_None;
-    self->flags = LLIST_HAS_PY_NONE_REF;
-
-    Py_INCREF(self->value);
-    Py_INCREF(self->list_weakref);
 
     return (PyObject*)self;
 }
@@ -190,6 +172,7 @@ static PyObject* sllistnode_new(PyTypeObject* type,
 /* Convenience function for formatting list node to a string.
  * Pass PyObject_Repr or PyObject_Str in the fmt_func argument. */
 static PyObject* sllistnode_to_string(SLListNodeObject* self,
+                                      PyObject* value,
                                       reprfunc fmt_func,
                                       const char* prefix,
                                       const char* suffix)
@@ -204,7 +187,7 @@ static PyObject* sllistnode_to_string(SLListNodeObject* self,
     if (str == NULL)
         goto str_alloc_error;
 
-    tmp_str = fmt_func(self->value);
+    tmp_str = fmt_func(value);
     if (tmp_str == NULL)
         goto str_alloc_error;
     Py23String_ConcatAndDel(&str, tmp_str);
@@ -227,14 +210,237 @@ str_alloc_error:
     return NULL;
 }
 
+
+/* Signature of functions called by sllistnode_access. list is the list
+ * referred to by owner reference of the node, or NULL if the node does
+ * not refer to a live list. */
+typedef PyObject* (*sllistnode_accessor)(SLListNodeObject* node,
+                                         PyObject* list,
+                                         PyObject* arg);
+
+/* Return 1 if the node belongs to list passed to a sllistnode_accessor.
+ * Nodes detached by clear() in deferred mode refer to an old owner
+ * reference of the list. */
+static int sllistnode_in_list(SLListNodeObject* node, PyObject* list)
+{
+    return list != NULL && sllist_get_node_ref(list) == node->list_weakref;
+}
+
+/* Call func with the lock guarding value, link and owner reference of
+ * the node held. As in dllist, nodes referring to a live list are
+ * guarded by critical section of that list, other nodes by their own
+ * critical section. */
+static PyObject* sllistnode_access(SLListNodeObject* node,
+                                   sllistnode_accessor func,
+                                   PyObject* arg)
+{
+#ifdef Py_GIL_DISABLED
+    PyObject* result = NULL;
+    int done = 0;
+
+    while (!done)
+    {
+        PyObject* owner_ref = NULL;
+        PyObject* list = NULL;
+
+        Py_BEGIN_CRITICAL_SECTION(node);
+        if (node->list_weakref == NULL ||
+            PyWeakref_GetRef(node->list_weakref, &list) <= 0)
+        {
+            result = func(node, NULL, arg);
+            done = 1;
+        }
+        else
+        {
+            owner_ref = node->list_weakref;
+            Py_INCREF(owner_ref);
+        }
+        Py_END_CRITICAL_SECTION();
+
+        if (done)
+            break;
+
+        /* retried if the node was moved to another list meanwhile */
+        Py_BEGIN_CRITICAL_SECTION2(list, node);
+        if (node->list_weakref == owner_ref)
+        {
+            result = func(node, list, arg);
+            done = 1;
+        }
+        Py_END_CRITICAL_SECTION2();
+
+        Py_DECREF(owner_ref);
+        Py_DECREF(list);
+    }
+
+    return result;
+#else
+    PyObject* list = NULL;
+
+    if (node->list_weakref != NULL)
+    {
+        list = PyWeakref_GetObject(node->list_weakref);
+        if (list == Py_None)
+            list = NULL;
+    }
+
+    return func(node, list, arg);
+#endif
+}
+
+static PyObject* sllistnode_value_locked(SLListNodeObject* node,
+                                         PyObject* list,
+                                         PyObject* unused)
+{
+    Py_INCREF(node->value);
+    return node->value;
+}
+
+/* Returns the replaced value, which should be released after the node
+ * is unlocked. */
+static PyObject* sllistnode_swap_value_locked(SLListNodeObject* node,
+                                              PyObject* list,
+                                              PyObject* value)
+{
+    PyObject* oldval = node->value;
+
+    Py_INCREF(value);
+    node->value = value;
+    sllistnode_update_gc(node);
+
+    return oldval;
+}
+
+static PyObject* sllistnode_owner_locked(SLListNodeObject* node,
+                                         PyObject* list,
+                                         PyObject* unused)
+{
+    PyObject* owner = node->list_weakref;
+
+    /* nodes detached by clear() or deletion of a list in deferred mode
+     * are not owned */
+    if (!sllistnode_in_list(node, list))
+        Py_RETURN_NONE;
+
+    Py_INCREF(owner);
+    return owner;
+}
+
+/* Check whether node can be adopted by a list. Nodes detached by clear()
+ * or deletion of a list in deferred mode are not owned, but stay chained
+ * until they are released, so all pending nodes are released before such
+ * a node is adopted. Returns 0 and sets ValueError with message if the
+ * node belongs to a list. */
+static int sllistnode_check_free(SLListNodeObject* node, const char* message)
+{
+    if (node->list_weakref != NULL)
+    {
+        PyObject* owner = sllistnode_access(node, sllistnode_owner_locked, NULL);
+
+        if (owner == Py_None)
+            llist_release_pending(-1);
+        Py_DECREF(owner);
+    }
+
+    if (node->list_weakref != NULL || node->next != NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, message);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* The link is exposed only for nodes in a list, nodes detached by
+ * clear() in deferred mode are chained only until they are released.
+ * If wrap is not NULL, the last node is followed by the first one. */
+static PyObject* sllistnode_next_locked(SLListNodeObject* node,
+                                        PyObject* list,
+                                        PyObject* wrap)
+{
+    PyObject* next = NULL;
+
+    if (sllistnode_in_list(node, list))
+    {
+        next = node->next;
+        if (next == NULL && wrap != NULL)
+            next = sllist_get_first(list);
+    }
+
+    if (next == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(next);
+    return next;
+}
+
+static PyObject* sllistnode_get_value(SLListNodeObject* self, void* closure)
+{
+    return sllistnode_access(self, sllistnode_value_locked, NULL);
+}
+
+static int sllistnode_set_value(SLListNodeObject* self, PyObject* value, void* closure)
+{
+    PyObject* oldval;
+
+    if (value == NULL)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete node value");
+        return -1;
+    }
+
+    /* Py_DECREF may evaluate its argument more than once on Python 2 */
+    oldval = sllistnode_access(self, sllistnode_swap_value_locked, value);
+    Py_DECREF(oldval);
+
+    return 0;
+}
+
+/* Methods inserting a node as an item insert its value instead.
+ * Returns a new reference to the inserted value. */
+static PyObject* sllistnode_unwrap_value(PyObject* item)
+{
+    if (PyObject_TypeCheck(item, &SLListNodeType))
+        return sllistnode_get_value((SLListNodeObject*)item, NULL);
+
+    Py_INCREF(item);
+    return item;
+}
+
+static int sllistnode_init(SLListNodeObject* self,
+                           PyObject* args,
+                           PyObject* kwds)
+{
+    PyObject* value = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &value))
+        return -1;
+
+    if (value == NULL)
+        return 0;
+
+    /* initialize node using passed value */
+    return sllistnode_set_value(self, value, NULL);
+}
+
 static PyObject* sllistnode_repr(SLListNodeObject* self)
 {
-    return sllistnode_to_string(self, PyObject_Repr, "<sllistnode(", ")>");
+    PyObject* value = sllistnode_get_value(self, NULL);
+    PyObject* str = sllistnode_to_string(
+        self, value, PyObject_Repr, "<sllistnode(", ")>");
+
+    Py_DECREF(value);
+    return str;
 }
 
 static PyObject* sllistnode_str(SLListNodeObject* self)
 {
-    return sllistnode_to_string(self, PyObject_Str, "sllistnode(", ")");
+    PyObject* value = sllistnode_get_value(self, NULL);
+    PyObject* str = sllistnode_to_string(
+        self, value, PyObject_Str, "sllistnode(", ")");
+
+    Py_DECREF(value);
+    return str;
 }
 
 
@@ -243,22 +449,37 @@ static PyObject* sllistnode_call(PyObject* self,
                                  PyObject* args,
                                  PyObject* kw)
 {
-    SLListNodeObject* node = (SLListNodeObject*)self;
-    Py_INCREF(node->value);
-    return node->value;
+    return sllistnode_get_value((SLListNodeObject*)self, NULL);
 }
 
 
 
 
-static PyMemberDef SLListNodeMembers[] =
+static PyObject* sllistnode_get_owner(SLListNodeObject* self, void* closure)
+{
+    return sllistnode_access(self, sllistnode_owner_locked, NULL);
+}
+
+static PyObject* sllistnode_get_next(SLListNodeObject* self, void* closure)
+{
+    return sllistnode_access(self, sllistnode_next_locked, NULL);
+}
+
+static PyObject* sllistnode_get_nextwrap(SLListNodeObject* self, void* closure)
+{
+    return sllistnode_access(self, sllistnode_next_locked, Py_True);
+}
+
+static PyGetSetDef SLListNodeGetSetters[] =
 {
-    { "value", T_OBJECT_EX, offsetof(SLListNodeObject, value), 0,
-      "value" },
-    { "next", T_OBJECT_EX, offsetof(SLListNodeObject, next), READONLY,
-      "next node" },
-    { "owner", T_OBJECT_EX, offsetof(SLListNodeObject, list_weakref), READONLY,
-      "List that this node belongs to" },
+    { "value", (getter)sllistnode_get_value, (setter)sllistnode_set_value,
+      "value", NULL },
+    { "next", (getter)sllistnode_get_next, llist_readonly_setter,
+      "next node", NULL },
+    { "owner", (getter)sllistnode_get_owner, llist_readonly_setter,
+      "List that this node belongs to", NULL },
+    { "nextwrap", (getter)sllistnode_get_nextwrap, NULL,
+      "Next node, or the first node of the list after the last one", NULL },
     { NULL },   /* sentinel */
 };
 
@@ -295,8 +516,8 @@ static PyTypeObject SLListNodeType =
     0,                              /* tp_iter           */
     0,                              /* tp_iternext       */
     0,                              /* tp_methods        */
-    SLListNodeMembers,              /* tp_members        */
-    0,                              /* tp_getset         */
+    0,                              /* tp_members        */
+    SLListNodeGetSetters,           /* tp_getset         */
     0,                              /* tp_base           */
     0,                              /* tp_dict           */
     0,                              /* tp_descr_get      */
@@ -305,6 +526,7 @@ static PyTypeObject SLListNodeType =
     (initproc)sllistnode_init,      /* tp_init           */
     0,                              /* tp_alloc          */
     sllistnode_new,                 /* tp_new            */
+    llist_arena_free,               /* tp_free           */
 };
 
 
@@ -313,6 +535,8 @@ static PyTypeObject SLListNodeType =
 /*                                      SLLIST                                    */
 /* ****************************************************************************** */
 
+/* Links between nodes, first and last are NULL at the ends of the list.
+ * They are exposed to Python as None. */
 typedef struct
 {
     PyObject_HEAD
@@ -320,27 +544,96 @@ typedef struct
     PyObject* last;
     Py_ssize_t size;
     PyObject* weakref_list;
+    /* weak reference to the list shared by all nodes in the list,
+     * replaced when nodes are detached by deferred clear() */
+    PyObject* node_ref;
+    /* NULL unless nodes are allocated from an arena */
+    LListArena* arena;
     unsigned char flags;
 } SLListObject;
 
+static PyObject* sllist_get_node_ref(PyObject* list)
+{
+    return ((SLListObject*)list)->node_ref;
+}
+
+static LListArena* sllist_get_arena(PyObject* list)
+{
+    return ((SLListObject*)list)->arena;
+}
+
+static Py_ssize_t sllist_get_size(PyObject* list)
+{
+    return ((SLListObject*)list)->size;
+}
+
+static PyObject* sllist_get_first(PyObject* list)
+{
+    return ((SLListObject*)list)->first;
+}
+
 
 static int sllist_traverse(SLListObject* self, visitproc visit, void* arg)
 {
   PyObject* node = self->first;
 
-  if (node != NULL)
+  while (node != NULL)
   {
-      while (node != Py_None)
-      {
-          PyObject* next_node = ((SLListNodeObject*)node)->next;
-          Py_VISIT(node);
-          node = next_node;
-      }
+      PyObject* next_node = ((SLListNodeObject*)node)->next;
+      Py_VISIT(node);
+      node = next_node;
   }
 
+  Py_VISIT(self->node_ref);
+
   return 0;
 }
 
+/* Release function for chains of nodes detached in deferred mode
+ * (see deferred.h). */
+static Py_ssize_t sllist_release_nodes(PyObject** head, Py_ssize_t budget)
+{
+    PyObject* node = *head;
+    Py_ssize_t released = 0;
+
+    while (node != NULL && released < budget)
+    {
+        PyObject* next_node = ((SLListNodeObject*)node)->next;
+        sllistnode_delete((SLListNodeObject*)node);
+        node = next_node;
+        ++released;
+    }
+
+    *head = node;
+
+    return released;
+}
+
+/* Move all nodes of the list to the queue of pending nodes, which are
+ * released incrementally. Returns 0 if nodes could not be queued. */
+static int sllist_detach_nodes(SLListObject* self)
+{
+    if (self->size == 0)
+        return 1;
+
+    if (!llist_defer_release(self->first, self->size, sllist_release_nodes))
+        return 0;
+
+    self->first = NULL;
+    self->last = NULL;
+    self->size = 0;
+
+    return 1;
+}
+
+/* Release a slice of pending nodes if the list is in deferred mode.
+ * Called at the start of operations which insert nodes. */
+static void sllist_release_step(SLListObject* self)
+{
+    if ((self->flags & LLIST_DEFERRED_RELEASE) != 0)
+        llist_release_pending(LLIST_RELEASE_STEP);
+}
+
 static int sllist_clear_refs(SLListObject* self)
 {
     PyObject* node = self->first;
@@ -350,24 +643,17 @@ static int sllist_clear_refs(SLListObject* self)
 
     self->first = NULL;
     self->last = NULL;
+    self->size = 0;
     self->weakref_list = NULL;
 
-    if (node != NULL)
+    while (node != NULL)
     {
-        while (node != Py_None)
-        {
-            PyObject* next_node = ((SLListNodeObject*)node)->next;
-            ((SLListNodeObject*)node)->next = Py_None;
-            Py_DECREF(node);
-            node = next_node;
-        }
+        PyObject* next_node = ((SLListNodeObject*)node)->next;
+        sllistnode_delete((SLListNodeObject*)node);
+        node = next_node;
     }
 
-    if ((self->flags & LLIST_HAS_PY_NONE_REF) != 0)
-    {
-      self->flags &= ~LLIST_HAS_PY_NONE_REF;
-      Py_DECREF(Py_None);
-    }
+    Py_CLEAR(self->node_ref);
 
     return 0;
 }
@@ -377,7 +663,12 @@ static void sllist_dealloc(SLListObject* self)
     PyObject_GC_UnTrack(self);
     PyObject* obj_self = (PyObject*)self;
 
+    /* nodes which cannot be queued are released by sllist_clear_refs */
+    if ((self->flags & LLIST_DEFERRED_RELEASE) != 0 && self->first != NULL)
+        sllist_detach_nodes(self);
+
     sllist_clear_refs(self);
+    llist_arena_enable(&self->arena, &SLListNodeType, 0);
 
     obj_self->ob_type->tp_free(obj_self);
 }
@@ -392,20 +683,30 @@ static PyObject* sllist_new(PyTypeObject* type,
     if (self == NULL)
         return NULL;
 
-    /* A single reference to Py_None is held for the whole
-     * lifetime of a list. */
-    Py_INCREF(Py_None);
-
-    self->first = Py_None;
-    self->last = Py_None;
+    self->first = NULL;
+    self->last = NULL;
     self->weakref_list = NULL;
     self->size = 0;
-    self->flags = LLIST_HAS_PY_NONE_REF;
+    self->node_ref = NULL;
+    self->arena = NULL;
+    self->flags = 0;
+
+    self->node_ref = llist_new_owner_ref((PyObject*)self);
+    if (self->node_ref == NULL)
+    {
+        Py_DECREF(self);
+        return NULL;
+    }
 
     return (PyObject*)self;
 }
 
-static int sllist_extend_internal(SLListObject* self, PyObject* sequence)
+/* Convenience function for extending (concatenating in-place)
+ * the list with elements from a sequence. If nodes is not NULL,
+ * created nodes are appended to it. */
+static int sllist_extend_internal(SLListObject* self,
+                                  PyObject* sequence,
+                                  PyObject* nodes)
 {
     Py_ssize_t i;
     Py_ssize_t sequence_len;
@@ -418,21 +719,28 @@ static int sllist_extend_internal(SLListObject* self, PyObject* sequence)
         PyObject* iter_node_obj = ((SLListObject *)sequence)->first;
         PyObject* last_node_obj = self->last;
 
-        while (iter_node_obj != Py_None)
+        while (iter_node_obj != NULL)
         {
             SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
             PyObject* new_node;
 
             new_node = (PyObject*)sllistnode_create(
-                Py_None, iter_node->value, (PyObject*)self);
+                NULL, iter_node->value, (PyObject*)self);
+            if (new_node == NULL)
+                return 0;
 
-            if (self->last != Py_None)
+            if (self->last != NULL)
                 ((SLListNodeObject*)self->last)->next = new_node;
 
-            if (self->first == Py_None)
+            if (self->first == NULL)
                 self->first = new_node;
             self->last = new_node;
 
+            ++self->size;
+
+            if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+                return 0;
+
             if (iter_node_obj == last_node_obj)
             {
                 /* This is needed to terminate loop if self == sequence. */
@@ -442,8 +750,6 @@ static int sllist_extend_internal(SLListObject* self, PyObject* sequence)
             iter_node_obj = iter_node->next;
         }
 
-        self->size += ((SLListObject*)sequence)->size;
-
         return 1;
     }
 
@@ -467,21 +773,23 @@ static int sllist_extend_internal(SLListObject* self, PyObject* sequence)
             return 0;
         }
 
-        new_node = (PyObject*)sllistnode_create(Py_None,
+        new_node = (PyObject*)sllistnode_create(NULL,
                                                 item,
                                                 (PyObject*)self);
+        Py_DECREF(item);
+        if (new_node == NULL)
+            return 0;
 
-
-        if(self->first == Py_None)
+        if(self->first == NULL)
             self->first = new_node;
         else
             ((SLListNodeObject*)self->last)->next = new_node;
-
         self->last = new_node;
 
         ++self->size;
 
-        Py_DECREF(item);
+        if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+            return 0;
     }
 
     return 1;
@@ -491,11 +799,24 @@ static int sllist_extend_internal(SLListObject* self, PyObject* sequence)
 
 static int sllist_init(SLListObject* self, PyObject* args, PyObject* kwds)
 {
+    static char* kwlist[] = { "iterable", "deferred", "arena", NULL };
+
     PyObject* sequence = NULL;
+    int deferred = 0;
+    int arena = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oii:sllist", kwlist,
+                                     &sequence, &deferred, &arena))
+        return -1;
 
-    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &sequence))
+    if (!llist_arena_enable(&self->arena, &SLListNodeType, arena))
         return -1;
 
+    if (deferred)
+        self->flags |= LLIST_DEFERRED_RELEASE;
+    else
+        self->flags &= ~LLIST_DEFERRED_RELEASE;
+
     if (sequence == NULL)
         return 0;
 
@@ -506,7 +827,7 @@ static int sllist_init(SLListObject* self, PyObject* args, PyObject* kwds)
         return -1;
     }
 
-    return sllist_extend_internal(self, sequence) ? 0 : -1;
+    return sllist_extend_internal(self, sequence, NULL) ? 0 : -1;
 }
 
 
@@ -540,8 +861,8 @@ static PyObject* sllist_richcompare(SLListObject* self,
     self_node = (SLListNodeObject*)self->first;
     other_node = (SLListNodeObject*)other->first;
 
-    while ((PyObject*)self_node != Py_None &&
-            (PyObject*)other_node != Py_None)
+    while (self_node != NULL &&
+            other_node != NULL)
     {
         satisfied = PyObject_RichCompareBool(
             self_node->value, other_node->value, Py_EQ);
@@ -560,7 +881,7 @@ static PyObject* sllist_richcompare(SLListObject* self,
     if (satisfied)
     {
         /* At least one of operands has been fully traversed.
-         * Either self_node or other_node is equal to Py_None. */
+         * Either self_node or other_node is NULL. */
         switch (op)
         {
         case Py_EQ:
@@ -570,16 +891,16 @@ static PyObject* sllist_richcompare(SLListObject* self,
             satisfied = (self_node != other_node);
             break;
         case Py_LT:
-            satisfied = ((PyObject*)other_node != Py_None);
+            satisfied = (other_node != NULL);
             break;
         case Py_GT:
-            satisfied = ((PyObject*)self_node != Py_None);
+            satisfied = (self_node != NULL);
             break;
         case Py_LE:
-            satisfied = ((PyObject*)self_node == Py_None);
+            satisfied = (self_node == NULL);
             break;
         case Py_GE:
-            satisfied = ((PyObject*)other_node == Py_None);
+            satisfied = (other_node == NULL);
             break;
         default:
             assert(0 && "Invalid rich compare operator");
@@ -615,7 +936,7 @@ static SLListNodeObject* sllist_get_prev(SLListObject* self,
         return NULL;
     }
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
     {
         PyErr_SetString(PyExc_RuntimeError, "List is empty");
         return NULL;
@@ -628,9 +949,9 @@ static SLListNodeObject* sllist_get_prev(SLListObject* self,
         return NULL;
     }
 
-    if(self->first != Py_None)
+    if(self->first != NULL)
     {
-        while((PyObject*)node != Py_None && node != next)
+        while(node != NULL && node != next)
         {
             prev = node;
             node = (SLListNodeObject*)node->next;
@@ -641,22 +962,55 @@ static SLListNodeObject* sllist_get_prev(SLListObject* self,
 
 }
 
+/* Checks in constant time that prev is the node preceding next in the list.
+ * Used to validate predecessor hints passed by the caller. */
+static int sllist_check_prev(SLListObject* self,
+                             PyObject* prev,
+                             PyObject* next)
+{
+    SLListNodeObject* prev_node;
+
+    if (!PyObject_TypeCheck(prev, &SLListNodeType))
+    {
+        PyErr_SetString(PyExc_TypeError, "prev is not an sllistnode");
+        return 0;
+    }
+
+    prev_node = (SLListNodeObject*)prev;
+
+    if (prev_node->next != next ||
+        prev_node->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "prev is not the predecessor of node");
+        return 0;
+    }
+
+    return 1;
+}
+
 
 static PyObject* sllist_appendleft(SLListObject* self, PyObject* arg)
 {
     SLListNodeObject* new_node;
+    PyObject* value;
 
-    if (PyObject_TypeCheck(arg, &SLListNodeType))
-        arg = ((SLListNodeObject*)arg)->value;
+    sllist_release_step(self);
+
+    value = sllistnode_unwrap_value(arg);
 
     new_node = sllistnode_create(self->first,
-                                 arg,
+                                 value,
                                  (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
+
     /* setting head as new node */
     self->first  = (PyObject*)new_node;
 
     /* setting tail as new node (appending to empty list)*/
-    if(self->last == Py_None)
+    if(self->last == NULL)
         self->last = (PyObject*)new_node;
 
     ++self->size;
@@ -668,16 +1022,21 @@ static PyObject* sllist_appendleft(SLListObject* self, PyObject* arg)
 static PyObject* sllist_appendright(SLListObject* self, PyObject* arg)
 {
     SLListNodeObject* new_node;
+    PyObject* value;
 
-    if (PyObject_TypeCheck(arg, &SLListNodeType))
-        arg = ((SLListNodeObject*)arg)->value;
+    sllist_release_step(self);
 
-    new_node = sllistnode_create(Py_None,
-                                 arg,
-                                 (PyObject*)self);
+    value = sllistnode_unwrap_value(arg);
+
+    new_node = sllistnode_create(NULL,
+                                 value,
+                                 (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     /* appending to empty list */
-    if(self->first == Py_None)
+    if(self->first == NULL)
         self->first = (PyObject*)new_node;
     /* setting next of last element as new node */
     else
@@ -693,6 +1052,8 @@ static PyObject* sllist_appendright(SLListObject* self, PyObject* arg)
 
 static PyObject* sllist_appendnode(SLListObject* self, PyObject* arg)
 {
+    sllist_release_step(self);
+
     if (!PyObject_TypeCheck(arg, &SLListNodeType))
     {
         PyErr_SetString(PyExc_TypeError, "Argument must be a sllistnode");
@@ -701,15 +1062,12 @@ static PyObject* sllist_appendnode(SLListObject* self, PyObject* arg)
 
     SLListNodeObject* node = (SLListNodeObject*) arg;
 
-    if (node->list_weakref != Py_None || node->next != Py_None)
-    {
-        PyErr_SetString(PyExc_ValueError,
-            "Argument node must not belong to a list");
+    if (!sllistnode_check_free(node,
+            "Argument node must not belong to a list"))
         return NULL;
-    }
 
     /* appending to empty list */
-    if(self->first == Py_None)
+    if(self->first == NULL)
         self->first = (PyObject*)node;
     /* setting next of last element as new node */
     else
@@ -718,8 +1076,8 @@ static PyObject* sllist_appendnode(SLListObject* self, PyObject* arg)
     /* allways set last node to new node */
     self->last = (PyObject*)node;
 
-    Py_DECREF(node->list_weakref);
-    node->list_weakref = PyWeakref_NewRef((PyObject*) self, NULL);
+    node->list_weakref = self->node_ref;
+    Py_INCREF(node->list_weakref);
 
     Py_INCREF((PyObject*)node);
     ++self->size;
@@ -732,9 +1090,10 @@ static PyObject* sllist_insertafter(SLListObject* self, PyObject* arg)
 {
     PyObject* value = NULL;
     PyObject* before = NULL;
-    PyObject* list_ref;
     SLListNodeObject* new_node;
 
+    sllist_release_step(self);
+
     if (!PyArg_UnpackTuple(arg, "insertafter", 2, 2, &value, &before))
         return NULL;
 
@@ -744,28 +1103,33 @@ static PyObject* sllist_insertafter(SLListObject* self, PyObject* arg)
         return NULL;
     }
 
-    if (PyObject_TypeCheck(value, &SLListNodeType))
-        value = ((SLListNodeObject*)value)->value;
+    /* the value is read before the reference node is validated, as
+     * reading it may release the list lock for a while on free-threaded
+     * builds */
+    value = sllistnode_unwrap_value(value);
 
-    if (((SLListNodeObject*)before)->list_weakref == Py_None)
+    if (((SLListNodeObject*)before)->list_weakref == NULL)
     {
         PyErr_SetString(PyExc_ValueError,
             "sllistnode does not belong to a list");
+        Py_DECREF(value);
         return NULL;
     }
 
-    list_ref = PyWeakref_GetObject(
-        ((SLListNodeObject*)before)->list_weakref);
-    if (list_ref != (PyObject*)self)
+    if (((SLListNodeObject*)before)->list_weakref != self->node_ref)
     {
         PyErr_SetString(PyExc_ValueError,
             "sllistnode belongs to another list");
+        Py_DECREF(value);
         return NULL;
     }
 
-    new_node = sllistnode_create(Py_None,
+    new_node = sllistnode_create(NULL,
                                  value,
                                  (PyObject*)self);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     /* putting new node in created gap */
     new_node->next = ((SLListNodeObject*)before)->next;
@@ -779,17 +1143,23 @@ static PyObject* sllist_insertafter(SLListObject* self, PyObject* arg)
     return (PyObject*)new_node;
 }
 
-static PyObject* sllist_insertbefore(SLListObject* self, PyObject* arg)
+static PyObject* sllist_insertbefore(SLListObject* self,
+                                     PyObject* args,
+                                     PyObject* kwds)
 {
+    static char* kwlist[] = { "value", "before_ref", "prev", NULL };
 
     PyObject* value = NULL;
     PyObject* after = NULL;
-    PyObject* list_ref;
+    PyObject* prev_hint = Py_None;
 
     SLListNodeObject* new_node;
     SLListNodeObject* prev;
 
-    if (!PyArg_UnpackTuple(arg, "insertbefore", 2, 2, &value, &after))
+    sllist_release_step(self);
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O:insertbefore", kwlist,
+                                     &value, &after, &prev_hint))
         return NULL;
 
     if (!PyObject_TypeCheck(after, &SLListNodeType))
@@ -797,33 +1167,49 @@ static PyObject* sllist_insertbefore(SLListObject* self, PyObject* arg)
         PyErr_SetString(PyExc_TypeError, "Argument is not an sllistnode");
         return NULL;
     }
-    if (PyObject_TypeCheck(value, &SLListNodeType))
-        value = ((SLListNodeObject*)value)->value;
+    /* see sllist_insertafter */
+    value = sllistnode_unwrap_value(value);
 
     if (after == Py_None)
     {
         PyErr_SetString(PyExc_ValueError,
             "sllistnode does not belong to a list");
+        Py_DECREF(value);
         return NULL;
     }
 
-    list_ref = PyWeakref_GetObject(
-        ((SLListNodeObject*)after)->list_weakref);
-    if (list_ref != (PyObject*)self)
+    if (((SLListNodeObject*)after)->list_weakref != self->node_ref)
     {
         PyErr_SetString(PyExc_ValueError,
             "sllistnode belongs to another list");
+        Py_DECREF(value);
         return NULL;
     }
-    new_node = sllistnode_create(Py_None,
+
+    if (prev_hint != Py_None)
+    {
+        if (!sllist_check_prev(self, prev_hint, after))
+        {
+            Py_DECREF(value);
+            return NULL;
+        }
+        prev = (SLListNodeObject*)prev_hint;
+    }
+    else
+    {
+        /* getting prev node for this from arg*/
+        prev = sllist_get_prev(self, (SLListNodeObject*)after);
+    }
+
+    new_node = sllistnode_create(NULL,
                                  value,
                                  (PyObject*)self);
-
-    /* getting prev node for this from arg*/
-    prev = sllist_get_prev(self, (SLListNodeObject*)after);
+    Py_DECREF(value);
+    if (new_node == NULL)
+        return NULL;
 
     /* putting new node in created gap, not first and exists */
-    if((PyObject*)prev != Py_None && prev != NULL)
+    if(prev != NULL)
     {
         ((SLListNodeObject*)prev)->next = (PyObject*)new_node;
         new_node->next = after;
@@ -845,6 +1231,8 @@ static PyObject* sllist_insertnodeafter(SLListObject* self, PyObject* arg)
     PyObject* inserted = NULL;
     PyObject* ref = NULL;
 
+    sllist_release_step(self);
+
     if (!PyArg_UnpackTuple(arg, "insertnodeafter", 2, 2, &inserted, &ref))
         return NULL;
 
@@ -857,13 +1245,9 @@ static PyObject* sllist_insertnodeafter(SLListObject* self, PyObject* arg)
 
     SLListNodeObject* inserted_node = (SLListNodeObject*)inserted;
 
-    if (inserted_node->list_weakref != Py_None
-        || inserted_node->next != Py_None)
-    {
-      PyErr_SetString(PyExc_ValueError,
-          "Inserted node must not belong to a list");
-      return NULL;
-    }
+    if (!sllistnode_check_free(inserted_node,
+            "Inserted node must not belong to a list"))
+        return NULL;
 
     if (!PyObject_TypeCheck(ref, &SLListNodeType))
     {
@@ -874,15 +1258,14 @@ static PyObject* sllist_insertnodeafter(SLListObject* self, PyObject* arg)
 
     SLListNodeObject* ref_node = (SLListNodeObject*)ref;
 
-    if (ref_node->list_weakref == Py_None)
+    if (ref_node->list_weakref == NULL)
     {
         PyErr_SetString(PyExc_ValueError,
             "ref_node does not belong to a list");
         return NULL;
     }
 
-    PyObject* list_ref = PyWeakref_GetObject(ref_node->list_weakref);
-    if (list_ref != (PyObject*)self)
+    if (ref_node->list_weakref != self->node_ref)
     {
         PyErr_SetString(PyExc_ValueError,
             "ref_node belongs to another list");
@@ -909,6 +1292,8 @@ static PyObject* sllist_insertnodebefore(SLListObject* self, PyObject* arg)
     PyObject* inserted = NULL;
     PyObject* ref = NULL;
 
+    sllist_release_step(self);
+
     if (!PyArg_UnpackTuple(arg, "insertnodebefore", 2, 2, &inserted, &ref))
         return NULL;
 
@@ -921,13 +1306,9 @@ static PyObject* sllist_insertnodebefore(SLListObject* self, PyObject* arg)
 
     SLListNodeObject* inserted_node = (SLListNodeObject*)inserted;
 
-    if (inserted_node->list_weakref != Py_None
-        || inserted_node->next != Py_None)
-    {
-        PyErr_SetString(PyExc_ValueError,
-            "Inserted node must not belong to a list");
+    if (!sllistnode_check_free(inserted_node,
+            "Inserted node must not belong to a list"))
         return NULL;
-    }
 
     if (!PyObject_TypeCheck(ref, &SLListNodeType))
     {
@@ -938,15 +1319,14 @@ static PyObject* sllist_insertnodebefore(SLListObject* self, PyObject* arg)
 
     SLListNodeObject* ref_node = (SLListNodeObject*)ref;
 
-    if (ref_node->list_weakref == Py_None)
+    if (ref_node->list_weakref == NULL)
     {
         PyErr_SetString(PyExc_ValueError,
             "ref_node does not belong to a list");
         return NULL;
     }
 
-    PyObject* list_ref = PyWeakref_GetObject(ref_node->list_weakref);
-    if (list_ref != (PyObject*)self)
+    if (ref_node->list_weakref != self->node_ref)
     {
         PyErr_SetString(PyExc_ValueError,
             "ref_node belongs to another list");
@@ -959,7 +1339,7 @@ static PyObject* sllist_insertnodebefore(SLListObject* self, PyObject* arg)
     SLListNodeObject* prev_node = sllist_get_prev(self, ref_node);
 
     /* putting new node in created gap, not first and exists */
-    if ((PyObject*)prev_node != Py_None && prev_node != NULL)
+    if (prev_node != NULL)
         prev_node->next = inserted;
     else
         self->first = inserted;
@@ -971,7 +1351,11 @@ static PyObject* sllist_insertnodebefore(SLListObject* self, PyObject* arg)
     return inserted;
 }
 
-static PyObject* sllist_extendleft(SLListObject* self, PyObject* sequence)
+/* Prepend elements of a sequence to the list, in reverse order.
+ * If nodes is not NULL, created nodes are appended to it. */
+static int sllist_extendleft_internal(SLListObject* self,
+                                      PyObject* sequence,
+                                      PyObject* nodes)
 {
     Py_ssize_t i;
     Py_ssize_t sequence_len;
@@ -984,18 +1368,25 @@ static PyObject* sllist_extendleft(SLListObject* self, PyObject* sequence)
         PyObject* iter_node_obj = ((SLListObject*)sequence)->first;
         PyObject* last_node_obj = ((SLListObject*)sequence)->last;
 
-        while (iter_node_obj != Py_None)
+        while (iter_node_obj != NULL)
         {
             SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
             PyObject* new_node;
 
             new_node = (PyObject*)sllistnode_create(
                 self->first, iter_node->value, (PyObject*)self);
+            if (new_node == NULL)
+                return 0;
 
             self->first = new_node;
-            if (self->last == Py_None)
+            if (self->last == NULL)
                 self->last = new_node;
 
+            ++self->size;
+
+            if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+                return 0;
+
             if (iter_node_obj == last_node_obj)
             {
                 /* This is needed to terminate loop if self == sequence. */
@@ -1005,16 +1396,14 @@ static PyObject* sllist_extendleft(SLListObject* self, PyObject* sequence)
             iter_node_obj = iter_node->next;
         }
 
-        self->size += ((SLListObject*)sequence)->size;
-
-        Py_RETURN_NONE;
+        return 1;
     }
 
     sequence_len = PySequence_Length(sequence);
     if (sequence_len == -1)
     {
         PyErr_SetString(PyExc_ValueError, "Invalid sequence");
-        return NULL;
+        return 0;
     }
 
     for (i = 0; i < sequence_len; ++i)
@@ -1027,34 +1416,89 @@ static PyObject* sllist_extendleft(SLListObject* self, PyObject* sequence)
         {
             PyErr_SetString(PyExc_ValueError,
                             "Failed to get element from sequence");
-            return NULL;
+            return 0;
         }
 
         new_node = (PyObject*)sllistnode_create(self->first,
                                                 item,
                                                 (PyObject*)self);
+        Py_DECREF(item);
+        if (new_node == NULL)
+            return 0;
 
         self->first = new_node;
-        if (self->last == Py_None)
+        if (self->last == NULL)
             self->last = new_node;
 
         ++self->size;
 
-        Py_DECREF(item);
+        if (nodes != NULL && PyList_Append(nodes, new_node) != 0)
+            return 0;
     }
 
+    return 1;
+}
+
+static PyObject* sllist_extendleft(SLListObject* self, PyObject* sequence)
+{
+    sllist_release_step(self);
+
+    if (!sllist_extendleft_internal(self, sequence, NULL))
+        return NULL;
+
     Py_RETURN_NONE;
 }
 
+static PyObject* sllist_extendleftnodes(SLListObject* self,
+                                        PyObject* sequence)
+{
+    PyObject* nodes;
+
+    sllist_release_step(self);
+
+    nodes = PyList_New(0);
+    if (nodes == NULL)
+        return NULL;
+
+    if (!sllist_extendleft_internal(self, sequence, nodes))
+    {
+        Py_DECREF(nodes);
+        return NULL;
+    }
+
+    return nodes;
+}
+
 
 static PyObject* sllist_extendright(SLListObject* self, PyObject* arg)
 {
-    if (!sllist_extend_internal(self, arg))
+    sllist_release_step(self);
+
+    if (!sllist_extend_internal(self, arg, NULL))
         return NULL;
 
     Py_RETURN_NONE;
 }
 
+static PyObject* sllist_extendnodes(SLListObject* self, PyObject* arg)
+{
+    PyObject* nodes;
+
+    sllist_release_step(self);
+
+    nodes = PyList_New(0);
+    if (nodes == NULL)
+        return NULL;
+
+    if (!sllist_extend_internal(self, arg, nodes))
+    {
+        Py_DECREF(nodes);
+        return NULL;
+    }
+
+    return nodes;
+}
+
 
 static SLListNodeObject* sllist_get_node_internal(SLListObject* self,
                                                   Py_ssize_t pos)
@@ -1062,150 +1506,1481 @@ static SLListNodeObject* sllist_get_node_internal(SLListObject* self,
     SLListNodeObject* node;
     Py_ssize_t counter;
 
-    if (pos < 0 || pos >= self->size)
-    {
-        PyErr_SetString(PyExc_IndexError, "Index out of range");
-        return NULL;
+    if (pos < 0 || pos >= self->size)
+    {
+        PyErr_SetString(PyExc_IndexError, "Index out of range");
+        return NULL;
+    }
+    /* taking head */
+    node = (SLListNodeObject*)self->first;
+    assert(node != NULL);
+    /* iterate to given index */
+    for (counter = 0; counter < pos; ++counter)
+        node = (SLListNodeObject*)node->next;
+
+    return node;
+}
+
+
+static PyObject* sllist_node_at(PyObject* self, PyObject* indexObject)
+{
+    SLListNodeObject* node;
+    Py_ssize_t index;
+
+    if (!Py23Int_Check(indexObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "Index must be an integer");
+        return NULL;
+    }
+
+    index = Py23Int_AsSsize_t(indexObject);
+
+    if (index < 0)
+        index = ((SLListObject*)self)->size + index;
+
+    node = sllist_get_node_internal((SLListObject*)self, index);
+    Py_XINCREF(node);
+
+    return (PyObject*)node;
+}
+
+
+/* Removes node arg from the list. If prev_hint is not None, it must be
+ * the node preceding arg, which avoids searching for it. */
+static PyObject* sllist_remove_node(SLListObject* self,
+                                    PyObject* arg,
+                                    PyObject* prev_hint)
+{
+    SLListNodeObject* del_node;
+    SLListNodeObject* prev;
+    PyObject* value;
+
+    if (!PyObject_TypeCheck(arg, &SLListNodeType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument is not an sllistnode");
+        return NULL;
+    }
+
+    if (self->first == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    del_node = (SLListNodeObject*)arg;
+
+    if (del_node->list_weakref == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode does not belong to a list");
+        return NULL;
+    }
+
+    if (del_node->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode belongs to another list");
+        return NULL;
+    }
+
+    if (prev_hint != Py_None && !sllist_check_prev(self, prev_hint, arg))
+        return NULL;
+
+    /* remove first node case */
+    if(self->first == arg) {
+        self->first = del_node->next;
+        if (self->last == arg)
+            self->last = NULL;
+    }
+    /* we are sure that we have more than 1 node */
+    else
+    {
+        /* making gap */
+        if (prev_hint != Py_None)
+            prev = (SLListNodeObject*)prev_hint;
+        else
+            prev = sllist_get_prev(self, del_node);
+        prev->next = del_node->next;
+
+        if (self->last == arg)
+            self->last = (PyObject*)prev;
+    }
+
+    --self->size;
+
+    value = del_node->value;
+    Py_INCREF(value);
+
+    sllistnode_delete(del_node);
+
+    return value;
+
+}
+
+static PyObject* sllist_remove(SLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds)
+{
+    static char* kwlist[] = { "node", "prev", NULL };
+
+    PyObject* node = NULL;
+    PyObject* prev_hint = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:remove", kwlist,
+                                     &node, &prev_hint))
+        return NULL;
+
+    return sllist_remove_node(self, node, prev_hint);
+}
+
+/* Unlinks the node following prev and returns it (borrowed reference,
+ * the list still holds its reference until sllistnode_delete is called). */
+static SLListNodeObject* sllist_unlink_after(SLListObject* self,
+                                             PyObject* prev)
+{
+    SLListNodeObject* prev_node;
+    SLListNodeObject* del_node;
+
+    if (!PyObject_TypeCheck(prev, &SLListNodeType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument is not an sllistnode");
+        return NULL;
+    }
+
+    prev_node = (SLListNodeObject*)prev;
+
+    if (prev_node->list_weakref == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode does not belong to a list");
+        return NULL;
+    }
+
+    if (prev_node->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode belongs to another list");
+        return NULL;
+    }
+
+    if (prev_node->next == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "No node after given node");
+        return NULL;
+    }
+
+    del_node = (SLListNodeObject*)prev_node->next;
+    prev_node->next = del_node->next;
+
+    if (self->last == (PyObject*)del_node)
+        self->last = prev;
+
+    --self->size;
+
+    return del_node;
+}
+
+static PyObject* sllist_removeafter(SLListObject* self, PyObject* arg)
+{
+    SLListNodeObject* del_node;
+    PyObject* next;
+
+    del_node = sllist_unlink_after(self, arg);
+    if (del_node == NULL)
+        return NULL;
+
+    next = (del_node->next != NULL) ? del_node->next : Py_None;
+    Py_INCREF(next);
+
+    sllistnode_delete(del_node);
+
+    return next;
+}
+
+static PyObject* sllist_popafter(SLListObject* self, PyObject* arg)
+{
+    SLListNodeObject* del_node;
+    PyObject* value;
+
+    del_node = sllist_unlink_after(self, arg);
+    if (del_node == NULL)
+        return NULL;
+
+    value = del_node->value;
+    Py_INCREF(value);
+
+    sllistnode_delete(del_node);
+
+    return value;
+}
+
+
+/* Return a new list of nodes of the list. */
+static PyObject* sllist_collect_nodes(SLListObject* self)
+{
+    PyObject* nodes;
+    PyObject* iter_node_obj = self->first;
+    Py_ssize_t i;
+
+    nodes = PyList_New(self->size);
+    if (nodes == NULL)
+        return NULL;
+
+    for (i = 0; i < self->size; ++i)
+    {
+        Py_INCREF(iter_node_obj);
+        PyList_SET_ITEM(nodes, i, iter_node_obj);
+        iter_node_obj = ((SLListNodeObject*)iter_node_obj)->next;
+    }
+
+    return nodes;
+}
+
+/* Return a new list of keys of values of nodes in list nodes. */
+static PyObject* sllist_collect_keys(PyObject* nodes, PyObject* key)
+{
+    PyObject* keys;
+    Py_ssize_t i;
+
+    keys = PyList_New(0);
+    if (keys == NULL)
+        return NULL;
+
+    /* nodes are kept alive by the list of nodes, even if the key
+     * function removes them from their list */
+    for (i = 0; i < PyList_GET_SIZE(nodes); ++i)
+    {
+        SLListNodeObject* node = (SLListNodeObject*)PyList_GET_ITEM(nodes, i);
+        PyObject* node_key;
+        int result;
+
+        node_key = llist_apply_key(key, node->value);
+        if (node_key == NULL)
+        {
+            Py_DECREF(keys);
+            return NULL;
+        }
+
+        result = PyList_Append(keys, node_key);
+        Py_DECREF(node_key);
+        if (result != 0)
+        {
+            Py_DECREF(keys);
+            return NULL;
+        }
+    }
+
+    return keys;
+}
+
+/* Check whether list consists of nodes in list nodes, in that order. */
+static int sllist_has_nodes(SLListObject* self, PyObject* nodes)
+{
+    PyObject* iter_node_obj = self->first;
+    Py_ssize_t i;
+
+    if (self->size != PyList_GET_SIZE(nodes))
+        return 0;
+
+    for (i = 0; i < self->size; ++i)
+    {
+        if (iter_node_obj != PyList_GET_ITEM(nodes, i))
+            return 0;
+        iter_node_obj = ((SLListNodeObject*)iter_node_obj)->next;
+    }
+
+    return 1;
+}
+
+/* Merge nodes of sorted list other into sorted list self. Keys of all
+ * values are computed and compared before any node is relinked, like
+ * in sorted(), so if the key function or a comparison fails, or modifies
+ * either list, both lists are left unchanged. */
+static PyObject* sllist_merge_nodes(SLListObject* self,
+                                    SLListObject* other,
+                                    PyObject* key)
+{
+    PyObject* self_ref;
+    PyObject* a_nodes = NULL;
+    PyObject* b_nodes = NULL;
+    PyObject* a_keys = NULL;
+    PyObject* b_keys = NULL;
+    PyObject* tail = NULL;
+    PyObject* result = NULL;
+    Py_ssize_t a_size;
+    Py_ssize_t b_size;
+    Py_ssize_t i = 0;
+    Py_ssize_t j = 0;
+    Py_ssize_t k;
+    char* take_b = NULL;
+
+    if (other->size == 0)
+        Py_RETURN_NONE;
+
+    /* nodes are collected before the key function can modify lists */
+    a_nodes = sllist_collect_nodes(self);
+    if (a_nodes == NULL)
+        goto merge_done;
+    b_nodes = sllist_collect_nodes(other);
+    if (b_nodes == NULL)
+        goto merge_done;
+
+    a_keys = sllist_collect_keys(a_nodes, key);
+    if (a_keys == NULL)
+        goto merge_done;
+    b_keys = sllist_collect_keys(b_nodes, key);
+    if (b_keys == NULL)
+        goto merge_done;
+
+    a_size = PyList_GET_SIZE(a_nodes);
+    b_size = PyList_GET_SIZE(b_nodes);
+
+    /* take_b[k] tells whether k-th merged node comes from other, while
+     * neither list is exhausted */
+    take_b = (char*)PyMem_Malloc(a_size + b_size);
+    if (take_b == NULL)
+    {
+        PyErr_NoMemory();
+        goto merge_done;
+    }
+
+    for (k = 0; i < a_size && j < b_size; ++k)
+    {
+        /* nodes of self come first among equal elements */
+        int less = PyObject_RichCompareBool(PyList_GET_ITEM(b_keys, j),
+                                            PyList_GET_ITEM(a_keys, i),
+                                            Py_LT);
+        if (less < 0)
+            goto merge_done;
+
+        take_b[k] = (char)less;
+        if (less)
+            ++j;
+        else
+            ++i;
+    }
+
+    if (!sllist_has_nodes(self, a_nodes) || !sllist_has_nodes(other, b_nodes))
+    {
+        PyErr_SetString(PyExc_ValueError, "List modified during merge");
+        goto merge_done;
+    }
+
+    /* no code can run from here on, until the lists are relinked */
+    self_ref = self->node_ref;
+    i = 0;
+    j = 0;
+    for (k = 0; k < a_size + b_size; ++k)
+    {
+        SLListNodeObject* node;
+
+        if (j < b_size && (i == a_size || take_b[k]))
+        {
+            node = (SLListNodeObject*)PyList_GET_ITEM(b_nodes, j++);
+
+            /* the old reference is still held by other */
+            Py_DECREF(node->list_weakref);
+            Py_INCREF(self_ref);
+            node->list_weakref = self_ref;
+        }
+        else
+            node = (SLListNodeObject*)PyList_GET_ITEM(a_nodes, i++);
+
+        if (tail != NULL)
+            ((SLListNodeObject*)tail)->next = (PyObject*)node;
+        else
+            self->first = (PyObject*)node;
+        tail = (PyObject*)node;
+    }
+    ((SLListNodeObject*)tail)->next = NULL;
+
+    self->last = tail;
+    self->size = a_size + b_size;
+
+    other->first = NULL;
+    other->last = NULL;
+    other->size = 0;
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+merge_done:
+    PyMem_Free(take_b);
+    Py_XDECREF(a_nodes);
+    Py_XDECREF(b_nodes);
+    Py_XDECREF(a_keys);
+    Py_XDECREF(b_keys);
+
+    return result;
+}
+
+static PyObject* sllist_merge(PyObject* self, PyObject* args, PyObject* kwds)
+{
+    static char* kwlist[] = { "other", "key", NULL };
+
+    PyObject* other = NULL;
+    PyObject* key = Py_None;
+    PyObject* result;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:merge", kwlist,
+                                     &other, &key))
+        return NULL;
+
+    if (!PyObject_TypeCheck(other, &SLListType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument must be an sllist");
+        return NULL;
+    }
+
+    if (other == self)
+    {
+        PyErr_SetString(PyExc_ValueError, "Cannot merge list with itself");
+        return NULL;
+    }
+
+    /* both lists are locked here, so the method is not wrapped */
+    Py_BEGIN_CRITICAL_SECTION2(self, other);
+    result = sllist_merge_nodes((SLListObject*)self,
+                                (SLListObject*)other,
+                                key);
+    Py_END_CRITICAL_SECTION2();
+
+    return result;
+}
+
+/* Remove nodes for which predicate returns a true value (or a false
+ * value if remove_matching is zero) in a single pass. Returns the number
+ * of removed nodes, or a list of removed values if values is nonzero. */
+static PyObject* sllist_filter(SLListObject* self,
+                               PyObject* predicate,
+                               int remove_matching,
+                               int values)
+{
+    PyObject* removed = NULL;
+    PyObject* node;
+    PyObject* prev = NULL;
+    Py_ssize_t count = 0;
+
+    if (!PyCallable_Check(predicate))
+    {
+        PyErr_SetString(PyExc_TypeError, "Predicate must be callable");
+        return NULL;
+    }
+
+    if (values)
+    {
+        removed = PyList_New(0);
+        if (removed == NULL)
+            return NULL;
+    }
+
+    /* References to the previous, current and next node are held,
+     * because the predicate (and values released with removed nodes) may
+     * run code modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+        PyObject* next;
+        PyObject* result;
+        int matches;
+
+        result = PyObject_CallFunctionObjArgs(
+            predicate, iter_node->value, NULL);
+        if (result == NULL)
+            goto filter_error;
+
+        matches = PyObject_IsTrue(result);
+        Py_DECREF(result);
+        if (matches < 0)
+            goto filter_error;
+
+        if (iter_node->list_weakref != self->node_ref ||
+            (prev != NULL ? ((SLListNodeObject*)prev)->next
+                          : self->first) != node)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "List modified during filtering");
+            goto filter_error;
+        }
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+
+        if (matches == remove_matching)
+        {
+            if (removed != NULL &&
+                PyList_Append(removed, iter_node->value) != 0)
+            {
+                Py_XDECREF(next);
+                goto filter_error;
+            }
+
+            if (prev != NULL)
+                ((SLListNodeObject*)prev)->next = next;
+            else
+                self->first = next;
+            if (self->last == node)
+                self->last = prev;
+
+            --self->size;
+            ++count;
+
+            sllistnode_delete(iter_node);
+            Py_DECREF(node);
+        }
+        else
+        {
+            Py_XDECREF(prev);
+            prev = node;
+        }
+
+        node = next;
+    }
+
+    Py_XDECREF(prev);
+
+    if (removed != NULL)
+        return removed;
+
+    return PyLong_FromSsize_t(count);
+
+filter_error:
+    Py_DECREF(node);
+    Py_XDECREF(prev);
+    Py_XDECREF(removed);
+    return NULL;
+}
+
+/* Check that all items are distinct nodes of the list. Nodes are marked by clearing their
+ * owner references (which are restored by sllist_unmark_nodes()), so
+ * no code may run until marks are removed. Returns the number of marked
+ * nodes, which is smaller than count on failure. */
+static Py_ssize_t sllist_mark_nodes(SLListObject* self,
+                                    PyObject** items,
+                                    Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < count; ++i)
+    {
+        SLListNodeObject* node = (SLListNodeObject*)items[i];
+        Py_ssize_t j;
+
+        if (!PyObject_TypeCheck(items[i], &SLListNodeType))
+        {
+            PyErr_SetString(PyExc_TypeError,
+                "Iterable must contain only sllistnode objects");
+            return i;
+        }
+
+        if (node->list_weakref == self->node_ref)
+        {
+            node->list_weakref = NULL;
+            continue;
+        }
+
+        if (node->list_weakref != NULL)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "sllistnode belongs to another list");
+            return i;
+        }
+
+        for (j = 0; j < i; ++j)
+        {
+            if (items[j] == items[i])
+            {
+                PyErr_SetString(PyExc_ValueError,
+                    "sllistnode occurs more than once");
+                return i;
+            }
+        }
+
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode does not belong to a list");
+        return i;
+    }
+
+    return count;
+}
+
+static void sllist_unmark_nodes(SLListObject* self,
+                                PyObject** items,
+                                Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < count; ++i)
+        ((SLListNodeObject*)items[i])->list_weakref = self->node_ref;
+}
+
+static PyObject* sllist_removenodes(SLListObject* self, PyObject* arg)
+{
+    PyObject* sequence;
+    PyObject* values;
+    PyObject** items;
+    PyObject* node;
+    PyObject* prev;
+    Py_ssize_t count;
+    Py_ssize_t remaining;
+    Py_ssize_t i;
+
+    /* a private copy of nodes cannot be modified by other code */
+    sequence = PySequence_List(arg);
+    if (sequence == NULL)
+        return NULL;
+
+    count = PyList_GET_SIZE(sequence);
+    items = PySequence_Fast_ITEMS(sequence);
+
+    /* allocated before nodes are marked, as it may run the collector */
+    values = PyList_New(count);
+    if (values == NULL)
+    {
+        Py_DECREF(sequence);
+        return NULL;
+    }
+
+    i = sllist_mark_nodes(self, items, count);
+    if (i < count)
+    {
+        sllist_unmark_nodes(self, items, i);
+        Py_DECREF(values);
+        Py_DECREF(sequence);
+        return NULL;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        PyObject* value = ((SLListNodeObject*)items[i])->value;
+
+        Py_INCREF(value);
+        PyList_SET_ITEM(values, i, value);
+    }
+
+    /* unlink marked nodes in a single sweep */
+    prev = NULL;
+    node = self->first;
+    remaining = count;
+
+    while (remaining > 0)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+        PyObject* next;
+
+        assert(node != NULL);
+        next = iter_node->next;
+
+        if (iter_node->list_weakref == NULL)
+        {
+            if (prev != NULL)
+                ((SLListNodeObject*)prev)->next = next;
+            else
+                self->first = next;
+            if (self->last == node)
+                self->last = prev;
+
+            iter_node->next = NULL;
+
+            /* reference to node_ref held by the node is dropped here */
+            Py_DECREF(self->node_ref);
+            --remaining;
+        }
+        else
+            prev = node;
+
+        node = next;
+    }
+
+    self->size -= count;
+
+    /* Release references held by the list only after all nodes are
+     * unlinked, because releasing nodes may run arbitrary code. */
+    for (i = 0; i < count; ++i)
+        Py_DECREF(items[i]);
+
+    Py_DECREF(sequence);
+
+    return values;
+}
+
+static PyObject* sllist_removeif(SLListObject* self,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    static char* kwlist[] = { "predicate", "values", NULL };
+
+    PyObject* predicate = NULL;
+    int values = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:removeif", kwlist,
+                                     &predicate, &values))
+        return NULL;
+
+    return sllist_filter(self, predicate, 1, values);
+}
+
+static PyObject* sllist_retain(SLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds)
+{
+    static char* kwlist[] = { "predicate", "values", NULL };
+
+    PyObject* predicate = NULL;
+    int values = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:retain", kwlist,
+                                     &predicate, &values))
+        return NULL;
+
+    return sllist_filter(self, predicate, 0, values);
+}
+
+/* Remove elements whose keys are equal to the key of any earlier element
+ * or, if adjacent is nonzero, to the key of the preceding kept element.
+ * Returns the number of removed elements. */
+static PyObject* sllist_dedupe_internal(SLListObject* self,
+                                        PyObject* key,
+                                        int adjacent)
+{
+    PyObject* seen = NULL;
+    PyObject* last_key = NULL;
+    PyObject* node;
+    PyObject* prev = NULL;
+    Py_ssize_t count = 0;
+
+    if (!adjacent)
+    {
+        seen = PySet_New(NULL);
+        if (seen == NULL)
+            return NULL;
+    }
+
+    /* References to the previous, current and next node are held,
+     * because the key function and comparisons (and values released with
+     * removed nodes) may run code modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+        PyObject* next;
+        PyObject* node_key;
+        int duplicate;
+
+        node_key = llist_apply_key(key, iter_node->value);
+        if (node_key == NULL)
+            goto dedupe_error;
+
+        if (adjacent)
+        {
+            duplicate = (last_key != NULL) ?
+                PyObject_RichCompareBool(last_key, node_key, Py_EQ) : 0;
+
+            if (duplicate == 0)
+            {
+                Py_XDECREF(last_key);
+                last_key = node_key;
+            }
+            else
+                Py_DECREF(node_key);
+        }
+        else
+        {
+            duplicate = PySet_Contains(seen, node_key);
+            if (duplicate == 0 && PySet_Add(seen, node_key) != 0)
+                duplicate = -1;
+            Py_DECREF(node_key);
+        }
+
+        if (duplicate < 0)
+            goto dedupe_error;
+
+        if (iter_node->list_weakref != self->node_ref ||
+            (prev != NULL ? ((SLListNodeObject*)prev)->next
+                          : self->first) != node)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "List modified during deduplication");
+            goto dedupe_error;
+        }
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+
+        if (duplicate)
+        {
+            if (prev != NULL)
+                ((SLListNodeObject*)prev)->next = next;
+            else
+                self->first = next;
+            if (self->last == node)
+                self->last = prev;
+
+            --self->size;
+            ++count;
+
+            sllistnode_delete(iter_node);
+            Py_DECREF(node);
+        }
+        else
+        {
+            Py_XDECREF(prev);
+            prev = node;
+        }
+
+        node = next;
+    }
+
+    Py_XDECREF(prev);
+    Py_XDECREF(seen);
+    Py_XDECREF(last_key);
+
+    return PyLong_FromSsize_t(count);
+
+dedupe_error:
+    Py_DECREF(node);
+    Py_XDECREF(prev);
+    Py_XDECREF(seen);
+    Py_XDECREF(last_key);
+    return NULL;
+}
+
+static PyObject* sllist_dedupe(SLListObject* self,
+                               PyObject* args,
+                               PyObject* kwds)
+{
+    static char* kwlist[] = { "key", NULL };
+
+    PyObject* key = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:dedupe", kwlist, &key))
+        return NULL;
+
+    return sllist_dedupe_internal(self, key, 0);
+}
+
+static PyObject* sllist_dedupeadjacent(SLListObject* self,
+                                       PyObject* args,
+                                       PyObject* kwds)
+{
+    static char* kwlist[] = { "key", NULL };
+
+    PyObject* key = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:dedupeadjacent", kwlist,
+                                     &key))
+        return NULL;
+
+    return sllist_dedupe_internal(self, key, 1);
+}
+
+static PyObject* sllist_rotate(SLListObject* self, PyObject* nObject)
+{
+    Py_ssize_t n;
+    Py_ssize_t split_idx;
+    Py_ssize_t n_mod;
+    SLListNodeObject* new_first;
+    SLListNodeObject* new_last;
+
+    if (self->size <= 1)
+        Py_RETURN_NONE;
+
+    if (!Py23Int_Check(nObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return NULL;
+    }
+
+    n = Py23Int_AsSsize_t(nObject);
+    n_mod = (n >= 0 ? n : -n) % self->size;
+
+    if (n_mod == 0)
+        Py_RETURN_NONE; /* no-op */
+
+    if (n > 0)
+        split_idx = self->size - n_mod; /* rotate right */
+    else
+        split_idx = n_mod;  /* rotate left */
+
+    new_last = sllist_get_node_internal(self, split_idx - 1);
+    assert(new_last != NULL);
+    new_first = (SLListNodeObject*)new_last->next;
+
+    ((SLListNodeObject*)self->last)->next = self->first;
+
+    new_last->next = NULL;
+
+    self->first = (PyObject*)new_first;
+    self->last = (PyObject*)new_last;
+
+    Py_RETURN_NONE;
+}
+
+/* Create an empty list of the same type and with the same release
+ * and allocation options as self. */
+static SLListObject* sllist_new_similar(SLListObject* self)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    SLListObject* new_list;
+    PyObject* args;
+
+    /* __init__ of subclasses is not called, like in copy.copy() */
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+
+    new_list = (SLListObject*)type->tp_new(type, args, NULL);
+    Py_DECREF(args);
+    if (new_list == NULL)
+        return NULL;
+
+    new_list->flags |= self->flags & LLIST_DEFERRED_RELEASE;
+
+    if (!llist_arena_enable(&new_list->arena, &SLListNodeType,
+                            self->arena != NULL))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return new_list;
+}
+
+/* Convenience function for copying lists. New nodes are created in
+ * a single pass over the source list. Values are copied with
+ * copy.deepcopy() if memo is not NULL. */
+static PyObject* sllist_copy_internal(SLListObject* self, PyObject* memo)
+{
+    SLListObject* new_list;
+    PyObject* iter_node_obj;
+
+    new_list = sllist_new_similar(self);
+    if (new_list == NULL)
+        return NULL;
+
+    if (memo != NULL &&
+        !llist_memo_store(memo, (PyObject*)self, (PyObject*)new_list))
+        goto copy_error;
+
+    iter_node_obj = self->first;
+
+    while (iter_node_obj != NULL)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
+        SLListNodeObject* new_node;
+        PyObject* value;
+
+        if (memo != NULL)
+        {
+            /* deepcopy may run arbitrary code, keep the node alive */
+            Py_INCREF(iter_node);
+            value = llist_deepcopy(iter_node->value, memo);
+            iter_node_obj = iter_node->next;
+            Py_DECREF(iter_node);
+
+            if (value == NULL)
+                goto copy_error;
+        }
+        else
+        {
+            value = iter_node->value;
+            Py_INCREF(value);
+            iter_node_obj = iter_node->next;
+        }
+
+        new_node = sllistnode_create(NULL, value, (PyObject*)new_list);
+        Py_DECREF(value);
+
+        if (new_node == NULL)
+            goto copy_error;
+
+        if (new_list->first == NULL)
+            new_list->first = (PyObject*)new_node;
+        else
+            ((SLListNodeObject*)new_list->last)->next = (PyObject*)new_node;
+        new_list->last = (PyObject*)new_node;
+        ++new_list->size;
+    }
+
+    if (!llist_copy_state((PyObject*)self, (PyObject*)new_list, memo))
+        goto copy_error;
+
+    return (PyObject*)new_list;
+
+copy_error:
+    Py_DECREF(new_list);
+    return NULL;
+}
+
+static PyObject* sllist_copy(SLListObject* self)
+{
+    return sllist_copy_internal(self, NULL);
+}
+
+static PyObject* sllist_deepcopy(SLListObject* self, PyObject* memo)
+{
+    return sllist_copy_internal(self, memo);
+}
+
+/* Move node and all nodes following it to a new list, which is returned.
+ * prev must be the node preceding node, or NULL if node is the first one.
+ * Nodes are relinked, not copied, but their owner references must be
+ * updated, so this is linear in the number of moved nodes. The new list
+ * is empty if node is NULL. */
+static PyObject* sllist_split_internal(SLListObject* self,
+                                       PyObject* prev,
+                                       PyObject* node)
+{
+    SLListObject* new_list;
+    PyObject* iter_node_obj;
+    Py_ssize_t count = 0;
+
+    new_list = sllist_new_similar(self);
+    if (new_list == NULL)
+        return NULL;
+
+    if (node == NULL)
+        return (PyObject*)new_list;
+
+    for (iter_node_obj = node; iter_node_obj != NULL;
+         iter_node_obj = ((SLListNodeObject*)iter_node_obj)->next)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
+
+        /* the list still holds its own reference to node_ref */
+        Py_DECREF(iter_node->list_weakref);
+        iter_node->list_weakref = new_list->node_ref;
+        Py_INCREF(iter_node->list_weakref);
+
+        ++count;
+    }
+
+    new_list->first = node;
+    new_list->last = self->last;
+    new_list->size = count;
+
+    if (prev != NULL)
+        ((SLListNodeObject*)prev)->next = NULL;
+    else
+        self->first = NULL;
+    self->last = prev;
+    self->size -= count;
+
+    return (PyObject*)new_list;
+}
+
+/* Check that arg is a node of the list. */
+static int sllist_validate_node(SLListObject* self, PyObject* arg)
+{
+    if (!PyObject_TypeCheck(arg, &SLListNodeType))
+    {
+        PyErr_SetString(PyExc_TypeError, "Argument is not an sllistnode");
+        return 0;
+    }
+
+    if (((SLListNodeObject*)arg)->list_weakref == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode does not belong to a list");
+        return 0;
+    }
+
+    if (((SLListNodeObject*)arg)->list_weakref != self->node_ref)
+    {
+        PyErr_SetString(PyExc_ValueError,
+            "sllistnode belongs to another list");
+        return 0;
+    }
+
+    return 1;
+}
+
+static PyObject* sllist_splitafter(SLListObject* self, PyObject* arg)
+{
+    if (!sllist_validate_node(self, arg))
+        return NULL;
+
+    return sllist_split_internal(self, arg, ((SLListNodeObject*)arg)->next);
+}
+
+static PyObject* sllist_splitbefore(SLListObject* self,
+                                    PyObject* args,
+                                    PyObject* kwds)
+{
+    static char* kwlist[] = { "node", "prev", NULL };
+
+    PyObject* node = NULL;
+    PyObject* prev_hint = Py_None;
+    PyObject* prev;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:splitbefore", kwlist,
+                                     &node, &prev_hint))
+        return NULL;
+
+    if (!sllist_validate_node(self, node))
+        return NULL;
+
+    if (prev_hint != Py_None && !sllist_check_prev(self, prev_hint, node))
+        return NULL;
+
+    if (self->first == node)
+        prev = NULL;
+    else if (prev_hint != Py_None)
+        prev = prev_hint;
+    else
+        prev = (PyObject*)sllist_get_prev(self, (SLListNodeObject*)node);
+
+    return sllist_split_internal(self, prev, node);
+}
+
+/* Rotate the list so that it starts at new_first and ends at new_last,
+ * which must be adjacent nodes of the list. Only the ends of the list
+ * are relinked. Does nothing if either node is NULL. */
+static void sllist_rotate_between(SLListObject* self,
+                                  PyObject* new_last,
+                                  PyObject* new_first)
+{
+    if (new_last == NULL || new_first == NULL)
+        return; /* no-op */
+
+    ((SLListNodeObject*)self->last)->next = self->first;
+    ((SLListNodeObject*)new_last)->next = NULL;
+
+    self->first = new_first;
+    self->last = new_last;
+}
+
+static PyObject* sllist_rotateto(SLListObject* self,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    static char* kwlist[] = { "node", "prev", NULL };
+
+    PyObject* node = NULL;
+    PyObject* prev_hint = Py_None;
+    PyObject* prev;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:rotateto", kwlist,
+                                     &node, &prev_hint))
+        return NULL;
+
+    if (!sllist_validate_node(self, node))
+        return NULL;
+
+    if (prev_hint != Py_None && !sllist_check_prev(self, prev_hint, node))
+        return NULL;
+
+    if (self->first == node)
+        Py_RETURN_NONE;
+
+    if (prev_hint != Py_None)
+        prev = prev_hint;
+    else
+        prev = (PyObject*)sllist_get_prev(self, (SLListNodeObject*)node);
+
+    sllist_rotate_between(self, prev, node);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* sllist_rotateafter(SLListObject* self, PyObject* arg)
+{
+    if (!sllist_validate_node(self, arg))
+        return NULL;
+
+    sllist_rotate_between(self, arg, ((SLListNodeObject*)arg)->next);
+
+    Py_RETURN_NONE;
+}
+
+/* Move nodes for whose values predicate is true to a new list, which is
+ * returned. Predicate is called for all nodes before any of them is
+ * moved, so the list is left unchanged if it fails. */
+static PyObject* sllist_partition(SLListObject* self, PyObject* predicate)
+{
+    SLListObject* matching;
+    PyObject* nodes;
+    PyObject* node;
+    PyObject* prev = NULL;
+    Py_ssize_t marked = 0;
+    Py_ssize_t i;
+
+    if (!PyCallable_Check(predicate))
+    {
+        PyErr_SetString(PyExc_TypeError, "Predicate must be callable");
+        return NULL;
+    }
+
+    nodes = PyList_New(0);
+    if (nodes == NULL)
+        return NULL;
+
+    /* References to the previous, current and next node are held,
+     * because the predicate may run code modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
+
+    while (node != NULL)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+        PyObject* next;
+        PyObject* result;
+        int matches;
+
+        result = PyObject_CallFunctionObjArgs(
+            predicate, iter_node->value, NULL);
+        if (result == NULL)
+            goto partition_error;
+
+        matches = PyObject_IsTrue(result);
+        Py_DECREF(result);
+        if (matches < 0)
+            goto partition_error;
+
+        if (iter_node->list_weakref != self->node_ref ||
+            (prev != NULL ? ((SLListNodeObject*)prev)->next
+                          : self->first) != node)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "List modified during partitioning");
+            goto partition_error;
+        }
+
+        if (matches && PyList_Append(nodes, node) != 0)
+            goto partition_error;
+
+        next = iter_node->next;
+        Py_XINCREF(next);
+        Py_XDECREF(prev);
+        prev = node;
+        node = next;
+    }
+
+    Py_XDECREF(prev);
+
+    matching = sllist_new_similar(self);
+    if (matching == NULL)
+    {
+        Py_DECREF(nodes);
+        return NULL;
+    }
+
+    /* No code can run from here. Nodes to move are marked by clearing
+     * their owner references (the references to node_ref are released
+     * when nodes are moved) and relinked in a single sweep. */
+    for (i = 0; i < PyList_GET_SIZE(nodes); ++i)
+    {
+        SLListNodeObject* moved = (SLListNodeObject*)PyList_GET_ITEM(nodes, i);
+
+        /* skip nodes visited twice */
+        if (moved->list_weakref != self->node_ref)
+            continue;
+
+        moved->list_weakref = NULL;
+        ++marked;
+    }
+
+    prev = NULL;
+    node = self->first;
+
+    while (marked > 0)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+        PyObject* next = iter_node->next;
+
+        if (iter_node->list_weakref != NULL)
+        {
+            prev = node;
+            node = next;
+            continue;
+        }
+
+        if (prev != NULL)
+            ((SLListNodeObject*)prev)->next = next;
+        else
+            self->first = next;
+        if (self->last == node)
+            self->last = prev;
+        --self->size;
+
+        Py_DECREF(self->node_ref);
+        iter_node->next = NULL;
+        sllistnode_link(NULL, iter_node, (PyObject*)matching);
+
+        if (matching->last != NULL)
+            ((SLListNodeObject*)matching->last)->next = node;
+        else
+            matching->first = node;
+        matching->last = node;
+        ++matching->size;
+
+        --marked;
+        node = next;
     }
-    /* taking head */
-    node = (SLListNodeObject*)self->first;
-    assert((PyObject*)node != Py_None);
-    /* iterate to given index */
-    for (counter = 0; counter < pos; ++counter)
-        node = (SLListNodeObject*)node->next;
 
-    return node;
-}
+    Py_DECREF(nodes);
 
+    return (PyObject*)matching;
 
-static PyObject* sllist_node_at(PyObject* self, PyObject* indexObject)
+partition_error:
+    Py_DECREF(node);
+    Py_XDECREF(prev);
+    Py_DECREF(nodes);
+    return NULL;
+}
+
+/* Replace each value of the list with the result of calling func on it. */
+static PyObject* sllist_apply(SLListObject* self, PyObject* func)
 {
-    SLListNodeObject* node;
-    Py_ssize_t index;
+    PyObject* node;
 
-    if (!Py23Int_Check(indexObject))
+    if (!PyCallable_Check(func))
     {
-        PyErr_SetString(PyExc_TypeError, "Index must be an integer");
+        PyErr_SetString(PyExc_TypeError, "Argument must be callable");
         return NULL;
     }
 
-    index = Py23Int_AsSsize_t(indexObject);
+    /* References to the current and next node are held, because func
+     * (and replaced values when they are released) may run code
+     * modifying the list. */
+    node = self->first;
+    Py_XINCREF(node);
 
-    if (index < 0)
-        index = ((SLListObject*)self)->size + index;
+    while (node != NULL)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+        PyObject* old_value = NULL;
+        PyObject* next;
 
-    node = sllist_get_node_internal((SLListObject*)self, index);
-    Py_XINCREF(node);
+        if (!llist_is_identity_call(func, iter_node->value))
+        {
+            PyObject* value = Py23Object_CallOneArg(func, iter_node->value);
 
-    return (PyObject*)node;
-}
+            if (value == NULL)
+                goto apply_error;
+
+            if (iter_node->list_weakref != self->node_ref)
+            {
+                Py_DECREF(value);
+                PyErr_SetString(PyExc_ValueError,
+                    "List modified during apply");
+                goto apply_error;
+            }
 
+            old_value = iter_node->value;
+            iter_node->value = value;
+            sllistnode_update_gc(iter_node);
+        }
 
-static PyObject* sllist_remove(SLListObject* self, PyObject* arg)
-{
-    SLListNodeObject* del_node;
-    SLListNodeObject* prev;
-    PyObject* list_ref;
-    PyObject* value;
+        next = iter_node->next;
+        Py_XINCREF(next);
 
-    if (!PyObject_TypeCheck(arg, &SLListNodeType))
-    {
-        PyErr_SetString(PyExc_TypeError, "Argument is not an sllistnode");
-        return NULL;
+        Py_XDECREF(old_value);
+        Py_DECREF(node);
+        node = next;
     }
 
-    if (self->first == Py_None)
-    {
-        PyErr_SetString(PyExc_ValueError, "List is empty");
-        return NULL;
-    }
+    Py_RETURN_NONE;
 
-    del_node = (SLListNodeObject*)arg;
+apply_error:
+    Py_DECREF(node);
+    return NULL;
+}
 
-    if (del_node->list_weakref == Py_None)
-    {
-        PyErr_SetString(PyExc_ValueError,
-            "sllistnode does not belong to a list");
+static PyObject* sllist_reduce(SLListObject* self)
+{
+    PyObject* args;
+    PyObject* state;
+    PyObject* items;
+    PyObject* result;
+
+    /* values are passed as an iterator over the list, so pickle creates
+     * (and memoizes) an empty list first and appends values to it, which
+     * handles lists containing themselves and avoids copying values */
+    items = PyObject_GetIter((PyObject*)self);
+    if (items == NULL)
         return NULL;
-    }
 
-    list_ref = PyWeakref_GetObject(del_node->list_weakref);
-    if (list_ref != (PyObject*)self)
+    state = llist_get_state((PyObject*)self);
+    if (state == NULL)
     {
-        PyErr_SetString(PyExc_ValueError,
-            "sllistnode belongs to another list");
+        Py_DECREF(items);
         return NULL;
     }
 
-    /* remove first node case */
-    if(self->first == arg) {
-        self->first = del_node->next;
-        if (self->last == arg)
-            self->last = Py_None;
-    }
-    /* we are sure that we have more than 1 node */
+    /* options are passed to the constructor only when set, so pickles
+     * of other lists stay loadable by subclasses overriding __init__ */
+    if (self->arena != NULL)
+        args = Py_BuildValue("(()ii)",
+            (self->flags & LLIST_DEFERRED_RELEASE) != 0, 1);
+    else if ((self->flags & LLIST_DEFERRED_RELEASE) != 0)
+        args = Py_BuildValue("(()i)", 1);
     else
+        args = PyTuple_New(0);
+    if (args == NULL)
     {
-        /* making gap */
-        prev = sllist_get_prev(self, del_node);
-        prev->next = del_node->next;
-
-        if (self->last == arg)
-            self->last = (PyObject*)prev;
+        Py_DECREF(state);
+        Py_DECREF(items);
+        return NULL;
     }
 
-    --self->size;
-
-    value = del_node->value;
-    Py_INCREF(value);
-
-    sllistnode_delete(del_node);
+    result = Py_BuildValue("ONON", (PyObject*)Py_TYPE(self), args,
+                           state, items);
 
-    return value;
+    Py_DECREF(state);
 
+    return result;
 }
 
-
-static PyObject* sllist_rotate(SLListObject* self, PyObject* nObject)
+/* Compute memory used by nodes owned by the list and by the weak
+ * reference shared by them. Values stored in nodes are not included. */
+static void sllist_memory_usage(SLListObject* self,
+                               Py_ssize_t* node_bytes,
+                               Py_ssize_t* ref_bytes)
 {
-    Py_ssize_t n;
-    Py_ssize_t split_idx;
-    Py_ssize_t n_mod;
-    SLListNodeObject* new_first;
-    SLListNodeObject* new_last;
-
-    if (self->size <= 1)
-        Py_RETURN_NONE;
+    PyObject* iter_node_obj = self->first;
 
-    if (!Py23Int_Check(nObject))
+    *node_bytes = 0;
+    while (iter_node_obj != NULL)
     {
-        PyErr_SetString(PyExc_TypeError, "n must be an integer");
-        return NULL;
+        *node_bytes += llist_object_size(iter_node_obj);
+        iter_node_obj = ((SLListNodeObject*)iter_node_obj)->next;
     }
 
-    n = Py23Int_AsSsize_t(nObject);
-    n_mod = (n >= 0 ? n : -n) % self->size;
-
-    if (n_mod == 0)
-        Py_RETURN_NONE; /* no-op */
+    *ref_bytes = llist_object_size(self->node_ref);
+}
 
-    if (n > 0)
-        split_idx = self->size - n_mod; /* rotate right */
-    else
-        split_idx = n_mod;  /* rotate left */
+static PyObject* sllist_sizeof(SLListObject* self)
+{
+    Py_ssize_t node_bytes;
+    Py_ssize_t ref_bytes;
 
-    new_last = sllist_get_node_internal(self, split_idx - 1);
-    assert(new_last != NULL);
-    new_first = (SLListNodeObject*)new_last->next;
+    sllist_memory_usage(self, &node_bytes, &ref_bytes);
 
-    ((SLListNodeObject*)self->last)->next = self->first;
+    return PyLong_FromSsize_t(
+        Py_TYPE(self)->tp_basicsize + node_bytes + ref_bytes);
+}
 
-    new_last->next = Py_None;
+static PyObject* sllist_memory_stats(SLListObject* self)
+{
+    Py_ssize_t node_bytes;
+    Py_ssize_t ref_bytes;
 
-    self->first = (PyObject*)new_first;
-    self->last = (PyObject*)new_last;
+    sllist_memory_usage(self, &node_bytes, &ref_bytes);
 
-    Py_RETURN_NONE;
+    return Py_BuildValue("{s:n,s:n,s:n,s:n,s:n}",
+                         "nodes", self->size,
+                         "node_bytes", node_bytes,
+                         "ref_bytes", ref_bytes,
+                         "pool_bytes", llist_arena_reserved(self->arena),
+                         "pinned_bytes", llist_arena_pinned(
+                             self->arena, self->first,
+                             offsetof(SLListNodeObject, next)));
 }
 
 
@@ -1216,8 +2991,8 @@ static PyObject* sllist_concat(PyObject* self, PyObject* other)
     new_list = (SLListObject*)PyObject_CallObject(
         (PyObject*)&SLListType, NULL);
 
-    if (!sllist_extend_internal(new_list, self) ||
-        !sllist_extend_internal(new_list, other))
+    if (!sllist_extend_internal(new_list, self, NULL) ||
+        !sllist_extend_internal(new_list, other, NULL))
     {
         Py_DECREF(new_list);
         return NULL;
@@ -1229,7 +3004,7 @@ static PyObject* sllist_concat(PyObject* self, PyObject* other)
 
 static PyObject* sllist_inplace_concat(PyObject* self, PyObject* other)
 {
-    if (!sllist_extend_internal((SLListObject*)self, other))
+    if (!sllist_extend_internal((SLListObject*)self, other, NULL))
         return NULL;
 
     Py_INCREF(self);
@@ -1247,7 +3022,7 @@ static PyObject* sllist_repeat(PyObject* self, Py_ssize_t count)
 
     for (i = 0; i < count; ++i)
     {
-        if (!sllist_extend_internal(new_list, self))
+        if (!sllist_extend_internal(new_list, self, NULL))
         {
             Py_DECREF(new_list);
             return NULL;
@@ -1278,8 +3053,14 @@ static int sllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
 {
     SLListObject* list = (SLListObject*)self;
     SLListNodeObject* node;
+    PyObject* value = NULL;
     PyObject* oldval;
 
+    /* value of the assigned node is read before looking up the item
+     * (see sllist_insertafter) */
+    if (val != NULL && PyObject_TypeCheck(val, &SLListNodeType))
+        value = sllistnode_get_value((SLListNodeObject*)val, NULL);
+
     /* setting fist node */
     if(index==0)
         node = (SLListNodeObject*)list->first;
@@ -1292,14 +3073,17 @@ static int sllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
         node = (SLListNodeObject*)sllist_get_node_internal(list, index);
 
     if (node == NULL)
+    {
+        Py_XDECREF(value);
         return -1;
+    }
 
     /* Here is a tricky (and undocumented) part of sequence protocol.
      * Python will pass NULL as item value when item is deleted with:
      * del list[index] */
     if (val == NULL)
     {
-        PyObject* result = sllist_remove(list, (PyObject*)node);
+        PyObject* result = sllist_remove_node(list, (PyObject*)node, Py_None);
 
         Py_XDECREF(result);
 
@@ -1308,18 +3092,15 @@ static int sllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
 
     /* The rest of this function handles normal assignment:
      * list[index] = item */
-    if (!PyObject_TypeCheck(val, &SLListNodeType)) {
+    if (value == NULL) {
         PyErr_SetString(PyExc_TypeError, "Argument is not an sllistnode");
         return -1;
     }
 
-    /* nice played, migu :) */
-    val = ((SLListNodeObject*)val)->value;
-
     oldval = node->value;
 
-    Py_INCREF(val);
-    node->value = val;
+    node->value = value;
+    sllistnode_update_gc(node);
     Py_DECREF(oldval);
 
     return 0;
@@ -1327,22 +3108,50 @@ static int sllist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
 
 static PyObject* sllist_clear(SLListObject* self)
 {
-    PyObject* iter_node_obj = self->first;
+    PyObject* iter_node_obj;
+
+    sllist_release_step(self);
 
-    while (iter_node_obj != Py_None)
+    /* blocks of the arena are freed along with the last of their nodes */
+    if (self->arena != NULL)
+        llist_arena_reset(self->arena);
+
+    if ((self->flags & LLIST_DEFERRED_RELEASE) != 0 && self->size > 0)
     {
-        SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
+        /* Detached nodes still refer to the old node_ref, so they are
+         * no longer recognized as members of the list. */
+        PyObject* old_node_ref = self->node_ref;
+        PyObject* new_node_ref = llist_new_owner_ref((PyObject*)self);
 
-        iter_node_obj = iter_node->next;
+        if (new_node_ref == NULL)
+            return NULL;
 
-        iter_node->next = Py_None;
-        Py_DECREF((PyObject*)iter_node);
+        if (sllist_detach_nodes(self))
+        {
+            self->node_ref = new_node_ref;
+            Py_DECREF(old_node_ref);
+            Py_RETURN_NONE;
+        }
+
+        Py_DECREF(new_node_ref);
     }
 
-    self->first = Py_None;
-    self->last = Py_None;
+    iter_node_obj = self->first;
+
+    /* the list is emptied first, as deleting nodes may run finalizers
+     * of their values */
+    self->first = NULL;
+    self->last = NULL;
     self->size = 0;
 
+    while (iter_node_obj != NULL)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
+
+        iter_node_obj = iter_node->next;
+        sllistnode_delete(iter_node);
+    }
+
     Py_RETURN_NONE;
 }
 
@@ -1351,7 +3160,7 @@ static PyObject* sllist_popleft(SLListObject* self)
     SLListNodeObject* del_node;
     PyObject* value;
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
     {
         PyErr_SetString(PyExc_ValueError, "List is empty");
         return NULL;
@@ -1363,7 +3172,7 @@ static PyObject* sllist_popleft(SLListObject* self)
     self->first = del_node->next;
     /* removeing last node */
     if (self->last == (PyObject*)del_node)
-        self->last = Py_None;
+        self->last = NULL;
 
     --self->size;
 
@@ -1382,7 +3191,7 @@ static PyObject* sllist_popright(SLListObject* self)
     SLListNodeObject* prev;
     PyObject* value;
 
-    if (self->last == Py_None)
+    if (self->last == NULL)
     {
         PyErr_SetString(PyExc_ValueError, "List is empty");
         return NULL;
@@ -1391,14 +3200,14 @@ static PyObject* sllist_popright(SLListObject* self)
     del_node = (SLListNodeObject*)self->last;
     /* only one node in list */
     if (self->first == (PyObject*)del_node){
-        self->last = Py_None;
-        self->first = Py_None;
+        self->last = NULL;
+        self->first = NULL;
     }
     /* more than one node */
     else
     {
         prev = sllist_get_prev(self, del_node);
-        prev->next = Py_None;
+        prev->next = NULL;
         self->last = (PyObject*)prev;
     }
 
@@ -1412,6 +3221,125 @@ static PyObject* sllist_popright(SLListObject* self)
     return value;
 }
 
+/* Parse count of elements to pop. Returns -1 on failure. */
+static Py_ssize_t sllist_parse_pop_count(SLListObject* self, PyObject* arg)
+{
+    Py_ssize_t n;
+
+    if (!Py23Int_Check(arg))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return -1;
+    }
+
+    n = Py23Int_AsSsize_t(arg);
+    if (n == -1 && PyErr_Occurred())
+        return -1;
+
+    if (n < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return -1;
+    }
+
+    return (n < self->size) ? n : self->size;
+}
+
+static PyObject* sllist_popleftn(SLListObject* self, PyObject* arg)
+{
+    Py_ssize_t n = sllist_parse_pop_count(self, arg);
+    PyObject* values;
+    PyObject* head;
+    PyObject* node;
+    Py_ssize_t i;
+
+    if (n < 0)
+        return NULL;
+
+    values = PyList_New(n);
+    if (values == NULL || n == 0)
+        return values;
+
+    /* detach the first n nodes as a single chain */
+    head = self->first;
+    node = head;
+    for (i = 0; i < n; ++i)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+
+        Py_INCREF(iter_node->value);
+        PyList_SET_ITEM(values, i, iter_node->value);
+
+        if (i == n - 1)
+        {
+            self->first = iter_node->next;
+            iter_node->next = NULL;
+        }
+        node = iter_node->next;
+    }
+
+    if (self->first == NULL)
+        self->last = NULL;
+
+    self->size -= n;
+
+    sllist_release_nodes(&head, n);
+
+    return values;
+}
+
+static PyObject* sllist_poprightn(SLListObject* self, PyObject* arg)
+{
+    Py_ssize_t n = sllist_parse_pop_count(self, arg);
+    PyObject* values;
+    PyObject* head;
+    PyObject* node;
+    Py_ssize_t i;
+
+    if (n < 0)
+        return NULL;
+
+    values = PyList_New(n);
+    if (values == NULL || n == 0)
+        return values;
+
+    /* find the node preceding the last n nodes */
+    if (n == self->size)
+    {
+        head = self->first;
+        self->first = NULL;
+        self->last = NULL;
+    }
+    else
+    {
+        SLListNodeObject* prev = (SLListNodeObject*)self->first;
+
+        for (i = self->size - n - 1; i > 0; --i)
+            prev = (SLListNodeObject*)prev->next;
+
+        head = prev->next;
+        prev->next = NULL;
+        self->last = (PyObject*)prev;
+    }
+
+    /* values are returned in order of removal, starting from the end */
+    node = head;
+    for (i = n - 1; i >= 0; --i)
+    {
+        SLListNodeObject* iter_node = (SLListNodeObject*)node;
+
+        Py_INCREF(iter_node->value);
+        PyList_SET_ITEM(values, i, iter_node->value);
+        node = iter_node->next;
+    }
+
+    self->size -= n;
+
+    sllist_release_nodes(&head, n);
+
+    return values;
+}
+
 
 static PyObject* sllist_create_iterator(PyObject* self, PyObject* iterator_type)
 {
@@ -1451,6 +3379,28 @@ static PyObject* sllist_itervalues(PyObject* self)
     return sllist_create_iterator(self, (PyObject*)&SLListIteratorType);
 }
 
+static PyObject* sllist_create_cycle_iterator(PyObject* self,
+                                            PyObject* iterator_type)
+{
+    PyObject* iterator = sllist_create_iterator(self, iterator_type);
+
+    if (iterator != NULL)
+        sllistiterator_set_cycle(iterator);
+
+    return iterator;
+}
+
+static PyObject* sllist_itercycle(PyObject* self)
+{
+    return sllist_create_cycle_iterator(self, (PyObject*)&SLListIteratorType);
+}
+
+static PyObject* sllist_itercyclenodes(PyObject* self)
+{
+    return sllist_create_cycle_iterator(self,
+                                      (PyObject*)&SLListNodeIteratorType);
+}
+
 
 static PyObject* sllist_to_string(SLListObject* self,
                                   reprfunc fmt_func)
@@ -1465,7 +3415,7 @@ static PyObject* sllist_to_string(SLListObject* self,
     if (Py_ReprEnter((PyObject*)self) > 0)
         return Py23String_FromString("sllist(<...>)");
 
-    if (self->first == Py_None)
+    if (self->first == NULL)
     {
         str = Py23String_FromString("sllist()");
         if (str == NULL)
@@ -1481,7 +3431,7 @@ static PyObject* sllist_to_string(SLListObject* self,
     if (comma_str == NULL)
         goto str_alloc_error;
 
-    while ((PyObject*)node != Py_None)
+    while (node != NULL)
     {
         if (node != (SLListNodeObject*)self->first)
             Py23String_Concat(&str, comma_str);
@@ -1540,7 +3490,7 @@ static long sllist_hash(SLListObject* self)
     long hash = 0;
     PyObject* iter_node_obj = self->first;
 
-    while (iter_node_obj != Py_None)
+    while (iter_node_obj != NULL)
     {
         long obj_hash;
         SLListNodeObject* iter_node = (SLListNodeObject*)iter_node_obj;
@@ -1557,76 +3507,198 @@ static long sllist_hash(SLListObject* self)
 }
 
 
+/* wrappers holding the list lock, see lock.h */
+LLIST_LOCKED_ARG(sllist_appendleft_locked, sllist_appendleft)
+LLIST_LOCKED_ARG(sllist_appendright_locked, sllist_appendright)
+LLIST_LOCKED_ARG2(sllist_appendnode_locked, sllist_appendnode)
+LLIST_LOCKED_ARG(sllist_apply_locked, sllist_apply)
+LLIST_LOCKED_NOARGS(sllist_clear_locked, sllist_clear)
+LLIST_LOCKED_NOARGS(sllist_copy_locked, sllist_copy)
+LLIST_LOCKED_ARG(sllist_deepcopy_locked, sllist_deepcopy)
+LLIST_LOCKED_ARG(sllist_partition_locked, sllist_partition)
+LLIST_LOCKED_ARG(sllist_splitafter_locked, sllist_splitafter)
+LLIST_LOCKED_KWARGS(sllist_splitbefore_locked, sllist_splitbefore)
+LLIST_LOCKED_ARG2(sllist_extendright_locked, sllist_extendright)
+LLIST_LOCKED_ARG2(sllist_extendleft_locked, sllist_extendleft)
+LLIST_LOCKED_ARG2(sllist_extendnodes_locked, sllist_extendnodes)
+LLIST_LOCKED_ARG2(sllist_extendleftnodes_locked, sllist_extendleftnodes)
+LLIST_LOCKED_ARG(sllist_insertafter_locked, sllist_insertafter)
+LLIST_LOCKED_KWARGS(sllist_insertbefore_locked, sllist_insertbefore)
+LLIST_LOCKED_ARGS2(sllist_insertnodeafter_locked, sllist_insertnodeafter)
+LLIST_LOCKED_ARGS2(sllist_insertnodebefore_locked, sllist_insertnodebefore)
+LLIST_LOCKED_NOARGS(sllist_itercycle_locked, sllist_itercycle)
+LLIST_LOCKED_NOARGS(sllist_itercyclenodes_locked, sllist_itercyclenodes)
+LLIST_LOCKED_NOARGS(sllist_iternodes_locked, sllist_iternodes)
+LLIST_LOCKED_NOARGS(sllist_itervalues_locked, sllist_itervalues)
+LLIST_LOCKED_NOARGS(sllist_memory_stats_locked, sllist_memory_stats)
+LLIST_LOCKED_ARG(sllist_node_at_locked, sllist_node_at)
+LLIST_LOCKED_NOARGS(sllist_popright_locked, sllist_popright)
+LLIST_LOCKED_ARG(sllist_poprightn_locked, sllist_poprightn)
+LLIST_LOCKED_ARG(sllist_popafter_locked, sllist_popafter)
+LLIST_LOCKED_NOARGS(sllist_popleft_locked, sllist_popleft)
+LLIST_LOCKED_ARG(sllist_popleftn_locked, sllist_popleftn)
+LLIST_LOCKED_NOARGS(sllist_reduce_locked, sllist_reduce)
+LLIST_LOCKED_KWARGS(sllist_remove_locked, sllist_remove)
+LLIST_LOCKED_KWARGS(sllist_removeif_locked, sllist_removeif)
+LLIST_LOCKED_ARG(sllist_removenodes_locked, sllist_removenodes)
+LLIST_LOCKED_KWARGS(sllist_retain_locked, sllist_retain)
+LLIST_LOCKED_KWARGS(sllist_dedupe_locked, sllist_dedupe)
+LLIST_LOCKED_KWARGS(sllist_dedupeadjacent_locked, sllist_dedupeadjacent)
+LLIST_LOCKED_ARG(sllist_removeafter_locked, sllist_removeafter)
+LLIST_LOCKED_ARG(sllist_rotate_locked, sllist_rotate)
+LLIST_LOCKED_ARG(sllist_rotateafter_locked, sllist_rotateafter)
+LLIST_LOCKED_KWARGS(sllist_rotateto_locked, sllist_rotateto)
+LLIST_LOCKED_NOARGS(sllist_sizeof_locked, sllist_sizeof)
+LLIST_LOCKED_LEN(sllist_len_locked, sllist_len)
+LLIST_LOCKED_CONCAT(sllist_concat_locked, sllist_concat)
+LLIST_LOCKED_INDEX(sllist_repeat_locked, sllist_repeat)
+LLIST_LOCKED_INDEX(sllist_get_item_locked, sllist_get_item)
+LLIST_LOCKED_ASS_ITEM(sllist_set_item_locked, sllist_set_item)
+LLIST_LOCKED_CONCAT(sllist_inplace_concat_locked, sllist_inplace_concat)
+LLIST_LOCKED_UNARY(sllist_repr_locked, sllist_repr)
+LLIST_LOCKED_UNARY(sllist_str_locked, sllist_str)
+LLIST_LOCKED_HASH(sllist_hash_locked, sllist_hash)
+LLIST_LOCKED_RICHCOMPARE(sllist_richcompare_locked, sllist_richcompare)
+LLIST_LOCKED_INIT(sllist_init_locked, sllist_init)
+
 static PyMethodDef SLListMethods[] =
 {
-    { "appendleft", (PyCFunction)sllist_appendleft, METH_O,
+    { "appendleft", (PyCFunction)sllist_appendleft_locked, METH_O,
       "Append element at the beginning of the list" },
 
-    { "appendright", (PyCFunction)sllist_appendright, METH_O,
+    { "appendright", (PyCFunction)sllist_appendright_locked, METH_O,
       "Append element at the end of the list" },
 
-    { "appendnode", (PyCFunction)sllist_appendnode, METH_O,
+    { "appendnode", (PyCFunction)sllist_appendnode_locked, METH_O,
       "Append raw sllistnode at the end of the list" },
 
-    { "append", (PyCFunction)sllist_appendright, METH_O,
+    { "apply", (PyCFunction)sllist_apply_locked, METH_O,
+      "Replace each element with the result of calling func on it" },
+
+    { "append", (PyCFunction)sllist_appendright_locked, METH_O,
       "Append element at the end of the list" },
 
-    { "clear", (PyCFunction)sllist_clear, METH_NOARGS,
+    { "clear", (PyCFunction)sllist_clear_locked, METH_NOARGS,
       "Remove all elements from the list" },
-
-    { "extend", (PyCFunction)sllist_extendright, METH_O,
+    { "__copy__", (PyCFunction)sllist_copy_locked, METH_NOARGS,
+      "Return shallow copy of the list" },
+    { "__deepcopy__", (PyCFunction)sllist_deepcopy_locked, METH_O,
+      "Return deep copy of the list" },
+    { "dedupe", (PyCFunction)sllist_dedupe_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Remove elements equal to an earlier element" },
+    { "dedupeadjacent", (PyCFunction)sllist_dedupeadjacent_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Collapse runs of equal elements into their first element" },
+
+    { "extend", (PyCFunction)sllist_extendright_locked, METH_O,
       "Append elements from iterable at the right side of the list" },
 
-    { "extendleft", (PyCFunction)sllist_extendleft, METH_O,
+    { "extendleft", (PyCFunction)sllist_extendleft_locked, METH_O,
       "Append elements from iterable at the left side of the list" },
 
-    { "extendright", (PyCFunction)sllist_extendright, METH_O,
+    { "extendleftnodes", (PyCFunction)sllist_extendleftnodes_locked, METH_O,
+      "Append elements from iterable at the left side of the list and "
+      "return created nodes" },
+
+    { "extendnodes", (PyCFunction)sllist_extendnodes_locked, METH_O,
+      "Append elements from iterable at the right side of the list and "
+      "return created nodes" },
+
+    { "extendright", (PyCFunction)sllist_extendright_locked, METH_O,
       "Append elements from iterable at the right side of the list" },
 
-    { "insertafter", (PyCFunction)sllist_insertafter, METH_VARARGS,
+    { "insertafter", (PyCFunction)sllist_insertafter_locked, METH_VARARGS,
       "Inserts element after node" },
 
-    { "insertbefore", (PyCFunction)sllist_insertbefore, METH_VARARGS,
+    { "insertbefore", (PyCFunction)sllist_insertbefore_locked,
+      METH_VARARGS | METH_KEYWORDS,
       "Inserts element before node" },
 
-    { "insertnodeafter", (PyCFunction)sllist_insertnodeafter, METH_VARARGS,
+    { "insertnodeafter", (PyCFunction)sllist_insertnodeafter_locked, METH_VARARGS,
       "Inserts element after node" },
 
-    { "insertnodebefore", (PyCFunction)sllist_insertnodebefore, METH_VARARGS,
+    { "insertnodebefore", (PyCFunction)sllist_insertnodebefore_locked, METH_VARARGS,
       "Inserts element before node" },
 
-    { "iternodes", (PyCFunction)sllist_iternodes, METH_NOARGS,
+    { "itercycle", (PyCFunction)sllist_itercycle_locked, METH_NOARGS,
+      "Return iterator cycling over list values" },
+
+    { "itercyclenodes", (PyCFunction)sllist_itercyclenodes_locked, METH_NOARGS,
+      "Return iterator cycling over list nodes" },
+
+    { "iternodes", (PyCFunction)sllist_iternodes_locked, METH_NOARGS,
       "Return iterator over list nodes" },
 
-    { "itervalues", (PyCFunction)sllist_itervalues, METH_NOARGS,
+    { "itervalues", (PyCFunction)sllist_itervalues_locked, METH_NOARGS,
       "Return iterator over list values" },
+    { "memory_stats", (PyCFunction)sllist_memory_stats_locked, METH_NOARGS,
+      "Return statistics of memory used by the list" },
+    { "merge", (PyCFunction)sllist_merge, METH_VARARGS | METH_KEYWORDS,
+      "Merge nodes of another sorted list into the sorted list" },
 
-    { "nodeat", (PyCFunction)sllist_node_at, METH_O,
+    { "nodeat", (PyCFunction)sllist_node_at_locked, METH_O,
       "Return node at index" },
 
-    { "pop", (PyCFunction)sllist_popright, METH_NOARGS,
+    { "partition", (PyCFunction)sllist_partition_locked, METH_O,
+      "Move elements for which predicate is true to a new list" },
+
+    { "pop", (PyCFunction)sllist_popright_locked, METH_NOARGS,
       "Remove last element from the list and return it" },
 
-    { "popleft", (PyCFunction)sllist_popleft, METH_NOARGS,
+    { "popafter", (PyCFunction)sllist_popafter_locked, METH_O,
+      "Remove element following node and return it" },
+
+    { "popleft", (PyCFunction)sllist_popleft_locked, METH_NOARGS,
       "Remove first element from the list and return it" },
+    { "popleftn", (PyCFunction)sllist_popleftn_locked, METH_O,
+      "Remove up to n first elements from the list and return them" },
 
-    { "popright", (PyCFunction)sllist_popright, METH_NOARGS,
+    { "popright", (PyCFunction)sllist_popright_locked, METH_NOARGS,
       "Remove last element from the list and return it" },
+    { "poprightn", (PyCFunction)sllist_poprightn_locked, METH_O,
+      "Remove up to n last elements from the list and return them" },
 
-    { "remove", (PyCFunction)sllist_remove, METH_O,
+    { "__reduce__", (PyCFunction)sllist_reduce_locked, METH_NOARGS,
+      "Return state information for pickling" },
+    { "remove", (PyCFunction)sllist_remove_locked,
+      METH_VARARGS | METH_KEYWORDS,
       "Remove element from the list" },
 
-    { "rotate", (PyCFunction)sllist_rotate, METH_O,
+    { "removeafter", (PyCFunction)sllist_removeafter_locked, METH_O,
+      "Remove element following node and return the next node" },
+
+    { "removeif", (PyCFunction)sllist_removeif_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Remove all elements for which predicate is true" },
+    { "removenodes", (PyCFunction)sllist_removenodes_locked, METH_O,
+      "Remove nodes from the list and return their values" },
+    { "retain", (PyCFunction)sllist_retain_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Keep only elements for which predicate is true" },
+    { "rotate", (PyCFunction)sllist_rotate_locked, METH_O,
       "Rotate the list n steps to the right" },
+    { "rotateafter", (PyCFunction)sllist_rotateafter_locked, METH_O,
+      "Rotate the list so that it ends at node" },
+    { "rotateto", (PyCFunction)sllist_rotateto_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Rotate the list so that it starts at node" },
+    { "splitafter", (PyCFunction)sllist_splitafter_locked, METH_O,
+      "Move nodes following node to a new list and return it" },
+    { "splitbefore", (PyCFunction)sllist_splitbefore_locked,
+      METH_VARARGS | METH_KEYWORDS,
+      "Move node and nodes following it to a new list and return it" },
+    { "__sizeof__", (PyCFunction)sllist_sizeof_locked, METH_NOARGS,
+      "Return size of the list and its nodes in memory, in bytes" },
 
     { NULL },   /* sentinel */
 };
 
 static PyMemberDef SLListMembers[] =
 {
-    { "first", T_OBJECT_EX, offsetof(SLListObject, first), READONLY,
+    { "first", T_OBJECT, offsetof(SLListObject, first), READONLY,
       "First node" },
-    { "last", T_OBJECT_EX, offsetof(SLListObject, last), READONLY,
+    { "last", T_OBJECT, offsetof(SLListObject, last), READONLY,
       "Next node" },
     { "size", T_INT, offsetof(SLListObject, size), READONLY,
       "size" },
@@ -1634,17 +3706,61 @@ static PyMemberDef SLListMembers[] =
     { NULL },   /* sentinel */
 };
 
+static PyObject* sllist_get_deferred(SLListObject* self, void* closure)
+{
+    return PyBool_FromLong((self->flags & LLIST_DEFERRED_RELEASE) != 0);
+}
+
+static int sllist_set_deferred(SLListObject* self,
+                               PyObject* value,
+                               void* closure)
+{
+    int deferred;
+
+    if (value == NULL)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete deferred attribute");
+        return -1;
+    }
+
+    deferred = PyObject_IsTrue(value);
+    if (deferred < 0)
+        return -1;
+
+    if (deferred)
+        self->flags |= LLIST_DEFERRED_RELEASE;
+    else
+        self->flags &= ~LLIST_DEFERRED_RELEASE;
+
+    return 0;
+}
+
+static PyObject* sllist_get_arena_attr(SLListObject* self, void* closure)
+{
+    return PyBool_FromLong(self->arena != NULL);
+}
+
+static PyGetSetDef SLListGetSetters[] =
+{
+    { "arena", (getter)sllist_get_arena_attr, NULL,
+      "Whether nodes are allocated from a per-list arena", NULL },
+    { "deferred", (getter)sllist_get_deferred, (setter)sllist_set_deferred,
+      "Release nodes incrementally when the list is cleared or deleted",
+      NULL },
+    { NULL },   /* sentinel */
+};
+
 static PySequenceMethods SLListSequenceMethods =
 {
-    sllist_len,                  /* sq_length         */
-    sllist_concat,               /* sq_concat         */
-    sllist_repeat,               /* sq_repeat         */
-    sllist_get_item,             /* sq_item           */
+    sllist_len_locked,           /* sq_length         */
+    sllist_concat_locked,        /* sq_concat         */
+    sllist_repeat_locked,        /* sq_repeat         */
+    sllist_get_item_locked,      /* sq_item           */
     0,                           /* sq_slice;         */
-    sllist_set_item,             /* sq_ass_item       */
+    sllist_set_item_locked,      /* sq_ass_item       */
     0,                           /* sq_ass_slice      */
     0,                           /* sq_contains       */
-    sllist_inplace_concat,       /* sq_inplace_concat */
+    sllist_inplace_concat_locked, /* sq_inplace_concat */
     0,                           /* sq_inplace_repeat */
 };
 
@@ -1659,13 +3775,13 @@ static PyTypeObject SLListType =
     0,                           /* tp_getattr        */
     0,                           /* tp_setattr        */
     0,                           /* tp_compare        */
-    (reprfunc)sllist_repr,       /* tp_repr           */
+    (reprfunc)sllist_repr_locked, /* tp_repr           */
     0,                           /* tp_as_number      */
     &SLListSequenceMethods,      /* tp_as_sequence    */
     0,                           /* tp_as_mapping     */
-    (hashfunc)sllist_hash,       /* tp_hash           */
+    (hashfunc)sllist_hash_locked, /* tp_hash           */
     0,                           /* tp_call           */
-    (reprfunc)sllist_str,        /* tp_str            */
+    (reprfunc)sllist_str_locked, /* tp_str            */
     0,                           /* tp_getattro       */
     0,                           /* tp_setattro       */
     0,                           /* tp_as_buffer      */
@@ -1675,7 +3791,7 @@ static PyTypeObject SLListType =
     (traverseproc)sllist_traverse,
                                  /* tp_traverse       */
     (inquiry)sllist_clear_refs,  /* tp_clear          */
-    (richcmpfunc)sllist_richcompare,
+    (richcmpfunc)sllist_richcompare_locked,
                                  /* tp_richcompare    */
     offsetof(SLListObject, weakref_list),
                                  /* tp_weaklistoffset */
@@ -1683,13 +3799,13 @@ static PyTypeObject SLListType =
     0,                           /* tp_iternext       */
     SLListMethods,               /* tp_methods        */
     SLListMembers,               /* tp_members        */
-    0,                           /* tp_getset         */
+    SLListGetSetters,            /* tp_getset         */
     0,                           /* tp_base           */
     0,                           /* tp_dict           */
     0,                           /* tp_descr_get      */
     0,                           /* tp_descr_set      */
     0,                           /* tp_dictoffset     */
-    (initproc)sllist_init,       /* tp_init           */
+    (initproc)sllist_init_locked, /* tp_init           */
     0,                           /* tp_alloc          */
     sllist_new,                  /* tp_new            */
 };
@@ -1701,7 +3817,11 @@ typedef struct
 {
     PyObject_HEAD
     SLListObject* list;
+    /* node returned by the last call to next(), NULL before first call */
     PyObject* current_node;
+    int exhausted;
+    /* restart from the first node after the last one */
+    int cycle;
 } SLListIteratorObject;
 
 static int sllistiterator_traverse(SLListIteratorObject* self,
@@ -1754,6 +3874,8 @@ static PyObject* sllistiterator_new(PyTypeObject* type,
 
     self->list = (SLListObject*)owner_list;
     self->current_node = NULL;
+    self->exhausted = 0;
+    self->cycle = 0;
 
     Py_INCREF(self->list);
 
@@ -1761,33 +3883,46 @@ static PyObject* sllistiterator_new(PyTypeObject* type,
 }
 
 
+static void sllistiterator_set_cycle(PyObject* iterator)
+{
+    ((SLListIteratorObject*)iterator)->cycle = 1;
+}
+
 static SLListNodeObject* sllistiterator_advance(PyObject* self)
 {
     SLListIteratorObject* iter_self = (SLListIteratorObject*)self;
+    PyObject* next_node;
+
+    if (iter_self->exhausted)
+    {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
 
     if (iter_self->current_node == NULL)
     {
         // first iteration
-        iter_self->current_node = iter_self->list->first;
-        Py_INCREF(iter_self->current_node);
+        next_node = iter_self->list->first;
     }
-    else if (iter_self->current_node != Py_None)
-    {
-        PyObject* next_node;
-
+    else
         next_node = ((SLListNodeObject*)iter_self->current_node)->next;
-        Py_INCREF(next_node);
-        Py_DECREF(iter_self->current_node);
-        iter_self->current_node = next_node;
-    }
 
-    if (iter_self->current_node == Py_None)
+    /* cycling iterators stop only when the list is empty */
+    if (next_node == NULL && iter_self->cycle)
+        next_node = iter_self->list->first;
+
+    Py_XINCREF(next_node);
+    Py_XDECREF(iter_self->current_node);
+    iter_self->current_node = next_node;
+
+    if (next_node == NULL)
     {
+        iter_self->exhausted = 1;
         PyErr_SetNone(PyExc_StopIteration);
         return NULL;
     }
 
-    return (SLListNodeObject*)iter_self->current_node;
+    return (SLListNodeObject*)next_node;
 }
 
 static PyObject* sllistvalueiterator_iternext(PyObject* self)
@@ -1811,6 +3946,11 @@ static PyObject* sllistnodeiterator_iternext(PyObject* self)
 }
 
 
+LLIST_LOCKED_ITERNEXT(sllistvalueiterator_iternext_locked,
+    sllistvalueiterator_iternext, SLListIteratorObject)
+LLIST_LOCKED_ITERNEXT(sllistnodeiterator_iternext_locked,
+    sllistnodeiterator_iternext, SLListIteratorObject)
+
 static PyTypeObject SLListIteratorType =
 {
     PyVarObject_HEAD_INIT(NULL, 0)
@@ -1841,7 +3981,7 @@ static PyTypeObject SLListIteratorType =
     0,                                  /* tp_richcompare    */
     0,                                  /* tp_weaklistoffset */
     PyObject_SelfIter,                  /* tp_iter           */
-    sllistvalueiterator_iternext,       /* tp_iternext       */
+    sllistvalueiterator_iternext_locked, /* tp_iternext       */
     0,                                  /* tp_methods        */
     0,                                  /* tp_members        */
     0,                                  /* tp_getset         */
@@ -1885,7 +4025,7 @@ static PyTypeObject SLListNodeIteratorType =
     0,                                  /* tp_richcompare    */
     0,                                  /* tp_weaklistoffset */
     PyObject_SelfIter,                  /* tp_iter           */
-    sllistnodeiterator_iternext,        /* tp_iternext       */
+    sllistnodeiterator_iternext_locked, /* tp_iternext       */
     0,                                  /* tp_methods        */
     0,                                  /* tp_members        */
     0,                                  /* tp_getset         */
@@ -0,0 +1,1285 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+#include <structmember.h>
+#include <string.h>
+
+#include "config.h"
+#include "lock.h"
+#include "py23macros.h"
+#include "typedvalue.h"
+#include "utils.h"
+
+#ifndef PyVarObject_HEAD_INIT
+    #define PyVarObject_HEAD_INIT(type, size) \
+        PyObject_HEAD_INIT(type) size,
+#endif
+
+
+static PyTypeObject DLListI64Type;
+static PyTypeObject DLListF64Type;
+static PyTypeObject TypedDLListIteratorType;
+
+
+/* TypedDLListNode */
+
+/* Nodes of typed lists are plain C structures holding unboxed values.
+ * Python objects are created only when values are accessed. */
+typedef struct TypedDLListNode
+{
+    struct TypedDLListNode* prev;
+    struct TypedDLListNode* next;
+    LListTypedValue value;
+} TypedDLListNode;
+
+
+/* TypedDLList */
+
+typedef struct
+{
+    PyObject_HEAD
+    const LListValueKind* kind;
+    TypedDLListNode* first;
+    TypedDLListNode* last;
+    TypedDLListNode* last_accessed_node;
+    Py_ssize_t last_accessed_idx;
+    Py_ssize_t size;
+    /* incremented whenever nodes are released, invalidates iterators */
+    Py_ssize_t state;
+    PyObject* weakref_list;
+} TypedDLListObject;
+
+static int typeddllist_check(PyObject* obj)
+{
+    return PyObject_TypeCheck(obj, &DLListI64Type) ||
+        PyObject_TypeCheck(obj, &DLListF64Type);
+}
+
+static const LListValueKind* typeddllist_kind_of(PyTypeObject* type)
+{
+    if (PyType_IsSubtype(type, &DLListF64Type))
+        return &llist_f64_kind;
+    return &llist_i64_kind;
+}
+
+static void typeddllist_invalidate_last_access_cache(TypedDLListObject* self)
+{
+    self->last_accessed_node = NULL;
+    self->last_accessed_idx = -1;
+}
+
+static Py_ssize_t py_ssize_t_abs(Py_ssize_t x)
+{
+    return (x >= 0) ? x : -x;
+}
+
+/* Convenience function for locating list nodes using index. */
+static TypedDLListNode* typeddllist_get_node_internal(TypedDLListObject* self,
+                                                      Py_ssize_t index)
+{
+    Py_ssize_t i;
+    Py_ssize_t middle = self->size / 2;
+    TypedDLListNode* node;
+    Py_ssize_t start_pos;
+    int reverse_dir;
+
+    if (index >= self->size || index < 0)
+    {
+        PyErr_SetString(PyExc_IndexError, "Index out of range");
+        return NULL;
+    }
+
+    /* pick the closest base node */
+    if (index <= middle)
+    {
+        node = self->first;
+        start_pos = 0;
+        reverse_dir = 0;
+    }
+    else
+    {
+        node = self->last;
+        start_pos = self->size - 1;
+        reverse_dir = 1;
+    }
+
+    /* check if last accessed index is closer */
+    if (self->last_accessed_node != NULL &&
+        self->last_accessed_idx >= 0 &&
+        py_ssize_t_abs(index - self->last_accessed_idx) < middle)
+    {
+        node = self->last_accessed_node;
+        start_pos = self->last_accessed_idx;
+        reverse_dir = (index < self->last_accessed_idx) ? 1 : 0;
+    }
+
+    assert(node != NULL);
+
+    if (!reverse_dir)
+    {
+        /* forward scan */
+        for (i = start_pos; i < index; ++i)
+            node = node->next;
+    }
+    else
+    {
+        /* backward scan */
+        for (i = start_pos; i > index; --i)
+            node = node->prev;
+    }
+
+    return node;
+}
+
+/* Convenience function for creating list nodes.
+ * Links the new node between prev and next (both might be NULL). */
+static TypedDLListNode* typeddllist_link_new(TypedDLListObject* self,
+                                             TypedDLListNode* prev,
+                                             TypedDLListNode* next,
+                                             LListTypedValue value)
+{
+    TypedDLListNode* node;
+
+    node = (TypedDLListNode*)PyMem_Malloc(sizeof(TypedDLListNode));
+    if (node == NULL)
+    {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    node->value = value;
+    node->prev = prev;
+    node->next = next;
+
+    if (prev != NULL)
+        prev->next = node;
+    else
+        self->first = node;
+
+    if (next != NULL)
+        next->prev = node;
+    else
+        self->last = node;
+
+    ++self->size;
+
+    return node;
+}
+
+/* Convenience function for deleting list nodes.
+ * Does not update the last accessed index. */
+static LListTypedValue typeddllist_unlink(TypedDLListObject* self,
+                                          TypedDLListNode* node)
+{
+    LListTypedValue value = node->value;
+
+    if (node->prev != NULL)
+        node->prev->next = node->next;
+    else
+        self->first = node->next;
+
+    if (node->next != NULL)
+        node->next->prev = node->prev;
+    else
+        self->last = node->prev;
+
+    if (self->last_accessed_node == node)
+        typeddllist_invalidate_last_access_cache(self);
+
+    --self->size;
+    ++self->state;
+
+    PyMem_Free(node);
+
+    return value;
+}
+
+static void typeddllist_free_nodes(TypedDLListObject* self)
+{
+    TypedDLListNode* node = self->first;
+
+    while (node != NULL)
+    {
+        TypedDLListNode* next_node = node->next;
+        PyMem_Free(node);
+        node = next_node;
+    }
+
+    self->first = NULL;
+    self->last = NULL;
+    self->size = 0;
+    ++self->state;
+
+    typeddllist_invalidate_last_access_cache(self);
+}
+
+/* Convenience function for extending the list with elements
+ * from an iterable. Elements are added at the right side if
+ * left is 0, or at the left side otherwise. */
+static int typeddllist_extend_internal(TypedDLListObject* self,
+                                       PyObject* iterable,
+                                       int left)
+{
+    PyObject* iterator;
+    PyObject* item;
+
+    if (typeddllist_check(iterable) &&
+        ((TypedDLListObject*)iterable)->kind == self->kind)
+    {
+        /* Special path for extending with a list of the same kind.
+         * Values are copied without boxing. Number of copied nodes is
+         * fixed in advance to terminate loop if self == iterable. */
+        TypedDLListObject* other = (TypedDLListObject*)iterable;
+        TypedDLListNode* iter_node = other->first;
+        Py_ssize_t count = other->size;
+        Py_ssize_t i;
+
+        for (i = 0; i < count; ++i)
+        {
+            TypedDLListNode* new_node;
+
+            if (left)
+                new_node = typeddllist_link_new(
+                    self, NULL, self->first, iter_node->value);
+            else
+                new_node = typeddllist_link_new(
+                    self, self->last, NULL, iter_node->value);
+
+            if (new_node == NULL)
+                return 0;
+
+            if (left && self->last_accessed_idx >= 0)
+                ++self->last_accessed_idx;
+
+            iter_node = iter_node->next;
+        }
+
+        return 1;
+    }
+
+    iterator = PyObject_GetIter(iterable);
+    if (iterator == NULL)
+        return 0;
+
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        LListTypedValue value;
+        TypedDLListNode* new_node = NULL;
+
+        if (self->kind->unbox(item, &value))
+        {
+            if (left)
+                new_node = typeddllist_link_new(
+                    self, NULL, self->first, value);
+            else
+                new_node = typeddllist_link_new(
+                    self, self->last, NULL, value);
+        }
+
+        Py_DECREF(item);
+
+        if (new_node == NULL)
+        {
+            Py_DECREF(iterator);
+            return 0;
+        }
+
+        if (left && self->last_accessed_idx >= 0)
+            ++self->last_accessed_idx;
+    }
+
+    Py_DECREF(iterator);
+
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+static void typeddllist_dealloc(TypedDLListObject* self)
+{
+    PyObject* obj_self = (PyObject*)self;
+
+    if (self->weakref_list != NULL)
+        PyObject_ClearWeakRefs(obj_self);
+
+    typeddllist_free_nodes(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* typeddllist_new(PyTypeObject* type,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    TypedDLListObject* self;
+
+    self = (TypedDLListObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->kind = typeddllist_kind_of(type);
+    self->first = NULL;
+    self->last = NULL;
+    self->last_accessed_node = NULL;
+    self->last_accessed_idx = -1;
+    self->size = 0;
+    self->state = 0;
+    self->weakref_list = NULL;
+
+    return (PyObject*)self;
+}
+
+static int typeddllist_init(TypedDLListObject* self,
+                            PyObject* args,
+                            PyObject* kwds)
+{
+    PyObject* iterable = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &iterable))
+        return -1;
+
+    if (iterable == NULL)
+        return 0;
+
+    return typeddllist_extend_internal(self, iterable, 0) ? 0 : -1;
+}
+
+static PyObject* typeddllist_repr(TypedDLListObject* self)
+{
+    PyObject* str = NULL;
+    PyObject* comma_str = NULL;
+    PyObject* tmp_str;
+    TypedDLListNode* node;
+    const char* type_name = Py_TYPE(self)->tp_name;
+
+    /* strip module name */
+    if (strrchr(type_name, '.') != NULL)
+        type_name = strrchr(type_name, '.') + 1;
+
+    str = Py23String_FromString(type_name);
+    if (str == NULL)
+        goto str_alloc_error;
+
+    if (self->first == NULL)
+    {
+        tmp_str = Py23String_FromString("()");
+        if (tmp_str == NULL)
+            goto str_alloc_error;
+        Py23String_ConcatAndDel(&str, tmp_str);
+        return str;
+    }
+
+    tmp_str = Py23String_FromString("([");
+    if (tmp_str == NULL)
+        goto str_alloc_error;
+    Py23String_ConcatAndDel(&str, tmp_str);
+
+    comma_str = Py23String_FromString(", ");
+    if (comma_str == NULL)
+        goto str_alloc_error;
+
+    for (node = self->first; node != NULL; node = node->next)
+    {
+        PyObject* value;
+
+        if (node != self->first)
+            Py23String_Concat(&str, comma_str);
+
+        value = self->kind->box(node->value);
+        if (value == NULL)
+            goto str_alloc_error;
+
+        tmp_str = PyObject_Repr(value);
+        Py_DECREF(value);
+        if (tmp_str == NULL)
+            goto str_alloc_error;
+        Py23String_ConcatAndDel(&str, tmp_str);
+    }
+
+    Py_DECREF(comma_str);
+    comma_str = NULL;
+
+    tmp_str = Py23String_FromString("])");
+    if (tmp_str == NULL)
+        goto str_alloc_error;
+    Py23String_ConcatAndDel(&str, tmp_str);
+
+    return str;
+
+str_alloc_error:
+    Py_XDECREF(str);
+    Py_XDECREF(comma_str);
+    PyErr_SetString(PyExc_RuntimeError, "Failed to create string");
+
+    return NULL;
+}
+
+static long typeddllist_hash(TypedDLListObject* self)
+{
+    long hash = 0;
+    TypedDLListNode* node;
+
+    for (node = self->first; node != NULL; node = node->next)
+    {
+        long value_hash = self->kind->hash(node->value);
+
+        if (value_hash == -1)
+            return -1;
+
+        hash = hash_combine(hash, value_hash);
+    }
+
+    /* -1 is reserved for signalling errors */
+    return (hash != -1) ? hash : -2;
+}
+
+static PyObject* typeddllist_richcompare(TypedDLListObject* self,
+                                         PyObject* other_obj,
+                                         int op)
+{
+    TypedDLListObject* other = (TypedDLListObject*)other_obj;
+    TypedDLListNode* self_node;
+    TypedDLListNode* other_node;
+    int satisfied;
+
+    if (!typeddllist_check(other_obj) || other->kind != self->kind)
+    {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    if (self->size != other->size)
+    {
+        if (op == Py_EQ)
+            Py_RETURN_FALSE;
+        else if (op == Py_NE)
+            Py_RETURN_TRUE;
+    }
+
+    /* Scan through sequences' items as long as they are equal. */
+    self_node = self->first;
+    other_node = other->first;
+
+    while (self_node != NULL && other_node != NULL &&
+           self->kind->equal(self_node->value, other_node->value))
+    {
+        self_node = self_node->next;
+        other_node = other_node->next;
+    }
+
+    if (self_node != NULL && other_node != NULL)
+    {
+        /* Both nodes are valid, but not equal */
+        satisfied = self->kind->compare(
+            self_node->value, other_node->value, op);
+    }
+    else
+    {
+        /* At least one of operands has been fully traversed. */
+        switch (op)
+        {
+        case Py_EQ:
+            satisfied = (self_node == other_node);
+            break;
+        case Py_NE:
+            satisfied = (self_node != other_node);
+            break;
+        case Py_LT:
+            satisfied = (other_node != NULL);
+            break;
+        case Py_GT:
+            satisfied = (self_node != NULL);
+            break;
+        case Py_LE:
+            satisfied = (self_node == NULL);
+            break;
+        case Py_GE:
+            satisfied = (other_node == NULL);
+            break;
+        default:
+            assert(0 && "Invalid rich compare operator");
+            PyErr_SetString(PyExc_ValueError, "Invalid rich compare operator");
+            return NULL;
+        }
+    }
+
+    if (satisfied)
+        Py_RETURN_TRUE;
+    else
+        Py_RETURN_FALSE;
+}
+
+static PyObject* typeddllist_appendleft(TypedDLListObject* self, PyObject* arg)
+{
+    LListTypedValue value;
+
+    if (!self->kind->unbox(arg, &value))
+        return NULL;
+
+    if (typeddllist_link_new(self, NULL, self->first, value) == NULL)
+        return NULL;
+
+    if (self->last_accessed_idx >= 0)
+        ++self->last_accessed_idx;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_appendright(TypedDLListObject* self, PyObject* arg)
+{
+    LListTypedValue value;
+
+    if (!self->kind->unbox(arg, &value))
+        return NULL;
+
+    if (typeddllist_link_new(self, self->last, NULL, value) == NULL)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_clear(TypedDLListObject* self)
+{
+    typeddllist_free_nodes(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_extendleft(TypedDLListObject* self, PyObject* arg)
+{
+    if (!typeddllist_extend_internal(self, arg, 1))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_extendright(TypedDLListObject* self, PyObject* arg)
+{
+    if (!typeddllist_extend_internal(self, arg, 0))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_popleft(TypedDLListObject* self)
+{
+    TypedDLListNode* del_node = self->first;
+
+    if (del_node == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    if (self->last_accessed_node != del_node && self->last_accessed_idx >= 0)
+        --self->last_accessed_idx;
+
+    return self->kind->box(typeddllist_unlink(self, del_node));
+}
+
+static PyObject* typeddllist_popright(TypedDLListObject* self)
+{
+    TypedDLListNode* del_node = self->last;
+
+    if (del_node == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    return self->kind->box(typeddllist_unlink(self, del_node));
+}
+
+/* Returns index of first node equal to value, -1 if value is not
+ * present in the list or -2 on error. */
+static Py_ssize_t typeddllist_find(TypedDLListObject* self,
+                                   PyObject* value,
+                                   TypedDLListNode** found)
+{
+    LListTypedValue native;
+    TypedDLListNode* node;
+    Py_ssize_t index = 0;
+
+    if (self->kind->unbox_exact(value, &native))
+    {
+        /* fast path, comparing unboxed values */
+        for (node = self->first; node != NULL; node = node->next, ++index)
+        {
+            if (self->kind->equal(node->value, native))
+            {
+                *found = node;
+                return index;
+            }
+        }
+
+        return -1;
+    }
+
+    /* slow path for objects which cannot be unboxed exactly */
+    for (node = self->first; node != NULL; node = node->next, ++index)
+    {
+        PyObject* item;
+        Py_ssize_t state = self->state;
+        int equal;
+
+        item = self->kind->box(node->value);
+        if (item == NULL)
+            return -2;
+
+        equal = PyObject_RichCompareBool(item, value, Py_EQ);
+        Py_DECREF(item);
+
+        if (equal < 0)
+            return -2;
+
+        if (state != self->state)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                "List changed during comparison");
+            return -2;
+        }
+
+        if (equal)
+        {
+            *found = node;
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+static PyObject* typeddllist_remove(TypedDLListObject* self, PyObject* arg)
+{
+    TypedDLListNode* node = NULL;
+    Py_ssize_t index;
+
+    index = typeddllist_find(self, arg, &node);
+    if (index == -2)
+        return NULL;
+
+    if (index == -1)
+    {
+        PyErr_SetString(PyExc_ValueError, "Value not found in list");
+        return NULL;
+    }
+
+    typeddllist_unlink(self, node);
+    typeddllist_invalidate_last_access_cache(self);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_rotate(TypedDLListObject* self, PyObject* nObject)
+{
+    Py_ssize_t n;
+    Py_ssize_t split_idx;
+    Py_ssize_t n_mod;
+    TypedDLListNode* new_first;
+    TypedDLListNode* new_last;
+
+    if (self->size <= 1)
+        Py_RETURN_NONE;
+
+    if (!Py23Int_Check(nObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return NULL;
+    }
+
+    n = Py23Int_AsSsize_t(nObject);
+    if (n == -1 && PyErr_Occurred())
+        return NULL;
+
+    n_mod = py_ssize_t_abs(n) % self->size;
+
+    if (n_mod == 0)
+        Py_RETURN_NONE; /* no-op */
+
+    if (n > 0)
+        split_idx = self->size - n_mod; /* rotate right */
+    else
+        split_idx = n_mod;  /* rotate left */
+
+    new_last = typeddllist_get_node_internal(self, split_idx - 1);
+    assert(new_last != NULL);
+    new_first = new_last->next;
+
+    self->first->prev = self->last;
+    self->last->next = self->first;
+
+    new_first->prev = NULL;
+    new_last->next = NULL;
+
+    self->first = new_first;
+    self->last = new_last;
+
+    if (self->last_accessed_idx >= 0)
+    {
+        self->last_accessed_idx =
+            (self->last_accessed_idx + self->size - split_idx) % self->size;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typeddllist_iter(PyObject* self)
+{
+    PyObject* args;
+    PyObject* result;
+
+    args = PyTuple_Pack(1, self);
+    if (args == NULL)
+        return NULL;
+
+    result = PyObject_CallObject((PyObject*)&TypedDLListIteratorType, args);
+
+    Py_DECREF(args);
+
+    return result;
+}
+
+static Py_ssize_t typeddllist_len(PyObject* self)
+{
+    return ((TypedDLListObject*)self)->size;
+}
+
+static PyObject* typeddllist_concat(PyObject* self, PyObject* other)
+{
+    TypedDLListObject* new_list;
+
+    new_list = (TypedDLListObject*)PyObject_CallObject(
+        (PyObject*)Py_TYPE(self), NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    if (!typeddllist_extend_internal(new_list, self, 0) ||
+        !typeddllist_extend_internal(new_list, other, 0))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* typeddllist_inplace_concat(PyObject* self, PyObject* other)
+{
+    if (!typeddllist_extend_internal((TypedDLListObject*)self, other, 0))
+        return NULL;
+
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject* typeddllist_repeat(PyObject* self, Py_ssize_t count)
+{
+    TypedDLListObject* new_list;
+    Py_ssize_t i;
+
+    new_list = (TypedDLListObject*)PyObject_CallObject(
+        (PyObject*)Py_TYPE(self), NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (!typeddllist_extend_internal(new_list, self, 0))
+        {
+            Py_DECREF(new_list);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* typeddllist_get_item(PyObject* self, Py_ssize_t index)
+{
+    TypedDLListObject* list = (TypedDLListObject*)self;
+    TypedDLListNode* node;
+
+    node = typeddllist_get_node_internal(list, index);
+    if (node == NULL)
+        return NULL;
+
+    /* update last accessed node */
+    list->last_accessed_node = node;
+    list->last_accessed_idx = index;
+
+    return list->kind->box(node->value);
+}
+
+static int typeddllist_set_item(PyObject* self,
+                                Py_ssize_t index,
+                                PyObject* val)
+{
+    TypedDLListObject* list = (TypedDLListObject*)self;
+    TypedDLListNode* node;
+    LListTypedValue value;
+
+    node = typeddllist_get_node_internal(list, index);
+    if (node == NULL)
+        return -1;
+
+    /* del list[index] */
+    if (val == NULL)
+    {
+        TypedDLListNode* prev = node->prev;
+
+        typeddllist_unlink(list, node);
+        typeddllist_invalidate_last_access_cache(list);
+
+        if (prev != NULL)
+        {
+            /* restore cache as the preceding node */
+            list->last_accessed_node = prev;
+            list->last_accessed_idx = index - 1;
+        }
+
+        return 0;
+    }
+
+    /* list[index] = item */
+    if (!list->kind->unbox(val, &value))
+        return -1;
+
+    node->value = value;
+
+    /* update last accessed node */
+    list->last_accessed_node = node;
+    list->last_accessed_idx = index;
+
+    return 0;
+}
+
+static int typeddllist_contains(PyObject* self, PyObject* value)
+{
+    TypedDLListNode* node = NULL;
+    Py_ssize_t index;
+
+    index = typeddllist_find((TypedDLListObject*)self, value, &node);
+    if (index == -2)
+        return -1;
+
+    return (index >= 0) ? 1 : 0;
+}
+
+/* Size of the list including its nodes. */
+static PyObject* typeddllist_sizeof(TypedDLListObject* self)
+{
+    return PyLong_FromSsize_t(Py_TYPE(self)->tp_basicsize +
+                              self->size * sizeof(TypedDLListNode));
+}
+
+/* Convenience function for copying lists. Values are immutable numbers,
+ * so deep copies differ from shallow ones only in copying the instance
+ * dictionary with copy.deepcopy(), which happens if memo is not NULL. */
+static PyObject* typeddllist_copy_internal(TypedDLListObject* self,
+                                          PyObject* memo)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject* new_list;
+    PyObject* args;
+
+    /* __init__ of subclasses is not called, like in copy.copy() */
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+
+    new_list = type->tp_new(type, args, NULL);
+    Py_DECREF(args);
+    if (new_list == NULL)
+        return NULL;
+
+    if (memo != NULL && !llist_memo_store(memo, (PyObject*)self, new_list))
+        goto copy_error;
+
+    if (!typeddllist_extend_internal((TypedDLListObject*)new_list,
+                                     (PyObject*)self, 0))
+        goto copy_error;
+
+    if (!llist_copy_state((PyObject*)self, new_list, memo))
+        goto copy_error;
+
+    return new_list;
+
+copy_error:
+    Py_DECREF(new_list);
+    return NULL;
+}
+
+static PyObject* typeddllist_copy(TypedDLListObject* self)
+{
+    return typeddllist_copy_internal(self, NULL);
+}
+
+static PyObject* typeddllist_deepcopy(TypedDLListObject* self, PyObject* memo)
+{
+    return typeddllist_copy_internal(self, memo);
+}
+
+/* Values are passed as an iterator, like for untyped lists, so pickle
+ * appends them to an empty list created by the type without copying. */
+static PyObject* typeddllist_reduce(TypedDLListObject* self)
+{
+    PyObject* state;
+    PyObject* items;
+
+    items = PyObject_GetIter((PyObject*)self);
+    if (items == NULL)
+        return NULL;
+
+    state = llist_get_state((PyObject*)self);
+    if (state == NULL)
+    {
+        Py_DECREF(items);
+        return NULL;
+    }
+
+    return Py_BuildValue("O()NN", (PyObject*)Py_TYPE(self), state, items);
+}
+
+/* wrappers holding the list lock, see lock.h */
+LLIST_LOCKED_ARG(typeddllist_appendleft_locked, typeddllist_appendleft)
+LLIST_LOCKED_ARG(typeddllist_appendright_locked, typeddllist_appendright)
+LLIST_LOCKED_NOARGS(typeddllist_clear_locked, typeddllist_clear)
+LLIST_LOCKED_NOARGS(typeddllist_copy_locked, typeddllist_copy)
+LLIST_LOCKED_ARG(typeddllist_deepcopy_locked, typeddllist_deepcopy)
+LLIST_LOCKED_ARG2(typeddllist_extendright_locked, typeddllist_extendright)
+LLIST_LOCKED_ARG2(typeddllist_extendleft_locked, typeddllist_extendleft)
+LLIST_LOCKED_NOARGS(typeddllist_popleft_locked, typeddllist_popleft)
+LLIST_LOCKED_NOARGS(typeddllist_popright_locked, typeddllist_popright)
+LLIST_LOCKED_ARG(typeddllist_remove_locked, typeddllist_remove)
+LLIST_LOCKED_ARG(typeddllist_rotate_locked, typeddllist_rotate)
+LLIST_LOCKED_NOARGS(typeddllist_reduce_locked, typeddllist_reduce)
+LLIST_LOCKED_NOARGS(typeddllist_sizeof_locked, typeddllist_sizeof)
+LLIST_LOCKED_LEN(typeddllist_len_locked, typeddllist_len)
+LLIST_LOCKED_CONCAT(typeddllist_concat_locked, typeddllist_concat)
+LLIST_LOCKED_INDEX(typeddllist_repeat_locked, typeddllist_repeat)
+LLIST_LOCKED_INDEX(typeddllist_get_item_locked, typeddllist_get_item)
+LLIST_LOCKED_ASS_ITEM(typeddllist_set_item_locked, typeddllist_set_item)
+LLIST_LOCKED_CONTAINS(typeddllist_contains_locked, typeddllist_contains)
+LLIST_LOCKED_CONCAT(typeddllist_inplace_concat_locked, typeddllist_inplace_concat)
+LLIST_LOCKED_UNARY(typeddllist_repr_locked, typeddllist_repr)
+LLIST_LOCKED_HASH(typeddllist_hash_locked, typeddllist_hash)
+LLIST_LOCKED_RICHCOMPARE(typeddllist_richcompare_locked, typeddllist_richcompare)
+LLIST_LOCKED_INIT(typeddllist_init_locked, typeddllist_init)
+
+static PyMethodDef TypedDLListMethods[] =
+{
+    { "appendleft", (PyCFunction)typeddllist_appendleft_locked, METH_O,
+      "Append element at the beginning of the list" },
+    { "append", (PyCFunction)typeddllist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "appendright", (PyCFunction)typeddllist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "clear", (PyCFunction)typeddllist_clear_locked, METH_NOARGS,
+      "Remove all elements from the list" },
+    { "extend", (PyCFunction)typeddllist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "extendleft", (PyCFunction)typeddllist_extendleft_locked, METH_O,
+      "Append elements from iterable at the left side of the list" },
+    { "extendright", (PyCFunction)typeddllist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "popleft", (PyCFunction)typeddllist_popleft_locked, METH_NOARGS,
+      "Remove first element from the list and return it" },
+    { "pop", (PyCFunction)typeddllist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "popright", (PyCFunction)typeddllist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "remove", (PyCFunction)typeddllist_remove_locked, METH_O,
+      "Remove first occurrence of value from the list" },
+    { "rotate", (PyCFunction)typeddllist_rotate_locked, METH_O,
+      "Rotate the list n steps to the right" },
+    { "__copy__", (PyCFunction)typeddllist_copy_locked, METH_NOARGS,
+      "Return shallow copy of the list" },
+    { "__deepcopy__", (PyCFunction)typeddllist_deepcopy_locked, METH_O,
+      "Return deep copy of the list" },
+    { "__reduce__", (PyCFunction)typeddllist_reduce_locked, METH_NOARGS,
+      "Return state information for pickling" },
+    { "__sizeof__", (PyCFunction)typeddllist_sizeof_locked, METH_NOARGS,
+      "Return size of the list and its nodes in memory, in bytes" },
+    { NULL },   /* sentinel */
+};
+
+static PyMemberDef TypedDLListMembers[] =
+{
+    { "size", T_PYSSIZET, offsetof(TypedDLListObject, size), READONLY,
+      "Number of elements in the list" },
+    { NULL },   /* sentinel */
+};
+
+static PySequenceMethods TypedDLListSequenceMethods =
+{
+    typeddllist_len_locked,         /* sq_length */
+    typeddllist_concat_locked,      /* sq_concat */
+    typeddllist_repeat_locked,      /* sq_repeat */
+    typeddllist_get_item_locked,    /* sq_item */
+    0,                              /* sq_slice */
+    typeddllist_set_item_locked,    /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    typeddllist_contains_locked,    /* sq_contains */
+    typeddllist_inplace_concat_locked, /* sq_inplace_concat */
+    0,                              /* sq_inplace_repeat */
+};
+
+static PyTypeObject DLListI64Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.dllist_i64",             /* tp_name */
+    sizeof(TypedDLListObject),      /* tp_basicsize */
+    0,                              /* tp_itemsize */
+    (destructor)typeddllist_dealloc,/* tp_dealloc */
+    0,                              /* tp_print */
+    0,                              /* tp_getattr */
+    0,                              /* tp_setattr */
+    0,                              /* tp_compare */
+    (reprfunc)typeddllist_repr_locked, /* tp_repr */
+    0,                              /* tp_as_number */
+    &TypedDLListSequenceMethods,    /* tp_as_sequence */
+    0,                              /* tp_as_mapping */
+    (hashfunc)typeddllist_hash_locked, /* tp_hash */
+    0,                              /* tp_call */
+    0,                              /* tp_str */
+    0,                              /* tp_getattro */
+    0,                              /* tp_setattro */
+    0,                              /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                    /* tp_flags */
+    "Doubly linked list of 64-bit integers",
+                                    /* tp_doc */
+    0,                              /* tp_traverse */
+    0,                              /* tp_clear */
+    (richcmpfunc)typeddllist_richcompare_locked,
+                                    /* tp_richcompare */
+    offsetof(TypedDLListObject, weakref_list),
+                                    /* tp_weaklistoffset */
+    typeddllist_iter,               /* tp_iter */
+    0,                              /* tp_iternext */
+    TypedDLListMethods,             /* tp_methods */
+    TypedDLListMembers,             /* tp_members */
+    0,                              /* tp_getset */
+    0,                              /* tp_base */
+    0,                              /* tp_dict */
+    0,                              /* tp_descr_get */
+    0,                              /* tp_descr_set */
+    0,                              /* tp_dictoffset */
+    (initproc)typeddllist_init_locked, /* tp_init */
+    0,                              /* tp_alloc */
+    typeddllist_new,                /* tp_new */
+};
+
+static PyTypeObject DLListF64Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.dllist_f64",             /* tp_name */
+    sizeof(TypedDLListObject),      /* tp_basicsize */
+    0,                              /* tp_itemsize */
+    (destructor)typeddllist_dealloc,/* tp_dealloc */
+    0,                              /* tp_print */
+    0,                              /* tp_getattr */
+    0,                              /* tp_setattr */
+    0,                              /* tp_compare */
+    (reprfunc)typeddllist_repr_locked, /* tp_repr */
+    0,                              /* tp_as_number */
+    &TypedDLListSequenceMethods,    /* tp_as_sequence */
+    0,                              /* tp_as_mapping */
+    (hashfunc)typeddllist_hash_locked, /* tp_hash */
+    0,                              /* tp_call */
+    0,                              /* tp_str */
+    0,                              /* tp_getattro */
+    0,                              /* tp_setattro */
+    0,                              /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                    /* tp_flags */
+    "Doubly linked list of 64-bit floats",
+                                    /* tp_doc */
+    0,                              /* tp_traverse */
+    0,                              /* tp_clear */
+    (richcmpfunc)typeddllist_richcompare_locked,
+                                    /* tp_richcompare */
+    offsetof(TypedDLListObject, weakref_list),
+                                    /* tp_weaklistoffset */
+    typeddllist_iter,               /* tp_iter */
+    0,                              /* tp_iternext */
+    TypedDLListMethods,             /* tp_methods */
+    TypedDLListMembers,             /* tp_members */
+    0,                              /* tp_getset */
+    0,                              /* tp_base */
+    0,                              /* tp_dict */
+    0,                              /* tp_descr_get */
+    0,                              /* tp_descr_set */
+    0,                              /* tp_dictoffset */
+    (initproc)typeddllist_init_locked, /* tp_init */
+    0,                              /* tp_alloc */
+    typeddllist_new,                /* tp_new */
+};
+
+
+/* TypedDLListIterator */
+
+typedef struct
+{
+    PyObject_HEAD
+    TypedDLListObject* list;
+    /* node returned by the last call to next(), NULL before first call */
+    TypedDLListNode* current_node;
+    Py_ssize_t state;
+    int exhausted;
+} TypedDLListIteratorObject;
+
+static int typeddllistiterator_traverse(TypedDLListIteratorObject* self,
+                                        visitproc visit,
+                                        void* arg)
+{
+    Py_VISIT(self->list);
+
+    return 0;
+}
+
+static int typeddllistiterator_clear_refs(TypedDLListIteratorObject* self)
+{
+    Py_CLEAR(self->list);
+
+    return 0;
+}
+
+static void typeddllistiterator_dealloc(TypedDLListIteratorObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    typeddllistiterator_clear_refs(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* typeddllistiterator_new(PyTypeObject* type,
+                                         PyObject* args,
+                                         PyObject* kwds)
+{
+    TypedDLListIteratorObject* self;
+    PyObject* owner_list = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__new__", 1, 1, &owner_list))
+        return NULL;
+
+    if (!typeddllist_check(owner_list))
+    {
+        PyErr_SetString(PyExc_TypeError, "Typed dllist argument expected");
+        return NULL;
+    }
+
+    self = (TypedDLListIteratorObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->list = (TypedDLListObject*)owner_list;
+    self->current_node = NULL;
+    self->state = self->list->state;
+    self->exhausted = 0;
+
+    Py_INCREF(self->list);
+
+    return (PyObject*)self;
+}
+
+static PyObject* typeddllistiterator_iternext(PyObject* self)
+{
+    TypedDLListIteratorObject* iter_self = (TypedDLListIteratorObject*)self;
+    TypedDLListNode* next_node;
+
+    if (iter_self->exhausted)
+        return NULL;
+
+    if (iter_self->state != iter_self->list->state)
+    {
+        iter_self->exhausted = 1;
+        PyErr_SetString(PyExc_RuntimeError,
+            "List changed size during iteration");
+        return NULL;
+    }
+
+    if (iter_self->current_node == NULL)
+        next_node = iter_self->list->first;
+    else
+        next_node = iter_self->current_node->next;
+
+    if (next_node == NULL)
+    {
+        iter_self->exhausted = 1;
+        return NULL;
+    }
+
+    iter_self->current_node = next_node;
+
+    return iter_self->list->kind->box(next_node->value);
+}
+
+LLIST_LOCKED_ITERNEXT(typeddllistiterator_iternext_locked,
+    typeddllistiterator_iternext, TypedDLListIteratorObject)
+
+static PyTypeObject TypedDLListIteratorType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.typeddllistiterator",            /* tp_name */
+    sizeof(TypedDLListIteratorObject),      /* tp_basicsize */
+    0,                                      /* tp_itemsize */
+    (destructor)typeddllistiterator_dealloc,/* tp_dealloc */
+    0,                                      /* tp_print */
+    0,                                      /* tp_getattr */
+    0,                                      /* tp_setattr */
+    0,                                      /* tp_compare */
+    0,                                      /* tp_repr */
+    0,                                      /* tp_as_number */
+    0,                                      /* tp_as_sequence */
+    0,                                      /* tp_as_mapping */
+    0,                                      /* tp_hash */
+    0,                                      /* tp_call */
+    0,                                      /* tp_str */
+    0,                                      /* tp_getattro */
+    0,                                      /* tp_setattro */
+    0,                                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+                                            /* tp_flags */
+    "Typed doubly linked list iterator",    /* tp_doc */
+    (traverseproc)typeddllistiterator_traverse,
+                                            /* tp_traverse */
+    (inquiry)typeddllistiterator_clear_refs,/* tp_clear */
+    0,                                      /* tp_richcompare */
+    0,                                      /* tp_weaklistoffset */
+    PyObject_SelfIter,                      /* tp_iter */
+    typeddllistiterator_iternext_locked,    /* tp_iternext */
+    0,                                      /* tp_methods */
+    0,                                      /* tp_members */
+    0,                                      /* tp_getset */
+    0,                                      /* tp_base */
+    0,                                      /* tp_dict */
+    0,                                      /* tp_descr_get */
+    0,                                      /* tp_descr_set */
+    0,                                      /* tp_dictoffset */
+    0,                                      /* tp_init */
+    0,                                      /* tp_alloc */
+    typeddllistiterator_new,                /* tp_new */
+};
+
+LLIST_INTERNAL int typeddllist_init_type(void)
+{
+    return
+        ((PyType_Ready(&DLListI64Type) == 0) &&
+         (PyType_Ready(&DLListF64Type) == 0) &&
+         (PyType_Ready(&TypedDLListIteratorType) == 0))
+        ? 1 : 0;
+}
+
+LLIST_INTERNAL void typeddllist_register(PyObject* module)
+{
+    Py_INCREF(&DLListI64Type);
+    Py_INCREF(&DLListF64Type);
+    Py_INCREF(&TypedDLListIteratorType);
+
+    PyModule_AddObject(module, "dllist_i64", (PyObject*)&DLListI64Type);
+    PyModule_AddObject(module, "dllist_f64", (PyObject*)&DLListF64Type);
+    PyModule_AddObject(
+        module, "typeddllistiterator", (PyObject*)&TypedDLListIteratorType);
+}
@@ -0,0 +1,13 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef TYPEDDLLIST_H
+#define TYPEDDLLIST_H
+
+#include "config.h"
+
+LLIST_INTERNAL int  typeddllist_init_type(void);
+LLIST_INTERNAL void typeddllist_register(PyObject* module);
+
+#endif /* TYPEDDLLIST_H */
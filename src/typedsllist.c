@@ -0,0 +1,1194 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+#include <structmember.h>
+#include <string.h>
+
+#include "config.h"
+#include "lock.h"
+#include "py23macros.h"
+#include "typedvalue.h"
+#include "utils.h"
+
+#ifndef PyVarObject_HEAD_INIT
+    #define PyVarObject_HEAD_INIT(type, size) \
+        PyObject_HEAD_INIT(type) size,
+#endif
+
+
+static PyTypeObject SLListI64Type;
+static PyTypeObject SLListF64Type;
+static PyTypeObject TypedSLListIteratorType;
+
+
+/* TypedSLListNode */
+
+/* Nodes of typed lists are plain C structures holding unboxed values.
+ * Python objects are created only when values are accessed. */
+typedef struct TypedSLListNode
+{
+    struct TypedSLListNode* next;
+    LListTypedValue value;
+} TypedSLListNode;
+
+
+/* TypedSLList */
+
+typedef struct
+{
+    PyObject_HEAD
+    const LListValueKind* kind;
+    TypedSLListNode* first;
+    TypedSLListNode* last;
+    Py_ssize_t size;
+    /* incremented whenever nodes are released, invalidates iterators */
+    Py_ssize_t state;
+    PyObject* weakref_list;
+} TypedSLListObject;
+
+static int typedsllist_check(PyObject* obj)
+{
+    return PyObject_TypeCheck(obj, &SLListI64Type) ||
+        PyObject_TypeCheck(obj, &SLListF64Type);
+}
+
+static const LListValueKind* typedsllist_kind_of(PyTypeObject* type)
+{
+    if (PyType_IsSubtype(type, &SLListF64Type))
+        return &llist_f64_kind;
+    return &llist_i64_kind;
+}
+
+static TypedSLListNode* typedsllist_get_node_internal(TypedSLListObject* self,
+                                                      Py_ssize_t pos)
+{
+    TypedSLListNode* node;
+    Py_ssize_t counter;
+
+    if (pos < 0 || pos >= self->size)
+    {
+        PyErr_SetString(PyExc_IndexError, "Index out of range");
+        return NULL;
+    }
+
+    /* last node is accessible directly */
+    if (pos == self->size - 1)
+        return self->last;
+
+    node = self->first;
+    for (counter = 0; counter < pos; ++counter)
+        node = node->next;
+
+    return node;
+}
+
+/* Convenience function for creating list nodes.
+ * Links the new node after prev (or at the beginning if prev is NULL). */
+static TypedSLListNode* typedsllist_link_new(TypedSLListObject* self,
+                                             TypedSLListNode* prev,
+                                             LListTypedValue value)
+{
+    TypedSLListNode* node;
+
+    node = (TypedSLListNode*)PyMem_Malloc(sizeof(TypedSLListNode));
+    if (node == NULL)
+    {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    node->value = value;
+
+    if (prev != NULL)
+    {
+        node->next = prev->next;
+        prev->next = node;
+    }
+    else
+    {
+        node->next = self->first;
+        self->first = node;
+    }
+
+    if (node->next == NULL)
+        self->last = node;
+
+    ++self->size;
+
+    return node;
+}
+
+/* Convenience function for deleting list nodes.
+ * prev must point to the node preceding the deleted one
+ * (or NULL if the first node is deleted). */
+static LListTypedValue typedsllist_unlink(TypedSLListObject* self,
+                                          TypedSLListNode* prev,
+                                          TypedSLListNode* node)
+{
+    LListTypedValue value = node->value;
+
+    assert((prev == NULL && self->first == node) ||
+           (prev != NULL && prev->next == node));
+
+    if (prev != NULL)
+        prev->next = node->next;
+    else
+        self->first = node->next;
+
+    if (self->last == node)
+        self->last = prev;
+
+    --self->size;
+    ++self->state;
+
+    PyMem_Free(node);
+
+    return value;
+}
+
+static void typedsllist_free_nodes(TypedSLListObject* self)
+{
+    TypedSLListNode* node = self->first;
+
+    while (node != NULL)
+    {
+        TypedSLListNode* next_node = node->next;
+        PyMem_Free(node);
+        node = next_node;
+    }
+
+    self->first = NULL;
+    self->last = NULL;
+    self->size = 0;
+    ++self->state;
+}
+
+/* Convenience function for extending the list with elements
+ * from an iterable. Elements are added at the right side if
+ * left is 0, or at the left side otherwise. */
+static int typedsllist_extend_internal(TypedSLListObject* self,
+                                       PyObject* iterable,
+                                       int left)
+{
+    PyObject* iterator;
+    PyObject* item;
+
+    if (typedsllist_check(iterable) &&
+        ((TypedSLListObject*)iterable)->kind == self->kind)
+    {
+        /* Special path for extending with a list of the same kind.
+         * Values are copied without boxing. Number of copied nodes is
+         * fixed in advance to terminate loop if self == iterable. */
+        TypedSLListObject* other = (TypedSLListObject*)iterable;
+        TypedSLListNode* iter_node = other->first;
+        Py_ssize_t count = other->size;
+        Py_ssize_t i;
+
+        for (i = 0; i < count; ++i)
+        {
+            if (typedsllist_link_new(self, left ? NULL : self->last,
+                                     iter_node->value) == NULL)
+                return 0;
+
+            iter_node = iter_node->next;
+        }
+
+        return 1;
+    }
+
+    iterator = PyObject_GetIter(iterable);
+    if (iterator == NULL)
+        return 0;
+
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        LListTypedValue value;
+        TypedSLListNode* new_node = NULL;
+
+        if (self->kind->unbox(item, &value))
+            new_node = typedsllist_link_new(
+                self, left ? NULL : self->last, value);
+
+        Py_DECREF(item);
+
+        if (new_node == NULL)
+        {
+            Py_DECREF(iterator);
+            return 0;
+        }
+    }
+
+    Py_DECREF(iterator);
+
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+static void typedsllist_dealloc(TypedSLListObject* self)
+{
+    PyObject* obj_self = (PyObject*)self;
+
+    if (self->weakref_list != NULL)
+        PyObject_ClearWeakRefs(obj_self);
+
+    typedsllist_free_nodes(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* typedsllist_new(PyTypeObject* type,
+                                 PyObject* args,
+                                 PyObject* kwds)
+{
+    TypedSLListObject* self;
+
+    self = (TypedSLListObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->kind = typedsllist_kind_of(type);
+    self->first = NULL;
+    self->last = NULL;
+    self->size = 0;
+    self->state = 0;
+    self->weakref_list = NULL;
+
+    return (PyObject*)self;
+}
+
+static int typedsllist_init(TypedSLListObject* self,
+                            PyObject* args,
+                            PyObject* kwds)
+{
+    PyObject* iterable = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &iterable))
+        return -1;
+
+    if (iterable == NULL)
+        return 0;
+
+    return typedsllist_extend_internal(self, iterable, 0) ? 0 : -1;
+}
+
+static PyObject* typedsllist_repr(TypedSLListObject* self)
+{
+    PyObject* str = NULL;
+    PyObject* comma_str = NULL;
+    PyObject* tmp_str;
+    TypedSLListNode* node;
+    const char* type_name = Py_TYPE(self)->tp_name;
+
+    /* strip module name */
+    if (strrchr(type_name, '.') != NULL)
+        type_name = strrchr(type_name, '.') + 1;
+
+    str = Py23String_FromString(type_name);
+    if (str == NULL)
+        goto str_alloc_error;
+
+    if (self->first == NULL)
+    {
+        tmp_str = Py23String_FromString("()");
+        if (tmp_str == NULL)
+            goto str_alloc_error;
+        Py23String_ConcatAndDel(&str, tmp_str);
+        return str;
+    }
+
+    tmp_str = Py23String_FromString("([");
+    if (tmp_str == NULL)
+        goto str_alloc_error;
+    Py23String_ConcatAndDel(&str, tmp_str);
+
+    comma_str = Py23String_FromString(", ");
+    if (comma_str == NULL)
+        goto str_alloc_error;
+
+    for (node = self->first; node != NULL; node = node->next)
+    {
+        PyObject* value;
+
+        if (node != self->first)
+            Py23String_Concat(&str, comma_str);
+
+        value = self->kind->box(node->value);
+        if (value == NULL)
+            goto str_alloc_error;
+
+        tmp_str = PyObject_Repr(value);
+        Py_DECREF(value);
+        if (tmp_str == NULL)
+            goto str_alloc_error;
+        Py23String_ConcatAndDel(&str, tmp_str);
+    }
+
+    Py_DECREF(comma_str);
+    comma_str = NULL;
+
+    tmp_str = Py23String_FromString("])");
+    if (tmp_str == NULL)
+        goto str_alloc_error;
+    Py23String_ConcatAndDel(&str, tmp_str);
+
+    return str;
+
+str_alloc_error:
+    Py_XDECREF(str);
+    Py_XDECREF(comma_str);
+    PyErr_SetString(PyExc_RuntimeError, "Failed to create string");
+
+    return NULL;
+}
+
+static long typedsllist_hash(TypedSLListObject* self)
+{
+    long hash = 0;
+    TypedSLListNode* node;
+
+    for (node = self->first; node != NULL; node = node->next)
+    {
+        long value_hash = self->kind->hash(node->value);
+
+        if (value_hash == -1)
+            return -1;
+
+        hash = hash_combine(hash, value_hash);
+    }
+
+    /* -1 is reserved for signalling errors */
+    return (hash != -1) ? hash : -2;
+}
+
+static PyObject* typedsllist_richcompare(TypedSLListObject* self,
+                                         PyObject* other_obj,
+                                         int op)
+{
+    TypedSLListObject* other = (TypedSLListObject*)other_obj;
+    TypedSLListNode* self_node;
+    TypedSLListNode* other_node;
+    int satisfied;
+
+    if (!typedsllist_check(other_obj) || other->kind != self->kind)
+    {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    if (self->size != other->size)
+    {
+        if (op == Py_EQ)
+            Py_RETURN_FALSE;
+        else if (op == Py_NE)
+            Py_RETURN_TRUE;
+    }
+
+    /* Scan through sequences' items as long as they are equal. */
+    self_node = self->first;
+    other_node = other->first;
+
+    while (self_node != NULL && other_node != NULL &&
+           self->kind->equal(self_node->value, other_node->value))
+    {
+        self_node = self_node->next;
+        other_node = other_node->next;
+    }
+
+    if (self_node != NULL && other_node != NULL)
+    {
+        /* Both nodes are valid, but not equal */
+        satisfied = self->kind->compare(
+            self_node->value, other_node->value, op);
+    }
+    else
+    {
+        /* At least one of operands has been fully traversed. */
+        switch (op)
+        {
+        case Py_EQ:
+            satisfied = (self_node == other_node);
+            break;
+        case Py_NE:
+            satisfied = (self_node != other_node);
+            break;
+        case Py_LT:
+            satisfied = (other_node != NULL);
+            break;
+        case Py_GT:
+            satisfied = (self_node != NULL);
+            break;
+        case Py_LE:
+            satisfied = (self_node == NULL);
+            break;
+        case Py_GE:
+            satisfied = (other_node == NULL);
+            break;
+        default:
+            assert(0 && "Invalid rich compare operator");
+            PyErr_SetString(PyExc_ValueError, "Invalid rich compare operator");
+            return NULL;
+        }
+    }
+
+    if (satisfied)
+        Py_RETURN_TRUE;
+    else
+        Py_RETURN_FALSE;
+}
+
+static PyObject* typedsllist_appendleft(TypedSLListObject* self, PyObject* arg)
+{
+    LListTypedValue value;
+
+    if (!self->kind->unbox(arg, &value))
+        return NULL;
+
+    if (typedsllist_link_new(self, NULL, value) == NULL)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_appendright(TypedSLListObject* self, PyObject* arg)
+{
+    LListTypedValue value;
+
+    if (!self->kind->unbox(arg, &value))
+        return NULL;
+
+    if (typedsllist_link_new(self, self->last, value) == NULL)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_clear(TypedSLListObject* self)
+{
+    typedsllist_free_nodes(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_extendleft(TypedSLListObject* self, PyObject* arg)
+{
+    if (!typedsllist_extend_internal(self, arg, 1))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_extendright(TypedSLListObject* self, PyObject* arg)
+{
+    if (!typedsllist_extend_internal(self, arg, 0))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_popleft(TypedSLListObject* self)
+{
+    if (self->first == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    return self->kind->box(typedsllist_unlink(self, NULL, self->first));
+}
+
+static PyObject* typedsllist_popright(TypedSLListObject* self)
+{
+    TypedSLListNode* prev = NULL;
+
+    if (self->last == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    if (self->first != self->last)
+    {
+        prev = self->first;
+        while (prev->next != self->last)
+            prev = prev->next;
+    }
+
+    return self->kind->box(typedsllist_unlink(self, prev, self->last));
+}
+
+/* Returns 1 if a node equal to value was found, 0 if value is not
+ * present in the list or -1 on error. On success found_prev is set to
+ * the node preceding the matching one (NULL for the first node). */
+static int typedsllist_find(TypedSLListObject* self,
+                            PyObject* value,
+                            TypedSLListNode** found_prev)
+{
+    LListTypedValue native;
+    TypedSLListNode* prev = NULL;
+    TypedSLListNode* node;
+
+    if (self->kind->unbox_exact(value, &native))
+    {
+        /* fast path, comparing unboxed values */
+        for (node = self->first; node != NULL; prev = node, node = node->next)
+        {
+            if (self->kind->equal(node->value, native))
+            {
+                *found_prev = prev;
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    /* slow path for objects which cannot be unboxed exactly */
+    for (node = self->first; node != NULL; prev = node, node = node->next)
+    {
+        PyObject* item;
+        Py_ssize_t state = self->state;
+        int equal;
+
+        item = self->kind->box(node->value);
+        if (item == NULL)
+            return -1;
+
+        equal = PyObject_RichCompareBool(item, value, Py_EQ);
+        Py_DECREF(item);
+
+        if (equal < 0)
+            return -1;
+
+        if (state != self->state)
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                "List changed during comparison");
+            return -1;
+        }
+
+        if (equal)
+        {
+            *found_prev = prev;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static PyObject* typedsllist_remove(TypedSLListObject* self, PyObject* arg)
+{
+    TypedSLListNode* prev = NULL;
+    TypedSLListNode* node;
+    int found;
+
+    found = typedsllist_find(self, arg, &prev);
+    if (found < 0)
+        return NULL;
+
+    if (!found)
+    {
+        PyErr_SetString(PyExc_ValueError, "Value not found in list");
+        return NULL;
+    }
+
+    node = (prev != NULL) ? prev->next : self->first;
+    typedsllist_unlink(self, prev, node);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_rotate(TypedSLListObject* self, PyObject* nObject)
+{
+    Py_ssize_t n;
+    Py_ssize_t split_idx;
+    Py_ssize_t n_mod;
+    TypedSLListNode* new_first;
+    TypedSLListNode* new_last;
+
+    if (self->size <= 1)
+        Py_RETURN_NONE;
+
+    if (!Py23Int_Check(nObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return NULL;
+    }
+
+    n = Py23Int_AsSsize_t(nObject);
+    if (n == -1 && PyErr_Occurred())
+        return NULL;
+
+    n_mod = (n >= 0 ? n : -n) % self->size;
+
+    if (n_mod == 0)
+        Py_RETURN_NONE; /* no-op */
+
+    if (n > 0)
+        split_idx = self->size - n_mod; /* rotate right */
+    else
+        split_idx = n_mod;  /* rotate left */
+
+    new_last = typedsllist_get_node_internal(self, split_idx - 1);
+    assert(new_last != NULL);
+    new_first = new_last->next;
+
+    self->last->next = self->first;
+    new_last->next = NULL;
+
+    self->first = new_first;
+    self->last = new_last;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* typedsllist_iter(PyObject* self)
+{
+    PyObject* args;
+    PyObject* result;
+
+    args = PyTuple_Pack(1, self);
+    if (args == NULL)
+        return NULL;
+
+    result = PyObject_CallObject((PyObject*)&TypedSLListIteratorType, args);
+
+    Py_DECREF(args);
+
+    return result;
+}
+
+static Py_ssize_t typedsllist_len(PyObject* self)
+{
+    return ((TypedSLListObject*)self)->size;
+}
+
+static PyObject* typedsllist_concat(PyObject* self, PyObject* other)
+{
+    TypedSLListObject* new_list;
+
+    new_list = (TypedSLListObject*)PyObject_CallObject(
+        (PyObject*)Py_TYPE(self), NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    if (!typedsllist_extend_internal(new_list, self, 0) ||
+        !typedsllist_extend_internal(new_list, other, 0))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* typedsllist_inplace_concat(PyObject* self, PyObject* other)
+{
+    if (!typedsllist_extend_internal((TypedSLListObject*)self, other, 0))
+        return NULL;
+
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject* typedsllist_repeat(PyObject* self, Py_ssize_t count)
+{
+    TypedSLListObject* new_list;
+    Py_ssize_t i;
+
+    new_list = (TypedSLListObject*)PyObject_CallObject(
+        (PyObject*)Py_TYPE(self), NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (!typedsllist_extend_internal(new_list, self, 0))
+        {
+            Py_DECREF(new_list);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* typedsllist_get_item(PyObject* self, Py_ssize_t index)
+{
+    TypedSLListObject* list = (TypedSLListObject*)self;
+    TypedSLListNode* node;
+
+    node = typedsllist_get_node_internal(list, index);
+    if (node == NULL)
+        return NULL;
+
+    return list->kind->box(node->value);
+}
+
+static int typedsllist_set_item(PyObject* self,
+                                Py_ssize_t index,
+                                PyObject* val)
+{
+    TypedSLListObject* list = (TypedSLListObject*)self;
+    TypedSLListNode* node;
+    LListTypedValue value;
+
+    /* del list[index] */
+    if (val == NULL)
+    {
+        TypedSLListNode* prev = NULL;
+
+        if (index < 0 || index >= list->size)
+        {
+            PyErr_SetString(PyExc_IndexError, "Index out of range");
+            return -1;
+        }
+
+        if (index > 0)
+            prev = typedsllist_get_node_internal(list, index - 1);
+
+        node = (prev != NULL) ? prev->next : list->first;
+        typedsllist_unlink(list, prev, node);
+
+        return 0;
+    }
+
+    node = typedsllist_get_node_internal(list, index);
+    if (node == NULL)
+        return -1;
+
+    /* list[index] = item */
+    if (!list->kind->unbox(val, &value))
+        return -1;
+
+    node->value = value;
+
+    return 0;
+}
+
+static int typedsllist_contains(PyObject* self, PyObject* value)
+{
+    TypedSLListNode* prev = NULL;
+
+    return typedsllist_find((TypedSLListObject*)self, value, &prev);
+}
+
+/* Size of the list including its nodes. */
+static PyObject* typedsllist_sizeof(TypedSLListObject* self)
+{
+    return PyLong_FromSsize_t(Py_TYPE(self)->tp_basicsize +
+                              self->size * sizeof(TypedSLListNode));
+}
+
+/* Convenience function for copying lists. Values are immutable numbers,
+ * so deep copies differ from shallow ones only in copying the instance
+ * dictionary with copy.deepcopy(), which happens if memo is not NULL. */
+static PyObject* typedsllist_copy_internal(TypedSLListObject* self,
+                                          PyObject* memo)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject* new_list;
+    PyObject* args;
+
+    /* __init__ of subclasses is not called, like in copy.copy() */
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+
+    new_list = type->tp_new(type, args, NULL);
+    Py_DECREF(args);
+    if (new_list == NULL)
+        return NULL;
+
+    if (memo != NULL && !llist_memo_store(memo, (PyObject*)self, new_list))
+        goto copy_error;
+
+    if (!typedsllist_extend_internal((TypedSLListObject*)new_list,
+                                     (PyObject*)self, 0))
+        goto copy_error;
+
+    if (!llist_copy_state((PyObject*)self, new_list, memo))
+        goto copy_error;
+
+    return new_list;
+
+copy_error:
+    Py_DECREF(new_list);
+    return NULL;
+}
+
+static PyObject* typedsllist_copy(TypedSLListObject* self)
+{
+    return typedsllist_copy_internal(self, NULL);
+}
+
+static PyObject* typedsllist_deepcopy(TypedSLListObject* self, PyObject* memo)
+{
+    return typedsllist_copy_internal(self, memo);
+}
+
+/* Values are passed as an iterator, like for untyped lists, so pickle
+ * appends them to an empty list created by the type without copying. */
+static PyObject* typedsllist_reduce(TypedSLListObject* self)
+{
+    PyObject* state;
+    PyObject* items;
+
+    items = PyObject_GetIter((PyObject*)self);
+    if (items == NULL)
+        return NULL;
+
+    state = llist_get_state((PyObject*)self);
+    if (state == NULL)
+    {
+        Py_DECREF(items);
+        return NULL;
+    }
+
+    return Py_BuildValue("O()NN", (PyObject*)Py_TYPE(self), state, items);
+}
+
+/* wrappers holding the list lock, see lock.h */
+LLIST_LOCKED_ARG(typedsllist_appendleft_locked, typedsllist_appendleft)
+LLIST_LOCKED_ARG(typedsllist_appendright_locked, typedsllist_appendright)
+LLIST_LOCKED_NOARGS(typedsllist_clear_locked, typedsllist_clear)
+LLIST_LOCKED_NOARGS(typedsllist_copy_locked, typedsllist_copy)
+LLIST_LOCKED_ARG(typedsllist_deepcopy_locked, typedsllist_deepcopy)
+LLIST_LOCKED_ARG2(typedsllist_extendright_locked, typedsllist_extendright)
+LLIST_LOCKED_ARG2(typedsllist_extendleft_locked, typedsllist_extendleft)
+LLIST_LOCKED_NOARGS(typedsllist_popleft_locked, typedsllist_popleft)
+LLIST_LOCKED_NOARGS(typedsllist_popright_locked, typedsllist_popright)
+LLIST_LOCKED_ARG(typedsllist_remove_locked, typedsllist_remove)
+LLIST_LOCKED_ARG(typedsllist_rotate_locked, typedsllist_rotate)
+LLIST_LOCKED_NOARGS(typedsllist_reduce_locked, typedsllist_reduce)
+LLIST_LOCKED_NOARGS(typedsllist_sizeof_locked, typedsllist_sizeof)
+LLIST_LOCKED_LEN(typedsllist_len_locked, typedsllist_len)
+LLIST_LOCKED_CONCAT(typedsllist_concat_locked, typedsllist_concat)
+LLIST_LOCKED_INDEX(typedsllist_repeat_locked, typedsllist_repeat)
+LLIST_LOCKED_INDEX(typedsllist_get_item_locked, typedsllist_get_item)
+LLIST_LOCKED_ASS_ITEM(typedsllist_set_item_locked, typedsllist_set_item)
+LLIST_LOCKED_CONTAINS(typedsllist_contains_locked, typedsllist_contains)
+LLIST_LOCKED_CONCAT(typedsllist_inplace_concat_locked, typedsllist_inplace_concat)
+LLIST_LOCKED_UNARY(typedsllist_repr_locked, typedsllist_repr)
+LLIST_LOCKED_HASH(typedsllist_hash_locked, typedsllist_hash)
+LLIST_LOCKED_RICHCOMPARE(typedsllist_richcompare_locked, typedsllist_richcompare)
+LLIST_LOCKED_INIT(typedsllist_init_locked, typedsllist_init)
+
+static PyMethodDef TypedSLListMethods[] =
+{
+    { "appendleft", (PyCFunction)typedsllist_appendleft_locked, METH_O,
+      "Append element at the beginning of the list" },
+    { "append", (PyCFunction)typedsllist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "appendright", (PyCFunction)typedsllist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "clear", (PyCFunction)typedsllist_clear_locked, METH_NOARGS,
+      "Remove all elements from the list" },
+    { "extend", (PyCFunction)typedsllist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "extendleft", (PyCFunction)typedsllist_extendleft_locked, METH_O,
+      "Append elements from iterable at the left side of the list" },
+    { "extendright", (PyCFunction)typedsllist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "popleft", (PyCFunction)typedsllist_popleft_locked, METH_NOARGS,
+      "Remove first element from the list and return it" },
+    { "pop", (PyCFunction)typedsllist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "popright", (PyCFunction)typedsllist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "remove", (PyCFunction)typedsllist_remove_locked, METH_O,
+      "Remove first occurrence of value from the list" },
+    { "rotate", (PyCFunction)typedsllist_rotate_locked, METH_O,
+      "Rotate the list n steps to the right" },
+    { "__copy__", (PyCFunction)typedsllist_copy_locked, METH_NOARGS,
+      "Return shallow copy of the list" },
+    { "__deepcopy__", (PyCFunction)typedsllist_deepcopy_locked, METH_O,
+      "Return deep copy of the list" },
+    { "__reduce__", (PyCFunction)typedsllist_reduce_locked, METH_NOARGS,
+      "Return state information for pickling" },
+    { "__sizeof__", (PyCFunction)typedsllist_sizeof_locked, METH_NOARGS,
+      "Return size of the list and its nodes in memory, in bytes" },
+    { NULL },   /* sentinel */
+};
+
+static PyMemberDef TypedSLListMembers[] =
+{
+    { "size", T_PYSSIZET, offsetof(TypedSLListObject, size), READONLY,
+      "Number of elements in the list" },
+    { NULL },   /* sentinel */
+};
+
+static PySequenceMethods TypedSLListSequenceMethods =
+{
+    typedsllist_len_locked,         /* sq_length */
+    typedsllist_concat_locked,      /* sq_concat */
+    typedsllist_repeat_locked,      /* sq_repeat */
+    typedsllist_get_item_locked,    /* sq_item */
+    0,                              /* sq_slice */
+    typedsllist_set_item_locked,    /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    typedsllist_contains_locked,    /* sq_contains */
+    typedsllist_inplace_concat_locked, /* sq_inplace_concat */
+    0,                              /* sq_inplace_repeat */
+};
+
+static PyTypeObject SLListI64Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.sllist_i64",             /* tp_name */
+    sizeof(TypedSLListObject),      /* tp_basicsize */
+    0,                              /* tp_itemsize */
+    (destructor)typedsllist_dealloc,/* tp_dealloc */
+    0,                              /* tp_print */
+    0,                              /* tp_getattr */
+    0,                              /* tp_setattr */
+    0,                              /* tp_compare */
+    (reprfunc)typedsllist_repr_locked, /* tp_repr */
+    0,                              /* tp_as_number */
+    &TypedSLListSequenceMethods,    /* tp_as_sequence */
+    0,                              /* tp_as_mapping */
+    (hashfunc)typedsllist_hash_locked, /* tp_hash */
+    0,                              /* tp_call */
+    0,                              /* tp_str */
+    0,                              /* tp_getattro */
+    0,                              /* tp_setattro */
+    0,                              /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                    /* tp_flags */
+    "Singly linked list of 64-bit integers",
+                                    /* tp_doc */
+    0,                              /* tp_traverse */
+    0,                              /* tp_clear */
+    (richcmpfunc)typedsllist_richcompare_locked,
+                                    /* tp_richcompare */
+    offsetof(TypedSLListObject, weakref_list),
+                                    /* tp_weaklistoffset */
+    typedsllist_iter,               /* tp_iter */
+    0,                              /* tp_iternext */
+    TypedSLListMethods,             /* tp_methods */
+    TypedSLListMembers,             /* tp_members */
+    0,                              /* tp_getset */
+    0,                              /* tp_base */
+    0,                              /* tp_dict */
+    0,                              /* tp_descr_get */
+    0,                              /* tp_descr_set */
+    0,                              /* tp_dictoffset */
+    (initproc)typedsllist_init_locked, /* tp_init */
+    0,                              /* tp_alloc */
+    typedsllist_new,                /* tp_new */
+};
+
+static PyTypeObject SLListF64Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.sllist_f64",             /* tp_name */
+    sizeof(TypedSLListObject),      /* tp_basicsize */
+    0,                              /* tp_itemsize */
+    (destructor)typedsllist_dealloc,/* tp_dealloc */
+    0,                              /* tp_print */
+    0,                              /* tp_getattr */
+    0,                              /* tp_setattr */
+    0,                              /* tp_compare */
+    (reprfunc)typedsllist_repr_locked, /* tp_repr */
+    0,                              /* tp_as_number */
+    &TypedSLListSequenceMethods,    /* tp_as_sequence */
+    0,                              /* tp_as_mapping */
+    (hashfunc)typedsllist_hash_locked, /* tp_hash */
+    0,                              /* tp_call */
+    0,                              /* tp_str */
+    0,                              /* tp_getattro */
+    0,                              /* tp_setattro */
+    0,                              /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                    /* tp_flags */
+    "Singly linked list of 64-bit floats",
+                                    /* tp_doc */
+    0,                              /* tp_traverse */
+    0,                              /* tp_clear */
+    (richcmpfunc)typedsllist_richcompare_locked,
+                                    /* tp_richcompare */
+    offsetof(TypedSLListObject, weakref_list),
+                                    /* tp_weaklistoffset */
+    typedsllist_iter,               /* tp_iter */
+    0,                              /* tp_iternext */
+    TypedSLListMethods,             /* tp_methods */
+    TypedSLListMembers,             /* tp_members */
+    0,                              /* tp_getset */
+    0,                              /* tp_base */
+    0,                              /* tp_dict */
+    0,                              /* tp_descr_get */
+    0,                              /* tp_descr_set */
+    0,                              /* tp_dictoffset */
+    (initproc)typedsllist_init_locked, /* tp_init */
+    0,                              /* tp_alloc */
+    typedsllist_new,                /* tp_new */
+};
+
+
+/* TypedSLListIterator */
+
+typedef struct
+{
+    PyObject_HEAD
+    TypedSLListObject* list;
+    /* node returned by the last call to next(), NULL before first call */
+    TypedSLListNode* current_node;
+    Py_ssize_t state;
+    int exhausted;
+} TypedSLListIteratorObject;
+
+static int typedsllistiterator_traverse(TypedSLListIteratorObject* self,
+                                        visitproc visit,
+                                        void* arg)
+{
+    Py_VISIT(self->list);
+
+    return 0;
+}
+
+static int typedsllistiterator_clear_refs(TypedSLListIteratorObject* self)
+{
+    Py_CLEAR(self->list);
+
+    return 0;
+}
+
+static void typedsllistiterator_dealloc(TypedSLListIteratorObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    typedsllistiterator_clear_refs(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* typedsllistiterator_new(PyTypeObject* type,
+                                         PyObject* args,
+                                         PyObject* kwds)
+{
+    TypedSLListIteratorObject* self;
+    PyObject* owner_list = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__new__", 1, 1, &owner_list))
+        return NULL;
+
+    if (!typedsllist_check(owner_list))
+    {
+        PyErr_SetString(PyExc_TypeError, "Typed sllist argument expected");
+        return NULL;
+    }
+
+    self = (TypedSLListIteratorObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->list = (TypedSLListObject*)owner_list;
+    self->current_node = NULL;
+    self->state = self->list->state;
+    self->exhausted = 0;
+
+    Py_INCREF(self->list);
+
+    return (PyObject*)self;
+}
+
+static PyObject* typedsllistiterator_iternext(PyObject* self)
+{
+    TypedSLListIteratorObject* iter_self = (TypedSLListIteratorObject*)self;
+    TypedSLListNode* next_node;
+
+    if (iter_self->exhausted)
+        return NULL;
+
+    if (iter_self->state != iter_self->list->state)
+    {
+        iter_self->exhausted = 1;
+        PyErr_SetString(PyExc_RuntimeError,
+            "List changed size during iteration");
+        return NULL;
+    }
+
+    if (iter_self->current_node == NULL)
+        next_node = iter_self->list->first;
+    else
+        next_node = iter_self->current_node->next;
+
+    if (next_node == NULL)
+    {
+        iter_self->exhausted = 1;
+        return NULL;
+    }
+
+    iter_self->current_node = next_node;
+
+    return iter_self->list->kind->box(next_node->value);
+}
+
+LLIST_LOCKED_ITERNEXT(typedsllistiterator_iternext_locked,
+    typedsllistiterator_iternext, TypedSLListIteratorObject)
+
+static PyTypeObject TypedSLListIteratorType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.typedsllistiterator",            /* tp_name */
+    sizeof(TypedSLListIteratorObject),      /* tp_basicsize */
+    0,                                      /* tp_itemsize */
+    (destructor)typedsllistiterator_dealloc,/* tp_dealloc */
+    0,                                      /* tp_print */
+    0,                                      /* tp_getattr */
+    0,                                      /* tp_setattr */
+    0,                                      /* tp_compare */
+    0,                                      /* tp_repr */
+    0,                                      /* tp_as_number */
+    0,                                      /* tp_as_sequence */
+    0,                                      /* tp_as_mapping */
+    0,                                      /* tp_hash */
+    0,                                      /* tp_call */
+    0,                                      /* tp_str */
+    0,                                      /* tp_getattro */
+    0,                                      /* tp_setattro */
+    0,                                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+                                            /* tp_flags */
+    "Typed singly linked list iterator",    /* tp_doc */
+    (traverseproc)typedsllistiterator_traverse,
+                                            /* tp_traverse */
+    (inquiry)typedsllistiterator_clear_refs,/* tp_clear */
+    0,                                      /* tp_richcompare */
+    0,                                      /* tp_weaklistoffset */
+    PyObject_SelfIter,                      /* tp_iter */
+    typedsllistiterator_iternext_locked,    /* tp_iternext */
+    0,                                      /* tp_methods */
+    0,                                      /* tp_members */
+    0,                                      /* tp_getset */
+    0,                                      /* tp_base */
+    0,                                      /* tp_dict */
+    0,                                      /* tp_descr_get */
+    0,                                      /* tp_descr_set */
+    0,                                      /* tp_dictoffset */
+    0,                                      /* tp_init */
+    0,                                      /* tp_alloc */
+    typedsllistiterator_new,                /* tp_new */
+};
+
+LLIST_INTERNAL int typedsllist_init_type(void)
+{
+    return
+        ((PyType_Ready(&SLListI64Type) == 0) &&
+         (PyType_Ready(&SLListF64Type) == 0) &&
+         (PyType_Ready(&TypedSLListIteratorType) == 0))
+        ? 1 : 0;
+}
+
+LLIST_INTERNAL void typedsllist_register(PyObject* module)
+{
+    Py_INCREF(&SLListI64Type);
+    Py_INCREF(&SLListF64Type);
+    Py_INCREF(&TypedSLListIteratorType);
+
+    PyModule_AddObject(module, "sllist_i64", (PyObject*)&SLListI64Type);
+    PyModule_AddObject(module, "sllist_f64", (PyObject*)&SLListF64Type);
+    PyModule_AddObject(
+        module, "typedsllistiterator", (PyObject*)&TypedSLListIteratorType);
+}
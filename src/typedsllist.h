@@ -0,0 +1,13 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef TYPEDSLLIST_H
+#define TYPEDSLLIST_H
+
+#include "config.h"
+
+LLIST_INTERNAL int  typedsllist_init_type(void);
+LLIST_INTERNAL void typedsllist_register(PyObject* module);
+
+#endif /* TYPEDSLLIST_H */
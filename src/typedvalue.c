@@ -0,0 +1,225 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+
+#include "config.h"
+#include "py23macros.h"
+#include "typedvalue.h"
+
+/* Largest magnitude of an integer which can be represented
+ * exactly by a double. */
+#define LLIST_MAX_EXACT_DOUBLE_INT (1LL << 53)
+
+/* Integers of smaller magnitude hash to themselves (except -1) on all
+ * supported Python versions and platforms. */
+#define LLIST_IDENTITY_HASH_LIMIT 0x7fffffffLL
+
+/* Hash value like Python hashes its boxed object, so that typed lists
+ * hash like dllist and sllist objects holding equal values.
+ * Returns -1 on failure. */
+static long hash_boxed(PyObject* (*box)(LListTypedValue), LListTypedValue value)
+{
+    PyObject* obj;
+    long hash;
+
+    obj = box(value);
+    if (obj == NULL)
+        return -1;
+
+    hash = (long)PyObject_Hash(obj);
+    Py_DECREF(obj);
+
+    return hash;
+}
+
+/* Fast path of hash_boxed() for small integers. */
+static long hash_small_int(long long value)
+{
+    return (value != -1) ? (long)value : -2;
+}
+
+static int compare_result(int cmp, int op)
+{
+    switch (op)
+    {
+    case Py_LT: return cmp < 0;
+    case Py_LE: return cmp <= 0;
+    case Py_EQ: return cmp == 0;
+    case Py_NE: return cmp != 0;
+    case Py_GT: return cmp > 0;
+    case Py_GE: return cmp >= 0;
+    default:
+        assert(0 && "Invalid rich compare operator");
+        return 0;
+    }
+}
+
+/* int64 values */
+
+static int i64_unbox(PyObject* obj, LListTypedValue* result)
+{
+    PyObject* index;
+    long long value;
+
+    index = PyNumber_Index(obj);
+    if (index == NULL)
+        return 0;
+
+    value = PyLong_AsLongLong(index);
+    Py_DECREF(index);
+
+    if (value == -1 && PyErr_Occurred())
+        return 0;
+
+    result->i64 = value;
+    return 1;
+}
+
+static PyObject* i64_box(LListTypedValue value)
+{
+#if PY_MAJOR_VERSION < 3
+    /* keep small values as plain ints, like the rest of Python 2 */
+    if (value.i64 >= LONG_MIN && value.i64 <= LONG_MAX)
+        return PyInt_FromLong((long)value.i64);
+#endif
+    return PyLong_FromLongLong(value.i64);
+}
+
+static int i64_unbox_exact(PyObject* obj, LListTypedValue* result)
+{
+    long long value;
+    int overflow = 0;
+
+    if (!Py23Int_Check(obj))
+        return 0;
+
+    value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+    if (value == -1 && PyErr_Occurred())
+    {
+        PyErr_Clear();
+        return 0;
+    }
+
+    if (overflow != 0)
+        return 0;
+
+    result->i64 = value;
+    return 1;
+}
+
+static int i64_equal(LListTypedValue a, LListTypedValue b)
+{
+    return a.i64 == b.i64;
+}
+
+static int i64_compare(LListTypedValue a, LListTypedValue b, int op)
+{
+    return compare_result((a.i64 > b.i64) - (a.i64 < b.i64), op);
+}
+
+static long i64_hash(LListTypedValue value)
+{
+    if (value.i64 < LLIST_IDENTITY_HASH_LIMIT &&
+        value.i64 > -LLIST_IDENTITY_HASH_LIMIT)
+        return hash_small_int(value.i64);
+
+    return hash_boxed(i64_box, value);
+}
+
+LLIST_INTERNAL const LListValueKind llist_i64_kind =
+{
+    "i64",
+    i64_unbox,
+    i64_box,
+    i64_unbox_exact,
+    i64_equal,
+    i64_compare,
+    i64_hash,
+};
+
+/* float64 values */
+
+static int f64_unbox(PyObject* obj, LListTypedValue* result)
+{
+    double value = PyFloat_AsDouble(obj);
+
+    if (value == -1.0 && PyErr_Occurred())
+        return 0;
+
+    result->f64 = value;
+    return 1;
+}
+
+static PyObject* f64_box(LListTypedValue value)
+{
+    return PyFloat_FromDouble(value.f64);
+}
+
+static int f64_unbox_exact(PyObject* obj, LListTypedValue* result)
+{
+    LListTypedValue int_value;
+
+    if (PyFloat_Check(obj))
+    {
+        result->f64 = PyFloat_AS_DOUBLE(obj);
+        return 1;
+    }
+
+    /* integers are compared natively only if the conversion is exact */
+    if (!i64_unbox_exact(obj, &int_value))
+        return 0;
+
+    if (int_value.i64 > LLIST_MAX_EXACT_DOUBLE_INT ||
+        int_value.i64 < -LLIST_MAX_EXACT_DOUBLE_INT)
+        return 0;
+
+    result->f64 = (double)int_value.i64;
+    return 1;
+}
+
+static int f64_equal(LListTypedValue a, LListTypedValue b)
+{
+    return a.f64 == b.f64;
+}
+
+static int f64_compare(LListTypedValue a, LListTypedValue b, int op)
+{
+    switch (op)
+    {
+    case Py_LT: return a.f64 < b.f64;
+    case Py_LE: return a.f64 <= b.f64;
+    case Py_EQ: return a.f64 == b.f64;
+    case Py_NE: return a.f64 != b.f64;
+    case Py_GT: return a.f64 > b.f64;
+    case Py_GE: return a.f64 >= b.f64;
+    default:
+        assert(0 && "Invalid rich compare operator");
+        return 0;
+    }
+}
+
+static long f64_hash(LListTypedValue value)
+{
+    double d = value.f64;
+
+    /* integral floats hash like equal integers (also 0.0 and -0.0) */
+    if (d < (double)LLIST_IDENTITY_HASH_LIMIT &&
+        d > -(double)LLIST_IDENTITY_HASH_LIMIT &&
+        d == (double)(long long)d)
+        return hash_small_int((long long)d);
+
+    return hash_boxed(f64_box, value);
+}
+
+LLIST_INTERNAL const LListValueKind llist_f64_kind =
+{
+    "f64",
+    f64_unbox,
+    f64_box,
+    f64_unbox_exact,
+    f64_equal,
+    f64_compare,
+    f64_hash,
+};
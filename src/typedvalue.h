@@ -0,0 +1,48 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef TYPEDVALUE_H
+#define TYPEDVALUE_H
+
+#include <Python.h>
+
+#include "config.h"
+
+/* Unboxed value stored directly in nodes of typed lists. */
+typedef union
+{
+    long long i64;
+    double f64;
+} LListTypedValue;
+
+/* Set of operations on a specific kind of unboxed values. */
+typedef struct
+{
+    /* suffix used in type names, e.g. "i64" */
+    const char* name;
+
+    /* Convert Python object to a native value.
+     * Returns 0 and sets an exception on failure. */
+    int (*unbox)(PyObject* obj, LListTypedValue* result);
+
+    /* Create new Python object from a native value. */
+    PyObject* (*box)(LListTypedValue value);
+
+    /* Convert Python object to a native value for the purpose of
+     * comparison. Returns 1 on success, 0 if object cannot be compared
+     * natively (without setting an exception). */
+    int (*unbox_exact)(PyObject* obj, LListTypedValue* result);
+
+    int (*equal)(LListTypedValue a, LListTypedValue b);
+    int (*compare)(LListTypedValue a, LListTypedValue b, int op);
+
+    /* Hash native value like its boxed Python object.
+     * Returns -1 and sets an exception on failure. */
+    long (*hash)(LListTypedValue value);
+} LListValueKind;
+
+LLIST_INTERNAL extern const LListValueKind llist_i64_kind;
+LLIST_INTERNAL extern const LListValueKind llist_f64_kind;
+
+#endif /* TYPEDVALUE_H */
@@ -0,0 +1,1545 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#include <Python.h>
+#include <structmember.h>
+#include <string.h>
+
+#include "config.h"
+#include "lock.h"
+#include "py23macros.h"
+#include "utils.h"
+
+#ifndef PyVarObject_HEAD_INIT
+    #define PyVarObject_HEAD_INIT(type, size) \
+        PyObject_HEAD_INIT(type) size,
+#endif
+
+/* Maximum number of values stored in a single block. */
+#define ULLIST_BLOCK_CAPACITY 32
+
+/* Adjacent blocks are merged when their combined size
+ * does not exceed this limit. */
+#define ULLIST_MERGE_THRESHOLD (ULLIST_BLOCK_CAPACITY / 2)
+
+
+static PyTypeObject ULListType;
+static PyTypeObject ULListIteratorType;
+
+
+/* ULListBlock */
+
+/* Blocks are plain C structures holding a contiguous array of values.
+ * Values occupy items[0] .. items[count - 1]. Empty blocks are never
+ * kept in the list. */
+typedef struct ULListBlock
+{
+    struct ULListBlock* prev;
+    struct ULListBlock* next;
+    Py_ssize_t count;
+    PyObject* items[ULLIST_BLOCK_CAPACITY];
+} ULListBlock;
+
+
+/* ULList */
+
+typedef struct
+{
+    PyObject_HEAD
+    ULListBlock* first;
+    ULListBlock* last;
+    ULListBlock* last_accessed_block;
+    /* index of the first value in last_accessed_block */
+    Py_ssize_t last_accessed_start;
+    Py_ssize_t size;
+    /* incremented whenever values are moved between positions,
+     * invalidates iterators */
+    Py_ssize_t state;
+    PyObject* weakref_list;
+} ULListObject;
+
+static Py_ssize_t py_ssize_t_abs(Py_ssize_t x)
+{
+    return (x >= 0) ? x : -x;
+}
+
+static void ullist_invalidate_last_access_cache(ULListObject* self)
+{
+    self->last_accessed_block = NULL;
+    self->last_accessed_start = -1;
+}
+
+/* Allocate a new empty block and link it after prev
+ * (or at the beginning of the list if prev is NULL). */
+static ULListBlock* ullist_link_new_block(ULListObject* self,
+                                          ULListBlock* prev)
+{
+    ULListBlock* block;
+
+    block = (ULListBlock*)PyMem_Malloc(sizeof(ULListBlock));
+    if (block == NULL)
+    {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    block->count = 0;
+    block->prev = prev;
+
+    if (prev != NULL)
+    {
+        block->next = prev->next;
+        prev->next = block;
+    }
+    else
+    {
+        block->next = self->first;
+        self->first = block;
+    }
+
+    if (block->next != NULL)
+        block->next->prev = block;
+    else
+        self->last = block;
+
+    return block;
+}
+
+/* Unlink block from the list and release it.
+ * Values stored in the block are not released. */
+static void ullist_unlink_block(ULListObject* self, ULListBlock* block)
+{
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        self->first = block->next;
+
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+    else
+        self->last = block->prev;
+
+    if (self->last_accessed_block == block)
+        ullist_invalidate_last_access_cache(self);
+
+    PyMem_Free(block);
+}
+
+/* Merge block with its successor if both are sparsely populated. */
+static void ullist_merge_with_next(ULListObject* self, ULListBlock* block)
+{
+    ULListBlock* next = block->next;
+
+    if (next == NULL || block->count + next->count > ULLIST_MERGE_THRESHOLD)
+        return;
+
+    memcpy(&block->items[block->count], &next->items[0],
+           next->count * sizeof(PyObject*));
+    block->count += next->count;
+
+    ullist_unlink_block(self, next);
+}
+
+/* Convenience function for locating values using index.
+ * Returns block containing the value and stores position of the value
+ * within the block in offset. */
+static ULListBlock* ullist_locate(ULListObject* self,
+                                  Py_ssize_t index,
+                                  Py_ssize_t* offset)
+{
+    ULListBlock* block;
+    Py_ssize_t start;
+
+    if (index >= self->size || index < 0)
+    {
+        PyErr_SetString(PyExc_IndexError, "Index out of range");
+        return NULL;
+    }
+
+    /* pick the closest base block */
+    if (index <= self->size / 2)
+    {
+        block = self->first;
+        start = 0;
+    }
+    else
+    {
+        block = self->last;
+        start = self->size - block->count;
+    }
+
+    /* check if last accessed block is closer */
+    if (self->last_accessed_block != NULL &&
+        py_ssize_t_abs(index - self->last_accessed_start) <
+        py_ssize_t_abs(index - start))
+    {
+        block = self->last_accessed_block;
+        start = self->last_accessed_start;
+    }
+
+    /* backward scan */
+    while (index < start)
+    {
+        block = block->prev;
+        start -= block->count;
+    }
+
+    /* forward scan */
+    while (index >= start + block->count)
+    {
+        start += block->count;
+        block = block->next;
+    }
+
+    self->last_accessed_block = block;
+    self->last_accessed_start = start;
+
+    *offset = index - start;
+
+    return block;
+}
+
+static int ullist_append_right(ULListObject* self, PyObject* value)
+{
+    ULListBlock* block = self->last;
+
+    if (block == NULL || block->count == ULLIST_BLOCK_CAPACITY)
+    {
+        block = ullist_link_new_block(self, self->last);
+        if (block == NULL)
+            return 0;
+    }
+
+    Py_INCREF(value);
+    block->items[block->count++] = value;
+    ++self->size;
+
+    return 1;
+}
+
+static int ullist_append_left(ULListObject* self, PyObject* value)
+{
+    ULListBlock* block = self->first;
+
+    if (block == NULL || block->count == ULLIST_BLOCK_CAPACITY)
+    {
+        block = ullist_link_new_block(self, NULL);
+        if (block == NULL)
+            return 0;
+    }
+
+    if (self->last_accessed_block != NULL)
+    {
+        /* start of the first block is always 0 */
+        if (self->last_accessed_block != block)
+            ++self->last_accessed_start;
+    }
+
+    memmove(&block->items[1], &block->items[0],
+            block->count * sizeof(PyObject*));
+
+    Py_INCREF(value);
+    block->items[0] = value;
+    ++block->count;
+    ++self->size;
+    ++self->state;
+
+    return 1;
+}
+
+/* Insert value before position index. Index equal to the size of the list
+ * appends value at the end. */
+static int ullist_insert_internal(ULListObject* self,
+                                  Py_ssize_t index,
+                                  PyObject* value)
+{
+    ULListBlock* block;
+    Py_ssize_t offset;
+
+    if (index == self->size)
+        return ullist_append_right(self, value);
+
+    block = ullist_locate(self, index, &offset);
+    if (block == NULL)
+        return 0;
+
+    if (block->count == ULLIST_BLOCK_CAPACITY)
+    {
+        /* split full block in half */
+        const Py_ssize_t half = ULLIST_BLOCK_CAPACITY / 2;
+        ULListBlock* new_block = ullist_link_new_block(self, block);
+
+        if (new_block == NULL)
+            return 0;
+
+        memcpy(&new_block->items[0], &block->items[half],
+               (block->count - half) * sizeof(PyObject*));
+        new_block->count = block->count - half;
+        block->count = half;
+
+        if (offset > half)
+        {
+            block = new_block;
+            offset -= half;
+        }
+    }
+
+    memmove(&block->items[offset + 1], &block->items[offset],
+            (block->count - offset) * sizeof(PyObject*));
+
+    Py_INCREF(value);
+    block->items[offset] = value;
+    ++block->count;
+    ++self->size;
+    ++self->state;
+
+    ullist_invalidate_last_access_cache(self);
+
+    return 1;
+}
+
+/* Remove value at offset from block. Returns the removed value,
+ * ownership of the reference is passed to the caller. */
+static PyObject* ullist_delete_internal(ULListObject* self,
+                                        ULListBlock* block,
+                                        Py_ssize_t offset)
+{
+    PyObject* value = block->items[offset];
+
+    --block->count;
+    memmove(&block->items[offset], &block->items[offset + 1],
+            (block->count - offset) * sizeof(PyObject*));
+
+    --self->size;
+    ++self->state;
+
+    ullist_invalidate_last_access_cache(self);
+
+    if (block->count == 0)
+        ullist_unlink_block(self, block);
+    else if (block->prev != NULL &&
+             block->prev->count + block->count <= ULLIST_MERGE_THRESHOLD)
+        ullist_merge_with_next(self, block->prev);
+    else
+        ullist_merge_with_next(self, block);
+
+    return value;
+}
+
+/* Detach all blocks from the list and release them. */
+static void ullist_clear_internal(ULListObject* self)
+{
+    ULListBlock* block = self->first;
+
+    self->first = NULL;
+    self->last = NULL;
+    self->size = 0;
+    ++self->state;
+
+    ullist_invalidate_last_access_cache(self);
+
+    /* Values are released after the list is detached from blocks,
+     * because destructors of values may access the list. */
+    while (block != NULL)
+    {
+        ULListBlock* next_block = block->next;
+        Py_ssize_t i;
+
+        for (i = 0; i < block->count; ++i)
+            Py_DECREF(block->items[i]);
+
+        PyMem_Free(block);
+        block = next_block;
+    }
+}
+
+/* Convenience function for extending the list with elements
+ * from an iterable. Elements are added at the right side if
+ * left is 0, or at the left side otherwise. */
+static int ullist_extend_internal(ULListObject* self,
+                                  PyObject* iterable,
+                                  int left)
+{
+    PyObject* iterator;
+    PyObject* item;
+
+    if (PyObject_TypeCheck(iterable, &ULListType) &&
+        (!left || iterable != (PyObject*)self))
+    {
+        /* Special path for extending with an ULList.
+         * Number of copied values is fixed in advance to terminate
+         * loop if self == iterable. Appending at the right side does
+         * not move existing values, so blocks can be scanned safely. */
+        ULListObject* other = (ULListObject*)iterable;
+        ULListBlock* block = other->first;
+        Py_ssize_t remaining = other->size;
+
+        while (remaining > 0)
+        {
+            Py_ssize_t i;
+            Py_ssize_t count = block->count;
+
+            if (count > remaining)
+                count = remaining;
+
+            for (i = 0; i < count; ++i)
+            {
+                int result = left ?
+                    ullist_append_left(self, block->items[i]) :
+                    ullist_append_right(self, block->items[i]);
+
+                if (!result)
+                    return 0;
+            }
+
+            remaining -= count;
+            block = block->next;
+        }
+
+        return 1;
+    }
+
+    iterator = PyObject_GetIter(iterable);
+    if (iterator == NULL)
+        return 0;
+
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        int result = left ?
+            ullist_append_left(self, item) :
+            ullist_append_right(self, item);
+
+        Py_DECREF(item);
+
+        if (!result)
+        {
+            Py_DECREF(iterator);
+            return 0;
+        }
+    }
+
+    Py_DECREF(iterator);
+
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+/* Find first position holding a value equal to value.
+ * Returns index of the value, -1 if it was not found, or -2 on error. */
+static Py_ssize_t ullist_find(ULListObject* self, PyObject* value)
+{
+    ULListBlock* block = self->first;
+    Py_ssize_t state = self->state;
+    Py_ssize_t index = 0;
+
+    while (block != NULL)
+    {
+        Py_ssize_t i;
+
+        for (i = 0; i < block->count; ++i, ++index)
+        {
+            PyObject* item = block->items[i];
+            int equal;
+
+            Py_INCREF(item);
+            equal = PyObject_RichCompareBool(item, value, Py_EQ);
+            Py_DECREF(item);
+
+            if (equal < 0)
+                return -2;
+
+            if (equal)
+                return index;
+
+            if (state != self->state)
+            {
+                PyErr_SetString(PyExc_RuntimeError,
+                    "List changed during comparison");
+                return -2;
+            }
+        }
+
+        block = block->next;
+    }
+
+    return -1;
+}
+
+/* Convenience function for formatting list to a string.
+ * Pass PyObject_Repr or PyObject_Str in the fmt_func argument. */
+static PyObject* ullist_to_string(ULListObject* self,
+                                  reprfunc fmt_func)
+{
+    PyObject* str = NULL;
+    PyObject* comma_str = NULL;
+    PyObject* tmp_str;
+    Py_ssize_t index;
+
+    assert(fmt_func != NULL);
+
+    if (Py_ReprEnter((PyObject*)self) > 0)
+        return Py23String_FromString("ullist(<...>)");
+
+    if (self->size == 0)
+    {
+        Py_ReprLeave((PyObject*)self);
+
+        str = Py23String_FromString("ullist()");
+        if (str == NULL)
+            goto str_alloc_error;
+        return str;
+    }
+
+    str = Py23String_FromString("ullist([");
+    if (str == NULL)
+        goto str_alloc_error;
+
+    comma_str = Py23String_FromString(", ");
+    if (comma_str == NULL)
+        goto str_alloc_error;
+
+    /* Values are accessed by index, because formatting functions
+     * may modify the list. */
+    for (index = 0; index < self->size; ++index)
+    {
+        ULListBlock* block;
+        Py_ssize_t offset;
+        PyObject* item;
+
+        if (index > 0)
+            Py23String_Concat(&str, comma_str);
+
+        block = ullist_locate(self, index, &offset);
+        item = block->items[offset];
+
+        Py_INCREF(item);
+        tmp_str = fmt_func(item);
+        Py_DECREF(item);
+
+        if (tmp_str == NULL)
+            goto str_alloc_error;
+        Py23String_ConcatAndDel(&str, tmp_str);
+    }
+
+    Py_DECREF(comma_str);
+    comma_str = NULL;
+
+    tmp_str = Py23String_FromString("])");
+    if (tmp_str == NULL)
+        goto str_alloc_error;
+    Py23String_ConcatAndDel(&str, tmp_str);
+
+    Py_ReprLeave((PyObject*)self);
+
+    return str;
+
+str_alloc_error:
+    Py_XDECREF(str);
+    Py_XDECREF(comma_str);
+    PyErr_SetString(PyExc_RuntimeError, "Failed to create string");
+
+    Py_ReprLeave((PyObject*)self);
+
+    return NULL;
+}
+
+static int ullist_traverse(ULListObject* self, visitproc visit, void* arg)
+{
+    ULListBlock* block;
+
+    for (block = self->first; block != NULL; block = block->next)
+    {
+        Py_ssize_t i;
+
+        for (i = 0; i < block->count; ++i)
+            Py_VISIT(block->items[i]);
+    }
+
+    return 0;
+}
+
+static int ullist_clear_refs(ULListObject* self)
+{
+    ullist_clear_internal(self);
+
+    return 0;
+}
+
+static void ullist_dealloc(ULListObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    if (self->weakref_list != NULL)
+        PyObject_ClearWeakRefs(obj_self);
+
+    ullist_clear_internal(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* ullist_new(PyTypeObject* type,
+                            PyObject* args,
+                            PyObject* kwds)
+{
+    ULListObject* self;
+
+    self = (ULListObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->first = NULL;
+    self->last = NULL;
+    self->last_accessed_block = NULL;
+    self->last_accessed_start = -1;
+    self->size = 0;
+    self->state = 0;
+    self->weakref_list = NULL;
+
+    return (PyObject*)self;
+}
+
+static int ullist_init(ULListObject* self, PyObject* args, PyObject* kwds)
+{
+    PyObject* iterable = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__init__", 0, 1, &iterable))
+        return -1;
+
+    if (iterable == NULL)
+        return 0;
+
+    return ullist_extend_internal(self, iterable, 0) ? 0 : -1;
+}
+
+static PyObject* ullist_repr(ULListObject* self)
+{
+    return ullist_to_string(self, PyObject_Repr);
+}
+
+static PyObject* ullist_str(ULListObject* self)
+{
+    return ullist_to_string(self, PyObject_Str);
+}
+
+static long ullist_hash(ULListObject* self)
+{
+    long hash = 0;
+    Py_ssize_t index;
+
+    for (index = 0; index < self->size; ++index)
+    {
+        ULListBlock* block;
+        Py_ssize_t offset;
+        PyObject* item;
+        long obj_hash;
+
+        block = ullist_locate(self, index, &offset);
+        item = block->items[offset];
+
+        Py_INCREF(item);
+        obj_hash = PyObject_Hash(item);
+        Py_DECREF(item);
+
+        if (obj_hash == -1)
+            return -1;
+
+        hash = hash_combine(hash, obj_hash);
+    }
+
+    /* -1 is reserved for signalling errors */
+    return (hash != -1) ? hash : -2;
+}
+
+static PyObject* ullist_richcompare(ULListObject* self,
+                                    ULListObject* other,
+                                    int op)
+{
+    Py_ssize_t index;
+    int satisfied;
+
+    if (!PyObject_TypeCheck(other, &ULListType))
+    {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    if (self == other &&
+        (op == Py_EQ || op == Py_LE || op == Py_GE))
+        Py_RETURN_TRUE;
+
+    if (self->size != other->size)
+    {
+        if (op == Py_EQ)
+            Py_RETURN_FALSE;
+        else if (op == Py_NE)
+            Py_RETURN_TRUE;
+    }
+
+    /* Scan through sequences' items as long as they are equal.
+     * Values are accessed by index, because comparisons may modify
+     * the lists. */
+    for (index = 0; index < self->size && index < other->size; ++index)
+    {
+        ULListBlock* block;
+        Py_ssize_t offset;
+        PyObject* self_item;
+        PyObject* other_item;
+
+        block = ullist_locate(self, index, &offset);
+        self_item = block->items[offset];
+        block = ullist_locate(other, index, &offset);
+        other_item = block->items[offset];
+
+        Py_INCREF(self_item);
+        Py_INCREF(other_item);
+
+        satisfied = PyObject_RichCompareBool(self_item, other_item, Py_EQ);
+
+        if (satisfied == 0 && op != Py_EQ)
+        {
+            /* Both items are valid, but not equal */
+            satisfied = PyObject_RichCompareBool(self_item, other_item, op);
+        }
+        else if (satisfied == 0)
+        {
+            Py_DECREF(self_item);
+            Py_DECREF(other_item);
+            Py_RETURN_FALSE;
+        }
+        else if (satisfied == 1)
+        {
+            Py_DECREF(self_item);
+            Py_DECREF(other_item);
+            continue;
+        }
+
+        Py_DECREF(self_item);
+        Py_DECREF(other_item);
+
+        if (satisfied == -1)
+            return NULL;
+
+        if (satisfied)
+            Py_RETURN_TRUE;
+        else
+            Py_RETURN_FALSE;
+    }
+
+    /* At least one of operands has been fully traversed. */
+    switch (op)
+    {
+    case Py_EQ:
+        satisfied = (self->size == other->size);
+        break;
+    case Py_NE:
+        satisfied = (self->size != other->size);
+        break;
+    case Py_LT:
+        satisfied = (self->size < other->size);
+        break;
+    case Py_GT:
+        satisfied = (self->size > other->size);
+        break;
+    case Py_LE:
+        satisfied = (self->size <= other->size);
+        break;
+    case Py_GE:
+        satisfied = (self->size >= other->size);
+        break;
+    default:
+        assert(0 && "Invalid rich compare operator");
+        PyErr_SetString(PyExc_ValueError, "Invalid rich compare operator");
+        return NULL;
+    }
+
+    if (satisfied)
+        Py_RETURN_TRUE;
+    else
+        Py_RETURN_FALSE;
+}
+
+static PyObject* ullist_appendleft(ULListObject* self, PyObject* arg)
+{
+    if (!ullist_append_left(self, arg))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_appendright(ULListObject* self, PyObject* arg)
+{
+    if (!ullist_append_right(self, arg))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_insert(ULListObject* self, PyObject* args)
+{
+    PyObject* value = NULL;
+    PyObject* index_obj = NULL;
+    Py_ssize_t index;
+
+    if (!PyArg_UnpackTuple(args, "insert", 1, 2, &value, &index_obj))
+        return NULL;
+
+    if (index_obj == NULL || index_obj == Py_None)
+        index = self->size;
+    else
+    {
+        if (!Py23Int_Check(index_obj))
+        {
+            PyErr_SetString(PyExc_TypeError, "Index must be an integer");
+            return NULL;
+        }
+
+        index = Py23Int_AsSsize_t(index_obj);
+        if (index == -1 && PyErr_Occurred())
+            return NULL;
+
+        if (index < 0)
+            index += self->size;
+
+        if (index < 0 || index > self->size)
+        {
+            PyErr_SetString(PyExc_IndexError, "Index out of range");
+            return NULL;
+        }
+    }
+
+    if (!ullist_insert_internal(self, index, value))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_extendleft(ULListObject* self, PyObject* arg)
+{
+    if (arg == (PyObject*)self)
+    {
+        /* Prepending values moves them, so a snapshot is needed. */
+        PyObject* snapshot = PySequence_List(arg);
+        int result;
+
+        if (snapshot == NULL)
+            return NULL;
+
+        result = ullist_extend_internal(self, snapshot, 1);
+        Py_DECREF(snapshot);
+
+        if (!result)
+            return NULL;
+
+        Py_RETURN_NONE;
+    }
+
+    if (!ullist_extend_internal(self, arg, 1))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_extendright(ULListObject* self, PyObject* arg)
+{
+    if (!ullist_extend_internal(self, arg, 0))
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_clear(ULListObject* self)
+{
+    ullist_clear_internal(self);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_popleft(ULListObject* self)
+{
+    if (self->first == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    return ullist_delete_internal(self, self->first, 0);
+}
+
+static PyObject* ullist_popright(ULListObject* self)
+{
+    if (self->last == NULL)
+    {
+        PyErr_SetString(PyExc_ValueError, "List is empty");
+        return NULL;
+    }
+
+    return ullist_delete_internal(self, self->last, self->last->count - 1);
+}
+
+static PyObject* ullist_remove(ULListObject* self, PyObject* arg)
+{
+    ULListBlock* block;
+    Py_ssize_t offset;
+    Py_ssize_t index;
+    PyObject* value;
+
+    index = ullist_find(self, arg);
+    if (index == -2)
+        return NULL;
+
+    if (index == -1)
+    {
+        PyErr_SetString(PyExc_ValueError, "Value not found in list");
+        return NULL;
+    }
+
+    block = ullist_locate(self, index, &offset);
+    /* Py_DECREF may evaluate its argument more than once on Python 2 */
+    value = ullist_delete_internal(self, block, offset);
+    Py_DECREF(value);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_index(ULListObject* self, PyObject* arg)
+{
+    Py_ssize_t index;
+
+    index = ullist_find(self, arg);
+    if (index == -2)
+        return NULL;
+
+    if (index == -1)
+    {
+        PyErr_SetString(PyExc_ValueError, "Value not found in list");
+        return NULL;
+    }
+
+    return PyLong_FromSsize_t(index);
+}
+
+static PyObject* ullist_rotate(ULListObject* self, PyObject* nObject)
+{
+    Py_ssize_t n;
+    Py_ssize_t n_mod;
+    Py_ssize_t i;
+
+    if (self->size <= 1)
+        Py_RETURN_NONE;
+
+    if (!Py23Int_Check(nObject))
+    {
+        PyErr_SetString(PyExc_TypeError, "n must be an integer");
+        return NULL;
+    }
+
+    n = Py23Int_AsSsize_t(nObject);
+    if (n == -1 && PyErr_Occurred())
+        return NULL;
+
+    /* number of steps to the right */
+    n_mod = py_ssize_t_abs(n) % self->size;
+    if (n < 0)
+        n_mod = (self->size - n_mod) % self->size;
+
+    /* move values in the direction requiring fewer steps */
+    if (n_mod <= self->size / 2)
+    {
+        for (i = 0; i < n_mod; ++i)
+        {
+            PyObject* value = ullist_delete_internal(
+                self, self->last, self->last->count - 1);
+
+            if (!ullist_append_left(self, value))
+            {
+                Py_DECREF(value);
+                return NULL;
+            }
+
+            Py_DECREF(value);
+        }
+    }
+    else
+    {
+        for (i = 0; i < self->size - n_mod; ++i)
+        {
+            PyObject* value = ullist_delete_internal(self, self->first, 0);
+
+            if (!ullist_append_right(self, value))
+            {
+                Py_DECREF(value);
+                return NULL;
+            }
+
+            Py_DECREF(value);
+        }
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ullist_iter(PyObject* self)
+{
+    PyObject* args;
+    PyObject* result;
+
+    args = PyTuple_Pack(1, self);
+    if (args == NULL)
+        return NULL;
+
+    result = PyObject_CallObject((PyObject*)&ULListIteratorType, args);
+
+    Py_DECREF(args);
+
+    return result;
+}
+
+static Py_ssize_t ullist_len(PyObject* self)
+{
+    return ((ULListObject*)self)->size;
+}
+
+static PyObject* ullist_concat(PyObject* self, PyObject* other)
+{
+    ULListObject* new_list;
+
+    new_list = (ULListObject*)PyObject_CallObject(
+        (PyObject*)&ULListType, NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    if (!ullist_extend_internal(new_list, self, 0) ||
+        !ullist_extend_internal(new_list, other, 0))
+    {
+        Py_DECREF(new_list);
+        return NULL;
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* ullist_inplace_concat(PyObject* self, PyObject* other)
+{
+    if (!ullist_extend_internal((ULListObject*)self, other, 0))
+        return NULL;
+
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject* ullist_repeat(PyObject* self, Py_ssize_t count)
+{
+    ULListObject* new_list;
+    Py_ssize_t i;
+
+    new_list = (ULListObject*)PyObject_CallObject(
+        (PyObject*)&ULListType, NULL);
+    if (new_list == NULL)
+        return NULL;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (!ullist_extend_internal(new_list, self, 0))
+        {
+            Py_DECREF(new_list);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)new_list;
+}
+
+static PyObject* ullist_get_item(PyObject* self, Py_ssize_t index)
+{
+    ULListBlock* block;
+    Py_ssize_t offset;
+    PyObject* value;
+
+    block = ullist_locate((ULListObject*)self, index, &offset);
+    if (block == NULL)
+        return NULL;
+
+    value = block->items[offset];
+    Py_INCREF(value);
+
+    return value;
+}
+
+static int ullist_set_item(PyObject* self, Py_ssize_t index, PyObject* val)
+{
+    ULListObject* list = (ULListObject*)self;
+    ULListBlock* block;
+    Py_ssize_t offset;
+    PyObject* oldval;
+
+    block = ullist_locate(list, index, &offset);
+    if (block == NULL)
+        return -1;
+
+    /* del list[index] */
+    if (val == NULL)
+    {
+        oldval = ullist_delete_internal(list, block, offset);
+        Py_DECREF(oldval);
+        return 0;
+    }
+
+    /* list[index] = item */
+    oldval = block->items[offset];
+
+    Py_INCREF(val);
+    block->items[offset] = val;
+    Py_DECREF(oldval);
+
+    return 0;
+}
+
+static int ullist_contains(PyObject* self, PyObject* value)
+{
+    Py_ssize_t index = ullist_find((ULListObject*)self, value);
+
+    if (index == -2)
+        return -1;
+
+    return (index >= 0) ? 1 : 0;
+}
+
+/* Size of the list including its blocks. Values are not included. */
+static PyObject* ullist_sizeof(ULListObject* self)
+{
+    Py_ssize_t size = Py_TYPE(self)->tp_basicsize;
+    ULListBlock* block;
+
+    for (block = self->first; block != NULL; block = block->next)
+        size += sizeof(ULListBlock);
+
+    return PyLong_FromSsize_t(size);
+}
+
+/* Convenience function for copying lists. Values are copied with
+ * copy.deepcopy() if memo is not NULL. */
+static PyObject* ullist_copy_internal(ULListObject* self, PyObject* memo)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    ULListObject* new_list;
+    PyObject* args;
+    PyObject* values = NULL;
+    ULListBlock* block;
+    Py_ssize_t index = 0;
+    Py_ssize_t i;
+
+    /* __init__ of subclasses is not called, like in copy.copy() */
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+
+    new_list = (ULListObject*)type->tp_new(type, args, NULL);
+    Py_DECREF(args);
+    if (new_list == NULL)
+        return NULL;
+
+    if (memo == NULL)
+    {
+        if (!ullist_extend_internal(new_list, (PyObject*)self, 0))
+            goto copy_error;
+    }
+    else
+    {
+        if (!llist_memo_store(memo, (PyObject*)self, (PyObject*)new_list))
+            goto copy_error;
+
+        /* deepcopy may run arbitrary code modifying the list,
+         * so values are copied from a snapshot */
+        values = PyList_New(self->size);
+        if (values == NULL)
+            goto copy_error;
+
+        for (block = self->first; block != NULL; block = block->next)
+        {
+            for (i = 0; i < block->count; ++i)
+            {
+                Py_INCREF(block->items[i]);
+                PyList_SET_ITEM(values, index++, block->items[i]);
+            }
+        }
+
+        for (i = 0; i < index; ++i)
+        {
+            PyObject* value;
+            int result;
+
+            value = llist_deepcopy(PyList_GET_ITEM(values, i), memo);
+            if (value == NULL)
+                goto copy_error;
+
+            result = ullist_append_right(new_list, value);
+            Py_DECREF(value);
+            if (!result)
+                goto copy_error;
+        }
+
+        Py_CLEAR(values);
+    }
+
+    if (!llist_copy_state((PyObject*)self, (PyObject*)new_list, memo))
+        goto copy_error;
+
+    return (PyObject*)new_list;
+
+copy_error:
+    Py_XDECREF(values);
+    Py_DECREF(new_list);
+    return NULL;
+}
+
+static PyObject* ullist_copy(ULListObject* self)
+{
+    return ullist_copy_internal(self, NULL);
+}
+
+static PyObject* ullist_deepcopy(ULListObject* self, PyObject* memo)
+{
+    return ullist_copy_internal(self, memo);
+}
+
+/* Values are passed as an iterator, like for dllist, so pickle creates
+ * (and memoizes) an empty list first and appends values to it, which
+ * handles lists containing themselves. */
+static PyObject* ullist_reduce(ULListObject* self)
+{
+    PyObject* state;
+    PyObject* items;
+
+    items = PyObject_GetIter((PyObject*)self);
+    if (items == NULL)
+        return NULL;
+
+    state = llist_get_state((PyObject*)self);
+    if (state == NULL)
+    {
+        Py_DECREF(items);
+        return NULL;
+    }
+
+    return Py_BuildValue("O()NN", (PyObject*)Py_TYPE(self), state, items);
+}
+
+/* wrappers holding the list lock, see lock.h */
+LLIST_LOCKED_ARG(ullist_appendleft_locked, ullist_appendleft)
+LLIST_LOCKED_ARG(ullist_appendright_locked, ullist_appendright)
+LLIST_LOCKED_NOARGS(ullist_clear_locked, ullist_clear)
+LLIST_LOCKED_NOARGS(ullist_copy_locked, ullist_copy)
+LLIST_LOCKED_ARG(ullist_deepcopy_locked, ullist_deepcopy)
+LLIST_LOCKED_ARG2(ullist_extendright_locked, ullist_extendright)
+LLIST_LOCKED_ARG2(ullist_extendleft_locked, ullist_extendleft)
+LLIST_LOCKED_ARG(ullist_index_locked, ullist_index)
+LLIST_LOCKED_ARG(ullist_insert_locked, ullist_insert)
+LLIST_LOCKED_NOARGS(ullist_popleft_locked, ullist_popleft)
+LLIST_LOCKED_NOARGS(ullist_popright_locked, ullist_popright)
+LLIST_LOCKED_NOARGS(ullist_reduce_locked, ullist_reduce)
+LLIST_LOCKED_ARG(ullist_remove_locked, ullist_remove)
+LLIST_LOCKED_ARG(ullist_rotate_locked, ullist_rotate)
+LLIST_LOCKED_NOARGS(ullist_sizeof_locked, ullist_sizeof)
+LLIST_LOCKED_LEN(ullist_len_locked, ullist_len)
+LLIST_LOCKED_CONCAT(ullist_concat_locked, ullist_concat)
+LLIST_LOCKED_INDEX(ullist_repeat_locked, ullist_repeat)
+LLIST_LOCKED_INDEX(ullist_get_item_locked, ullist_get_item)
+LLIST_LOCKED_ASS_ITEM(ullist_set_item_locked, ullist_set_item)
+LLIST_LOCKED_CONTAINS(ullist_contains_locked, ullist_contains)
+LLIST_LOCKED_CONCAT(ullist_inplace_concat_locked, ullist_inplace_concat)
+LLIST_LOCKED_UNARY(ullist_repr_locked, ullist_repr)
+LLIST_LOCKED_UNARY(ullist_str_locked, ullist_str)
+LLIST_LOCKED_HASH(ullist_hash_locked, ullist_hash)
+LLIST_LOCKED_RICHCOMPARE(ullist_richcompare_locked, ullist_richcompare)
+LLIST_LOCKED_INIT(ullist_init_locked, ullist_init)
+
+static PyMethodDef ULListMethods[] =
+{
+    { "appendleft", (PyCFunction)ullist_appendleft_locked, METH_O,
+      "Append element at the beginning of the list" },
+    { "append", (PyCFunction)ullist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "appendright", (PyCFunction)ullist_appendright_locked, METH_O,
+      "Append element at the end of the list" },
+    { "clear", (PyCFunction)ullist_clear_locked, METH_NOARGS,
+      "Remove all elements from the list" },
+    { "extend", (PyCFunction)ullist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "extendleft", (PyCFunction)ullist_extendleft_locked, METH_O,
+      "Append elements from iterable at the left side of the list" },
+    { "extendright", (PyCFunction)ullist_extendright_locked, METH_O,
+      "Append elements from iterable at the right side of the list" },
+    { "index", (PyCFunction)ullist_index_locked, METH_O,
+      "Return index of the first occurrence of value" },
+    { "insert", (PyCFunction)ullist_insert_locked, METH_VARARGS,
+      "Inserts element before index" },
+    { "popleft", (PyCFunction)ullist_popleft_locked, METH_NOARGS,
+      "Remove first element from the list and return it" },
+    { "pop", (PyCFunction)ullist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "popright", (PyCFunction)ullist_popright_locked, METH_NOARGS,
+      "Remove last element from the list and return it" },
+    { "remove", (PyCFunction)ullist_remove_locked, METH_O,
+      "Remove first occurrence of value from the list" },
+    { "rotate", (PyCFunction)ullist_rotate_locked, METH_O,
+      "Rotate the list n steps to the right" },
+    { "__copy__", (PyCFunction)ullist_copy_locked, METH_NOARGS,
+      "Return shallow copy of the list" },
+    { "__deepcopy__", (PyCFunction)ullist_deepcopy_locked, METH_O,
+      "Return deep copy of the list" },
+    { "__reduce__", (PyCFunction)ullist_reduce_locked, METH_NOARGS,
+      "Return state information for pickling" },
+    { "__sizeof__", (PyCFunction)ullist_sizeof_locked, METH_NOARGS,
+      "Return size of the list and its blocks in memory, in bytes" },
+    { NULL },   /* sentinel */
+};
+
+static PyMemberDef ULListMembers[] =
+{
+    { "size", T_PYSSIZET, offsetof(ULListObject, size), READONLY,
+      "Number of elements in the list" },
+    { NULL },   /* sentinel */
+};
+
+static PySequenceMethods ULListSequenceMethods =
+{
+    ullist_len_locked,          /* sq_length */
+    ullist_concat_locked,       /* sq_concat */
+    ullist_repeat_locked,       /* sq_repeat */
+    ullist_get_item_locked,     /* sq_item */
+    0,                          /* sq_slice */
+    ullist_set_item_locked,     /* sq_ass_item */
+    0,                          /* sq_ass_slice */
+    ullist_contains_locked,     /* sq_contains */
+    ullist_inplace_concat_locked, /* sq_inplace_concat */
+    0,                          /* sq_inplace_repeat */
+};
+
+static PyTypeObject ULListType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.ullist",             /* tp_name */
+    sizeof(ULListObject),       /* tp_basicsize */
+    0,                          /* tp_itemsize */
+    (destructor)ullist_dealloc, /* tp_dealloc */
+    0,                          /* tp_print */
+    0,                          /* tp_getattr */
+    0,                          /* tp_setattr */
+    0,                          /* tp_compare */
+    (reprfunc)ullist_repr_locked, /* tp_repr */
+    0,                          /* tp_as_number */
+    &ULListSequenceMethods,     /* tp_as_sequence */
+    0,                          /* tp_as_mapping */
+    (hashfunc)ullist_hash_locked, /* tp_hash */
+    0,                          /* tp_call */
+    (reprfunc)ullist_str_locked, /* tp_str */
+    0,                          /* tp_getattro */
+    0,                          /* tp_setattro */
+    0,                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+                                /* tp_flags */
+    "Unrolled linked list",     /* tp_doc */
+    (traverseproc)ullist_traverse,
+                                /* tp_traverse */
+    (inquiry)ullist_clear_refs, /* tp_clear */
+    (richcmpfunc)ullist_richcompare_locked,
+                                /* tp_richcompare */
+    offsetof(ULListObject, weakref_list),
+                                /* tp_weaklistoffset */
+    ullist_iter,                /* tp_iter */
+    0,                          /* tp_iternext */
+    ULListMethods,              /* tp_methods */
+    ULListMembers,              /* tp_members */
+    0,                          /* tp_getset */
+    0,                          /* tp_base */
+    0,                          /* tp_dict */
+    0,                          /* tp_descr_get */
+    0,                          /* tp_descr_set */
+    0,                          /* tp_dictoffset */
+    (initproc)ullist_init_locked, /* tp_init */
+    0,                          /* tp_alloc */
+    ullist_new,                 /* tp_new */
+};
+
+
+/* ULListIterator */
+
+typedef struct
+{
+    PyObject_HEAD
+    ULListObject* list;
+    /* position of the next value, block is NULL before first call */
+    ULListBlock* block;
+    Py_ssize_t offset;
+    Py_ssize_t state;
+} ULListIteratorObject;
+
+static int ullistiterator_traverse(ULListIteratorObject* self,
+                                   visitproc visit,
+                                   void* arg)
+{
+    Py_VISIT(self->list);
+
+    return 0;
+}
+
+static int ullistiterator_clear_refs(ULListIteratorObject* self)
+{
+    Py_CLEAR(self->list);
+
+    return 0;
+}
+
+static void ullistiterator_dealloc(ULListIteratorObject* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyObject* obj_self = (PyObject*)self;
+
+    ullistiterator_clear_refs(self);
+
+    obj_self->ob_type->tp_free(obj_self);
+}
+
+static PyObject* ullistiterator_new(PyTypeObject* type,
+                                    PyObject* args,
+                                    PyObject* kwds)
+{
+    ULListIteratorObject* self;
+    PyObject* owner_list = NULL;
+
+    if (!PyArg_UnpackTuple(args, "__new__", 1, 1, &owner_list))
+        return NULL;
+
+    if (!PyObject_TypeCheck(owner_list, &ULListType))
+    {
+        PyErr_SetString(PyExc_TypeError, "ullist argument expected");
+        return NULL;
+    }
+
+    self = (ULListIteratorObject*)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->list = (ULListObject*)owner_list;
+    self->block = NULL;
+    self->offset = 0;
+    self->state = self->list->state;
+
+    Py_INCREF(self->list);
+
+    return (PyObject*)self;
+}
+
+static PyObject* ullistiterator_iternext(PyObject* self)
+{
+    ULListIteratorObject* iter_self = (ULListIteratorObject*)self;
+    ULListBlock* block;
+    PyObject* value;
+
+    if (iter_self->list == NULL)
+        return NULL;
+
+    if (iter_self->state != iter_self->list->state)
+    {
+        Py_CLEAR(iter_self->list);
+        PyErr_SetString(PyExc_RuntimeError,
+            "List changed size during iteration");
+        return NULL;
+    }
+
+    if (iter_self->block == NULL)
+    {
+        iter_self->block = iter_self->list->first;
+        iter_self->offset = 0;
+    }
+
+    block = iter_self->block;
+    if (block == NULL)
+    {
+        Py_CLEAR(iter_self->list);
+        return NULL;
+    }
+
+    while (iter_self->offset >= block->count)
+    {
+        if (block->next == NULL)
+        {
+            /* release the list, so that the iterator stays exhausted */
+            Py_CLEAR(iter_self->list);
+            return NULL;
+        }
+
+        block = block->next;
+        iter_self->block = block;
+        iter_self->offset = 0;
+    }
+
+    value = block->items[iter_self->offset++];
+    Py_INCREF(value);
+
+    return value;
+}
+
+LLIST_LOCKED_ITERNEXT(ullistiterator_iternext_locked,
+    ullistiterator_iternext, ULListIteratorObject)
+
+static PyTypeObject ULListIteratorType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "llist.ullistiterator",                 /* tp_name */
+    sizeof(ULListIteratorObject),           /* tp_basicsize */
+    0,                                      /* tp_itemsize */
+    (destructor)ullistiterator_dealloc,     /* tp_dealloc */
+    0,                                      /* tp_print */
+    0,                                      /* tp_getattr */
+    0,                                      /* tp_setattr */
+    0,                                      /* tp_compare */
+    0,                                      /* tp_repr */
+    0,                                      /* tp_as_number */
+    0,                                      /* tp_as_sequence */
+    0,                                      /* tp_as_mapping */
+    0,                                      /* tp_hash */
+    0,                                      /* tp_call */
+    0,                                      /* tp_str */
+    0,                                      /* tp_getattro */
+    0,                                      /* tp_setattro */
+    0,                                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+                                            /* tp_flags */
+    "Unrolled linked list iterator",        /* tp_doc */
+    (traverseproc)ullistiterator_traverse,  /* tp_traverse */
+    (inquiry)ullistiterator_clear_refs,     /* tp_clear */
+    0,                                      /* tp_richcompare */
+    0,                                      /* tp_weaklistoffset */
+    PyObject_SelfIter,                      /* tp_iter */
+    ullistiterator_iternext_locked,         /* tp_iternext */
+    0,                                      /* tp_methods */
+    0,                                      /* tp_members */
+    0,                                      /* tp_getset */
+    0,                                      /* tp_base */
+    0,                                      /* tp_dict */
+    0,                                      /* tp_descr_get */
+    0,                                      /* tp_descr_set */
+    0,                                      /* tp_dictoffset */
+    0,                                      /* tp_init */
+    0,                                      /* tp_alloc */
+    ullistiterator_new,                     /* tp_new */
+};
+
+LLIST_INTERNAL int ullist_init_type(void)
+{
+    return
+        ((PyType_Ready(&ULListType) == 0) &&
+         (PyType_Ready(&ULListIteratorType) == 0))
+        ? 1 : 0;
+}
+
+LLIST_INTERNAL void ullist_register(PyObject* module)
+{
+    Py_INCREF(&ULListType);
+    Py_INCREF(&ULListIteratorType);
+
+    PyModule_AddObject(module, "ullist", (PyObject*)&ULListType);
+    PyModule_AddObject(module, "ullistiterator", (PyObject*)&ULListIteratorType);
+}
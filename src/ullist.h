@@ -0,0 +1,13 @@
+/* Copyright (c) 2011-2018 Adam Jakubek, Rafał Gałczyński
+ * Released under the MIT license (see attached LICENSE file).
+ */
+
+#ifndef ULLIST_H
+#define ULLIST_H
+
+#include "config.h"
+
+LLIST_INTERNAL int  ullist_init_type(void);
+LLIST_INTERNAL void ullist_register(PyObject* module);
+
+#endif /* ULLIST_H */
@@ -2,7 +2,11 @@
  * Released under the MIT license (see attached LICENSE file).
  */
 
+#include <Python.h>
+
 #include "config.h"
+#include "py23macros.h"
+#include "utils.h"
 
 #ifdef HAVE_64_BIT_LONG
 #define HASH_MIX_CONSTANT 0x9e3779b97f4a7c15
@@ -17,3 +21,259 @@ LLIST_INTERNAL long hash_combine(long h1, long h2)
     unsigned long c = uh1 ^ ((uh1 << 6) + (uh1 >> 2) + HASH_MIX_CONSTANT + uh2);
     return (long)c;
 }
+
+LLIST_INTERNAL PyObject* llist_get_state(PyObject* obj)
+{
+    PyObject* dict;
+
+    dict = PyObject_GetAttrString(obj, "__dict__");
+    if (dict == NULL)
+    {
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+            return NULL;
+
+        /* instances of base types have no dictionary */
+        PyErr_Clear();
+        Py_RETURN_NONE;
+    }
+
+    if (!PyDict_Check(dict) || PyDict_Size(dict) == 0)
+    {
+        Py_DECREF(dict);
+        Py_RETURN_NONE;
+    }
+
+    return dict;
+}
+
+LLIST_INTERNAL int llist_copy_state(PyObject* src,
+                                    PyObject* dst,
+                                    PyObject* memo)
+{
+    PyObject* state;
+    PyObject* dst_dict;
+    int result;
+
+    state = llist_get_state(src);
+    if (state == NULL)
+        return 0;
+
+    if (state == Py_None)
+    {
+        Py_DECREF(state);
+        return 1;
+    }
+
+    if (memo != NULL)
+    {
+        PyObject* state_copy = llist_deepcopy(state, memo);
+
+        Py_DECREF(state);
+        if (state_copy == NULL)
+            return 0;
+        state = state_copy;
+    }
+
+    dst_dict = PyObject_GetAttrString(dst, "__dict__");
+    if (dst_dict == NULL)
+    {
+        Py_DECREF(state);
+        return 0;
+    }
+
+    result = PyDict_Update(dst_dict, state);
+
+    Py_DECREF(dst_dict);
+    Py_DECREF(state);
+
+    return (result == 0) ? 1 : 0;
+}
+
+LLIST_INTERNAL PyObject* llist_deepcopy(PyObject* obj, PyObject* memo)
+{
+    PyObject* copy_module;
+    PyObject* result;
+
+    copy_module = PyImport_ImportModule("copy");
+    if (copy_module == NULL)
+        return NULL;
+
+    result = PyObject_CallMethod(copy_module, "deepcopy", "OO", obj, memo);
+
+    Py_DECREF(copy_module);
+
+    return result;
+}
+
+LLIST_INTERNAL int llist_memo_store(PyObject* memo,
+                                    PyObject* obj,
+                                    PyObject* copy)
+{
+    PyObject* key;
+    int result;
+
+    if (memo == Py_None)
+        return 1;
+
+    key = PyLong_FromVoidPtr(obj);
+    if (key == NULL)
+        return 0;
+
+    result = PyObject_SetItem(memo, key, copy);
+
+    Py_DECREF(key);
+
+    return (result == 0) ? 1 : 0;
+}
+
+static PyObject* llist_owner_ref_callback(PyObject* self, PyObject* ref)
+{
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef llist_owner_ref_callback_def =
+{
+    "_owner_ref_callback", (PyCFunction)llist_owner_ref_callback, METH_O,
+    "Callback of weak references held by list nodes"
+};
+
+/* created once by llist_utils_init, so that threads creating lists do
+ * not race to create it */
+static PyObject* llist_owner_ref_callback_obj = NULL;
+
+static Py_ssize_t gc_head_size = -1;
+
+/* sys.getsizeof() adds size of the garbage collector header to the result
+ * of __sizeof__() for objects of types supporting garbage collection,
+ * like lists. Returns 0 on failure. */
+static int llist_measure_gc_head_size(void)
+{
+    PyObject* getsizeof;
+    PyObject* obj;
+    PyObject* full_size;
+    PyObject* size;
+    int result = 0;
+
+    getsizeof = PySys_GetObject("getsizeof");
+    if (getsizeof == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Cannot find sys.getsizeof");
+        return 0;
+    }
+
+    obj = PyList_New(0);
+    if (obj == NULL)
+        return 0;
+
+    full_size = PyObject_CallFunctionObjArgs(getsizeof, obj, NULL);
+    size = PyObject_CallMethod(obj, "__sizeof__", NULL);
+
+    if (full_size != NULL && size != NULL)
+    {
+        gc_head_size =
+            Py23Int_AsSsize_t(full_size) - Py23Int_AsSsize_t(size);
+        result = !PyErr_Occurred();
+    }
+
+    Py_XDECREF(full_size);
+    Py_XDECREF(size);
+    Py_DECREF(obj);
+
+    return result;
+}
+
+LLIST_INTERNAL int llist_utils_init(void)
+{
+    if (llist_owner_ref_callback_obj == NULL)
+    {
+        llist_owner_ref_callback_obj =
+            PyCFunction_New(&llist_owner_ref_callback_def, NULL);
+        if (llist_owner_ref_callback_obj == NULL)
+            return 0;
+    }
+
+    if (gc_head_size < 0 && !llist_measure_gc_head_size())
+        return 0;
+
+    return 1;
+}
+
+LLIST_INTERNAL Py_ssize_t llist_gc_head_size(void)
+{
+    assert(gc_head_size >= 0);
+
+    return gc_head_size;
+}
+
+LLIST_INTERNAL PyObject* llist_new_owner_ref(PyObject* list)
+{
+    assert(llist_owner_ref_callback_obj != NULL);
+
+    return PyWeakref_NewRef(list, llist_owner_ref_callback_obj);
+}
+
+LLIST_INTERNAL int llist_is_atomic(PyObject* value)
+{
+    if (value == Py_None || PyBool_Check(value) ||
+        PyLong_CheckExact(value) || PyFloat_CheckExact(value) ||
+        PyComplex_CheckExact(value))
+        return 1;
+
+#if PY_MAJOR_VERSION >= 3
+    return PyUnicode_CheckExact(value) || PyBytes_CheckExact(value);
+#else
+    return PyInt_CheckExact(value) || PyString_CheckExact(value) ||
+        PyUnicode_CheckExact(value);
+#endif
+}
+
+LLIST_INTERNAL int llist_readonly_setter(PyObject* self,
+                                         PyObject* value,
+                                         void* closure)
+{
+#if PY_MAJOR_VERSION >= 3
+    PyErr_SetString(PyExc_AttributeError, "readonly attribute");
+#else
+    PyErr_SetString(PyExc_TypeError, "readonly attribute");
+#endif
+    return -1;
+}
+
+LLIST_INTERNAL PyObject* llist_apply_key(PyObject* key, PyObject* value)
+{
+    if (key == NULL || key == Py_None)
+    {
+        Py_INCREF(value);
+        return value;
+    }
+
+    return Py23Object_CallOneArg(key, value);
+}
+
+LLIST_INTERNAL int llist_is_identity_call(PyObject* func, PyObject* value)
+{
+    /* constructors of these types return exact instances unchanged */
+    if (func == (PyObject*)&PyLong_Type)
+        return PyLong_CheckExact(value);
+    if (func == (PyObject*)&PyFloat_Type)
+        return PyFloat_CheckExact(value);
+    if (func == (PyObject*)&PyUnicode_Type)
+        return PyUnicode_CheckExact(value);
+    if (func == (PyObject*)&PyBytes_Type)
+        return PyBytes_CheckExact(value);
+    if (func == (PyObject*)&PyTuple_Type)
+        return PyTuple_CheckExact(value);
+
+    return 0;
+}
+
+LLIST_INTERNAL Py_ssize_t llist_object_size(PyObject* obj)
+{
+    PyTypeObject* type = Py_TYPE(obj);
+    Py_ssize_t size = type->tp_basicsize;
+
+    if (PyType_IS_GC(type))
+        size += gc_head_size;
+
+    return size;
+}
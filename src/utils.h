@@ -5,8 +5,68 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <Python.h>
+
 #include "config.h"
 
+/* Initialize objects shared by all lists. Must be called during module
+ * initialization, returns 0 on failure. */
+LLIST_INTERNAL int llist_utils_init(void);
+
 LLIST_INTERNAL long hash_combine(long h1, long h2);
 
+/* Return instance dictionary of obj if it is not empty, or Py_None
+ * otherwise. Returns a new reference or NULL on failure. */
+LLIST_INTERNAL PyObject* llist_get_state(PyObject* obj);
+
+/* Copy instance dictionary from src to dst. If memo is not NULL,
+ * values are copied with copy.deepcopy(). Returns 0 on failure. */
+LLIST_INTERNAL int llist_copy_state(PyObject* src,
+                                    PyObject* dst,
+                                    PyObject* memo);
+
+/* Call copy.deepcopy(obj, memo). */
+LLIST_INTERNAL PyObject* llist_deepcopy(PyObject* obj, PyObject* memo);
+
+/* Store copy of obj in memo dictionary used by copy.deepcopy().
+ * Returns 0 on failure. */
+LLIST_INTERNAL int llist_memo_store(PyObject* memo,
+                                    PyObject* obj,
+                                    PyObject* copy);
+
+/* Create a weak reference to list, which is shared by all its nodes.
+ * The reference has a (no-op) callback, so it is never shared with
+ * references created by other code. */
+LLIST_INTERNAL PyObject* llist_new_owner_ref(PyObject* list);
+
+/* Return 1 if value is an instance of a builtin type which holds no
+ * references to other objects (None, bool, int, float, complex, str or
+ * bytes), so it can never be a part of a reference cycle. */
+LLIST_INTERNAL int llist_is_atomic(PyObject* value);
+
+/* Setter of read-only attributes defined with PyGetSetDef. Raises the
+ * same error as read-only members (TypeError on Python 2 and
+ * AttributeError on Python 3). */
+LLIST_INTERNAL int llist_readonly_setter(PyObject* self,
+                                         PyObject* value,
+                                         void* closure);
+
+/* Return key(value), or value itself if key is NULL or None.
+ * Returns a new reference or NULL on failure. */
+LLIST_INTERNAL PyObject* llist_apply_key(PyObject* key, PyObject* value);
+
+/* Return 1 if func(value) is known to return value itself, like int()
+ * called with an int, so the call can be skipped. */
+LLIST_INTERNAL int llist_is_identity_call(PyObject* func, PyObject* value);
+
+/* Size of the garbage collector header preceding tracked objects.
+ * PyGC_Head is not a part of the public API since Python 3.9, so the
+ * size is measured by llist_utils_init() (it is 0 on free-threaded
+ * builds, which keep garbage collector state in the object header). */
+LLIST_INTERNAL Py_ssize_t llist_gc_head_size(void);
+
+/* Return memory used by obj itself (including the garbage collector
+ * header, like sys.getsizeof()), without objects referenced by it. */
+LLIST_INTERNAL Py_ssize_t llist_object_size(PyObject* obj);
+
 #endif /* UTILS_H */
@@ -0,0 +1,336 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import copy
+import gc
+import pickle
+import random
+import sys
+import weakref
+
+from llist_test_case import LListTestCase
+from py23_utils import py23_range, py23_xrange
+
+from llist import adllist
+
+
+class DerivedPicklableADLList(adllist):
+    pass
+
+
+class testadllist(LListTestCase):
+
+    def test_init_empty(self):
+        ll = adllist()
+        self.assertEqual(len(ll), 0)
+        self.assertEqual(ll.size, 0)
+        self.assertEqual(ll.capacity, 0)
+        self.assertEqual(list(ll), [])
+        self.assertTrue(ll.first is None)
+        self.assertTrue(ll.last is None)
+
+    def test_init_with_sequence(self):
+        ref = py23_range(0, 1024, 4)
+        ll = adllist(ref)
+        self.assertEqual(len(ll), len(ref))
+        self.assertEqual(ll.size, len(ref))
+        self.assertTrue(ll.capacity >= len(ref))
+        self.assertEqual(list(ll), ref)
+
+    def test_init_with_non_sequence(self):
+        self.assertRaises(TypeError, adllist, None)
+        self.assertRaises(TypeError, adllist, 1)
+
+    def test_repr(self):
+        self.assertEqual(repr(adllist()), 'adllist()')
+        self.assertEqual(repr(adllist([None, 1, 'abc'])),
+                         'adllist([None, 1, \'abc\'])')
+        self.assertEqual(str(adllist([None, 1, 'abc'])),
+                         'adllist([None, 1, abc])')
+
+    def test_repr_recursive_list(self):
+        ll = adllist([1])
+        ll.append(ll)
+        self.assertEqual(repr(ll), 'adllist([1, adllist(<...>)])')
+
+    def test_append_returns_slot(self):
+        ll = adllist()
+        a = ll.append('a')
+        b = ll.appendleft('b')
+        c = ll.appendright('c')
+        self.assertEqual(ll.slotvalue(a), 'a')
+        self.assertEqual(ll.slotvalue(b), 'b')
+        self.assertEqual(ll.slotvalue(c), 'c')
+        self.assertEqual(ll.first, b)
+        self.assertEqual(ll.last, c)
+        self.assertEqual(list(ll), ['b', 'a', 'c'])
+
+    def test_slots_survive_growth(self):
+        ll = adllist()
+        slots = [ll.append(i) for i in py23_xrange(1000)]
+        for i, slot in enumerate(slots):
+            self.assertEqual(ll.slotvalue(slot), i)
+
+    def test_insert(self):
+        ll = adllist([1, 3])
+        three = ll.slotat(1)
+        two = ll.insert(2, three)
+        four = ll.insert(4)
+        self.assertEqual(list(ll), [1, 2, 3, 4])
+        self.assertEqual(ll.insertbefore(0, ll.first), ll.first)
+        ll.insertafter(2.5, two)
+        self.assertEqual(ll.insertafter(5, four), ll.last)
+        self.assertEqual(list(ll), [0, 1, 2, 2.5, 3, 4, 5])
+
+    def test_insert_invalid_slot(self):
+        ll = adllist([1, 2])
+        self.assertRaises(TypeError, ll.insertbefore, 0, 'abc')
+        self.assertRaises(ValueError, ll.insertbefore, 0, -1)
+        self.assertRaises(ValueError, ll.insertafter, 0, 100)
+        removed = ll.first
+        ll.remove(removed)
+        self.assertRaises(ValueError, ll.insertafter, 0, removed)
+        self.assertEqual(list(ll), [2])
+
+    def test_remove(self):
+        ll = adllist()
+        slots = [ll.append(i) for i in py23_xrange(10)]
+        self.assertEqual(ll.remove(slots[3]), 3)
+        self.assertEqual(ll.remove(slots[0]), 0)
+        self.assertEqual(ll.remove(slots[9]), 9)
+        self.assertEqual(list(ll), [1, 2, 4, 5, 6, 7, 8])
+        self.assertEqual(ll.first, slots[1])
+        self.assertEqual(ll.last, slots[8])
+        self.assertRaises(ValueError, ll.remove, slots[3])
+
+    def test_delitem_last_reference(self):
+        # the list holds the only reference to each value
+        ll = adllist(['x' * i for i in py23_range(1, 6)])
+        del ll[1]
+        del ll[0]
+        self.assertEqual(list(ll), ['xxx', 'xxxx', 'xxxxx'])
+
+    def test_slot_reuse(self):
+        ll = adllist(py23_range(8))
+        capacity = ll.capacity
+        for i in py23_xrange(1000):
+            ll.remove(ll.first)
+            ll.append(i)
+        self.assertEqual(ll.capacity, capacity)
+        self.assertEqual(list(ll), py23_range(992, 1000))
+
+    def test_navigation(self):
+        ll = adllist([1, 2, 3])
+        slot = ll.first
+        self.assertTrue(ll.prevslot(slot) is None)
+        slot = ll.nextslot(slot)
+        self.assertEqual(ll.slotvalue(slot), 2)
+        slot = ll.nextslot(slot)
+        self.assertEqual(slot, ll.last)
+        self.assertTrue(ll.nextslot(slot) is None)
+        self.assertEqual(ll.slotvalue(ll.prevslot(slot)), 2)
+        self.assertEqual(list(ll.iterslots()),
+                         [ll.slotat(0), ll.slotat(1), ll.slotat(-1)])
+
+    def test_setslotvalue(self):
+        ll = adllist([1, 2])
+        ll.setslotvalue(ll.last, 'x')
+        self.assertEqual(list(ll), [1, 'x'])
+        self.assertRaises(ValueError, ll.setslotvalue, 5, 'y')
+
+    def test_pop(self):
+        ref = py23_range(100)
+        ll = adllist(ref)
+        while ref:
+            self.assertEqual(ll.popleft(), ref.pop(0))
+            if ref:
+                self.assertEqual(ll.pop(), ref.pop())
+        self.assertRaises(ValueError, ll.pop)
+        self.assertRaises(ValueError, ll.popleft)
+        self.assertRaises(ValueError, ll.popright)
+
+    def test_extend(self):
+        ll = adllist([1, 2])
+        ll.extend([3, 4])
+        ll.extendright(adllist([5]))
+        ll.extendleft([0, -1])
+        self.assertEqual(list(ll), [-1, 0, 1, 2, 3, 4, 5])
+        ll = adllist([1, 2, 3])
+        ll.extend(ll)
+        self.assertEqual(list(ll), [1, 2, 3, 1, 2, 3])
+        ll = adllist([1, 2, 3])
+        ll.extendleft(ll)
+        self.assertEqual(list(ll), [3, 2, 1, 1, 2, 3])
+
+    def test_sequence_protocol(self):
+        ref = py23_range(50)
+        ll = adllist(ref)
+        for idx in py23_range(len(ref)):
+            self.assertEqual(ll[idx], ref[idx])
+            self.assertEqual(ll[-idx - 1], ref[-idx - 1])
+        ll[10] = 'x'
+        ref[10] = 'x'
+        del ll[20]
+        del ref[20]
+        self.assertEqual(list(ll), ref)
+        self.assertTrue('x' in ll)
+        self.assertFalse(20 in ll)
+        self.assertRaises(IndexError, ll.__getitem__, len(ref))
+        self.assertRaises(IndexError, ll.__delitem__, len(ref))
+        self.assertEqual(list(ll + [1]), ref + [1])
+        self.assertEqual(list(adllist([1, 2]) * 2), [1, 2, 1, 2])
+
+    def test_compact(self):
+        ll = adllist()
+        ref = []
+        rng = random.Random(5)
+        for i in py23_xrange(500):
+            if ref and rng.random() < 0.3:
+                ll.remove(ll.slotat(rng.randint(0, len(ref) - 1)))
+                ref = [ll.slotvalue(s) for s in ll.iterslots()]
+            elif rng.random() < 0.5:
+                ll.appendleft(i)
+                ref.insert(0, i)
+            else:
+                ll.append(i)
+                ref.append(i)
+        ll.compact()
+        self.assertEqual(list(ll), ref)
+        self.assertEqual(list(ll.iterslots()), py23_range(len(ref)))
+        self.assertTrue(ll.capacity >= len(ref))
+        ll.append('end')
+        self.assertEqual(ll[-1], 'end')
+
+    def test_compact_empty(self):
+        ll = adllist([1, 2])
+        ll.clear()
+        ll.compact()
+        self.assertEqual(ll.capacity, 0)
+        ll.append(1)
+        self.assertEqual(list(ll), [1])
+
+    def test_iterator_invalidation(self):
+        ll = adllist(py23_range(10))
+        it = iter(ll)
+        next(it)
+        ll.popleft()
+        self.assertRaises(RuntimeError, next, it)
+        it = iter(ll)
+        next(it)
+        ll.compact()
+        self.assertRaises(RuntimeError, next, it)
+
+    def test_iterator_sees_inserted_values(self):
+        ll = adllist([1, 3])
+        it = iter(ll)
+        self.assertEqual(next(it), 1)
+        ll.insertafter(2, ll.first)
+        self.assertEqual(next(it), 2)
+        self.assertEqual(next(it), 3)
+        self.assertRaises(StopIteration, next, it)
+
+    def test_exhausted_iterator_stays_exhausted(self):
+        ll = adllist([1])
+        it = iter(ll)
+        self.assertEqual(next(it), 1)
+        self.assertRaises(StopIteration, next, it)
+        ll.append(2)
+        self.assertRaises(StopIteration, next, it)
+        self.assertEqual(list(it), [])
+
+    def test_compare(self):
+        self.assertEqual(adllist([1, 2]), adllist([1, 2]))
+        self.assertNotEqual(adllist([1, 2]), adllist([1]))
+        self.assertNotEqual(adllist([1, 2]), adllist([1, 3]))
+        self.assertTrue(adllist([1, 2]) < adllist([1, 3]))
+        self.assertTrue(adllist([1]) < adllist([1, 0]))
+        self.assertTrue(adllist([2]) >= adllist([1, 5]))
+        self.assertFalse(adllist([1]) == [1])
+        self.assertFalse(adllist([1]) == 1)
+        self.assertTrue(adllist([1]) != None)
+
+    def test_hash(self):
+        self.assertEqual(hash(adllist([1, 2])), hash(adllist([1, 2])))
+        self.assertNotEqual(hash(adllist([1, 2])), hash(adllist([2, 1])))
+
+    def test_weakref(self):
+        ll = adllist([1])
+        ref = weakref.ref(ll)
+        del ll
+        self.assertTrue(ref() is None)
+
+    def test_sizeof(self):
+        ll = adllist(py23_range(10))
+        empty_size = sys.getsizeof(adllist())
+        self.assertTrue(sys.getsizeof(ll) > empty_size)
+        size = sys.getsizeof(ll)
+        ll.pop()
+        # released slots remain allocated
+        self.assertEqual(sys.getsizeof(ll), size)
+
+    def test_cyclic_list_destruction(self):
+        ll = adllist()
+        ll.append(ll)
+        ref = weakref.ref(ll)
+        del ll
+        gc.collect()
+        self.assertTrue(ref() is None)
+
+    def test_copy(self):
+        values = [[1], 'abc', None]
+        ll = adllist(values)
+        copied = copy.copy(ll)
+        self.assertTrue(type(copied) is adllist)
+        self.assertEqual(copied, ll)
+        self.assertTrue(copied[0] is ll[0])
+        copied.append(1)
+        self.assertEqual(list(ll), values)
+        self.assertEqual(copy.copy(adllist()), adllist())
+
+    def test_copy_compacts_slots(self):
+        ll = adllist(py23_range(10))
+        for i in py23_range(5):
+            ll.popleft()
+        copied = copy.copy(ll)
+        self.assertEqual(list(copied.iterslots()), py23_range(5))
+        self.assertEqual(list(copied), py23_range(5, 10))
+
+    def test_deepcopy(self):
+        ll = adllist([[1], 'abc', None, [1]])
+        copied = copy.deepcopy(ll)
+        self.assertEqual(copied, ll)
+        self.assertTrue(copied[0] is not ll[0])
+        copied[0].append(2)
+        self.assertEqual(ll[0], [1])
+
+    def test_deepcopy_recursive_list(self):
+        ll = adllist([1])
+        ll.append(ll)
+        copied = copy.deepcopy(ll)
+        self.assertTrue(copied[1] is copied)
+        self.assertEqual(copied[0], 1)
+
+    def test_pickle(self):
+        ll = adllist(py23_range(100))
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertTrue(type(restored) is adllist)
+            self.assertEqual(restored, ll)
+        self.assertEqual(pickle.loads(pickle.dumps(adllist())), adllist())
+
+    def test_pickle_self_referential(self):
+        ll = adllist([1, 2])
+        ll.append(ll)
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertEqual(len(restored), 3)
+            self.assertEqual(list(restored)[:2], [1, 2])
+            self.assertTrue(restored[2] is restored)
+
+    def test_copy_subclass_with_state(self):
+        ll = DerivedPicklableADLList([1, 2])
+        ll.tag = 'x'
+        for copied in [copy.copy(ll), copy.deepcopy(ll),
+                       pickle.loads(pickle.dumps(ll))]:
+            self.assertTrue(type(copied) is DerivedPicklableADLList)
+            self.assertEqual(list(copied), [1, 2])
+            self.assertEqual(copied.tag, 'x')
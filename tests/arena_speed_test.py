@@ -0,0 +1,32 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Measures building, iterating and releasing large lists with nodes
+# allocated individually and from per-list arenas.
+from llist import sllist, dllist
+import time
+
+num = 300000
+
+
+def measure(container, arena):
+    start_time = time.time()
+    c = container(range(num), arena=arena)
+    built = time.time()
+    for value in c:
+        pass
+    iterated = time.time()
+    c.clear()
+    cleared = time.time()
+    return built - start_time, iterated - built, cleared - iterated
+
+
+for container in [dllist, sllist]:
+    for arena in [False, True]:
+        build, iterate, clear = measure(container, arena)
+        print("Completed %s/%s: build %.8f, iterate %.8f, "
+              "clear %.8f seconds" % (
+                  container.__name__,
+                  'arena' if arena else 'individual',
+                  build,
+                  iterate,
+                  clear))
@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Compares llist.asyncqueue with asyncio.Queue: throughput of a producer
+# and a consumer task, latency of passing an item between two tasks and
+# time of cancelling many waiting tasks (O(n) each in asyncio.Queue).
+from llist.asyncqueue import asyncqueue
+import asyncio
+import time
+
+num = 100000
+round_trips = 20000
+waiter_counts = [1000, 10000]
+
+
+async def throughput(queue_type):
+    q = queue_type(maxsize=64)
+
+    async def producer():
+        for i in range(num):
+            await q.put(i)
+
+    async def consumer():
+        for i in range(num):
+            await q.get()
+
+    start_time = time.time()
+    await asyncio.gather(producer(), consumer())
+    return time.time() - start_time
+
+
+async def latency(queue_type):
+    requests = queue_type()
+    responses = queue_type()
+
+    async def echo():
+        for i in range(round_trips):
+            responses.put_nowait(await requests.get())
+
+    task = asyncio.ensure_future(echo())
+    start_time = time.time()
+    for i in range(round_trips):
+        requests.put_nowait(i)
+        await responses.get()
+    elapsed = time.time() - start_time
+    await task
+    return elapsed / round_trips
+
+
+async def cancel_waiters(queue_type, count):
+    q = queue_type()
+    getters = [asyncio.ensure_future(q.get()) for i in range(count)]
+    await asyncio.sleep(0)
+
+    start_time = time.time()
+    # cancel the most recent waiters first, which are the furthest from
+    # the front of the queue of waiters
+    for getter in reversed(getters):
+        getter.cancel()
+    await asyncio.gather(*getters, return_exceptions=True)
+    return time.time() - start_time
+
+
+for queue_type in [asyncio.Queue, asyncqueue]:
+    name = queue_type.__name__
+    print("Completed %s/throughput in \t\t%.8f seconds" % (
+        name, asyncio.run(throughput(queue_type))))
+    print("Completed %s/latency in \t\t%.8f seconds per round trip" % (
+        name, asyncio.run(latency(queue_type))))
+    for count in waiter_counts:
+        print("Completed %s/cancel %d waiters in \t%.8f seconds" % (
+            name, count, asyncio.run(cancel_waiters(queue_type, count))))
@@ -0,0 +1,215 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import asyncio
+
+from llist_test_case import LListTestCase
+
+from llist import dllist, dllistnode
+from llist.asyncqueue import asyncqueue
+
+
+def run(coro):
+    return asyncio.run(coro)
+
+
+class testasyncqueue(LListTestCase):
+
+    def test_init_empty(self):
+        q = asyncqueue()
+        self.assertEqual(len(q), 0)
+        self.assertEqual(q.qsize(), 0)
+        self.assertEqual(q.maxsize, 0)
+        self.assertTrue(q.empty())
+        self.assertFalse(q.full())
+
+    def test_repr(self):
+        q = asyncqueue(2)
+        q.put_nowait(1)
+        self.assertEqual(repr(q), '<asyncqueue maxsize=2 qsize=1>')
+
+    def test_put_get_fifo(self):
+        async def main():
+            q = asyncqueue()
+            for i in range(10):
+                await q.put(i)
+            return [await q.get() for _ in range(10)]
+
+        self.assertEqual(run(main()), list(range(10)))
+
+    def test_put_returns_node(self):
+        q = asyncqueue()
+        node = q.put_nowait('abc')
+        self.assertTrue(isinstance(node, dllistnode))
+        self.assertEqual(node.value, 'abc')
+        self.assertEqual(run(q.put('def')).value, 'def')
+
+    def test_nowait_errors(self):
+        q = asyncqueue(1)
+        self.assertRaises(asyncio.QueueEmpty, q.get_nowait)
+        q.put_nowait(1)
+        self.assertTrue(q.full())
+        self.assertRaises(asyncio.QueueFull, q.put_nowait, 2)
+        self.assertEqual(q.get_nowait(), 1)
+
+    def test_get_waits_for_put(self):
+        async def main():
+            q = asyncqueue()
+            getter = asyncio.ensure_future(q.get())
+            await asyncio.sleep(0)
+            self.assertFalse(getter.done())
+            q.put_nowait('value')
+            return await getter
+
+        self.assertEqual(run(main()), 'value')
+
+    def test_put_waits_for_free_slot(self):
+        async def main():
+            q = asyncqueue(1)
+            q.put_nowait(1)
+            putter = asyncio.ensure_future(q.put(2))
+            await asyncio.sleep(0)
+            self.assertFalse(putter.done())
+            self.assertEqual(q.get_nowait(), 1)
+            node = await putter
+            self.assertEqual(node.value, 2)
+            return q.get_nowait()
+
+        self.assertEqual(run(main()), 2)
+
+    def test_cancelled_getter_is_removed(self):
+        async def main():
+            q = asyncqueue()
+            getters = [asyncio.ensure_future(q.get()) for _ in range(3)]
+            await asyncio.sleep(0)
+            self.assertEqual(len(q._getters), 3)
+            getters[1].cancel()
+            await asyncio.sleep(0)
+            self.assertEqual(len(q._getters), 2)
+            q.put_nowait('a')
+            q.put_nowait('b')
+            return [await getters[0], await getters[2]]
+
+        self.assertEqual(run(main()), ['a', 'b'])
+
+    def test_cancelled_putter_is_removed(self):
+        async def main():
+            q = asyncqueue(1)
+            q.put_nowait(0)
+            putters = [asyncio.ensure_future(q.put(i)) for i in (1, 2)]
+            await asyncio.sleep(0)
+            putters[0].cancel()
+            await asyncio.sleep(0)
+            self.assertEqual(len(q._putters), 1)
+            self.assertEqual(q.get_nowait(), 0)
+            await putters[1]
+            return q.get_nowait()
+
+        self.assertEqual(run(main()), 2)
+
+    def test_woken_cancelled_getter_passes_item_on(self):
+        async def main():
+            q = asyncqueue()
+            first = asyncio.ensure_future(q.get())
+            second = asyncio.ensure_future(q.get())
+            await asyncio.sleep(0)
+            q.put_nowait('value')
+            first.cancel()
+            return await second
+
+        self.assertEqual(run(main()), 'value')
+
+    def test_cancel_item(self):
+        q = asyncqueue()
+        nodes = [q.put_nowait(i) for i in range(5)]
+        self.assertTrue(q.cancel(nodes[1]))
+        self.assertTrue(q.cancel(nodes[3]))
+        self.assertFalse(q.cancel(nodes[3]))
+        self.assertEqual(len(q), 3)
+        self.assertEqual([q.get_nowait() for _ in range(3)], [0, 2, 4])
+        self.assertFalse(q.cancel(nodes[0]))
+        self.assertFalse(q.cancel(dllistnode(1)))
+
+    def test_cancel_invalid_node(self):
+        q = asyncqueue()
+        self.assertRaises(TypeError, q.cancel, None)
+        other = dllist([1])
+        self.assertRaises(ValueError, q.cancel, other.first)
+        other_queue = asyncqueue()
+        self.assertRaises(ValueError, q.cancel, other_queue.put_nowait(1))
+
+    def test_cancel_item_wakes_up_putter(self):
+        async def main():
+            q = asyncqueue(1)
+            node = q.put_nowait(1)
+            putter = asyncio.ensure_future(q.put(2))
+            await asyncio.sleep(0)
+            q.cancel(node)
+            await putter
+            return q.get_nowait()
+
+        self.assertEqual(run(main()), 2)
+
+    def test_task_done_and_join(self):
+        async def main():
+            q = asyncqueue()
+            done = []
+
+            async def worker():
+                while True:
+                    item = await q.get()
+                    done.append(item)
+                    q.task_done()
+
+            for i in range(10):
+                q.put_nowait(i)
+            task = asyncio.ensure_future(worker())
+            await q.join()
+            task.cancel()
+            return done
+
+        self.assertEqual(run(main()), list(range(10)))
+
+    def test_join_with_cancelled_items(self):
+        async def main():
+            q = asyncqueue()
+            nodes = [q.put_nowait(i) for i in range(3)]
+            q.get_nowait()
+            q.task_done()
+            q.cancel(nodes[1])
+            q.cancel(nodes[2])
+            await asyncio.wait_for(q.join(), 1)
+
+        run(main())
+
+    def test_task_done_too_many_times(self):
+        q = asyncqueue()
+        self.assertRaises(ValueError, q.task_done)
+        q.put_nowait(1)
+        q.get_nowait()
+        q.task_done()
+        self.assertRaises(ValueError, q.task_done)
+
+    def test_producers_and_consumers(self):
+        async def main():
+            q = asyncqueue(8)
+            results = []
+
+            async def producer(idx):
+                for i in range(200):
+                    await q.put(idx * 200 + i)
+
+            async def consumer():
+                while True:
+                    item = await q.get()
+                    if item is None:
+                        return
+                    results.append(item)
+
+            consumers = [asyncio.ensure_future(consumer()) for _ in range(4)]
+            await asyncio.gather(*[producer(idx) for idx in range(4)])
+            for _ in consumers:
+                await q.put(None)
+            await asyncio.gather(*consumers)
+            return sorted(results)
+
+        self.assertEqual(run(main()), list(range(800)))
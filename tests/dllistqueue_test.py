@@ -0,0 +1,226 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import gc
+import threading
+import time
+import weakref
+
+try:
+    import queue
+except ImportError:
+    import Queue as queue
+
+from llist_test_case import LListTestCase
+from py23_utils import py23_range, py23_xrange
+
+from llist import dllist, dllistnode, dllistqueue
+
+
+NUM_THREADS = 4
+NUM_ITEMS = 2000
+
+
+class testdllistqueue(LListTestCase):
+
+    def test_init_empty(self):
+        q = dllistqueue()
+        self.assertEqual(len(q), 0)
+        self.assertEqual(q.qsize(), 0)
+        self.assertTrue(q.empty())
+
+    def test_init_with_arguments(self):
+        self.assertRaises(TypeError, dllistqueue, [1, 2])
+
+    def test_put_get_fifo(self):
+        q = dllistqueue()
+        for i in py23_xrange(10):
+            q.put(i)
+        self.assertEqual(len(q), 10)
+        self.assertFalse(q.empty())
+        self.assertEqual([q.get() for _ in py23_xrange(10)], py23_range(10))
+        self.assertTrue(q.empty())
+
+    def test_put_returns_node(self):
+        q = dllistqueue()
+        node = q.put('abc')
+        self.assertTrue(isinstance(node, dllistnode))
+        self.assertEqual(node.value, 'abc')
+        self.assertTrue(isinstance(node.owner(), dllist))
+        self.assertEqual(q.put_nowait('def').value, 'def')
+
+    def test_put_stores_nodes_as_values(self):
+        q = dllistqueue()
+        item = dllistnode(1)
+        q.put(item)
+        self.assertTrue(q.get() is item)
+
+    def test_put_accepts_block_and_timeout(self):
+        q = dllistqueue()
+        q.put(1, False)
+        q.put(2, block=True, timeout=0.5)
+        self.assertEqual(q.get(), 1)
+        self.assertEqual(q.get(), 2)
+
+    def test_get_nowait_from_empty_queue(self):
+        q = dllistqueue()
+        self.assertRaises(queue.Empty, q.get_nowait)
+        self.assertRaises(queue.Empty, q.get, False)
+        self.assertRaises(queue.Empty, q.get, block=False, timeout=10)
+
+    def test_get_nowait(self):
+        q = dllistqueue()
+        q.put_nowait(1)
+        q.put_nowait(2)
+        self.assertEqual(q.get_nowait(), 1)
+        self.assertEqual(q.get(False), 2)
+
+    def test_get_with_timeout(self):
+        q = dllistqueue()
+        start = time.time()
+        self.assertRaises(queue.Empty, q.get, timeout=0.1)
+        self.assertTrue(time.time() - start >= 0.09)
+        self.assertRaises(queue.Empty, q.get, True, 0)
+        q.put(1)
+        self.assertEqual(q.get(timeout=0.1), 1)
+
+    def test_get_with_invalid_timeout(self):
+        q = dllistqueue()
+        self.assertRaises(ValueError, q.get, timeout=-1)
+        self.assertRaises(ValueError, q.get, timeout=float('nan'))
+        self.assertRaises(OverflowError, q.get, timeout=1e300)
+        self.assertRaises(TypeError, q.get, timeout='1')
+
+    def test_get_waits_for_put(self):
+        q = dllistqueue()
+        results = []
+
+        thread = threading.Thread(
+            target=lambda: results.append(q.get(timeout=10)))
+        thread.start()
+        time.sleep(0.05)
+        q.put('value')
+        thread.join()
+
+        self.assertEqual(results, ['value'])
+        self.assertTrue(q.empty())
+
+    def test_get_releases_gil_while_waiting(self):
+        q = dllistqueue()
+        counter = [0]
+
+        def worker():
+            while counter[0] < 1000:
+                counter[0] += 1
+            q.put(counter[0])
+
+        thread = threading.Thread(target=worker)
+        thread.start()
+        self.assertEqual(q.get(timeout=10), 1000)
+        thread.join()
+
+    def test_cancel(self):
+        q = dllistqueue()
+        nodes = [q.put(i) for i in py23_xrange(5)]
+        self.assertTrue(q.cancel(nodes[0]))
+        self.assertTrue(q.cancel(nodes[2]))
+        self.assertTrue(q.cancel(nodes[4]))
+        self.assertEqual(len(q), 2)
+        self.assertEqual(nodes[2].value, 2)
+        self.assertTrue(nodes[2].owner is None)
+        self.assertEqual(q.get(), 1)
+        self.assertEqual(q.get(), 3)
+        self.assertTrue(q.empty())
+
+    def test_cancel_taken_node(self):
+        q = dllistqueue()
+        node = q.put(1)
+        self.assertEqual(q.get(), 1)
+        self.assertFalse(q.cancel(node))
+        node = q.put(2)
+        self.assertTrue(q.cancel(node))
+        self.assertFalse(q.cancel(node))
+        self.assertFalse(q.cancel(dllistnode(3)))
+
+    def test_cancel_invalid_node(self):
+        q = dllistqueue()
+        self.assertRaises(TypeError, q.cancel, None)
+        self.assertRaises(TypeError, q.cancel, 1)
+        other = dllist([1])
+        self.assertRaises(ValueError, q.cancel, other.first)
+        other_queue = dllistqueue()
+        self.assertRaises(ValueError, q.cancel, other_queue.put(1))
+        self.assertEqual(len(other_queue), 1)
+
+    def test_concurrent_put_get(self):
+        q = dllistqueue()
+        results = []
+        lock = threading.Lock()
+
+        def consumer():
+            values = []
+            while True:
+                value = q.get()
+                if value is None:
+                    break
+                values.append(value)
+            with lock:
+                results.extend(values)
+
+        def producer(idx):
+            for i in py23_xrange(NUM_ITEMS):
+                q.put(idx * NUM_ITEMS + i)
+
+        consumers = [threading.Thread(target=consumer)
+                     for _ in py23_xrange(NUM_THREADS)]
+        producers = [threading.Thread(target=producer, args=(idx,))
+                     for idx in py23_xrange(NUM_THREADS)]
+        for thread in consumers + producers:
+            thread.start()
+        for thread in producers:
+            thread.join()
+        for _ in py23_xrange(NUM_THREADS):
+            q.put(None)
+        for thread in consumers:
+            thread.join()
+
+        self.assertEqual(sorted(results),
+                         py23_range(NUM_THREADS * NUM_ITEMS))
+        self.assertTrue(q.empty())
+
+    def test_concurrent_cancel(self):
+        q = dllistqueue()
+        nodes = [q.put(i) for i in py23_xrange(NUM_ITEMS)]
+        taken = []
+        cancelled = []
+
+        def consumer():
+            try:
+                while True:
+                    taken.append(q.get_nowait())
+            except queue.Empty:
+                pass
+
+        thread = threading.Thread(target=consumer)
+        thread.start()
+        for node in reversed(nodes):
+            if q.cancel(node):
+                cancelled.append(node.value)
+        thread.join()
+
+        self.assertEqual(sorted(taken + cancelled), py23_range(NUM_ITEMS))
+        self.assertTrue(q.empty())
+
+    def test_weakref(self):
+        q = dllistqueue()
+        ref = weakref.ref(q)
+        self.assertTrue(ref() is q)
+        del q
+        self.assertTrue(ref() is None)
+
+    def test_cyclic_queue_destruction(self):
+        q = dllistqueue()
+        q.put(q)
+        ref = weakref.ref(q)
+        del q
+        gc.collect()
+        self.assertTrue(ref() is None)
@@ -0,0 +1,44 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Measures duration of a full garbage collection while large lists are
+# alive. Nodes holding atomic values (int, float, str, ...) are not
+# tracked by the garbage collector, so they add little to the pause.
+from collections import deque
+from llist import sllist, dllist, ullist, adllist
+import gc
+import time
+
+num = 300000
+repeats = 5
+
+
+def atomic_values():
+    return range(num)
+
+
+def container_values():
+    return [(i,) for i in range(num)]
+
+
+def measure_collect():
+    best = None
+    for i in range(repeats):
+        start_time = time.time()
+        gc.collect()
+        elapsed = time.time() - start_time
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+baseline = measure_collect()
+print("Completed empty/gc.collect in \t\t%.8f seconds" % baseline)
+
+for values in [atomic_values, container_values]:
+    for container in [list, deque, dllist, sllist, ullist, adllist]:
+        c = container(values())
+        elapsed = measure_collect()
+        print("Completed %s/%s/gc.collect in \t\t%.8f seconds" % (
+            container.__name__,
+            values.__name__,
+            elapsed))
+        del c
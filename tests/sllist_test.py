@@ -1,12 +1,19 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
+import copy
+import gc
+import pickle
 import sys
 import weakref
 
 from llist_test_case import LListTestCase
 from py23_utils import py23_cmp, py23_range, py23_xrange
 
-from llist import sllist, sllistnode
+from llist import drain, sllist, sllistnode
+
+
+class DerivedPicklableSLList(sllist):
+    pass
 
 
 class testsllist(LListTestCase):
@@ -437,6 +444,489 @@ class testsllist(LListTestCase):
         ll = sllist(py23_xrange(0, 100))
         self.assertEqual(50, ll[50])
 
+    def test_merge(self):
+        ll = sllist([1, 3, 3, 5])
+        other = sllist([2, 3, 4])
+        nodes = list(other.iternodes())
+        self.assertTrue(ll.merge(other) is None)
+        self.assertEqual(list(ll), [1, 2, 3, 3, 3, 4, 5])
+        self.assertEqual(len(ll), 7)
+        self.assertEqual(len(other), 0)
+        self.assertTrue(other.first is None)
+        self.assertTrue(other.last is None)
+        self.assertEqual([node() for node in nodes], [2, 3, 4])
+        for node in nodes:
+            self.assertTrue(node.owner() is ll)
+        self.assertTrue(ll.last is ll.nodeat(6))
+        ll.remove(nodes[1])
+        self.assertEqual(list(ll), [1, 2, 3, 3, 4, 5])
+
+    def test_merge_is_stable(self):
+        ll = sllist([(1, 'a'), (2, 'a')])
+        other = sllist([(1, 'b'), (2, 'b'), (3, 'b')])
+        ll.merge(other, key=lambda item: item[0])
+        self.assertEqual(list(ll),
+                         [(1, 'a'), (1, 'b'), (2, 'a'), (2, 'b'), (3, 'b')])
+
+    def test_merge_empty(self):
+        ll = sllist()
+        ll.merge(sllist([1, 2]))
+        self.assertEqual(list(ll), [1, 2])
+        ll.merge(sllist())
+        self.assertEqual(list(ll), [1, 2])
+
+    def test_merge_failed_comparison_keeps_lists(self):
+        ll = sllist([1, 3, 5])
+        # complex numbers are not ordered on Python 2 either
+        other = sllist([2, 1j, 4])
+        self.assertRaises(TypeError, ll.merge, other)
+        self.assertEqual(list(ll), [1, 3, 5])
+        self.assertEqual(list(other), [2, 1j, 4])
+        self.assertEqual(len(other), 3)
+        self.assertTrue(other.first.owner() is other)
+
+    def test_merge_failed_key_keeps_lists(self):
+        def key(value):
+            if value == 4:
+                raise RuntimeError
+            return value
+        ll = sllist([1, 3, 5])
+        other = sllist([2, 4])
+        self.assertRaises(RuntimeError, ll.merge, other, key)
+        self.assertEqual(list(ll), [1, 3, 5])
+        self.assertEqual(list(other), [2, 4])
+        self.assertTrue(other.last.owner() is other)
+
+    def test_merge_modified_by_key(self):
+        ll = sllist([1, 3, 5])
+        other = sllist([2, 4])
+        def clearing_key(value):
+            other.clear()
+            return value
+        self.assertRaises(ValueError, ll.merge, other, clearing_key)
+        self.assertEqual(list(ll), [1, 3, 5])
+        self.assertEqual(len(other), 0)
+
+        other = sllist([2, 4])
+        def removing_key(value):
+            if len(ll) == 3:
+                ll.remove(ll.last)
+            return value
+        self.assertRaises(ValueError, ll.merge, other, removing_key)
+        self.assertEqual(list(ll), [1, 3])
+        self.assertEqual(list(other), [2, 4])
+
+    def test_merge_with_invalid_argument(self):
+        ll = sllist([1])
+        self.assertRaises(TypeError, ll.merge, [1])
+        self.assertRaises(ValueError, ll.merge, ll)
+
+    def test_removeif(self):
+        ll = sllist(py23_range(10))
+        node = ll.nodeat(1)
+        self.assertEqual(ll.removeif(lambda value: value % 2 == 0), 5)
+        self.assertEqual(list(ll), [1, 3, 5, 7, 9])
+        self.assertEqual(len(ll), 5)
+        self.assertTrue(ll.first is node)
+        self.assertEqual(ll.last.value, 9)
+        self.assertEqual(ll.removeif(lambda value: value > 4, values=True),
+                         [5, 7, 9])
+        self.assertEqual(list(ll), [1, 3])
+        self.assertEqual(ll.last.value, 3)
+        ll.append(4)
+        self.assertEqual(list(ll), [1, 3, 4])
+
+    def test_removeif_all(self):
+        ll = sllist([1, 2, 3])
+        nodes = list(ll.iternodes())
+        self.assertEqual(ll.removeif(lambda value: True), 3)
+        self.assertEqual(len(ll), 0)
+        self.assertTrue(ll.first is None)
+        self.assertTrue(ll.last is None)
+        for node in nodes:
+            self.assertTrue(node.owner is None)
+            self.assertTrue(node.next is None)
+
+    def test_retain(self):
+        ll = sllist(['a', 'bb', 'c', 'dd'])
+        self.assertEqual(ll.retain(lambda value: len(value) == 1,
+                                   values=True), ['bb', 'dd'])
+        self.assertEqual(list(ll), ['a', 'c'])
+        self.assertEqual(ll.retain(lambda value: False), 2)
+        self.assertEqual(list(ll), [])
+
+    def test_removeif_with_failing_predicate(self):
+        ll = sllist([1, 2, 0, 4])
+        self.assertRaises(ZeroDivisionError, ll.removeif,
+                          lambda value: 1 // value == 1)
+        self.assertEqual(list(ll), [2, 0, 4])
+        self.assertRaises(TypeError, ll.removeif, None)
+
+    def test_removeif_list_modified_by_predicate(self):
+        ll = sllist([1, 2, 3])
+
+        def predicate(value):
+            ll.clear()
+            return False
+
+        self.assertRaises(ValueError, ll.removeif, predicate)
+        self.assertEqual(len(ll), 0)
+
+    def test_removenodes(self):
+        ll = sllist(py23_range(6))
+        nodes = list(ll.iternodes())
+        removed = [nodes[5], nodes[0], nodes[3]]
+        self.assertEqual(ll.removenodes(iter(removed)), [5, 0, 3])
+        self.assertEqual(list(ll), [1, 2, 4])
+        self.assertEqual(len(ll), 3)
+        self.assertTrue(ll.first is nodes[1])
+        self.assertTrue(ll.last is nodes[4])
+        for node in removed:
+            self.assertTrue(node.owner is None)
+            self.assertTrue(node.next is None)
+        self.assertEqual(ll.removenodes([]), [])
+        ll.appendnode(nodes[0])
+        self.assertEqual(list(ll), [1, 2, 4, 0])
+
+    def test_removenodes_validates_all_nodes(self):
+        ll = sllist([1, 2, 3])
+        other = sllist([4])
+        first = ll.first
+        self.assertRaises(ValueError, ll.removenodes, [first, first])
+        self.assertRaises(ValueError, ll.removenodes, [first, other.first])
+        self.assertRaises(ValueError, ll.removenodes, [first, sllistnode(5)])
+        self.assertRaises(TypeError, ll.removenodes, [first, 5])
+        self.assertRaises(TypeError, ll.removenodes, None)
+        self.assertEqual(list(ll), [1, 2, 3])
+        self.assertTrue(first.owner() is ll)
+        ll.remove(first)
+        self.assertEqual(list(ll), [2, 3])
+
+    def test_popleftn(self):
+        ll = sllist(py23_range(6))
+        nodes = list(ll.iternodes())
+        self.assertEqual(ll.popleftn(2), [0, 1])
+        self.assertEqual(list(ll), [2, 3, 4, 5])
+        self.assertEqual(len(ll), 4)
+        self.assertTrue(ll.first is nodes[2])
+        self.assertTrue(nodes[0].owner is None)
+        self.assertTrue(nodes[1].next is None)
+        self.assertEqual(ll.popleftn(0), [])
+        self.assertEqual(ll.popleftn(10), [2, 3, 4, 5])
+        self.assertEqual(len(ll), 0)
+        self.assertTrue(ll.first is None)
+        self.assertTrue(ll.last is None)
+        self.assertEqual(ll.popleftn(1), [])
+        ll.append(6)
+        self.assertEqual(list(ll), [6])
+
+    def test_poprightn(self):
+        ll = sllist(py23_range(6))
+        nodes = list(ll.iternodes())
+        self.assertEqual(ll.poprightn(2), [5, 4])
+        self.assertEqual(list(ll), [0, 1, 2, 3])
+        self.assertEqual(len(ll), 4)
+        self.assertTrue(ll.last is nodes[3])
+        self.assertTrue(nodes[3].next is None)
+        self.assertTrue(nodes[4].owner is None)
+        self.assertEqual(ll.poprightn(10), [3, 2, 1, 0])
+        self.assertEqual(len(ll), 0)
+        self.assertTrue(ll.first is None)
+        self.assertTrue(ll.last is None)
+        ll.appendleft(6)
+        self.assertEqual(list(ll), [6])
+
+    def test_popn_invalid_count(self):
+        ll = sllist([1, 2, 3])
+        self.assertRaises(TypeError, ll.popleftn, None)
+        self.assertRaises(TypeError, ll.poprightn, 1.0)
+        self.assertRaises(ValueError, ll.popleftn, -1)
+        self.assertRaises(ValueError, ll.poprightn, -1)
+        self.assertEqual(list(ll), [1, 2, 3])
+
+    def test_extendnodes(self):
+        ll = sllist([1, 2])
+        nodes = ll.extendnodes([3, 4])
+        self.assertEqual([node.value for node in nodes], [3, 4])
+        self.assertEqual(list(ll), [1, 2, 3, 4])
+        self.assertEqual(len(ll), 4)
+        self.assertTrue(nodes[-1] is ll.last)
+        self.assertTrue(nodes[0].owner() is ll)
+        ll.remove(nodes[0])
+        self.assertEqual(list(ll), [1, 2, 4])
+        self.assertEqual(ll.extendnodes([]), [])
+
+    def test_extendnodes_with_self(self):
+        ll = sllist([1, 2])
+        nodes = ll.extendnodes(ll)
+        self.assertEqual([node.value for node in nodes], [1, 2])
+        self.assertEqual(list(ll), [1, 2, 1, 2])
+        self.assertTrue(nodes[-1] is ll.last)
+
+    def test_extendleftnodes(self):
+        ll = sllist([3])
+        nodes = ll.extendleftnodes(py23_range(3))
+        self.assertEqual([node.value for node in nodes], [0, 1, 2])
+        self.assertEqual(list(ll), [2, 1, 0, 3])
+        self.assertEqual(len(ll), 4)
+        self.assertTrue(nodes[-1] is ll.first)
+        self.assertEqual(ll.extendleftnodes(sllist()), [])
+
+    def test_dedupe(self):
+        ll = sllist([3, 1, 3, 2, 1, 3])
+        first = ll.first
+        third = ll.nodeat(2)
+        self.assertEqual(ll.dedupe(), 3)
+        self.assertEqual(list(ll), [3, 1, 2])
+        self.assertEqual(len(ll), 3)
+        self.assertTrue(ll.first is first)
+        self.assertEqual(ll.last.value, 2)
+        self.assertTrue(third.owner is None)
+        self.assertEqual(ll.dedupe(), 0)
+        self.assertEqual(sllist().dedupe(), 0)
+
+    def test_dedupe_key(self):
+        ll = sllist(['a', 'B', 'A', 'b', 'c'])
+        self.assertEqual(ll.dedupe(key=str.lower), 2)
+        self.assertEqual(list(ll), ['a', 'B', 'c'])
+        ll = sllist([[1], [1]])
+        self.assertRaises(TypeError, ll.dedupe)
+        self.assertEqual(ll.dedupe(key=tuple), 1)
+        self.assertEqual(list(ll), [[1]])
+
+    def test_dedupe_modified_by_key(self):
+        ll = sllist(py23_range(5))
+        def key(value):
+            if value == 2:
+                ll.clear()
+            return value
+        self.assertRaises(ValueError, ll.dedupe, key)
+        self.assertEqual(list(ll), [])
+
+    def test_dedupeadjacent(self):
+        ll = sllist([1, 1, 2, 2, 2, 1, 3, 3])
+        self.assertEqual(ll.dedupeadjacent(), 4)
+        self.assertEqual(list(ll), [1, 2, 1, 3])
+        self.assertEqual(len(ll), 4)
+        self.assertEqual(ll.last.value, 3)
+        ll = sllist([[1], [1], [2]])
+        self.assertEqual(ll.dedupeadjacent(), 1)
+        self.assertEqual(list(ll), [[1], [2]])
+        ll = sllist(['a', 'A', 'b', 'a'])
+        self.assertEqual(ll.dedupeadjacent(key=str.lower), 1)
+        self.assertEqual(list(ll), ['a', 'b', 'a'])
+
+    def test_splitafter(self):
+        ll = sllist(py23_range(5))
+        nodes = list(ll.iternodes())
+        tail = ll.splitafter(nodes[1])
+        self.assertTrue(type(tail) is sllist)
+        self.assertEqual(list(ll), [0, 1])
+        self.assertEqual(len(ll), 2)
+        self.assertTrue(ll.last is nodes[1])
+        self.assertTrue(nodes[1].next is None)
+        self.assertEqual(list(tail), [2, 3, 4])
+        self.assertEqual(len(tail), 3)
+        self.assertTrue(tail.first is nodes[2])
+        self.assertTrue(tail.last is nodes[4])
+        self.assertTrue(nodes[2].owner() is tail)
+        self.assertTrue(nodes[0].owner() is ll)
+        tail.remove(nodes[3])
+        self.assertEqual(list(tail), [2, 4])
+        self.assertEqual(list(ll.splitafter(ll.last)), [])
+        self.assertEqual(list(ll), [0, 1])
+
+    def test_splitbefore(self):
+        ll = sllist(py23_range(4))
+        nodes = list(ll.iternodes())
+        tail = ll.splitbefore(nodes[2])
+        self.assertEqual(list(ll), [0, 1])
+        self.assertEqual(list(tail), [2, 3])
+        self.assertTrue(tail.first is nodes[2])
+        head = ll.splitbefore(ll.first)
+        self.assertEqual(list(head), [0, 1])
+        self.assertEqual(list(ll), [])
+        self.assertEqual(len(ll), 0)
+        self.assertTrue(ll.first is None)
+        self.assertTrue(ll.last is None)
+        ll.append(5)
+        self.assertEqual(list(ll), [5])
+
+    def test_split_invalid_node(self):
+        ll = sllist([1, 2])
+        other = sllist([3])
+        self.assertRaises(TypeError, ll.splitafter, 1)
+        self.assertRaises(TypeError, ll.splitbefore, None)
+        self.assertRaises(ValueError, ll.splitafter, other.first)
+        self.assertRaises(ValueError, ll.splitbefore, sllistnode(4))
+        self.assertEqual(list(ll), [1, 2])
+
+    def test_split_keeps_options(self):
+        ll = sllist(py23_range(4), deferred=True, arena=True)
+        tail = ll.splitafter(ll.first)
+        self.assertTrue(tail.deferred)
+        self.assertEqual(tail.arena, ll.arena)
+
+    def test_splitbefore_prev_hint(self):
+        ll = sllist(py23_range(5))
+        nodes = list(ll.iternodes())
+        tail = ll.splitbefore(nodes[3], nodes[2])
+        self.assertEqual(list(ll), [0, 1, 2])
+        self.assertEqual(list(tail), [3, 4])
+        self.assertRaises(ValueError, ll.splitbefore, nodes[2], nodes[0])
+        self.assertRaises(TypeError, ll.splitbefore, nodes[2], 1)
+        self.assertEqual(list(ll), [0, 1, 2])
+
+    def test_partition(self):
+        ll = sllist(py23_range(7))
+        nodes = list(ll.iternodes())
+        even = ll.partition(lambda x: x % 2 == 0)
+        self.assertTrue(type(even) is sllist)
+        self.assertEqual(list(even), [0, 2, 4, 6])
+        self.assertEqual(len(even), 4)
+        self.assertEqual(list(ll), [1, 3, 5])
+        self.assertEqual(len(ll), 3)
+        self.assertTrue(even.first is nodes[0])
+        self.assertTrue(even.last is nodes[6])
+        self.assertTrue(ll.first is nodes[1])
+        self.assertTrue(ll.last is nodes[5])
+        self.assertTrue(nodes[2].owner() is even)
+        self.assertTrue(nodes[3].owner() is ll)
+        ll.append(7)
+        even.append(8)
+        self.assertEqual(list(ll), [1, 3, 5, 7])
+        self.assertEqual(list(even), [0, 2, 4, 6, 8])
+        self.assertEqual(list(sllist().partition(bool)), [])
+
+    def test_partition_error_leaves_list_unchanged(self):
+        ll = sllist(py23_range(5))
+        def predicate(value):
+            if value == 3:
+                raise KeyError(value)
+            return True
+        self.assertRaises(KeyError, ll.partition, predicate)
+        self.assertEqual(list(ll), [0, 1, 2, 3, 4])
+        self.assertRaises(TypeError, ll.partition, None)
+
+    def test_partition_modified_by_predicate(self):
+        ll = sllist(py23_range(5))
+        def predicate(value):
+            if value == 2:
+                ll.clear()
+            return True
+        self.assertRaises(ValueError, ll.partition, predicate)
+        self.assertEqual(list(ll), [])
+
+    def test_rotateto(self):
+        ll = sllist(py23_range(5))
+        nodes = list(ll.iternodes())
+        ll.rotateto(nodes[3])
+        self.assertEqual(list(ll), [3, 4, 0, 1, 2])
+        self.assertTrue(ll.first is nodes[3])
+        self.assertTrue(ll.last is nodes[2])
+        self.assertTrue(nodes[2].next is None)
+        self.assertEqual(len(ll), 5)
+        ll.rotateto(nodes[3])
+        self.assertEqual(list(ll), [3, 4, 0, 1, 2])
+        ll.append(5)
+        self.assertEqual(list(ll), [3, 4, 0, 1, 2, 5])
+
+    def test_rotateafter(self):
+        ll = sllist(py23_range(5))
+        nodes = list(ll.iternodes())
+        ll.rotateafter(nodes[1])
+        self.assertEqual(list(ll), [2, 3, 4, 0, 1])
+        self.assertTrue(ll.first is nodes[2])
+        self.assertTrue(ll.last is nodes[1])
+        ll.rotateafter(nodes[1])
+        self.assertEqual(list(ll), [2, 3, 4, 0, 1])
+        ll.appendleft(5)
+        self.assertEqual(list(ll), [5, 2, 3, 4, 0, 1])
+
+    def test_rotateto_invalid_node(self):
+        ll = sllist([1, 2])
+        other = sllist([3])
+        self.assertRaises(TypeError, ll.rotateto, 1)
+        self.assertRaises(TypeError, ll.rotateafter, None)
+        self.assertRaises(ValueError, ll.rotateto, other.first)
+        self.assertRaises(ValueError, ll.rotateafter, sllistnode(4))
+        self.assertEqual(list(ll), [1, 2])
+
+    def test_rotateto_prev_hint(self):
+        ll = sllist(py23_range(4))
+        nodes = list(ll.iternodes())
+        ll.rotateto(nodes[2], nodes[1])
+        self.assertEqual(list(ll), [2, 3, 0, 1])
+        self.assertRaises(ValueError, ll.rotateto, nodes[3], nodes[0])
+        self.assertEqual(list(ll), [2, 3, 0, 1])
+
+    def test_apply(self):
+        ll = sllist(py23_range(4))
+        nodes = list(ll.iternodes())
+        self.assertTrue(ll.apply(lambda x: x * 10) is None)
+        self.assertEqual(list(ll), [0, 10, 20, 30])
+        self.assertEqual(nodes[1].value, 10)
+        ll.apply(str)
+        self.assertEqual(list(ll), ['0', '10', '20', '30'])
+        ll.apply(int)
+        self.assertEqual(list(ll), [0, 10, 20, 30])
+        self.assertRaises(TypeError, ll.apply, None)
+        sllist().apply(len)
+
+    def test_apply_updates_gc_tracking(self):
+        ll = sllist([1, 2])
+        ll.apply(lambda x: [x])
+        self.assertTrue(gc.is_tracked(ll.first))
+        ll.apply(len)
+        self.assertFalse(gc.is_tracked(ll.first))
+
+    def test_apply_error(self):
+        ll = sllist(py23_range(4))
+        def func(value):
+            if value == 2:
+                raise KeyError(value)
+            return -value
+        self.assertRaises(KeyError, ll.apply, func)
+        self.assertEqual(list(ll), [0, -1, 2, 3])
+        def modify(value):
+            ll.clear()
+            return value
+        self.assertRaises(ValueError, ll.apply, modify)
+
+    def test_itercycle(self):
+        ll = sllist([1, 2, 3])
+        it = ll.itercycle()
+        self.assertEqual([next(it) for i in py23_range(7)],
+                         [1, 2, 3, 1, 2, 3, 1])
+        ll.append(4)
+        self.assertEqual([next(it) for i in py23_range(4)], [2, 3, 4, 1])
+        ll.clear()
+        self.assertRaises(StopIteration, next, it)
+        ll.append(5)
+        self.assertRaises(StopIteration, next, it)
+        self.assertEqual(list(sllist().itercycle()), [])
+
+    def test_itercyclenodes(self):
+        ll = sllist([1, 2, 3])
+        nodes = list(ll.iternodes())
+        it = ll.itercyclenodes()
+        self.assertEqual([next(it) for i in py23_range(4)],
+                         nodes + [nodes[0]])
+        self.assertTrue(next(it) is nodes[1])
+        ll.remove(nodes[1])
+        self.assertTrue(next(it) is nodes[0])
+
+    def test_node_wrap_attributes(self):
+        ll = sllist([1, 2, 3])
+        self.assertTrue(ll.last.nextwrap is ll.first)
+        self.assertTrue(ll.first.nextwrap is ll.first.next)
+        single = sllist([1])
+        self.assertTrue(single.first.nextwrap is single.first)
+        self.assertTrue(sllistnode(1).nextwrap is None)
+        node = ll.last
+        ll.remove(node)
+        self.assertTrue(node.nextwrap is None)
+
     def test_remove_from_n_elem(self):
         ll = sllist()
         nn = sllistnode()
@@ -445,6 +935,93 @@ class testsllist(LListTestCase):
         ll.remove(to_del)
         self.assertEqual(None, None)
 
+    def test_remove_with_prev_hint(self):
+        ll = sllist(py23_xrange(5))
+        prev = ll.nodeat(1)
+        self.assertEqual(ll.remove(ll.nodeat(2), prev), 2)
+        self.assertEqual(ll.remove(ll.last, prev=ll.nodeat(2)), 4)
+        self.assertEqual(ll.last.value, 3)
+        self.assertEqual(ll.remove(ll.first, prev=None), 0)
+        self.assertEqual(list(ll), [1, 3])
+        self.assertEqual(len(ll), 2)
+
+    def test_remove_with_invalid_prev_hint(self):
+        ll = sllist(py23_xrange(5))
+        other = sllist(py23_xrange(5))
+        self.assertRaises(ValueError, ll.remove, ll.nodeat(3), ll.nodeat(1))
+        self.assertRaises(ValueError, ll.remove, ll.first, ll.last)
+        self.assertRaises(ValueError, ll.remove, ll.nodeat(1), other.first)
+        self.assertRaises(TypeError, ll.remove, ll.nodeat(1), 0)
+        self.assertEqual(list(ll), list(py23_xrange(5)))
+
+    def test_filter_with_prev_hint(self):
+        ll = sllist(py23_xrange(100))
+        prev = None
+        node = ll.first
+        while node is not None:
+            next = node.next
+            if node.value % 3 != 0:
+                ll.remove(node, prev)
+            else:
+                prev = node
+            node = next
+        self.assertEqual(list(ll), list(py23_xrange(0, 100, 3)))
+        self.assertEqual(ll.last.value, 99)
+        self.assertEqual(len(ll), 34)
+
+    def test_removeafter(self):
+        ll = sllist(py23_xrange(5))
+        self.assertTrue(ll.removeafter(ll.first) is ll.nodeat(1))
+        self.assertEqual(list(ll), [0, 2, 3, 4])
+        self.assertTrue(ll.removeafter(ll.nodeat(2)) is None)
+        self.assertEqual(list(ll), [0, 2, 3])
+        self.assertEqual(ll.last.value, 3)
+        self.assertEqual(len(ll), 3)
+        ll.append(5)
+        self.assertEqual(list(ll), [0, 2, 3, 5])
+
+    def test_removeafter_filter(self):
+        ll = sllist(py23_xrange(20))
+        prev = ll.first
+        while prev.next is not None:
+            if prev.next.value % 2:
+                ll.removeafter(prev)
+            else:
+                prev = prev.next
+        self.assertEqual(list(ll), list(py23_xrange(0, 20, 2)))
+        self.assertEqual(ll.last.value, 18)
+
+    def test_popafter(self):
+        ll = sllist(py23_xrange(4))
+        removed = ll.nodeat(1)
+        self.assertEqual(ll.popafter(ll.first), 1)
+        self.assertRaises(ValueError, ll.popafter, removed)
+        self.assertTrue(removed.next is None)
+        self.assertEqual(ll.popafter(ll.nodeat(1)), 3)
+        self.assertEqual(list(ll), [0, 2])
+        self.assertEqual(ll.last.value, 2)
+        self.assertEqual(len(ll), 2)
+
+    def test_popafter_invalid_node(self):
+        ll = sllist([1, 2])
+        other = sllist([1, 2])
+        self.assertRaises(ValueError, ll.popafter, ll.last)
+        self.assertRaises(ValueError, ll.popafter, other.first)
+        self.assertRaises(ValueError, ll.removeafter, sllistnode(1))
+        self.assertRaises(TypeError, ll.popafter, None)
+        self.assertEqual(list(ll), [1, 2])
+
+    def test_insert_before_with_prev_hint(self):
+        ll = sllist([1, 3])
+        node = ll.insertbefore(2, ll.last, prev=ll.first)
+        self.assertEqual(list(ll), [1, 2, 3])
+        self.assertTrue(ll.first.next is node)
+        ll.insertbefore(0, ll.first, None)
+        self.assertEqual(list(ll), [0, 1, 2, 3])
+        self.assertRaises(ValueError, ll.insertbefore, 5, ll.last, ll.first)
+        self.assertEqual(list(ll), [0, 1, 2, 3])
+        self.assertEqual(len(ll), 4)
+
     def test_insert_after(self):
         ll = sllist([1, 3, '123'])
         ll.insertafter(100, ll.first)
@@ -1091,6 +1668,80 @@ class testsllist(LListTestCase):
         self.assertEqual(hash(sllist([0, 2])), hash(sllist([0.0, 2.0])))
         self.assertNotEqual(hash(sllist([1, 2])), hash(sllist([2, 1])))
 
+    def test_copy(self):
+        values = [[1], 'abc', None]
+        ll = sllist(values)
+        copied = copy.copy(ll)
+        self.assertTrue(type(copied) is sllist)
+        self.assertEqual(copied, ll)
+        self.assertEqual(copied.size, ll.size)
+        self.assertTrue(copied.first is not ll.first)
+        self.assertTrue(copied[0] is ll[0])
+        copied.append(1)
+        self.assertEqual(list(ll), values)
+        self.assertEqual(copy.copy(sllist()), sllist())
+
+    def test_deepcopy(self):
+        ll = sllist([[1], 'abc', None])
+        copied = copy.deepcopy(ll)
+        self.assertEqual(copied, ll)
+        self.assertTrue(copied[0] is not ll[0])
+        copied[0].append(2)
+        self.assertEqual(ll[0], [1])
+
+    def test_deepcopy_recursive_list(self):
+        ll = sllist([1])
+        ll.append(ll)
+        copied = copy.deepcopy(ll)
+        self.assertTrue(copied[1] is copied)
+        self.assertEqual(copied[0], 1)
+
+    def test_pickle(self):
+        ll = sllist([1, 'abc', None, [2.5]])
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertTrue(type(restored) is sllist)
+            self.assertEqual(restored, ll)
+            self.assertEqual(restored.size, ll.size)
+        self.assertEqual(pickle.loads(pickle.dumps(sllist())), sllist())
+
+        ll = sllist([1, 2], deferred=True)
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertEqual(restored, ll)
+            self.assertTrue(restored.deferred)
+        self.assertFalse(pickle.loads(pickle.dumps(sllist([1]))).deferred)
+
+        # arena is false in both lists on builds without arenas
+        ll = sllist([1, 2], arena=True)
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertEqual(restored, ll)
+            self.assertEqual(restored.arena, ll.arena)
+            self.assertFalse(restored.deferred)
+        restored = pickle.loads(pickle.dumps(
+            sllist([1], deferred=True, arena=True)))
+        self.assertTrue(restored.deferred)
+        self.assertFalse(pickle.loads(pickle.dumps(sllist([1]))).arena)
+
+    def test_pickle_self_referential(self):
+        ll = sllist([1, 2])
+        ll.append(ll)
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertEqual(restored.size, 3)
+            self.assertEqual(list(restored)[:2], [1, 2])
+            self.assertTrue(restored.last.value is restored)
+
+    def test_copy_subclass_with_state(self):
+        ll = DerivedPicklableSLList([1, 2])
+        ll.tag = 'x'
+        for copied in [copy.copy(ll), copy.deepcopy(ll),
+                       pickle.loads(pickle.dumps(ll))]:
+            self.assertTrue(type(copied) is DerivedPicklableSLList)
+            self.assertEqual(list(copied), [1, 2])
+            self.assertEqual(copied.tag, 'x')
+
     def test_list_can_be_subclassed(self):
         class DerivedList(sllist):
             pass
@@ -1099,6 +1750,213 @@ class testsllist(LListTestCase):
         class DerivedNode(sllistnode):
             pass
 
+    def test_nodes_with_atomic_values_are_not_gc_tracked(self):
+        ll = sllist([1, 2.5, 'abc', b'abc', None, True, [], (1,)])
+        tracked = [gc.is_tracked(node) for node in ll.iternodes()]
+        self.assertEqual(tracked,
+                         [False, False, False, False, False, False, True, True])
+        self.assertFalse(gc.is_tracked(sllistnode(1)))
+        self.assertTrue(gc.is_tracked(sllistnode([])))
+
+    def test_node_gc_tracking_follows_value(self):
+        ll = sllist([1, 2])
+        node = ll.first
+        node.value = []
+        self.assertTrue(gc.is_tracked(node))
+        node.value = 3
+        self.assertFalse(gc.is_tracked(node))
+        ll[1] = sllistnode({})
+        self.assertTrue(gc.is_tracked(ll.last))
+
+    def test_node_value_cannot_be_deleted(self):
+        node = sllist([1]).first
+        def delete_value():
+            del node.value
+        self.assertRaises(TypeError, delete_value)
+
+    def test_cycle_through_reassigned_value_is_collected(self):
+        ll = sllist([1])
+        ll.first.value = ll
+        ref = weakref.ref(ll)
+        del ll
+        gc.collect()
+        self.assertTrue(ref() is None)
+
+    def test_end_links_are_none(self):
+        node = sllistnode(1)
+        self.assertTrue(node.next is None)
+        self.assertTrue(node.owner is None)
+        ll = sllist()
+        self.assertTrue(ll.first is None)
+        self.assertTrue(ll.last is None)
+        ll.append(1)
+        self.assertTrue(ll.last.next is None)
+
+    def test_exhausted_iterator_stays_exhausted(self):
+        ll = sllist([1])
+        it = iter(ll)
+        self.assertEqual(next(it), 1)
+        self.assertRaises(StopIteration, next, it)
+        ll.append(2)
+        self.assertRaises(StopIteration, next, it)
+
+    def test_sizeof_includes_nodes(self):
+        ll = sllist([1, [], 'abc'])
+        node_sizes = sum(sys.getsizeof(node) for node in ll.iternodes())
+        self.assertEqual(sys.getsizeof(ll), sys.getsizeof(sllist()) + node_sizes)
+
+    def test_memory_stats(self):
+        ll = sllist(py23_range(10))
+        stats = ll.memory_stats()
+        self.assertEqual(stats['nodes'], 10)
+        self.assertEqual(stats['node_bytes'],
+                         sum(sys.getsizeof(node) for node in ll.iternodes()))
+        self.assertTrue(stats['ref_bytes'] > 0)
+        self.assertEqual(stats['pool_bytes'], 0)
+        self.assertEqual(stats['pinned_bytes'], 0)
+        self.assertEqual(sllist().memory_stats()['node_bytes'], 0)
+
+    def test_arena_attribute(self):
+        self.assertFalse(sllist().arena)
+        ll = sllist([1, 2], arena=True)
+        if not ll.arena:
+            return  # arenas are not supported by this build
+        self.assertTrue(copy.copy(ll).arena)
+        self.assertRaises(AttributeError, setattr, ll, 'arena', False)
+
+    def test_arena_blocks_released_with_nodes(self):
+        ll = sllist(py23_range(1000), arena=True)
+        if not ll.arena:
+            return  # arenas are not supported by this build
+        stats = ll.memory_stats()
+        self.assertTrue(stats['pool_bytes'] >= stats['node_bytes'])
+        self.assertEqual(stats['pinned_bytes'], 0)
+        node = ll.nodeat(500)
+        ll.clear()
+        stats = ll.memory_stats()
+        self.assertTrue(stats['pool_bytes'] > 0)
+        self.assertEqual(stats['pinned_bytes'], stats['pool_bytes'])
+        self.assertEqual(node.value, 500)
+        self.assertTrue(node.owner is None)
+        del node
+        self.assertEqual(ll.memory_stats()['pool_bytes'], 0)
+        ll.extend([1, 2, 3])
+        self.assertEqual(list(ll), [1, 2, 3])
+        self.assertTrue(ll.memory_stats()['pool_bytes'] > 0)
+
+    def test_arena_blocks_not_enlarged_for_detached_nodes(self):
+        ll = sllist(py23_range(5000), arena=True)
+        if not ll.arena:
+            return  # arenas are not supported by this build
+        kept = ll.nodeat(1000)
+        ll.remove(kept)
+        reserved = ll.memory_stats()['pool_bytes']
+        while ll.memory_stats()['pool_bytes'] == reserved:
+            ll.extend([0] * 100)
+        # new blocks have the minimum size of 16 KiB
+        self.assertEqual(ll.memory_stats()['pool_bytes'] - reserved,
+                         16 * 1024)
+        self.assertEqual(ll.memory_stats()['pinned_bytes'], 0)
+
+    def test_arena_node_outlives_list(self):
+        ll = sllist([[1], [2]], arena=True)
+        node = ll.last
+        del ll
+        gc.collect()
+        self.assertEqual(node.value, [2])
+        self.assertTrue(node.owner is None)
+
+    def test_arena_nodes_not_counted_by_gc(self):
+        if not sllist(arena=True).arena:
+            return  # arenas are not supported by this build
+        values = py23_range(1000)
+        gc.disable()
+        try:
+            gc.collect()
+            ll = sllist(values, arena=True)
+            arena_count = gc.get_count()[0]
+            gc.collect()
+            plain = sllist(values)
+            plain_count = gc.get_count()[0]
+        finally:
+            gc.enable()
+        # arena nodes do not count toward the generation 0 threshold
+        self.assertTrue(plain_count >= 1000)
+        self.assertTrue(arena_count < 100)
+        # but they are tracked, so cycles through them are collected
+        ll.append(ll)
+        ref = weakref.ref(ll)
+        del ll, plain
+        gc.collect()
+        self.assertTrue(ref() is None)
+
+    def test_deferred_attribute(self):
+        self.assertFalse(sllist().deferred)
+        ll = sllist([1, 2], deferred=True)
+        self.assertTrue(ll.deferred)
+        self.assertTrue(copy.copy(ll).deferred)
+        ll.deferred = False
+        self.assertFalse(ll.deferred)
+
+    def test_deferred_clear(self):
+        ll = sllist([set() for _ in py23_xrange(100)], deferred=True)
+        node = ll.first
+        value_ref = weakref.ref(ll.last.value)
+        ll.clear()
+        self.assertEqual(len(ll), 0)
+        self.assertIsNone(ll.first)
+        self.assertIsNone(node.owner)
+        # detached nodes are linked only until they are released
+        self.assertIsNone(node.next)
+        self.assertIsNone(node.nextwrap)
+        self.assertRaises(ValueError, ll.remove, node)
+        ll.append(1)
+        self.assertEqual(list(ll), [1])
+        self.assertIs(ll.first.owner(), ll)
+        self.assertEqual(drain(), 0)
+        self.assertIsNone(value_ref())
+        self.assertIsNone(node.next)
+
+    def test_deferred_detached_node_can_be_inserted(self):
+        ll = sllist([1, 2, 3], deferred=True)
+        first = ll.first
+        middle = ll.nodeat(1)
+        ll.clear()
+        self.assertIsNone(middle.owner)
+        other = sllist([0])
+        self.assertIs(other.appendnode(middle), middle)
+        self.assertIs(middle.owner(), other)
+        self.assertIsNone(first.owner)
+        other.insertnodebefore(first, other.first)
+        self.assertEqual(list(other), [1, 0, 2])
+
+        ll = sllist([4, 5], deferred=True)
+        node = ll.last
+        del ll
+        self.assertIsNone(node.owner)
+        self.assertIsNone(node.next)
+        other.appendnode(node)
+        self.assertIs(node.owner(), other)
+        self.assertEqual(list(other), [1, 0, 2, 5])
+        self.assertEqual(drain(), 0)
+
+    def test_deferred_del(self):
+        drain()
+        ll = sllist([set() for _ in py23_xrange(100)], deferred=True)
+        value_ref = weakref.ref(ll.first.value)
+        del ll
+        self.assertIsNotNone(value_ref())
+        self.assertEqual(drain(10), 90)
+        self.assertEqual(drain(), 0)
+        self.assertIsNone(value_ref())
+
+    def test_insertion_releases_pending_nodes(self):
+        ll = sllist(py23_xrange(100), deferred=True)
+        ll.clear()
+        for i in py23_xrange(100):
+            ll.append(i)
+        self.assertEqual(drain(), 0)
+
     def test_cyclic_list_destruction_does_not_release_extra_None_refs(self):
         def create_and_free_lists():
             for _ in range(10):
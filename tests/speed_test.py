@@ -1,7 +1,7 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 from collections import deque
-from llist import sllist, dllist
+from llist import sllist, dllist, ullist, adllist
 import time
 # import gc
 # gc.set_debug(gc.DEBUG_UNCOLLECTABLE | gc.DEBUG_STATS)
@@ -53,12 +53,15 @@ def popleft(stopwatch, c):
 
 
 def remove(stopwatch, c):
-    if isinstance(c, deque):
+    if isinstance(c, (deque, ullist)):
         for i in range(0, num, 2):
             with stopwatch:
                 c.remove(i)
     else:
-        nodes = list(c.iternodes())
+        if isinstance(c, adllist):
+            nodes = list(c.iterslots())
+        else:
+            nodes = list(c.iternodes())
         for i in range(0, num, 2):
             with stopwatch:
                 c.remove(nodes[i])
@@ -70,7 +73,7 @@ def index_iter(stopwatch, c):
             c[i]
 
 
-for container in [deque, dllist, sllist]:
+for container in [deque, dllist, sllist, ullist, adllist]:
     for operation in [append, appendleft, pop, popleft, remove, index_iter]:
         stopwatch = Stopwatch()
         c = container(range(num))
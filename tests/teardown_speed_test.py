@@ -0,0 +1,53 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Measures the longest pause caused by releasing a large list. Lists in
+# deferred mode hand their nodes over to llist.drain(), which releases
+# them in bounded slices instead of a single long pause.
+from llist import sllist, dllist, drain
+import time
+
+num = 300000
+slice_size = 10000
+
+
+def values():
+    return [(i,) for i in range(num)]
+
+
+def measure_clear(container, deferred):
+    c = container(values(), deferred=deferred)
+    start_time = time.time()
+    c.clear()
+    return time.time() - start_time
+
+
+def measure_del(container, deferred):
+    c = container(values(), deferred=deferred)
+    start_time = time.time()
+    del c
+    return time.time() - start_time
+
+
+def measure_drain():
+    longest = 0.0
+    pending = 1
+    while pending > 0:
+        start_time = time.time()
+        pending = drain(slice_size)
+        longest = max(longest, time.time() - start_time)
+    return longest
+
+
+for container in [dllist, sllist]:
+    for measure in [measure_clear, measure_del]:
+        for deferred in [False, True]:
+            elapsed = measure(container, deferred)
+            longest_slice = measure_drain()
+            print("Completed %s/%s/%s in \t\t%.8f seconds, "
+                  "longest drain(%d) took %.8f seconds" % (
+                      container.__name__,
+                      measure.__name__,
+                      'deferred' if deferred else 'immediate',
+                      elapsed,
+                      slice_size,
+                      longest_slice))
@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Measures throughput of list operations executed from multiple threads.
+# On free-threaded Python builds threads working on separate lists should
+# scale with the number of cores, while threads sharing a single list
+# are serialized by its lock.
+from collections import deque
+from llist import sllist, dllist, ullist, adllist
+import sys
+import threading
+import time
+
+num = 100000
+thread_counts = [1, 2, 4, 8]
+
+
+def append_popleft(c, count):
+    for i in range(count):
+        c.append(i)
+        c.popleft()
+
+
+def run(container, num_threads, shared):
+    shared_list = container()
+    lists = [shared_list if shared else container()
+             for i in range(num_threads)]
+    count = num // num_threads
+    threads = [threading.Thread(target=append_popleft, args=(c, count))
+               for c in lists]
+    start_time = time.time()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return time.time() - start_time
+
+
+gil_enabled = getattr(sys, '_is_gil_enabled', lambda: True)()
+print("GIL enabled: %s" % gil_enabled)
+
+for container in [deque, dllist, sllist, ullist, adllist]:
+    for shared in [False, True]:
+        for num_threads in thread_counts:
+            elapsed = run(container, num_threads, shared)
+            print("Completed %s/%s/%d threads in \t%.8f seconds:\t "
+                  "%.1f ops/sec" % (
+                      container.__name__,
+                      'shared' if shared else 'separate',
+                      num_threads,
+                      elapsed,
+                      num / elapsed if elapsed != 0 else float('inf')))
@@ -0,0 +1,143 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import threading
+
+from llist_test_case import LListTestCase
+from py23_utils import py23_xrange
+
+from llist import (adllist, dllist, dllist_i64, sllist, sllist_i64,
+                   ullist)
+
+
+NUM_THREADS = 4
+NUM_ITEMS = 2000
+
+
+def run_threads(target, *args):
+    threads = [threading.Thread(target=target, args=(i,) + args)
+               for i in py23_xrange(NUM_THREADS)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+
+class ThreadingTests(object):
+
+    def test_concurrent_append(self):
+        ll = self.list_type()
+
+        def worker(idx):
+            for i in py23_xrange(NUM_ITEMS):
+                if i % 2:
+                    ll.append(idx * NUM_ITEMS + i)
+                else:
+                    ll.appendleft(idx * NUM_ITEMS + i)
+
+        run_threads(worker)
+        self.assertEqual(len(ll), NUM_THREADS * NUM_ITEMS)
+        self.assertEqual(sorted(ll),
+                         list(py23_xrange(NUM_THREADS * NUM_ITEMS)))
+
+    def test_concurrent_append_pop(self):
+        ll = self.list_type()
+        popped = []
+
+        def worker(idx):
+            values = []
+            for i in py23_xrange(NUM_ITEMS):
+                ll.append(idx * NUM_ITEMS + i)
+                values.append(ll.popleft())
+            popped.extend(values)
+
+        run_threads(worker)
+        self.assertEqual(len(ll), 0)
+        self.assertEqual(sorted(popped),
+                         list(py23_xrange(NUM_THREADS * NUM_ITEMS)))
+
+    def test_concurrent_read_write(self):
+        ll = self.list_type(py23_xrange(100))
+        errors = []
+
+        def worker(idx):
+            for i in py23_xrange(NUM_ITEMS // 10):
+                if idx == 0:
+                    ll.append(i)
+                    ll.popleft()
+                    continue
+                try:
+                    values = list(ll)
+                except RuntimeError:
+                    # list changed size during iteration
+                    continue
+                if len(values) not in (100, 101):
+                    errors.append(len(values))
+                ll[50]
+                len(ll)
+
+        run_threads(worker)
+        self.assertEqual(errors, [])
+        self.assertEqual(len(ll), 100)
+
+
+class NodeThreadingTests(object):
+
+    def test_concurrent_node_and_item_assignment(self):
+        ll = self.list_type([[i] for i in py23_xrange(10)])
+        node = ll.nodeat(5)
+
+        def worker(idx):
+            for i in py23_xrange(NUM_ITEMS):
+                if idx % 2:
+                    node.value = [i]
+                else:
+                    ll[5] = self.list_type([[i]]).first
+                    ll.apply(list)
+                node.value
+                repr(node)
+
+        run_threads(worker)
+        self.assertEqual(len(ll), 10)
+        self.assertTrue(ll[5] is node.value)
+
+    def test_concurrent_node_walk(self):
+        ll = self.list_type(py23_xrange(100))
+
+        def worker(idx):
+            for i in py23_xrange(NUM_ITEMS // 10):
+                if idx == 0:
+                    ll.append(i)
+                    ll.popleft()
+                    continue
+                node = ll.first
+                while node is not None:
+                    node = node.next
+
+        run_threads(worker)
+        self.assertEqual(len(ll), 100)
+
+
+class testdllistthreading(ThreadingTests, NodeThreadingTests,
+                          LListTestCase):
+    list_type = dllist
+
+
+class testsllistthreading(ThreadingTests, NodeThreadingTests,
+                          LListTestCase):
+    list_type = sllist
+
+
+class testullistthreading(ThreadingTests, LListTestCase):
+    list_type = ullist
+
+
+class testadllistthreading(ThreadingTests, LListTestCase):
+    list_type = adllist
+
+
+class testdllisti64threading(ThreadingTests, LListTestCase):
+    list_type = dllist_i64
+
+
+class testsllisti64threading(ThreadingTests, LListTestCase):
+    list_type = sllist_i64
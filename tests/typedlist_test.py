@@ -0,0 +1,338 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import copy
+import pickle
+import sys
+import weakref
+
+from llist_test_case import LListTestCase
+from py23_utils import py23_range
+
+from llist import dllist, sllist
+from llist import dllist_i64, dllist_f64, sllist_i64, sllist_f64
+
+
+class TypedListTests(object):
+
+    list_type = None
+    value_type = None
+    other_list_type = None
+    untyped_list_type = None
+    hash_values = None
+
+    def make_list(self, values=None):
+        if values is None:
+            return self.list_type()
+        return self.list_type(values)
+
+    def test_init_empty(self):
+        ll = self.make_list()
+        self.assertEqual(len(ll), 0)
+        self.assertEqual(ll.size, 0)
+        self.assertEqual(list(ll), [])
+
+    def test_init_with_sequence(self):
+        ref = py23_range(0, 1024, 4)
+        ll = self.make_list(ref)
+        self.assertEqual(len(ll), len(ref))
+        self.assertEqual(ll.size, len(ref))
+        self.assertEqual(list(ll), ref)
+
+    def test_init_with_non_sequence(self):
+        self.assertRaises(TypeError, self.list_type, None)
+        self.assertRaises(TypeError, self.list_type, 1)
+
+    def test_values_are_converted(self):
+        ll = self.make_list([1, 2, True])
+        for value in ll:
+            self.assertTrue(type(value) is self.value_type)
+
+    def test_invalid_value(self):
+        ll = self.make_list([1, 2])
+        self.assertRaises(TypeError, ll.append, 'abc')
+        self.assertRaises(TypeError, ll.appendleft, None)
+        self.assertRaises(TypeError, ll.extend, [3, 'abc'])
+        self.assertEqual(list(ll), [1, 2, 3])
+
+    def test_repr(self):
+        name = self.list_type.__name__
+        self.assertEqual(repr(self.make_list()), name + '()')
+        self.assertEqual(repr(self.make_list([1, 2])),
+                         name + '(' + repr([self.value_type(1),
+                                            self.value_type(2)]) + ')')
+        self.assertEqual(str(self.make_list([1])),
+                         name + '(' + repr([self.value_type(1)]) + ')')
+
+    def test_append(self):
+        ll = self.make_list([1, 2])
+        self.assertTrue(ll.append(3) is None)
+        ll.appendright(4)
+        ll.appendleft(0)
+        self.assertEqual(list(ll), [0, 1, 2, 3, 4])
+        self.assertEqual(ll.size, 5)
+
+    def test_extend(self):
+        ll = self.make_list([1, 2])
+        ll.extend([3, 4])
+        ll.extendright(self.make_list([5]))
+        ll.extendleft([0, -1])
+        self.assertEqual(list(ll), [-1, 0, 1, 2, 3, 4, 5])
+
+    def test_extend_self(self):
+        ll = self.make_list([1, 2])
+        ll.extend(ll)
+        self.assertEqual(list(ll), [1, 2, 1, 2])
+        ll.extendleft(ll)
+        self.assertEqual(list(ll), [2, 1, 2, 1, 1, 2, 1, 2])
+
+    def test_pop(self):
+        ll = self.make_list([1, 2, 3])
+        self.assertEqual(ll.popleft(), 1)
+        self.assertEqual(ll.pop(), 3)
+        self.assertEqual(ll.popright(), 2)
+        self.assertEqual(len(ll), 0)
+        self.assertRaises(ValueError, ll.pop)
+        self.assertRaises(ValueError, ll.popleft)
+        self.assertRaises(ValueError, ll.popright)
+
+    def test_clear(self):
+        ll = self.make_list(py23_range(100))
+        ll.clear()
+        self.assertEqual(len(ll), 0)
+        self.assertEqual(list(ll), [])
+        ll.append(1)
+        self.assertEqual(list(ll), [1])
+
+    def test_remove(self):
+        ll = self.make_list([1, 2, 3, 2])
+        ll.remove(2)
+        self.assertEqual(list(ll), [1, 3, 2])
+        ll.remove(2)
+        ll.remove(1)
+        self.assertEqual(list(ll), [3])
+        self.assertRaises(ValueError, ll.remove, 5)
+        self.assertRaises(ValueError, ll.remove, 'abc')
+        ll.remove(3)
+        self.assertRaises(ValueError, ll.remove, 3)
+
+    def test_contains(self):
+        ll = self.make_list([1, 2, 3])
+        self.assertTrue(2 in ll)
+        self.assertTrue(2.0 in ll)
+        self.assertFalse(4 in ll)
+        self.assertFalse('abc' in ll)
+        self.assertFalse(None in ll)
+
+    def test_getitem(self):
+        ref = py23_range(0, 100, 3)
+        ll = self.make_list(ref)
+        for idx in py23_range(len(ref)):
+            self.assertEqual(ll[idx], ref[idx])
+        for idx in py23_range(1, len(ref) + 1):
+            self.assertEqual(ll[-idx], ref[-idx])
+        self.assertRaises(IndexError, ll.__getitem__, len(ref))
+        self.assertRaises(IndexError, ll.__getitem__, -len(ref) - 1)
+
+    def test_setitem(self):
+        ll = self.make_list([1, 2, 3])
+        ll[1] = 5
+        ll[-1] = 6
+        self.assertEqual(list(ll), [1, 5, 6])
+        self.assertRaises(IndexError, ll.__setitem__, 3, 1)
+        self.assertRaises(TypeError, ll.__setitem__, 0, 'abc')
+
+    def test_delitem(self):
+        ll = self.make_list([1, 2, 3, 4])
+        del ll[1]
+        self.assertEqual(list(ll), [1, 3, 4])
+        del ll[-1]
+        self.assertEqual(list(ll), [1, 3])
+        del ll[0]
+        self.assertEqual(list(ll), [3])
+        ll.append(5)
+        self.assertEqual(list(ll), [3, 5])
+        self.assertRaises(IndexError, ll.__delitem__, 2)
+
+    def test_rotate(self):
+        ref = py23_range(10)
+        for n in py23_range(-15, 15):
+            ll = self.make_list(ref)
+            ll.rotate(n)
+            shift = n % len(ref)
+            self.assertEqual(list(ll), ref[-shift:] + ref[:-shift])
+            ll.append(10)
+            self.assertEqual(ll[-1], 10)
+        self.assertRaises(TypeError, self.make_list([1, 2]).rotate, 'abc')
+
+    def test_rotate_overflow(self):
+        ll = self.make_list([1, 2, 3])
+        self.assertRaises(OverflowError, ll.rotate, 2 ** 70)
+        self.assertRaises(OverflowError, ll.rotate, -2 ** 70)
+        self.assertEqual(list(ll), [1, 2, 3])
+
+    def test_concat(self):
+        a = self.make_list([1, 2])
+        b = self.make_list([3])
+        c = a + b
+        self.assertTrue(type(c) is self.list_type)
+        self.assertEqual(list(c), [1, 2, 3])
+        c = a + [4]
+        self.assertEqual(list(c), [1, 2, 4])
+        a += b
+        self.assertEqual(list(a), [1, 2, 3])
+
+    def test_repeat(self):
+        ll = self.make_list([1, 2])
+        self.assertEqual(list(ll * 3), [1, 2, 1, 2, 1, 2])
+        self.assertEqual(list(ll * 0), [])
+
+    def test_compare(self):
+        self.assertEqual(self.make_list([1, 2]), self.make_list([1, 2]))
+        self.assertNotEqual(self.make_list([1, 2]), self.make_list([1]))
+        self.assertTrue(self.make_list([1, 2]) < self.make_list([1, 3]))
+        self.assertTrue(self.make_list([1]) < self.make_list([1, 0]))
+        self.assertTrue(self.make_list([2]) >= self.make_list([1, 5]))
+        self.assertFalse(self.make_list([1]) == [1])
+        self.assertFalse(self.make_list([1]) ==
+                         self.other_list_type([1]))
+
+    def test_hash(self):
+        self.assertEqual(hash(self.make_list([1, 2])),
+                         hash(self.make_list([1, 2])))
+        self.assertNotEqual(hash(self.make_list([1, 2])),
+                            hash(self.make_list([2, 1])))
+
+    def test_hash_matches_untyped_list(self):
+        for value in self.hash_values:
+            self.assertEqual(hash(self.make_list([value])),
+                             hash(self.untyped_list_type([value])))
+        self.assertEqual(hash(self.make_list(self.hash_values)),
+                         hash(self.untyped_list_type(self.hash_values)))
+
+    def test_copy(self):
+        ll = self.make_list([1, 2, 3])
+        cp = copy.copy(ll)
+        self.assertTrue(type(cp) is self.list_type)
+        self.assertEqual(cp, ll)
+        cp.append(4)
+        self.assertEqual(list(ll), [1, 2, 3])
+
+    def test_deepcopy_subclass(self):
+        class sub(self.list_type):
+            pass
+        ll = sub([1, 2])
+        ll.attr = [5]
+        cp = copy.deepcopy(ll)
+        self.assertTrue(type(cp) is sub)
+        self.assertEqual(list(cp), [1, 2])
+        self.assertEqual(cp.attr, [5])
+        self.assertFalse(cp.attr is ll.attr)
+
+    def test_pickle(self):
+        ll = self.make_list([1, 2, 3])
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            loaded = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertTrue(type(loaded) is self.list_type)
+            self.assertEqual(loaded, ll)
+        empty = pickle.loads(pickle.dumps(self.make_list()))
+        self.assertEqual(len(empty), 0)
+
+    def test_iterator_invalidation(self):
+        ll = self.make_list([1, 2, 3])
+        it = iter(ll)
+        next(it)
+        ll.popleft()
+        self.assertRaises(RuntimeError, next, it)
+
+    def test_exhausted_iterator_stays_exhausted(self):
+        ll = self.make_list([1])
+        it = iter(ll)
+        self.assertEqual(next(it), 1)
+        self.assertRaises(StopIteration, next, it)
+        ll.append(2)
+        self.assertRaises(StopIteration, next, it)
+        self.assertEqual(list(it), [])
+
+    def test_weakref(self):
+        ll = self.make_list([1])
+        ref = weakref.ref(ll)
+        self.assertTrue(ref() is ll)
+        del ll
+        self.assertTrue(ref() is None)
+
+    def test_subclass(self):
+        class sub(self.list_type):
+            pass
+        ll = sub([1, 2])
+        self.assertEqual(list(ll + [3]), [1, 2, 3])
+
+    def test_sizeof(self):
+        empty_size = sys.getsizeof(self.make_list())
+        one_size = sys.getsizeof(self.make_list([1]))
+        self.assertTrue(one_size > empty_size)
+        self.assertEqual(sys.getsizeof(self.make_list(py23_range(10))),
+                         empty_size + 10 * (one_size - empty_size))
+
+
+class IntListTests(TypedListTests):
+
+    value_type = int
+    hash_values = [0, 1, -1, -2, 2 ** 40, -2 ** 63, 2 ** 63 - 1]
+
+    def test_int_range(self):
+        ll = self.make_list([2 ** 63 - 1, -2 ** 63])
+        self.assertEqual(list(ll), [2 ** 63 - 1, -2 ** 63])
+        self.assertRaises(OverflowError, ll.append, 2 ** 63)
+        self.assertRaises(TypeError, ll.append, 1.5)
+
+    def test_contains_non_integral(self):
+        ll = self.make_list([1, 2])
+        self.assertFalse(1.5 in ll)
+        self.assertFalse(2 ** 64 in ll)
+
+
+class FloatListTests(TypedListTests):
+
+    value_type = float
+    hash_values = [0.0, -0.0, 1.0, -1.0, 0.5, 2.0 ** 40, 1e300,
+                   float('inf'), float('-inf')]
+
+    def test_float_values(self):
+        ll = self.make_list([0.5, -1e300, float('inf')])
+        self.assertEqual(list(ll), [0.5, -1e300, float('inf')])
+        self.assertTrue(0.5 in ll)
+        self.assertFalse(0.25 in ll)
+
+    def test_nan(self):
+        nan = float('nan')
+        ll = self.make_list([nan])
+        self.assertFalse(nan in ll)
+        self.assertNotEqual(ll, self.make_list([nan]))
+
+    def test_hash_signed_zero(self):
+        self.assertEqual(hash(self.make_list([0.0])),
+                         hash(self.make_list([-0.0])))
+
+
+class testdllist_i64(IntListTests, LListTestCase):
+    list_type = dllist_i64
+    other_list_type = dllist_f64
+    untyped_list_type = dllist
+
+
+class testdllist_f64(FloatListTests, LListTestCase):
+    list_type = dllist_f64
+    other_list_type = dllist_i64
+    untyped_list_type = dllist
+
+
+class testsllist_i64(IntListTests, LListTestCase):
+    list_type = sllist_i64
+    other_list_type = sllist_f64
+    untyped_list_type = sllist
+
+
+class testsllist_f64(FloatListTests, LListTestCase):
+    list_type = sllist_f64
+    other_list_type = sllist_i64
+    untyped_list_type = sllist
@@ -0,0 +1,372 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import copy
+import pickle
+import random
+import sys
+import weakref
+
+from llist_test_case import LListTestCase
+from py23_utils import py23_range, py23_xrange
+
+from llist import ullist
+
+
+class DerivedPicklableULList(ullist):
+    pass
+
+
+class testullist(LListTestCase):
+
+    def test_init_empty(self):
+        ll = ullist()
+        self.assertEqual(len(ll), 0)
+        self.assertEqual(ll.size, 0)
+        self.assertEqual(list(ll), [])
+
+    def test_init_with_sequence(self):
+        ref = py23_range(0, 1024, 4)
+        ll = ullist(ref)
+        self.assertEqual(len(ll), len(ref))
+        self.assertEqual(ll.size, len(ref))
+        self.assertEqual(list(ll), ref)
+
+    def test_init_with_iterable(self):
+        ll = ullist(x * 2 for x in py23_xrange(100))
+        self.assertEqual(list(ll), [x * 2 for x in py23_xrange(100)])
+
+    def test_init_with_non_sequence(self):
+        self.assertRaises(TypeError, ullist, None)
+        self.assertRaises(TypeError, ullist, 1)
+        self.assertRaises(TypeError, ullist, 1.5)
+
+    def test_str(self):
+        self.assertEqual(str(ullist()), 'ullist()')
+        self.assertEqual(str(ullist([None, 1, 'abc'])),
+                         'ullist([None, 1, abc])')
+
+    def test_repr(self):
+        self.assertEqual(repr(ullist()), 'ullist()')
+        self.assertEqual(repr(ullist([None, 1, 'abc'])),
+                         'ullist([None, 1, \'abc\'])')
+
+    def test_repr_recursive_list(self):
+        ll = ullist([1])
+        ll.append(ll)
+        self.assertEqual(repr(ll), 'ullist([1, ullist(<...>)])')
+
+    def test_append(self):
+        ll = ullist()
+        ref = []
+        for i in py23_xrange(100):
+            self.assertTrue(ll.append(i) is None)
+            ref.append(i)
+            ll.appendleft(-i)
+            ref.insert(0, -i)
+            ll.appendright(i * 10)
+            ref.append(i * 10)
+        self.assertEqual(list(ll), ref)
+        self.assertEqual(len(ll), len(ref))
+
+    def test_extend(self):
+        ll = ullist([1, 2])
+        ll.extend([3, 4])
+        ll.extendright(ullist([5]))
+        ll.extendleft([0, -1])
+        self.assertEqual(list(ll), [-1, 0, 1, 2, 3, 4, 5])
+
+    def test_extend_self(self):
+        ref = py23_range(50)
+        ll = ullist(ref)
+        ll.extend(ll)
+        self.assertEqual(list(ll), ref + ref)
+        ll = ullist(ref)
+        ll.extendleft(ll)
+        self.assertEqual(list(ll), ref[::-1] + ref)
+
+    def test_insert(self):
+        ll = ullist()
+        ref = []
+        rng = random.Random(1)
+        for i in py23_xrange(500):
+            idx = rng.randint(0, len(ref))
+            ll.insert(i, idx)
+            ref.insert(idx, i)
+        self.assertEqual(list(ll), ref)
+        ll.insert('end')
+        ll.insert('last', None)
+        ll.insert('neg', -1)
+        ref.extend(['end', 'last'])
+        ref.insert(-1, 'neg')
+        self.assertEqual(list(ll), ref)
+
+    def test_insert_invalid_index(self):
+        ll = ullist([1, 2])
+        self.assertRaises(IndexError, ll.insert, 0, 3)
+        self.assertRaises(IndexError, ll.insert, 0, -3)
+        self.assertRaises(TypeError, ll.insert, 0, 'abc')
+        self.assertEqual(list(ll), [1, 2])
+
+    def test_pop(self):
+        ref = py23_range(100)
+        ll = ullist(ref)
+        while ref:
+            self.assertEqual(ll.popleft(), ref.pop(0))
+            if ref:
+                self.assertEqual(ll.pop(), ref.pop())
+            self.assertEqual(list(ll), ref)
+        self.assertRaises(ValueError, ll.pop)
+        self.assertRaises(ValueError, ll.popleft)
+        self.assertRaises(ValueError, ll.popright)
+
+    def test_remove(self):
+        ll = ullist([1, 2, 3, 2])
+        self.assertTrue(ll.remove(2) is None)
+        self.assertEqual(list(ll), [1, 3, 2])
+        self.assertRaises(ValueError, ll.remove, 5)
+        self.assertEqual(list(ll), [1, 3, 2])
+
+    def test_remove_last_reference(self):
+        # the list holds the only reference to each value
+        ll = ullist(['x' * i for i in py23_range(1, 6)])
+        ll.remove('xx')
+        del ll[0]
+        self.assertEqual(list(ll), ['xxx', 'xxxx', 'xxxxx'])
+
+    def test_index(self):
+        ll = ullist(py23_range(100))
+        self.assertEqual(ll.index(0), 0)
+        self.assertEqual(ll.index(77), 77)
+        self.assertRaises(ValueError, ll.index, 100)
+
+    def test_contains(self):
+        ll = ullist([1, 'abc', None])
+        self.assertTrue(1 in ll)
+        self.assertTrue('abc' in ll)
+        self.assertTrue(None in ll)
+        self.assertFalse(2 in ll)
+
+    def test_getitem(self):
+        ref = py23_range(0, 1000, 3)
+        ll = ullist(ref)
+        for idx in py23_range(len(ref)):
+            self.assertEqual(ll[idx], ref[idx])
+        for idx in py23_range(1, len(ref) + 1):
+            self.assertEqual(ll[-idx], ref[-idx])
+        rng = random.Random(2)
+        for i in py23_xrange(200):
+            idx = rng.randint(0, len(ref) - 1)
+            self.assertEqual(ll[idx], ref[idx])
+        self.assertRaises(IndexError, ll.__getitem__, len(ref))
+        self.assertRaises(IndexError, ll.__getitem__, -len(ref) - 1)
+
+    def test_setitem(self):
+        ll = ullist(py23_range(100))
+        ll[50] = 'a'
+        ll[-1] = 'b'
+        self.assertEqual(ll[50], 'a')
+        self.assertEqual(ll[99], 'b')
+        self.assertRaises(IndexError, ll.__setitem__, 100, 1)
+
+    def test_delitem(self):
+        ref = py23_range(300)
+        ll = ullist(ref)
+        rng = random.Random(3)
+        while ref:
+            idx = rng.randint(-len(ref), len(ref) - 1)
+            del ll[idx]
+            del ref[idx]
+            self.assertEqual(len(ll), len(ref))
+        self.assertEqual(list(ll), [])
+        self.assertRaises(IndexError, ll.__delitem__, 0)
+
+    def test_random_operations(self):
+        ll = ullist()
+        ref = []
+        rng = random.Random(4)
+        for i in py23_xrange(3000):
+            op = rng.randint(0, 5)
+            if op == 0:
+                ll.append(i)
+                ref.append(i)
+            elif op == 1:
+                ll.appendleft(i)
+                ref.insert(0, i)
+            elif op == 2:
+                idx = rng.randint(0, len(ref))
+                ll.insert(i, idx)
+                ref.insert(idx, i)
+            elif ref and op == 3:
+                idx = rng.randint(0, len(ref) - 1)
+                del ll[idx]
+                del ref[idx]
+            elif ref and op == 4:
+                self.assertEqual(ll.popleft(), ref.pop(0))
+            elif ref:
+                self.assertEqual(ll.pop(), ref.pop())
+        self.assertEqual(list(ll), ref)
+        for idx in py23_range(len(ref)):
+            self.assertEqual(ll[idx], ref[idx])
+
+    def test_clear(self):
+        ll = ullist(py23_range(100))
+        ll.clear()
+        self.assertEqual(len(ll), 0)
+        self.assertEqual(list(ll), [])
+        ll.append(1)
+        self.assertEqual(list(ll), [1])
+
+    def test_rotate(self):
+        ref = py23_range(100)
+        for n in [0, 1, 2, 31, 32, 33, 50, 99, 100, 101, -1, -33, -150]:
+            ll = ullist(ref)
+            ll.rotate(n)
+            shift = n % len(ref)
+            self.assertEqual(list(ll), ref[-shift:] + ref[:-shift])
+        self.assertRaises(TypeError, ullist([1, 2]).rotate, 'abc')
+
+    def test_rotate_overflow(self):
+        ll = ullist([1, 2, 3])
+        self.assertRaises(OverflowError, ll.rotate, 2 ** 70)
+        self.assertRaises(OverflowError, ll.rotate, -2 ** 70)
+        self.assertEqual(list(ll), [1, 2, 3])
+
+    def test_concat(self):
+        a = ullist([1, 2])
+        b = ullist([3])
+        c = a + b
+        self.assertTrue(type(c) is ullist)
+        self.assertEqual(list(c), [1, 2, 3])
+        self.assertEqual(list(a + [4]), [1, 2, 4])
+        a += b
+        self.assertEqual(list(a), [1, 2, 3])
+
+    def test_repeat(self):
+        ll = ullist([1, 2])
+        self.assertEqual(list(ll * 3), [1, 2, 1, 2, 1, 2])
+        self.assertEqual(list(ll * 0), [])
+
+    def test_compare(self):
+        self.assertEqual(ullist([1, 2]), ullist([1, 2]))
+        self.assertNotEqual(ullist([1, 2]), ullist([1]))
+        self.assertTrue(ullist([1, 2]) < ullist([1, 3]))
+        self.assertTrue(ullist([1]) < ullist([1, 0]))
+        self.assertTrue(ullist([2]) >= ullist([1, 5]))
+        self.assertTrue(ullist([1, 2]) <= ullist([1, 2]))
+        self.assertFalse(ullist([1]) == [1])
+
+    def test_hash(self):
+        self.assertEqual(hash(ullist([1, 2])), hash(ullist([1, 2])))
+        self.assertNotEqual(hash(ullist([1, 2])), hash(ullist([2, 1])))
+        self.assertRaises(TypeError, hash, ullist([[]]))
+
+    def test_iterator_invalidation(self):
+        ll = ullist(py23_range(100))
+        it = iter(ll)
+        next(it)
+        ll.popleft()
+        self.assertRaises(RuntimeError, next, it)
+
+    def test_exhausted_iterator_stays_exhausted(self):
+        ll = ullist(py23_range(32))
+        it = iter(ll)
+        for i in py23_xrange(32):
+            self.assertEqual(next(it), i)
+        self.assertRaises(StopIteration, next, it)
+        ll.append(32)
+        self.assertRaises(StopIteration, next, it)
+
+    def test_exhausted_iterator_of_empty_list_stays_exhausted(self):
+        ll = ullist()
+        it = iter(ll)
+        self.assertRaises(StopIteration, next, it)
+        ll.append(1)
+        self.assertRaises(StopIteration, next, it)
+
+    def test_weakref(self):
+        ll = ullist([1])
+        ref = weakref.ref(ll)
+        self.assertTrue(ref() is ll)
+        del ll
+        self.assertTrue(ref() is None)
+
+    def test_sizeof(self):
+        empty_size = sys.getsizeof(ullist())
+        self.assertTrue(sys.getsizeof(ullist([1])) > empty_size)
+        self.assertTrue(sys.getsizeof(ullist(py23_range(1000))) >
+                        sys.getsizeof(ullist(py23_range(10))))
+
+    def test_copy(self):
+        values = [[1], 'abc', None] * 20
+        ll = ullist(values)
+        copied = copy.copy(ll)
+        self.assertTrue(type(copied) is ullist)
+        self.assertEqual(copied, ll)
+        self.assertTrue(copied[0] is ll[0])
+        copied.append(1)
+        self.assertEqual(list(ll), values)
+        self.assertEqual(copy.copy(ullist()), ullist())
+
+    def test_deepcopy(self):
+        ll = ullist([[1], 'abc', None] * 20)
+        copied = copy.deepcopy(ll)
+        self.assertEqual(copied, ll)
+        self.assertTrue(copied[0] is not ll[0])
+        self.assertTrue(copied[3] is copied[0])
+        copied[0].append(2)
+        self.assertEqual(ll[0], [1])
+
+    def test_deepcopy_recursive_list(self):
+        ll = ullist([1])
+        ll.append(ll)
+        copied = copy.deepcopy(ll)
+        self.assertTrue(copied[1] is copied)
+        self.assertEqual(copied[0], 1)
+
+    def test_pickle(self):
+        ll = ullist(py23_range(100))
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertTrue(type(restored) is ullist)
+            self.assertEqual(restored, ll)
+        self.assertEqual(pickle.loads(pickle.dumps(ullist())), ullist())
+
+    def test_pickle_self_referential(self):
+        ll = ullist([1, 2])
+        ll.append(ll)
+        for protocol in py23_range(pickle.HIGHEST_PROTOCOL + 1):
+            restored = pickle.loads(pickle.dumps(ll, protocol))
+            self.assertEqual(len(restored), 3)
+            self.assertEqual(list(restored)[:2], [1, 2])
+            self.assertTrue(restored[2] is restored)
+
+    def test_copy_subclass_with_state(self):
+        ll = DerivedPicklableULList([1, 2])
+        ll.tag = 'x'
+        for copied in [copy.copy(ll), copy.deepcopy(ll),
+                       pickle.loads(pickle.dumps(ll))]:
+            self.assertTrue(type(copied) is DerivedPicklableULList)
+            self.assertEqual(list(copied), [1, 2])
+            self.assertEqual(copied.tag, 'x')
+
+    def test_cyclic_list_destruction(self):
+        ll = ullist()
+        ll.append(ll)
+        ref = weakref.ref(ll)
+        del ll
+        import gc
+        gc.collect()
+        self.assertTrue(ref() is None)
+
+    def test_release_values(self):
+        class Value(object):
+            pass
+        value = Value()
+        ref = weakref.ref(value)
+        ll = ullist([value] * 100)
+        del value
+        del ll[0]
+        ll.pop()
+        ll.popleft()
+        ll.clear()
+        self.assertTrue(ref() is None)